@@ -1486,6 +1486,25 @@ AC_DEFUN([BEE_DLFCN],[
   ])
 
 
+dnl  BEE_CC_TARGET_INTRINSICS(name, header, target, statement)
+AC_DEFUN([BEE_CC_TARGET_INTRINSICS],[
+  AC_CACHE_CHECK([whether the compiler supports $1 intrinsics],bc_cv_cc_intrinsics_$1,[
+    AC_LANG_PUSH(C)
+    AC_COMPILE_IFELSE([
+      AC_LANG_PROGRAM([[
+#include <$2>
+__attribute__((target("$3"))) static void bc_test(void) { $4; }
+        ]],[[bc_test();]])
+      ],[
+      bc_cv_cc_intrinsics_$1=yes
+      ],[
+      bc_cv_cc_intrinsics_$1=no
+      ])
+    AC_LANG_POP(C)
+    ])
+  ])
+
+
 dnl  BEE_MULTITHREAD
 AC_DEFUN([BEE_MULTITHREAD],[
   AH_TEMPLATE([ENABLE_THREADS],[Define to 1 if you want to enable multithread support])
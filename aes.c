@@ -53,28 +53,48 @@
 
 #include "beecrypt/mp.h"
 
-#ifdef ASM_AESENCRYPTECB
+#if ENABLE_AESNI
+# include <wmmintrin.h>
+# include "beecrypt/blockmode.h"
+# include "beecrypt/cpu.h"
+# include "beecrypt/endianness.h"
+
+/* When AES-NI support is compiled in, the functions below check at run-time
+ * whether the cpu has the instructions; if not, the table-driven code and
+ * the generic block mode functions are used. Both variants produce the same
+ * key schedule, so an aesParam can be used by either one.
+ */
+static int aesEncryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+static int aesDecryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+static int aesEncryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+static int aesDecryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+static int aesEncryptCTR(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+
+# define aesDecryptCTR aesEncryptCTR
+#else
+# ifdef ASM_AESENCRYPTECB
 extern int aesEncryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
-#endif
+# endif
 
-#ifdef ASM_AESDECRYPTECB
+# ifdef ASM_AESDECRYPTECB
 extern int aesDecryptECB(aesParam*, uint32_t*, const uint32_t*, unsigned int);
-#endif
+# endif
 
-#ifdef ASM_AESENCRYPTCBC
+# ifdef ASM_AESENCRYPTCBC
 extern int aesEncryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
-#endif
+# endif
 
-#ifdef ASM_AESDECRYPTCBC
+# ifdef ASM_AESDECRYPTCBC
 extern int aesDecryptCBC(aesParam*, uint32_t*, const uint32_t*, unsigned int);
-#endif
+# endif
 
-#ifdef ASM_AESENCRYPTCTR
+# ifdef ASM_AESENCRYPTCTR
 extern int aesEncryptCTR(aesParam*, uint32_t*, const uint32_t*, unsigned int);
-#endif
+# endif
 
-#ifdef ASM_AESDECRYPTCTR
+# ifdef ASM_AESDECRYPTCTR
 extern int aesDecryptCTR(aesParam*, uint32_t*, const uint32_t*, unsigned int);
+# endif
 #endif
 
 const blockCipher aes = {
@@ -90,51 +110,380 @@ const blockCipher aes = {
 	(blockCipherFeedback) aesFeedback,
 	{
 		(blockCipherRawcrypt) aesEncrypt,
-		(blockCipherRawcrypt) aesDecrypt
+		(blockCipherRawcrypt) aesDecrypt,
+		(blockCipherRawcryptN) aesEncryptN,
+		(blockCipherRawcryptN) aesDecryptN
 	},
 	{
-		#ifdef ASM_AESENCRYPTECB
+		#if ENABLE_AESNI || defined(ASM_AESENCRYPTECB)
 		(blockCipherModcrypt) aesEncryptECB,
 		#else
 		(blockCipherModcrypt) 0,
 		#endif
-		#ifdef ASM_AESDECRYPTECB
+		#if ENABLE_AESNI || defined(ASM_AESDECRYPTECB)
 		(blockCipherModcrypt) aesDecryptECB,
 		#else
 		(blockCipherModcrypt) 0,
 		#endif
 	},
 	{
-		#ifdef ASM_AESENCRYPTCBC
+		#if ENABLE_AESNI || defined(ASM_AESENCRYPTCBC)
 		(blockCipherModcrypt) aesEncryptCBC,
 		#else
 		(blockCipherModcrypt) 0,
 		#endif
-		#ifdef ASM_AESDECRYPTCBC
+		#if ENABLE_AESNI || defined(ASM_AESDECRYPTCBC)
 		(blockCipherModcrypt) aesDecryptCBC,
 		#else
 		(blockCipherModcrypt) 0
 		#endif
 	},
 	{
-		#ifdef ASM_AESENCRYPTCTR
-		(blockCipherModcrypt) aesDecryptCTR,
+		#if ENABLE_AESNI || defined(ASM_AESENCRYPTCTR)
+		(blockCipherModcrypt) aesEncryptCTR,
 		#else
 		(blockCipherModcrypt) 0,
 		#endif
-		#ifdef ASM_AESDECRYPTCTR
-		(blockCipherModcrypt) aesEncryptCTR,
+		#if ENABLE_AESNI || defined(ASM_AESDECRYPTCTR)
+		(blockCipherModcrypt) aesDecryptCTR,
 		#else
 		(blockCipherModcrypt) 0
 		#endif
 	}
 };
 
+#if ENABLE_AESNI
+# define AESNI_TARGET __attribute__((target("aes,sse2")))
+
+/* set by aesSetup, if the cpu supports AES-NI */
+static int _aesni = 0;
+
+static AESNI_TARGET int aesniSetup(aesParam* ap, const byte* key, size_t keybits, cipherOperation op)
+{
+	register uint32_t* rk = ap->k;
+	register unsigned int nk = (keybits >> 5), n, i;
+
+	ap->nr = 6 + nk;
+
+	n = (ap->nr + 1) << 2;
+
+	memcpy(rk, key, keybits >> 3);
+
+	/* straightforward FIPS 197 key expansion, with aeskeygenassist
+	 * performing the s-box substitutions without table lookups
+	 */
+	for (i = nk; i < n; i++)
+	{
+		register uint32_t t = rk[i-1];
+
+		if ((i % nk) == 0)
+		{
+			__m128i x = _mm_aeskeygenassist_si128(_mm_set1_epi32((int) t), 0);
+
+			/* RotWord(SubWord(t)) */
+			t = (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(x, 4)) ^ _arc[i/nk - 1];
+		}
+		else if ((nk > 6) && ((i % nk) == 4))
+		{
+			__m128i x = _mm_aeskeygenassist_si128(_mm_set1_epi32((int) t), 0);
+
+			/* SubWord(t) */
+			t = (uint32_t) _mm_cvtsi128_si32(x);
+		}
+
+		rk[i] = rk[i-nk] ^ t;
+	}
+
+	if (op == DECRYPT)
+	{
+		/* reverse the round keys, and apply InvMixColumns to all but the
+		 * first and last, for the equivalent inverse cipher
+		 */
+		__m128i* k = (__m128i*) ap->k;
+		__m128i t;
+
+		for (i = 0, n = ap->nr; i < n; i++, n--)
+		{
+			t = _mm_loadu_si128(k+i);
+			_mm_storeu_si128(k+i, _mm_loadu_si128(k+n));
+			_mm_storeu_si128(k+n, t);
+		}
+		for (i = 1; i < ap->nr; i++)
+			_mm_storeu_si128(k+i, _mm_aesimc_si128(_mm_loadu_si128(k+i)));
+	}
+
+	return 0;
+}
+
+static AESNI_TARGET __m128i aesniEncryptBlock(const aesParam* ap, __m128i b)
+{
+	register const __m128i* rk = (const __m128i*) ap->k;
+	register unsigned int i;
+
+	b = _mm_xor_si128(b, _mm_loadu_si128(rk));
+	for (i = 1; i < ap->nr; i++)
+		b = _mm_aesenc_si128(b, _mm_loadu_si128(rk+i));
+	return _mm_aesenclast_si128(b, _mm_loadu_si128(rk+i));
+}
+
+static AESNI_TARGET __m128i aesniDecryptBlock(const aesParam* ap, __m128i b)
+{
+	register const __m128i* rk = (const __m128i*) ap->k;
+	register unsigned int i;
+
+	b = _mm_xor_si128(b, _mm_loadu_si128(rk));
+	for (i = 1; i < ap->nr; i++)
+		b = _mm_aesdec_si128(b, _mm_loadu_si128(rk+i));
+	return _mm_aesdeclast_si128(b, _mm_loadu_si128(rk+i));
+}
+
+/* The aesenc/aesdec instructions have a latency of several cycles but can
+ * start every cycle, so independent blocks are processed eight at a time.
+ */
+#define AESNI_LANES	8
+
+static AESNI_TARGET void aesniEncryptLanes(const aesParam* ap, __m128i* b)
+{
+	register const __m128i* rk = (const __m128i*) ap->k;
+	register unsigned int i, j;
+	__m128i k = _mm_loadu_si128(rk);
+
+	for (j = 0; j < AESNI_LANES; j++)
+		b[j] = _mm_xor_si128(b[j], k);
+	for (i = 1; i < ap->nr; i++)
+	{
+		k = _mm_loadu_si128(rk+i);
+		for (j = 0; j < AESNI_LANES; j++)
+			b[j] = _mm_aesenc_si128(b[j], k);
+	}
+	k = _mm_loadu_si128(rk+i);
+	for (j = 0; j < AESNI_LANES; j++)
+		b[j] = _mm_aesenclast_si128(b[j], k);
+}
+
+static AESNI_TARGET void aesniDecryptLanes(const aesParam* ap, __m128i* b)
+{
+	register const __m128i* rk = (const __m128i*) ap->k;
+	register unsigned int i, j;
+	__m128i k = _mm_loadu_si128(rk);
+
+	for (j = 0; j < AESNI_LANES; j++)
+		b[j] = _mm_xor_si128(b[j], k);
+	for (i = 1; i < ap->nr; i++)
+	{
+		k = _mm_loadu_si128(rk+i);
+		for (j = 0; j < AESNI_LANES; j++)
+			b[j] = _mm_aesdec_si128(b[j], k);
+	}
+	k = _mm_loadu_si128(rk+i);
+	for (j = 0; j < AESNI_LANES; j++)
+		b[j] = _mm_aesdeclast_si128(b[j], k);
+}
+
+static AESNI_TARGET int aesniEncryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	register const __m128i* in = (const __m128i*) src;
+	register __m128i* out = (__m128i*) dst;
+	register unsigned int j;
+	__m128i b[AESNI_LANES];
+
+	while (nblocks >= AESNI_LANES)
+	{
+		for (j = 0; j < AESNI_LANES; j++)
+			b[j] = _mm_loadu_si128(in+j);
+		aesniEncryptLanes(ap, b);
+		for (j = 0; j < AESNI_LANES; j++)
+			_mm_storeu_si128(out+j, b[j]);
+
+		in += AESNI_LANES;
+		out += AESNI_LANES;
+		nblocks -= AESNI_LANES;
+	}
+	while (nblocks > 0)
+	{
+		_mm_storeu_si128(out++, aesniEncryptBlock(ap, _mm_loadu_si128(in++)));
+		nblocks--;
+	}
+
+	return 0;
+}
+
+static AESNI_TARGET int aesniDecryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	register const __m128i* in = (const __m128i*) src;
+	register __m128i* out = (__m128i*) dst;
+	register unsigned int j;
+	__m128i b[AESNI_LANES];
+
+	while (nblocks >= AESNI_LANES)
+	{
+		for (j = 0; j < AESNI_LANES; j++)
+			b[j] = _mm_loadu_si128(in+j);
+		aesniDecryptLanes(ap, b);
+		for (j = 0; j < AESNI_LANES; j++)
+			_mm_storeu_si128(out+j, b[j]);
+
+		in += AESNI_LANES;
+		out += AESNI_LANES;
+		nblocks -= AESNI_LANES;
+	}
+	while (nblocks > 0)
+	{
+		_mm_storeu_si128(out++, aesniDecryptBlock(ap, _mm_loadu_si128(in++)));
+		nblocks--;
+	}
+
+	return 0;
+}
+
+static AESNI_TARGET int aesniEncryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	register const __m128i* in = (const __m128i*) src;
+	register __m128i* out = (__m128i*) dst;
+	__m128i fdback = _mm_loadu_si128((const __m128i*) ap->fdback);
+
+	while (nblocks > 0)
+	{
+		fdback = aesniEncryptBlock(ap, _mm_xor_si128(_mm_loadu_si128(in++), fdback));
+		_mm_storeu_si128(out++, fdback);
+		nblocks--;
+	}
+
+	_mm_storeu_si128((__m128i*) ap->fdback, fdback);
+
+	return 0;
+}
+
+static AESNI_TARGET int aesniDecryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	register const __m128i* in = (const __m128i*) src;
+	register __m128i* out = (__m128i*) dst;
+	register unsigned int j;
+	__m128i fdback = _mm_loadu_si128((const __m128i*) ap->fdback);
+	__m128i b[AESNI_LANES], c[AESNI_LANES];
+
+	/* load all ciphertext blocks before storing, so that dst may equal src */
+	while (nblocks >= AESNI_LANES)
+	{
+		for (j = 0; j < AESNI_LANES; j++)
+			b[j] = c[j] = _mm_loadu_si128(in+j);
+		aesniDecryptLanes(ap, b);
+		_mm_storeu_si128(out, _mm_xor_si128(b[0], fdback));
+		for (j = 1; j < AESNI_LANES; j++)
+			_mm_storeu_si128(out+j, _mm_xor_si128(b[j], c[j-1]));
+		fdback = c[AESNI_LANES-1];
+
+		in += AESNI_LANES;
+		out += AESNI_LANES;
+		nblocks -= AESNI_LANES;
+	}
+	while (nblocks > 0)
+	{
+		c[0] = _mm_loadu_si128(in++);
+		_mm_storeu_si128(out++, _mm_xor_si128(aesniDecryptBlock(ap, c[0]), fdback));
+		fdback = c[0];
+		nblocks--;
+	}
+
+	_mm_storeu_si128((__m128i*) ap->fdback, fdback);
+
+	return 0;
+}
+
+# if (MP_WBITS == 64)
+static AESNI_TARGET int aesniEncryptCTR(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	/* the counter is kept in fdback as a two-word host-endian mpi; the
+	 * keystream input is each word byte-swapped, as in blockEncryptCTR
+	 */
+	register const __m128i* in = (const __m128i*) src;
+	register __m128i* out = (__m128i*) dst;
+	register unsigned int j, n;
+	__m128i b[AESNI_LANES];
+	mpw ctr[2];
+
+	memcpy(ctr, ap->fdback, sizeof(ctr));
+
+	while (nblocks > 0)
+	{
+		n = (nblocks < AESNI_LANES) ? nblocks : AESNI_LANES;
+
+		for (j = 0; j < AESNI_LANES; j++)
+		{
+			b[j] = _mm_set_epi64x((long long) swapu64(ctr[0]), (long long) swapu64(ctr[1]));
+			if (j < n)
+			{
+				if (++ctr[1] == 0)
+					++ctr[0];
+			}
+		}
+		aesniEncryptLanes(ap, b);
+		for (j = 0; j < n; j++)
+			_mm_storeu_si128(out+j, _mm_xor_si128(_mm_loadu_si128(in+j), b[j]));
+
+		in += n;
+		out += n;
+		nblocks -= n;
+	}
+
+	memcpy(ap->fdback, ctr, sizeof(ctr));
+
+	return 0;
+}
+# endif
+
+static int aesEncryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	if (_aesni)
+		return aesniEncryptN(ap, dst, src, nblocks);
+
+	return blockEncryptECB(&aes, ap, dst, src, nblocks);
+}
+
+static int aesDecryptECB(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	if (_aesni)
+		return aesniDecryptN(ap, dst, src, nblocks);
+
+	return blockDecryptECB(&aes, ap, dst, src, nblocks);
+}
+
+static int aesEncryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	if (_aesni)
+		return aesniEncryptCBC(ap, dst, src, nblocks);
+
+	return blockEncryptCBC(&aes, ap, dst, src, nblocks);
+}
+
+static int aesDecryptCBC(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	if (_aesni)
+		return aesniDecryptCBC(ap, dst, src, nblocks);
+
+	return blockDecryptCBC(&aes, ap, dst, src, nblocks);
+}
+
+static int aesEncryptCTR(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	# if (MP_WBITS == 64)
+	if (_aesni)
+		return aesniEncryptCTR(ap, dst, src, nblocks);
+	# endif
+
+	return blockEncryptCTR(&aes, ap, dst, src, nblocks);
+}
+#endif
+
 int aesSetup(aesParam* ap, const byte* key, size_t keybits, cipherOperation op)
 {
 	if ((op != ENCRYPT) && (op != DECRYPT))
 		return -1;
 
+	#if ENABLE_AESNI
+	_aesni = ((cpuFeatures() & CPU_FEATURE_AESNI) != 0);
+	#endif
+
 	if (((keybits & 63) == 0) && (keybits >= 128) && (keybits <= 256))
 	{
 		register uint32_t* rk, t, i, j;
@@ -145,6 +494,11 @@ int aesSetup(aesParam* ap, const byte* key, size_t keybits, cipherOperation op)
 		ap->fdback[2] = 0;
 		ap->fdback[3] = 0;
 
+		#if ENABLE_AESNI
+		if (_aesni)
+			return aesniSetup(ap, key, keybits, op);
+		#endif
+
 		ap->nr = 6 + (keybits >> 5);
 
 		rk = ap->k;
@@ -361,6 +715,14 @@ int aesEncrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
 	#endif
 	register uint32_t* rk = ap->k;
 
+	#if ENABLE_AESNI
+	if (_aesni)
+	{
+		_mm_storeu_si128((__m128i*) dst, aesniEncryptBlock(ap, _mm_loadu_si128((const __m128i*) src)));
+		return 0;
+	}
+	#endif
+
 	#if defined (OPTIMIZE_MMX) && (defined(OPTIMIZE_I586) || defined(OPTIMIZE_I686))
 	s0 = _mm_cvtsi32_si64(src[0] ^ rk[0]);
 	s1 = _mm_cvtsi32_si64(src[1] ^ rk[1]);
@@ -421,6 +783,14 @@ int aesDecrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
 	register uint32_t t0, t1, t2, t3;
 	register uint32_t* rk = ap->k;
 
+	#if ENABLE_AESNI
+	if (_aesni)
+	{
+		_mm_storeu_si128((__m128i*) dst, aesniDecryptBlock(ap, _mm_loadu_si128((const __m128i*) src)));
+		return 0;
+	}
+	#endif
+
 	s0 = src[0] ^ rk[0];
 	s1 = src[1] ^ rk[1];
 	s2 = src[2] ^ rk[2];
@@ -460,6 +830,150 @@ int aesDecrypt(aesParam* ap, uint32_t* dst, const uint32_t* src)
 }
 #endif
 
+/* The multi-block functions below process two independent blocks side by
+ * side, so that the table lookups for one block can be issued while those
+ * for the other are still outstanding; with more blocks in flight the state
+ * no longer fits in the general purpose registers of a typical cpu.
+ */
+#define etfs2(d,s,i) etfsn(a##d, a##s, i); etfsn(b##d, b##s, i)
+#define dtfs2(d,s,i) dtfsn(a##d, a##s, i); dtfsn(b##d, b##s, i)
+
+#ifndef ASM_AESENCRYPTN
+int aesEncryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if ENABLE_AESNI
+	if (_aesni)
+		return aesniEncryptN(ap, dst, src, nblocks);
+	#endif
+
+	#if !(defined(OPTIMIZE_MMX) && (defined(OPTIMIZE_I586) || defined(OPTIMIZE_I686)))
+	while (nblocks >= 2)
+	{
+		register uint32_t as0, as1, as2, as3, at0, at1, at2, at3;
+		register uint32_t bs0, bs1, bs2, bs3, bt0, bt1, bt2, bt3;
+		register uint32_t* rk = ap->k;
+
+		as0 = src[0] ^ rk[0]; as1 = src[1] ^ rk[1]; as2 = src[2] ^ rk[2]; as3 = src[3] ^ rk[3];
+		bs0 = src[4] ^ rk[0]; bs1 = src[5] ^ rk[1]; bs2 = src[6] ^ rk[2]; bs3 = src[7] ^ rk[3];
+
+		etfs2(t, s, 4);		/* round 1 */
+		etfs2(s, t, 8);		/* round 2 */
+		etfs2(t, s, 12);	/* round 3 */
+		etfs2(s, t, 16);	/* round 4 */
+		etfs2(t, s, 20);	/* round 5 */
+		etfs2(s, t, 24);	/* round 6 */
+		etfs2(t, s, 28);	/* round 7 */
+		etfs2(s, t, 32);	/* round 8 */
+		etfs2(t, s, 36);	/* round 9 */
+
+		if (ap->nr > 10)
+		{
+			etfs2(s, t, 40);	/* round 10 */
+			etfs2(t, s, 44);	/* round 11 */
+			if (ap->nr > 12)
+			{
+				etfs2(s, t, 48);	/* round 12 */
+				etfs2(t, s, 52);	/* round 13 */
+			}
+		}
+
+		rk += (ap->nr << 2);
+
+		/* last round */
+		elrn(as, at, 0);
+		elrn(bs, bt, 0);
+
+		dst[0] = as0; dst[1] = as1; dst[2] = as2; dst[3] = as3;
+		dst[4] = bs0; dst[5] = bs1; dst[6] = bs2; dst[7] = bs3;
+
+		dst += 8;
+		src += 8;
+
+		nblocks -= 2;
+	}
+	#endif
+
+	while (nblocks > 0)
+	{
+		aesEncrypt(ap, dst, src);
+
+		dst += 4;
+		src += 4;
+
+		nblocks--;
+	}
+
+	return 0;
+}
+#endif
+
+#ifndef ASM_AESDECRYPTN
+int aesDecryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	#if ENABLE_AESNI
+	if (_aesni)
+		return aesniDecryptN(ap, dst, src, nblocks);
+	#endif
+
+	while (nblocks >= 2)
+	{
+		register uint32_t as0, as1, as2, as3, at0, at1, at2, at3;
+		register uint32_t bs0, bs1, bs2, bs3, bt0, bt1, bt2, bt3;
+		register uint32_t* rk = ap->k;
+
+		as0 = src[0] ^ rk[0]; as1 = src[1] ^ rk[1]; as2 = src[2] ^ rk[2]; as3 = src[3] ^ rk[3];
+		bs0 = src[4] ^ rk[0]; bs1 = src[5] ^ rk[1]; bs2 = src[6] ^ rk[2]; bs3 = src[7] ^ rk[3];
+
+		dtfs2(t, s, 4);		/* round 1 */
+		dtfs2(s, t, 8);		/* round 2 */
+		dtfs2(t, s, 12);	/* round 3 */
+		dtfs2(s, t, 16);	/* round 4 */
+		dtfs2(t, s, 20);	/* round 5 */
+		dtfs2(s, t, 24);	/* round 6 */
+		dtfs2(t, s, 28);	/* round 7 */
+		dtfs2(s, t, 32);	/* round 8 */
+		dtfs2(t, s, 36);	/* round 9 */
+
+		if (ap->nr > 10)
+		{
+			dtfs2(s, t, 40);	/* round 10 */
+			dtfs2(t, s, 44);	/* round 11 */
+			if (ap->nr > 12)
+			{
+				dtfs2(s, t, 48);	/* round 12 */
+				dtfs2(t, s, 52);	/* round 13 */
+			}
+		}
+
+		rk += (ap->nr << 2);
+
+		/* last round */
+		dlrn(as, at, 0);
+		dlrn(bs, bt, 0);
+
+		dst[0] = as0; dst[1] = as1; dst[2] = as2; dst[3] = as3;
+		dst[4] = bs0; dst[5] = bs1; dst[6] = bs2; dst[7] = bs3;
+
+		dst += 8;
+		src += 8;
+
+		nblocks -= 2;
+	}
+
+	while (nblocks > 0)
+	{
+		aesDecrypt(ap, dst, src);
+
+		dst += 4;
+		src += 4;
+
+		nblocks--;
+	}
+
+	return 0;
+}
+#endif
+
 uint32_t* aesFeedback(aesParam* ap)
 {
 	return ap->fdback;
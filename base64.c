@@ -36,288 +36,735 @@
 
 #include "beecrypt/endianness.h"
 
-#if HAVE_CTYPE_H
-# include <ctype.h>
+#if ENABLE_SSSE3 || ENABLE_AVX2
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# define B64_DISPATCH 1
 #endif
 
 static const char* to_b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+/* maps each character to its 6-bit value, or to 0xff if it isn't one */
+static const byte from_b64[256] = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
 /* encode 64 characters per line */
 #define CHARS_PER_LINE	64
 
-char* b64enc(const memchunk* chunk)
+int b64encode_chars_per_line = B64ENCODE_CHARS_PER_LINE;
+
+const char * b64encode_eolstr = B64ENCODE_EOLSTR;
+
+const char* b64decode_whitespace = B64DECODE_WHITESPACE;
+
+/* the encoders translate groups of three bytes into four characters, and
+ * the decoders do the reverse for as long as they meet nothing but base64
+ * characters; they return the number of groups of four which were decoded
+ */
+static void b64encodeC(const byte* src, size_t triples, char* dst)
 {
-	int div = chunk->size / 3;
-	int rem = chunk->size % 3;
-	int chars = div*4 + rem + 1;
-	int newlines = (chars + CHARS_PER_LINE - 1) / CHARS_PER_LINE;
+	while (triples--)
+	{
+		register uint32_t w = ((uint32_t) src[0] << 16) | ((uint32_t) src[1] << 8) | src[2];
+
+		dst[0] = to_b64[ w >> 18        ];
+		dst[1] = to_b64[(w >> 12) & 0x3f];
+		dst[2] = to_b64[(w >>  6) & 0x3f];
+		dst[3] = to_b64[ w        & 0x3f];
+		src += 3;
+		dst += 4;
+	}
+}
 
-	const byte* data = chunk->data;
-	char* string = (char*) malloc(chars + newlines + 1);
+static size_t b64decodeC(const char* src, size_t quads, byte* dst)
+{
+	register size_t done;
 
-	if (string)
+	for (done = 0; done < quads; done++)
+	{
+		register uint32_t a = from_b64[(byte) src[0]];
+		register uint32_t b = from_b64[(byte) src[1]];
+		register uint32_t c = from_b64[(byte) src[2]];
+		register uint32_t d = from_b64[(byte) src[3]];
+		register uint32_t w;
+
+		if ((a | b | c | d) & 0x80)
+			break;
+
+		w = (a << 18) | (b << 12) | (c << 6) | d;
+
+		dst[0] = (byte) (w >> 16);
+		dst[1] = (byte) (w >>  8);
+		dst[2] = (byte) (w      );
+		src += 4;
+		dst += 3;
+	}
+
+	return done;
+}
+
+#if ENABLE_SSSE3
+# define SSSE3_TARGET __attribute__((target("ssse3")))
+
+/* spreads twelve bytes over sixteen lanes of six bits each */
+static SSSE3_TARGET __m128i b64encodeUnpackSSSE3(__m128i x)
+{
+	__m128i lo, hi;
+
+	x = _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	hi = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+	lo = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+
+	return _mm_or_si128(hi, lo);
+}
+
+/* the range which a value falls in selects the offset that turns it into
+ * its character: 0..25 map to 13, 26..51 to 0, 52..61 to 1..10, 62 to 11
+ * and 63 to 12
+ */
+static SSSE3_TARGET __m128i b64encodeMapSSSE3(__m128i x)
+{
+	__m128i r = _mm_subs_epu8(x, _mm_set1_epi8(51));
+
+	r = _mm_or_si128(r, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), x), _mm_set1_epi8(13)));
+	r = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), r);
+
+	return _mm_add_epi8(x, r);
+}
+
+/* a character is valid if the bit for its high nibble is set in the mask
+ * for its low nibble; the high nibble also selects the offset which turns
+ * it into its value, with only '/' needing a correction
+ */
+static SSSE3_TARGET int b64decodeMapSSSE3(__m128i* x)
+{
+	__m128i hi = _mm_and_si128(_mm_srli_epi32(*x, 4), _mm_set1_epi8(0x0f));
+	__m128i lo = _mm_and_si128(*x, _mm_set1_epi8(0x0f));
+	__m128i mask = _mm_shuffle_epi8(_mm_setr_epi8(0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54), lo);
+	__m128i bit = _mm_shuffle_epi8(_mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0), hi);
+	__m128i shift = _mm_shuffle_epi8(_mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), hi);
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(mask, bit), _mm_setzero_si128())))
+		return -1;
+
+	shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(*x, _mm_set1_epi8('/')), _mm_set1_epi8(-3)));
+
+	*x = _mm_add_epi8(*x, shift);
+
+	return 0;
+}
+
+/* packs sixteen lanes of six bits into the low twelve bytes */
+static SSSE3_TARGET __m128i b64decodePackSSSE3(__m128i x)
+{
+	x = _mm_maddubs_epi16(x, _mm_set1_epi32(0x01400140));
+	x = _mm_madd_epi16(x, _mm_set1_epi32(0x00011000));
+
+	return _mm_shuffle_epi8(x, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+/* each load reads four bytes beyond the twelve it uses */
+static SSSE3_TARGET void b64encodeSSSE3(const byte* src, size_t triples, char* dst)
+{
+	while (triples >= 6)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i*) src);
+
+		_mm_storeu_si128((__m128i*) dst, b64encodeMapSSSE3(b64encodeUnpackSSSE3(x)));
+		src += 12;
+		dst += 16;
+		triples -= 4;
+	}
+
+	b64encodeC(src, triples, dst);
+}
+
+static SSSE3_TARGET size_t b64decodeSSSE3(const char* src, size_t quads, byte* dst)
+{
+	size_t done = 0;
+
+	while (quads - done >= 4)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i*) src);
+		uint32_t tail;
+
+		if (b64decodeMapSSSE3(&x))
+			break;
+
+		x = b64decodePackSSSE3(x);
+
+		_mm_storel_epi64((__m128i*) dst, x);
+		tail = (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(x, 8));
+		memcpy(dst + 8, &tail, 4);
+		src += 16;
+		dst += 12;
+		done += 4;
+	}
+
+	return done + b64decodeC(src, quads - done, dst);
+}
+#endif
+
+#if ENABLE_AVX2
+# define AVX2_TARGET __attribute__((target("avx2")))
+
+/* the same algorithms as above, on two lanes of sixteen at once */
+static AVX2_TARGET __m256i b64encodeMapAVX2(__m256i x)
+{
+	__m256i lo, hi, r;
+
+	x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	hi = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+	lo = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+	x = _mm256_or_si256(hi, lo);
+
+	r = _mm256_subs_epu8(x, _mm256_set1_epi8(51));
+	r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), x), _mm256_set1_epi8(13)));
+	r = _mm256_shuffle_epi8(_mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), r);
+
+	return _mm256_add_epi8(x, r);
+}
+
+static AVX2_TARGET void b64encodeAVX2(const byte* src, size_t triples, char* dst)
+{
+	/* the upper load reads four bytes beyond the 24 used */
+	while (triples >= 10)
+	{
+		__m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) src)), _mm_loadu_si128((const __m128i*) (src + 12)), 1);
+
+		_mm256_storeu_si256((__m256i*) dst, b64encodeMapAVX2(x));
+		src += 24;
+		dst += 32;
+		triples -= 8;
+	}
+
+	b64encodeC(src, triples, dst);
+}
+
+static AVX2_TARGET size_t b64decodeAVX2(const char* src, size_t quads, byte* dst)
+{
+	size_t done = 0;
+
+	while (quads - done >= 8)
 	{
-		register char* buf = string;
+		__m256i x = _mm256_loadu_si256((const __m256i*) src);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi32(x, 4), _mm256_set1_epi8(0x0f));
+		__m256i lo = _mm256_and_si256(x, _mm256_set1_epi8(0x0f));
+		__m256i mask = _mm256_shuffle_epi8(_mm256_setr_epi8(0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54, 0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x54, 0x50, 0x50, 0x50, 0x54), lo);
+		__m256i bit = _mm256_shuffle_epi8(_mm256_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0), hi);
+		__m256i shift = _mm256_shuffle_epi8(_mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), hi);
+
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(mask, bit), _mm256_setzero_si256())))
+			break;
+
+		shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('/')), _mm256_set1_epi8(-3)));
+		x = _mm256_add_epi8(x, shift);
+
+		x = _mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140));
+		x = _mm256_madd_epi16(x, _mm256_set1_epi32(0x00011000));
+		x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+		_mm_storeu_si128((__m128i*) dst, _mm256_castsi256_si128(x));
+		_mm_storel_epi64((__m128i*) (dst + 16), _mm256_extracti128_si256(x, 1));
+		src += 32;
+		dst += 24;
+		done += 8;
+	}
+
+	return done + b64decodeC(src, quads - done, dst);
+}
+#endif
+
+#if B64_DISPATCH
+typedef void (*b64encodeFunction)(const byte*, size_t, char*);
+typedef size_t (*b64decodeFunction)(const char*, size_t, byte*);
 
-		chars = 0;
+/* the implementations in use; chosen on the first call */
+static b64encodeFunction _b64encodeblocks = (b64encodeFunction) 0;
+static b64decodeFunction _b64decodeblocks = (b64decodeFunction) 0;
 
-		while (div > 0)
+static void b64select(void)
+{
+	register uint32_t features = cpuFeatures();
+
+	_b64encodeblocks = b64encodeC;
+	_b64decodeblocks = b64decodeC;
+
+	#if ENABLE_SSSE3
+	if (features & CPU_FEATURE_SSSE3)
+	{
+		_b64encodeblocks = b64encodeSSSE3;
+		_b64decodeblocks = b64decodeSSSE3;
+	}
+	#endif
+	#if ENABLE_AVX2
+	if (features & CPU_FEATURE_AVX2)
+	{
+		_b64encodeblocks = b64encodeAVX2;
+		_b64decodeblocks = b64decodeAVX2;
+	}
+	#endif
+}
+
+static void b64encodeBlocks(const byte* src, size_t triples, char* dst)
+{
+	if (_b64encodeblocks == (b64encodeFunction) 0)
+		b64select();
+
+	_b64encodeblocks(src, triples, dst);
+}
+
+static size_t b64decodeBlocks(const char* src, size_t quads, byte* dst)
+{
+	if (_b64decodeblocks == (b64decodeFunction) 0)
+		b64select();
+
+	return _b64decodeblocks(src, quads, dst);
+}
+#else
+# define b64encodeBlocks	b64encodeC
+# define b64decodeBlocks	b64decodeC
+#endif
+
+static int b64whitespace(char ch)
+{
+	return (ch != '\0') && b64decode_whitespace && strchr(b64decode_whitespace, ch);
+}
+
+int b64encodeInit(b64encodeContext* ctxt, int chars_per_line, const char* eolstr)
+{
+	ctxt->npending = 0;
+	ctxt->column = 0;
+
+	if ((chars_per_line > 0) && eolstr && *eolstr)
+	{
+		/* lines hold whole groups of four characters */
+		ctxt->linelen = ((size_t) chars_per_line + 3) & ~((size_t) 3);
+		ctxt->eolstr = eolstr;
+		ctxt->eollen = strlen(eolstr);
+	}
+	else
+	{
+		ctxt->linelen = 0;
+		ctxt->eolstr = (const char*) 0;
+		ctxt->eollen = 0;
+	}
+
+	return 0;
+}
+
+size_t b64encodeUpdateSize(const b64encodeContext* ctxt, size_t ns)
+{
+	register size_t chars = ((ctxt->npending + ns) / 3) * 4;
+
+	if (ctxt->linelen)
+		chars += ((ctxt->column + chars) / ctxt->linelen) * ctxt->eollen;
+
+	return chars;
+}
+
+/* encodes whole groups of three, one line at a time */
+static char* b64encodeLines(b64encodeContext* ctxt, const byte* src, size_t triples, char* dst)
+{
+	while (triples > 0)
+	{
+		register size_t n = triples;
+
+		if (ctxt->linelen && (n > ((ctxt->linelen - ctxt->column) >> 2)))
+			n = (ctxt->linelen - ctxt->column) >> 2;
+
+		b64encodeBlocks(src, n, dst);
+		src += 3 * n;
+		dst += 4 * n;
+		triples -= n;
+
+		if (ctxt->linelen && ((ctxt->column += 4 * n) == ctxt->linelen))
 		{
-			buf[0] = to_b64[ (data[0] >> 2) & 0x3f];
-			buf[1] = to_b64[((data[0] << 4) & 0x30) | ((data[1] >> 4) & 0xf)];
-			buf[2] = to_b64[((data[1] << 2) & 0x3c) | ((data[2] >> 6) & 0x3)];
-			buf[3] = to_b64[  data[2] & 0x3f];
-			data += 3;
-			buf += 4;
-			div--;
-			chars += 4;
-			if (chars == CHARS_PER_LINE)
-			{
-				chars = 0;
-				*(buf++) = '\n';
-			}
+			memcpy(dst, ctxt->eolstr, ctxt->eollen);
+			dst += ctxt->eollen;
+			ctxt->column = 0;
 		}
+	}
 
-		switch (rem)
+	return dst;
+}
+
+int b64encodeUpdate(b64encodeContext* ctxt, const void* data, size_t ns, char* s, size_t* slen)
+{
+	register const byte* src = (const byte*) data;
+	register char* dst = s;
+
+	if (*slen < b64encodeUpdateSize(ctxt, ns))
+		return -1;
+
+	if (ctxt->npending)
+	{
+		while ((ctxt->npending < 3) && (ns > 0))
 		{
-		case 2:
-			buf[0] = to_b64[ (data[0] >> 2) & 0x3f];
-			buf[1] = to_b64[((data[0] << 4) & 0x30) + ((data[1] >> 4) & 0xf)];
-			buf[2] = to_b64[ (data[1] << 2) & 0x3c];
-			buf[3] = '=';
-			buf += 4;
-			chars += 4;
-			break;
-		case 1:
-			buf[0] = to_b64[ (data[0] >> 2) & 0x3f];
-			buf[1] = to_b64[ (data[0] << 4) & 0x30];
-			buf[2] = '=';
-			buf[3] = '=';
-			buf += 4;
-			chars += 4;
-			break;
+			ctxt->pending[ctxt->npending++] = *(src++);
+			ns--;
 		}
 
-	/* 	*(buf++) = '\n'; This would result in a buffer overrun */
-		*buf = '\0';
+		if (ctxt->npending < 3)
+		{
+			*slen = 0;
+			return 0;
+		}
+
+		dst = b64encodeLines(ctxt, ctxt->pending, 1, dst);
+		ctxt->npending = 0;
 	}
 
-	return string;
+	dst = b64encodeLines(ctxt, src, ns / 3, dst);
+
+	ctxt->npending = ns % 3;
+	memcpy(ctxt->pending, src + ns - ctxt->npending, ctxt->npending);
+
+	*slen = dst - s;
+
+	return 0;
 }
 
-memchunk* b64dec(const char* string)
+int b64encodeFinal(b64encodeContext* ctxt, char* s, size_t* slen)
 {
-	/* return a decoded memchunk, or a null pointer in case of failure */
+	size_t chars = 0;
 
-	memchunk* rc = 0;
+	if (ctxt->npending)
+	{
+		byte last[3] = { 0, 0, 0 };
 
-	if (string)
+		chars = 4;
+		if (ctxt->linelen && (ctxt->column + 4 == ctxt->linelen))
+			chars += ctxt->eollen;
+
+		if (*slen < chars)
+			return -1;
+
+		memcpy(last, ctxt->pending, ctxt->npending);
+		b64encodeC(last, 1, s);
+		if (ctxt->npending == 1)
+			s[2] = '=';
+		s[3] = '=';
+
+		if (ctxt->linelen && ((ctxt->column += 4) == ctxt->linelen))
+		{
+			memcpy(s + 4, ctxt->eolstr, ctxt->eollen);
+			ctxt->column = 0;
+		}
+
+		memset(ctxt->pending, 0, sizeof(ctxt->pending));
+		ctxt->npending = 0;
+	}
+
+	*slen = chars;
+
+	return 0;
+}
+
+size_t b64encodesize(size_t ns, int chars_per_line, const char* eolstr)
+{
+	b64encodeContext ctxt;
+	register size_t chars = ((ns + 2) / 3) * 4;
+
+	b64encodeInit(&ctxt, chars_per_line, eolstr);
+
+	if (ctxt.linelen)
+		chars += (chars / ctxt.linelen) * ctxt.eollen;
+
+	return chars;
+}
+
+int b64encodeto(const void* data, size_t ns, char* s, size_t* slen, int chars_per_line, const char* eolstr)
+{
+	b64encodeContext ctxt;
+	size_t len = *slen, rest;
+
+	if (b64encodeInit(&ctxt, chars_per_line, eolstr))
+		return -1;
+
+	if (b64encodeUpdate(&ctxt, data, ns, s, &len))
+		return -1;
+
+	rest = *slen - len;
+
+	if (b64encodeFinal(&ctxt, s + len, &rest))
+		return -1;
+
+	*slen = len + rest;
+
+	return 0;
+}
+
+int b64decodeInit(b64decodeContext* ctxt)
+{
+	ctxt->bits = 0;
+	ctxt->count = 0;
+	ctxt->padding = -1;
+
+	return 0;
+}
+
+int b64decodeUpdate(b64decodeContext* ctxt, const char* s, size_t ns, void* data, size_t* datalen)
+{
+	register byte* dst = (byte*) data;
+	register size_t room = *datalen;
+
+	while (ns > 0)
 	{
-		register int length = strlen(string);
+		register byte bits;
 
-		/* do a format verification first */
-		if (length > 0)
+		/* whole groups go to the block decoder, which stops at the first
+		 * group that holds anything else than base64 characters
+		 */
+		if ((ctxt->count == 0) && (ctxt->padding < 0) && (ns >= 4))
 		{
-			register int count = 0, rem = 0;
-			register const char* tmp = string;
+			register size_t quads = ns >> 2;
 
-			while (length > 0)
-			{
-				register int skip = strspn(tmp, to_b64);
-				count += skip;
-				length -= skip;
-				tmp += skip;
-				if (length > 0)
-				{
-					register int i, vrfy = strcspn(tmp, to_b64);
-
-					for (i = 0; i < vrfy; i++)
-					{
-						if (isspace(tmp[i]))
-							continue;
-
-						if (tmp[i] == '=')
-						{
-							/* we should check if we're close to the end of the string */
-							rem = count % 4;
-
-							/* rem must be either 2 or 3, otherwise no '=' should be here */
-							if (rem < 2)
-								return 0;
-
-							/* end-of-message recognized */
-							break;
-						}
-						else
-						{
-							/* Transmission error; RFC tells us to ignore this, but:
-							 *  - the rest of the message is going to even more corrupt since we're sliding bits out of place
-							 * If a message is corrupt, it should be dropped. Period.
-							 */
-
-							return 0;
-						}
-					}
-
-					length -= vrfy;
-					tmp += vrfy;
-				}
-			}
+			if (quads > room / 3)
+				quads = room / 3;
 
-			rc = memchunkAlloc((count / 4) * 3 + (rem ? (rem - 1) : 0));
+			quads = b64decodeBlocks(s, quads, dst);
 
-			if (rc)
+			s += quads << 2;
+			ns -= quads << 2;
+			dst += quads * 3;
+			room -= quads * 3;
+
+			if (ns == 0)
+				break;
+		}
+
+		bits = from_b64[(byte) *s];
+
+		if (bits < 64)
+		{
+			/* nothing may follow the padding */
+			if (ctxt->padding >= 0)
+				return -1;
+
+			if (ctxt->count == 3)
+			{
+				if (room < 3)
+					return -1;
+
+				ctxt->bits = (ctxt->bits << 6) | bits;
+				dst[0] = (byte) (ctxt->bits >> 16);
+				dst[1] = (byte) (ctxt->bits >>  8);
+				dst[2] = (byte) (ctxt->bits      );
+				dst += 3;
+				room -= 3;
+				ctxt->bits = 0;
+				ctxt->count = 0;
+			}
+			else
 			{
-				if (count > 0)
+				ctxt->bits = (ctxt->bits << 6) | bits;
+				ctxt->count++;
+			}
+		}
+		else if (*s == '=')
+		{
+			if (ctxt->padding < 0)
+			{
+				if ((ctxt->count < 2) || (room < (size_t) (ctxt->count - 1)))
+					return -1;
+
+				if (ctxt->count == 2)
 				{
-					register int i, qw = 0, tw = 0;
-					register byte* data = rc->data;
-
-					length = strlen(tmp = string);
-
-					for (i = 0; i < length; i++)
-					{
-						register char ch = string[i];
-						register byte bits = 0;
-
-						if (isspace(ch))
-							continue;
-
-						if ((ch >= 'A') && (ch <= 'Z'))
-						{
-							bits = (byte) (ch - 'A');
-						}
-						else if ((ch >= 'a') && (ch <= 'z'))
-						{
-							bits = (byte) (ch - 'a' + 26);
-						}
-						else if ((ch >= '0') && (ch <= '9'))
-						{
-							bits = (byte) (ch - '0' + 52);
-						}
-						else if (ch == '+')
-						{
-							bits = 62;
-						}
-						else if (ch == '/')
-						{
-							bits = 63;
-						}
-						else if (ch == '=')
-							break;
-
-						switch (qw++)
-						{
-						case 0:
-							data[tw+0] = (bits << 2) & 0xfc;
-							break;
-						case 1:
-							data[tw+0] |= (bits >> 4) & 0x03;
-							data[tw+1] = (bits << 4) & 0xf0;
-							break;
-						case 2:
-							data[tw+1] |= (bits >> 2) & 0x0f;
-							data[tw+2] = (bits << 6) & 0xc0;
-							break;
-						case 3:
-							data[tw+2] |= bits & 0x3f;
-							break;
-						}
-
-						if (qw == 4)
-						{
-							qw = 0;
-							tw += 3;
-						}
-					}
+					dst[0] = (byte) (ctxt->bits >> 4);
+					ctxt->padding = 1;
 				}
+				else
+				{
+					dst[0] = (byte) (ctxt->bits >> 10);
+					dst[1] = (byte) (ctxt->bits >>  2);
+					ctxt->padding = 0;
+				}
+				dst += ctxt->count - 1;
+				room -= ctxt->count - 1;
+				ctxt->bits = 0;
+				ctxt->count = 0;
 			}
+			else if (ctxt->padding > 0)
+				ctxt->padding--;
+			else
+				return -1;
 		}
+		else if (!b64whitespace(*s))
+			return -1;
+
+		s++;
+		ns--;
 	}
 
-	return rc;
+	*datalen = dst - (byte*) data;
+
+	return 0;
 }
 
-int b64encode_chars_per_line = B64ENCODE_CHARS_PER_LINE;
+int b64decodeFinal(b64decodeContext* ctxt, void* data, size_t* datalen)
+{
+	register byte* dst = (byte*) data;
+	size_t bytes;
 
-const char * b64encode_eolstr = B64ENCODE_EOLSTR;
+	if ((ctxt->count == 1) || (ctxt->padding > 0))
+		return -1;
 
-char* b64encode(const void* data, size_t ns)
+	bytes = ctxt->count ? ctxt->count - 1 : 0;
+
+	if (*datalen < bytes)
+		return -1;
+
+	switch (ctxt->count)
+	{
+	case 2:
+		dst[0] = (byte) (ctxt->bits >> 4);
+		break;
+	case 3:
+		dst[0] = (byte) (ctxt->bits >> 10);
+		dst[1] = (byte) (ctxt->bits >>  2);
+		break;
+	}
+
+	ctxt->bits = 0;
+	ctxt->count = 0;
+
+	*datalen = bytes;
+
+	return 0;
+}
+
+size_t b64decodesize(size_t ns)
 {
-	static char b64enc[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-	const char *e;
-	const unsigned char *s = data;
-	unsigned char *t, *te;
-	int nt;
-	int lc;
-	unsigned c;
+	return ((ns + 3) / 4) * 3;
+}
+
+int b64decodeto(const char* s, size_t ns, void* data, size_t* datalen)
+{
+	b64decodeContext ctxt;
+	size_t len = *datalen, rest;
+
+	if (b64decodeInit(&ctxt))
+		return -1;
+
+	if (b64decodeUpdate(&ctxt, s, ns, data, &len))
+		return -1;
 
-	if (s == NULL) return NULL;
+	rest = *datalen - len;
+
+	if (b64decodeFinal(&ctxt, (byte*) data + len, &rest))
+		return -1;
+
+	*datalen = len + rest;
+
+	return 0;
+}
 
-	if (ns == 0) ns = strlen((const char*) s);
-	nt = ((ns + 2) / 3) * 4;
+char* b64enc(const memchunk* chunk)
+{
+	size_t chars = b64encodesize(chunk->size, CHARS_PER_LINE, "\n");
+	char* string = (char*) malloc(chars + 1);
 
-	/* Add additional bytes necessary for eol string(s). */
-	if (b64encode_chars_per_line > 0 && b64encode_eolstr != NULL)
+	if (string)
 	{
-		lc = (nt + b64encode_chars_per_line - 1) / b64encode_chars_per_line;
-		if (((nt + b64encode_chars_per_line - 1) % b64encode_chars_per_line) != 0)
-			++lc;
-		nt += lc * strlen(b64encode_eolstr);
+		b64encodeto(chunk->data, chunk->size, string, &chars, CHARS_PER_LINE, "\n");
+		string[chars] = '\0';
 	}
 
-	t = te = malloc(nt + 1);
+	return string;
+}
+
+memchunk* b64dec(const char* string)
+{
+	/* return a decoded memchunk, or a null pointer in case of failure */
+
+	memchunk* rc = 0;
 
-	lc = 0;
-	if (te)
+	if (string)
 	{
-		while (ns > 0)
+		size_t length = strlen(string);
+
+		if (length > 0)
 		{
-			c = *s++;
-			*te++ = b64enc[ (c >> 2) ], lc++;
-			*te++ = b64enc[ ((c & 0x3) << 4) | (((ns-1) > 0 ? *s : 0) >> 4) ], lc++; 
-			if (--ns == 0)
-			{
-				*te++ = '=';
-				*te++ = '=';
-				continue;
-			}
-			c = *s++;
-			*te++ = b64enc[ ((c & 0xf) << 2) | (((ns-1) > 0 ? *s : 0) >> 6) ], lc++;
-			if (--ns == 0)
-			{
-				*te++ = '=';
-				continue;
-			}
-			*te++ = b64enc[ (int)(*s & 0x3f) ], lc++;
+			rc = memchunkAlloc(b64decodesize(length));
 
-			/* Append eol string if desired. */
-			if (b64encode_chars_per_line > 0 && b64encode_eolstr != NULL)
+			if (rc)
 			{
-				if (lc >= b64encode_chars_per_line)
+				b64decodeContext ctxt;
+				size_t size = rc->size;
+
+				/* like it always did, this drops an unpadded partial group
+				 * at the end, and accepts a single '=' after two characters,
+				 * so it doesn't finish the decoding
+				 */
+				b64decodeInit(&ctxt);
+
+				if (b64decodeUpdate(&ctxt, string, length, rc->data, &size))
 				{
-					for (e = b64encode_eolstr; *e != '\0'; e++)
-						*te++ = *e;
-					lc = 0;
+					memchunkFree(rc);
+					rc = 0;
 				}
+				else
+					rc->size = size;
 			}
-			s++;
-			--ns;
 		}
+	}
+
+	return rc;
+}
+
+char* b64encode(const void* data, size_t ns)
+{
+	b64encodeContext ctxt;
+	char* t;
+	size_t nt;
+
+	if (data == NULL) return NULL;
+
+	if (ns == 0) ns = strlen((const char*) data);
+
+	b64encodeInit(&ctxt, b64encode_chars_per_line, b64encode_eolstr);
+
+	/* unlike b64encodeto, this terminates the last line too */
+	nt = b64encodesize(ns, b64encode_chars_per_line, b64encode_eolstr) + ctxt.eollen;
+
+	t = (char*) malloc(nt + 1);
+
+	if (t)
+	{
+		size_t len = nt, rest;
 
-		/* Append eol string if desired. */
-		if (b64encode_chars_per_line > 0 && b64encode_eolstr != NULL)
+		b64encodeUpdate(&ctxt, data, ns, t, &len);
+		rest = nt - len;
+		b64encodeFinal(&ctxt, t + len, &rest);
+		len += rest;
+
+		if (ctxt.column)
 		{
-			if (lc != 0)
-			{
-				for (e = b64encode_eolstr; *e != '\0'; e++)
-					*te++ = *e;
-			}
+			memcpy(t + len, ctxt.eolstr, ctxt.eollen);
+			len += ctxt.eollen;
 		}
-		*te = '\0';
+		t[len] = '\0';
 	}
 
-	return (char*) t;
+	return t;
 }
 
 #define CRC24_INIT 0xb704ceL
@@ -350,15 +797,15 @@ char* b64crc (const unsigned char* data, size_t ns)
 	return b64encode(data, ns);
 }
 
-const char* b64decode_whitespace = B64DECODE_WHITESPACE;
-
 int b64decode(const char* s, void** datap, size_t* lenp)
 {
 	unsigned char b64dec[256];
 	const unsigned char *t;
+	b64decodeContext ctxt;
 	unsigned char *te;
-	int ns, nt;
-	unsigned a, b, c, d;
+	size_t len, rest;
+	int ns;
+	unsigned c;
 
 	if (s == NULL)	return 1;
 
@@ -403,41 +850,26 @@ int b64decode(const char* s, void** datap, size_t* lenp)
 	
 	if (((unsigned) ns) & 0x3)	return 2;
 
-	nt = (ns / 4) * 3;
-	t = te = malloc(nt + 1);
+	len = b64decodesize(t - (const unsigned char*) s);
+	te = malloc(len + 1);
 
-	while (ns > 0)
+	if (te == NULL)	return 1;
+
+	/* '=' can still be out of place */
+	b64decodeInit(&ctxt);
+	if (b64decodeUpdate(&ctxt, s, t - (const unsigned char*) s, te, &len) || (rest = 0, b64decodeFinal(&ctxt, te + len, &rest)))
 	{
-		/* Get next 4 characters, ignoring whitespace. */
-		while ((a = b64dec[ (unsigned)*s++ ]) == 0x81)
-			;
-		while ((b = b64dec[ (unsigned)*s++ ]) == 0x81)
-			;
-		while ((c = b64dec[ (unsigned)*s++ ]) == 0x81)
-			;
-		while ((d = b64dec[ (unsigned)*s++ ]) == 0x81)
-			;
-
-		ns -= 4;
-		*te++ = (a << 2) | (b >> 4);
-		if (s[-2] == '=') break;
-		*te++ = (b << 4) | (c >> 2);
-		if (s[-1] == '=') break;
-		*te++ = (c << 6) | d;
+		free(te);
+		return 3;
 	}
 
-	if (ns != 0)
-	{	/* XXX can't happen, just in case */
-		if (t) free((void *)t);
-		return 1;
-	}
 	if (lenp)
-		*lenp = (te - t);
+		*lenp = len;
 
 	if (datap)
-		*datap = (void *)t;
+		*datap = (void *)te;
 	else
-		if (t) free((void *)t);
+		free((void *)te);
 
 	return 0;
 }
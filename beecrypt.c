@@ -34,6 +34,8 @@
 
 #include "beecrypt/fips186.h"
 #include "beecrypt/mtprng.h"
+#include "beecrypt/ctrdrbg.h"
+#include "beecrypt/hmacdrbg.h"
 
 #include "beecrypt/md4.h"
 #include "beecrypt/md5.h"
@@ -65,6 +67,9 @@ static entropySource entropySourceList[] =
 	{ "console", entropy_console },
 	{ "wavein", entropy_wavein },
 #else
+# if HAVE_GETRANDOM
+	{ "getrandom", entropy_getrandom },
+# endif
 # if HAVE_DEV_URANDOM
 	{ "urandom", entropy_dev_urandom },
 # endif
@@ -152,7 +157,11 @@ int entropyGatherNext(byte* data, size_t size)
 static const randomGenerator* randomGeneratorList[] =
 {
 	&fips186prng,
-	&mtprng
+	&fips186ptprng,
+	&mtprng,
+	&mtprngpt,
+	&ctrdrbg,
+	&hmacdrbg
 };
 
 #define RANDOMGENERATORS	(sizeof(randomGeneratorList) / sizeof(randomGenerator*))
@@ -189,7 +198,7 @@ const randomGenerator* randomGeneratorDefault()
 	if (selection)
 		return randomGeneratorFind(selection);
 	else
-		return &fips186prng;
+		return &fips186ptprng;
 }
 
 int randomGeneratorContextInit(randomGeneratorContext* ctxt, const randomGenerator* rng)
@@ -249,6 +258,29 @@ int randomGeneratorContextSeed(randomGeneratorContext* ctxt, const byte* data, s
 	return ctxt->rng->seed(ctxt->param, data, size);
 }
 
+int randomGeneratorContextFork(randomGeneratorContext* child, randomGeneratorContext* parent)
+{
+	byte seed[CTRDRBG_SEED_SIZE];
+	int rc;
+
+	if (parent == (randomGeneratorContext*) 0)
+		return -1;
+
+	if (randomGeneratorContextInit(child, &ctrdrbg))
+		return -1;
+
+	rc = parent->rng->next(parent->param, seed, sizeof(seed));
+	if (rc == 0)
+		rc = ctrdrbgInstantiate((ctrdrbgParam*) child->param, seed, sizeof(seed), (const byte*) 0, 0, (const byte*) "fork", 4);
+
+	memset(seed, 0, sizeof(seed));
+
+	if (rc)
+		randomGeneratorContextFree(child);
+
+	return rc;
+}
+
 static const hashFunction* hashFunctionList[] =
 {
 	&md4,
@@ -489,6 +521,175 @@ int hashFunctionContextDigestMatch(hashFunctionContext* ctxt, const mpnumber* d)
 	return rc;
 }
 
+int hashFunctionContextClone(hashFunctionContext* dst, const hashFunctionContext* src)
+{
+	if (dst == (hashFunctionContext*) 0)
+		return -1;
+
+	if (src == (hashFunctionContext*) 0)
+		return -1;
+
+	if (src->algo == (hashFunction*) 0)
+		return -1;
+
+	if (src->param == (hashFunctionParam*) 0)
+		return -1;
+
+	if (hashFunctionContextInit(dst, src->algo))
+		return -1;
+
+	if (src->algo->copy)
+	{
+		if (src->algo->copy(dst->param, src->param))
+		{
+			hashFunctionContextFree(dst);
+			return -1;
+		}
+	}
+	else
+		memcpy(dst->param, src->param, src->algo->paramsize);
+
+	return 0;
+}
+
+/* the serialized state: the hash function's name including its terminating
+ * zero, a byte order mark, the parameter block's size in big-endian order,
+ * then the parameter block itself
+ */
+#define HASHSTATE_MARK	0x01020304U
+
+size_t hashFunctionContextStateSize(const hashFunctionContext* ctxt)
+{
+	if (ctxt == (hashFunctionContext*) 0)
+		return 0;
+
+	if (ctxt->algo == (hashFunction*) 0)
+		return 0;
+
+	return strlen(ctxt->algo->name) + 1 + 8 + ctxt->algo->paramsize;
+}
+
+int hashFunctionContextSerialize(const hashFunctionContext* ctxt, byte* data, size_t size)
+{
+	uint32_t mark = HASHSTATE_MARK;
+	size_t namelen, paramsize;
+
+	if (ctxt == (hashFunctionContext*) 0)
+		return -1;
+
+	if (ctxt->algo == (hashFunction*) 0)
+		return -1;
+
+	if (ctxt->param == (hashFunctionParam*) 0)
+		return -1;
+
+	if (data == (byte*) 0 || size < hashFunctionContextStateSize(ctxt))
+		return -1;
+
+	namelen = strlen(ctxt->algo->name) + 1;
+	paramsize = ctxt->algo->paramsize;
+
+	memcpy(data, ctxt->algo->name, namelen);
+	data += namelen;
+	memcpy(data, &mark, 4);
+	data += 4;
+	data[0] = (byte)(paramsize >> 24);
+	data[1] = (byte)(paramsize >> 16);
+	data[2] = (byte)(paramsize >>  8);
+	data[3] = (byte)(paramsize      );
+	data += 4;
+	memcpy(data, ctxt->param, paramsize);
+
+	return 0;
+}
+
+int hashFunctionContextDeserialize(hashFunctionContext* ctxt, const byte* data, size_t size)
+{
+	hashFunctionParam* param;
+	uint32_t mark;
+	size_t namelen, paramsize;
+	int rc = -1;
+
+	if (ctxt == (hashFunctionContext*) 0)
+		return -1;
+
+	if (ctxt->algo == (hashFunction*) 0)
+		return -1;
+
+	if (ctxt->param == (hashFunctionParam*) 0)
+		return -1;
+
+	if (data == (const byte*) 0 || size != hashFunctionContextStateSize(ctxt))
+		return -1;
+
+	namelen = strlen(ctxt->algo->name) + 1;
+	paramsize = ctxt->algo->paramsize;
+
+	/* it has to come from the same hash function, on the same kind of machine */
+	if (memcmp(data, ctxt->algo->name, namelen))
+		return -1;
+	data += namelen;
+	memcpy(&mark, data, 4);
+	if (mark != HASHSTATE_MARK)
+		return -1;
+	data += 4;
+	if ((((size_t) data[0] << 24) | ((size_t) data[1] << 16) | ((size_t) data[2] << 8) | (size_t) data[3]) != paramsize)
+		return -1;
+	data += 4;
+
+	/* the contents have to make sense before the context takes them over */
+	if (ctxt->algo->check == (hashFunctionCheck) 0)
+		return -1;
+
+	if ((param = (hashFunctionParam*) malloc(paramsize)) == (hashFunctionParam*) 0)
+		return -1;
+
+	memcpy(param, data, paramsize);
+
+	if (ctxt->algo->check(param) == 0)
+	{
+		memcpy(ctxt->param, param, paramsize);
+		rc = 0;
+	}
+
+	memset(param, 0, paramsize);
+	free(param);
+
+	return rc;
+}
+
+int hashFunctionMultiDigest(const hashFunction* hf, size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+{
+	hashFunctionContext ctxt;
+	size_t i;
+	int rc = 0;
+
+	if (hf == (hashFunction*) 0)
+		return -1;
+
+	if (hf->batch)
+		return hf->batch(count, msgs, lens, digests);
+
+	if (count == 0)
+		return 0;
+
+	if (msgs == (const byte* const*) 0 || lens == (const size_t*) 0 || digests == (byte* const*) 0)
+		return -1;
+
+	if (hashFunctionContextInit(&ctxt, hf))
+		return -1;
+
+	for (i = 0; i < count && rc == 0; i++)
+	{
+		if (hashFunctionContextUpdate(&ctxt, msgs[i], lens[i]) || hashFunctionContextDigest(&ctxt, digests[i]))
+			rc = -1;
+	}
+
+	hashFunctionContextFree(&ctxt);
+
+	return rc;
+}
+
 static const keyedHashFunction* keyedHashFunctionList[] =
 {
 	&hmacmd5,
@@ -938,6 +1139,20 @@ int blockCipherContextCTR(blockCipherContext* ctxt, uint32_t* dst, const uint32_
 	return -1;
 }
 
+int blockCipherContextCTRParallel(blockCipherContext* ctxt, uint32_t* dst, const uint32_t* src, int nblocks)
+{
+	switch (ctxt->op)
+	{
+	case NOCRYPT:
+		memcpy(dst, src, nblocks * ctxt->algo->blocksize);
+		return 0;
+	case ENCRYPT:
+	case DECRYPT: /* encrypt and decrypt are the same operation in ctr mode */
+		return blockEncryptCTRParallel(ctxt->algo, ctxt->param, dst, src, nblocks);
+	}
+	return -1;
+}
+
 #if WIN32
 __declspec(dllexport)
 BOOL WINAPI DllMain(HINSTANCE hInst, DWORD fdwReason, LPVOID lpReserved)
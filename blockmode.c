@@ -30,16 +30,92 @@
 #endif
 
 #include "beecrypt/blockmode.h"
+#include "beecrypt/endianness.h"
+#include "beecrypt/mp.h"
+
+#if HAVE_STDLIB_H
+# include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+# include <string.h>
+#endif
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+/* Number of blocks handed to a cipher's multi-block raw function at once;
+ * also the granularity at which ECB work is divided among threads.
+ */
+#define BLOCKMODE_BATCH	64
+
+/* Size in words of the on-stack buffer used by CBC decryption and CTR mode;
+ * holds BLOCKMODE_BATCH blocks of a 128-bit cipher.
+ */
+#define BLOCKMODE_BUFWORDS	256
+
+/* Default minimum number of bytes per thread in the parallel functions;
+ * below this the cost of starting threads outweighs the gain.
+ */
+#define BLOCKMODE_MINCHUNK	65536
+
+static unsigned int _bm_threads = 0;
+static size_t _bm_minchunk = BLOCKMODE_MINCHUNK;
+
+int blockModeParallelSetup(unsigned int threads, size_t minchunk)
+{
+	_bm_threads = threads;
+	_bm_minchunk = minchunk ? minchunk : BLOCKMODE_MINCHUNK;
+
+	return 0;
+}
+
+/* returns the number of threads to use for nblocks, and the number of
+ * blocks each of them should handle
+ */
+static unsigned int blockModeChunks(const blockCipher* bc, unsigned int nblocks, unsigned int* chunkblocks)
+{
+	unsigned int threads = 1, minblocks = (unsigned int) (_bm_minchunk / bc->blocksize);
+
+	#ifdef _OPENMP
+	threads = _bm_threads ? _bm_threads : (unsigned int) omp_get_max_threads();
+	#endif
+
+	if (minblocks == 0)
+		minblocks = 1;
+
+	if (threads > nblocks / minblocks)
+		threads = nblocks / minblocks;
+	if (threads == 0)
+		threads = 1;
+
+	*chunkblocks = (nblocks + threads - 1) / threads;
+
+	return threads;
+}
 
 int blockEncryptECB(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
+	/* the raw functions don't modify the cipher's parameters, so threads
+	 * can share them
+	 */
 	const unsigned int blockwords = bc->blocksize >> 2;
-	unsigned int i;
+	unsigned int i, chunkblocks, threads = blockModeChunks(bc, nblocks, &chunkblocks);
 
-	#pragma omp parallel for
-	for (i = 0; i < nblocks; i++)
+	if (bc->raw.encryptN)
 	{
-		bc->raw.encrypt(bp, dst + i * blockwords, src + i * blockwords);
+		#pragma omp parallel for num_threads(threads) if (threads > 1)
+		for (i = 0; i < nblocks; i += BLOCKMODE_BATCH)
+		{
+			bc->raw.encryptN(bp, dst + i * blockwords, src + i * blockwords, ((nblocks - i) < BLOCKMODE_BATCH) ? (nblocks - i) : BLOCKMODE_BATCH);
+		}
+	}
+	else
+	{
+		#pragma omp parallel for num_threads(threads) if (threads > 1)
+		for (i = 0; i < nblocks; i++)
+		{
+			bc->raw.encrypt(bp, dst + i * blockwords, src + i * blockwords);
+		}
 	}
 
 	return 0;
@@ -47,13 +123,27 @@ int blockEncryptECB(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst,
 
 int blockDecryptECB(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
+	/* the raw functions don't modify the cipher's parameters, so threads
+	 * can share them
+	 */
 	const unsigned int blockwords = bc->blocksize >> 2;
-	unsigned int i;
+	unsigned int i, chunkblocks, threads = blockModeChunks(bc, nblocks, &chunkblocks);
 
-	#pragma omp parallel for
-	for (i = 0; i < nblocks; i++)
+	if (bc->raw.decryptN)
 	{
-		bc->raw.decrypt(bp, dst + i * blockwords, src + i * blockwords);
+		#pragma omp parallel for num_threads(threads) if (threads > 1)
+		for (i = 0; i < nblocks; i += BLOCKMODE_BATCH)
+		{
+			bc->raw.decryptN(bp, dst + i * blockwords, src + i * blockwords, ((nblocks - i) < BLOCKMODE_BATCH) ? (nblocks - i) : BLOCKMODE_BATCH);
+		}
+	}
+	else
+	{
+		#pragma omp parallel for num_threads(threads) if (threads > 1)
+		for (i = 0; i < nblocks; i++)
+		{
+			bc->raw.decrypt(bp, dst + i * blockwords, src + i * blockwords);
+		}
 	}
 
 	return 0;
@@ -98,79 +188,168 @@ int blockEncryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst,
 
 int blockDecryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
 {
+	/* decrypt a batch of ciphertext blocks into buf, then undo the
+	 * chaining from the last block to the first; this order allows
+	 * dst and src to be the same buffer.
+	 */
+
 	register const unsigned int blockwords = bc->blocksize >> 2;
+	register const unsigned int batch = BLOCKMODE_BUFWORDS / blockwords;
 	register uint32_t* fdback = bc->getfb(bp);
-	register uint32_t* buf = (uint32_t*) malloc(blockwords * sizeof(uint32_t));
+	uint32_t buf[BLOCKMODE_BUFWORDS];
 
-	if (buf)
+	if (batch == 0)
+		return -1;
+
+	while (nblocks > 0)
 	{
-		while (nblocks > 0)
-		{
-			register uint32_t tmp;
-			register unsigned int i;
+		register unsigned int i, k, n = (nblocks < batch) ? nblocks : batch;
 
-			bc->raw.decrypt(bp, buf, src);
+		if (bc->raw.decryptN)
+			bc->raw.decryptN(bp, buf, src, n);
+		else
+			for (k = 0; k < n; k++)
+				bc->raw.decrypt(bp, buf + k * blockwords, src + k * blockwords);
 
+		for (i = 0; i < blockwords; i++)
+			buf[i] ^= fdback[i];
+
+		for (i = 0; i < blockwords; i++)
+			fdback[i] = src[(n-1) * blockwords + i];
+
+		for (k = n-1; k > 0; k--)
 			for (i = 0; i < blockwords; i++)
-			{
-				tmp = src[i];
-				dst[i] = buf[i] ^ fdback[i];
-				fdback[i] = tmp;
-			}
+				dst[k * blockwords + i] = buf[k * blockwords + i] ^ src[(k-1) * blockwords + i];
 
-			dst += blockwords;
-			src += blockwords;
+		for (i = 0; i < blockwords; i++)
+			dst[i] = buf[i];
 
-			nblocks--;
-		}
-		free(buf);
-		return 0;
+		dst += n * blockwords;
+		src += n * blockwords;
+
+		nblocks -= n;
 	}
 
-	return -1;
+	return 0;
 }
 
-int blockEncryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+int blockKeystreamCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, unsigned int nblocks)
 {
 	/* host-endian counter is kept in fdback;
-	 * swap to big-endian buffer;
-	 * encrypt buffer;
-	 * src ^ ciphertext -> dst
-	 * increment fdback (as mpi) by one inlined;
+	 * swap successive counter values to big-endian blocks in dst;
+	 * increment fdback (as mpi) by one after each;
+	 * encrypt all blocks at once if the cipher supports it
 	 */
 
 	register const unsigned int blockwords = bc->blocksize >> 2;
 	register uint32_t* fdback = bc->getfb(bp);
-	register uint32_t* buf = (uint32_t*) malloc(blockwords * sizeof(uint32_t));
+	register unsigned int i, k;
 
-	if (buf)
+	for (k = 0; k < nblocks; k++)
 	{
-		while (nblocks > 0)
+		#if WORDS_BIGENDIAN
+		for (i = 0; i < blockwords; i++)
+			dst[k * blockwords + i] = fdback[i];
+		#else
+		register unsigned int j;
+
+		for (i = 0, j = blockwords-1; i < blockwords; i++, j--)
+			dst[k * blockwords + i] = swapu32(fdback[j]);
+		#endif
+
+		/* increment counter */
+		mpaddw((blockwords >> 1), (mpw*) fdback, 1);
+	}
+
+	if (bc->raw.encryptN)
+		return bc->raw.encryptN(bp, dst, dst, nblocks);
+
+	for (k = 0; k < nblocks; k++)
+		bc->raw.encrypt(bp, dst + k * blockwords, dst + k * blockwords);
+
+	return 0;
+}
+
+int blockEncryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	/* generate the keystream a batch at a time in buf;
+	 * src ^ keystream -> dst
+	 */
+
+	register const unsigned int blockwords = bc->blocksize >> 2;
+	register const unsigned int batch = BLOCKMODE_BUFWORDS / blockwords;
+	uint32_t buf[BLOCKMODE_BUFWORDS];
+
+	if (batch == 0)
+		return -1;
+
+	while (nblocks > 0)
+	{
+		register unsigned int i, n = (nblocks < batch) ? nblocks : batch;
+
+		if (blockKeystreamCTR(bc, bp, buf, n))
+			return -1;
+
+		for (i = 0; i < n * blockwords; i++)
+			dst[i] = src[i] ^ buf[i];
+
+		dst += n * blockwords;
+		src += n * blockwords;
+
+		nblocks -= n;
+	}
+
+	return 0;
+}
+
+int blockEncryptCTRParallel(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+{
+	/* split the data in chunks, one per thread; each thread works on its
+	 * own copy of the parameters, with the counter advanced to the chunk's
+	 * offset; afterwards the counter is advanced past all blocks.
+	 */
+
+	register const unsigned int blockwords = bc->blocksize >> 2;
+	unsigned int i, chunkblocks, threads = blockModeChunks(bc, nblocks, &chunkblocks);
+	int rc = 0;
+
+	if (threads > 1)
+	{
+		#pragma omp parallel for num_threads(threads) schedule(static, 1) reduction(|:rc)
+		for (i = 0; i < threads; i++)
 		{
-			unsigned int i, j;
+			unsigned int offset = i * chunkblocks;
+			unsigned int n = (nblocks - offset < chunkblocks) ? nblocks - offset : chunkblocks;
+			blockCipherParam* tp;
 
-			#if WORDS_BIGENDIAN
-			bc->raw.encrypt(bp, buf, fdback);
-			#else
-			for (i = 0, j = blockwords-1; i < blockwords; i++, j--)
-				buf[i] = swapu32(fdback[j]);
-			bc->raw.encrypt(bp, buf, buf);
-			#endif
+			if (offset >= nblocks)
+				continue;
 
-			for (i = 0; i < blockwords; i++)
-				dst[i] = src[i] ^ buf[i];
+			tp = (blockCipherParam*) malloc(bc->paramsize);
 
-			dst += blockwords;
-			src += blockwords;
+			if (tp)
+			{
+				memcpy(tp, bp, bc->paramsize);
+				mpaddw((blockwords >> 1), (mpw*) bc->getfb(tp), offset);
 
-			nblocks--;
+				rc |= (bc->ctr.encrypt) ?
+					bc->ctr.encrypt(tp, dst + offset * blockwords, src + offset * blockwords, n) :
+					blockEncryptCTR(bc, tp, dst + offset * blockwords, src + offset * blockwords, n);
 
-			/* increment counter */
-			mpaddw((blockwords >> 1), (mpw*) fdback, 1);
+				memset(tp, 0, bc->paramsize);
+				free(tp);
+			}
+			else
+				rc = -1;
 		}
-		free(buf);
-		return 0;
+
+		if (rc == 0)
+			mpaddw((blockwords >> 1), (mpw*) bc->getfb(bp), nblocks);
+
+		return rc;
 	}
 
-	return -1;
+	return (bc->ctr.encrypt) ?
+		bc->ctr.encrypt(bp, dst, src, nblocks) :
+		blockEncryptCTR(bc, bp, dst, src, nblocks);
 }
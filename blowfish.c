@@ -339,7 +339,9 @@ const blockCipher blowfish = {
 	(blockCipherFeedback) blowfishFeedback,
 	{
 		(blockCipherRawcrypt) blowfishEncrypt,
-		(blockCipherRawcrypt) blowfishDecrypt
+		(blockCipherRawcrypt) blowfishDecrypt,
+		(blockCipherRawcryptN) 0,
+		(blockCipherRawcryptN) 0
 	},
 	{
 		#ifdef AES_BLOWFISHENCRYPTECB
@@ -46,6 +46,11 @@ FileInputStream::~FileInputStream()
 {
 }
 
+FILE* FileInputStream::getFile() const throw ()
+{
+	return _f;
+}
+
 int FileInputStream::available() throw (IOException)
 {
 	if (!_f)
@@ -32,16 +32,24 @@ using beecrypt::crypto::MacInputStream;
 using beecrypt::crypto::MacOutputStream;
 #include "beecrypt/c++/io/ByteArrayInputStream.h"
 using beecrypt::io::ByteArrayInputStream;
+#include "beecrypt/c++/io/ByteArrayOutputStream.h"
+using beecrypt::io::ByteArrayOutputStream;
 #include "beecrypt/c++/io/DataInputStream.h"
 using beecrypt::io::DataInputStream;
 #include "beecrypt/c++/io/DataOutputStream.h"
 using beecrypt::io::DataOutputStream;
+#include "beecrypt/c++/io/FileInputStream.h"
+using beecrypt::io::FileInputStream;
 #include "beecrypt/c++/lang/Cloneable.h"
 using beecrypt::lang::Cloneable;
+#include "beecrypt/c++/lang/Integer.h"
+using beecrypt::lang::Integer;
 #include "beecrypt/c++/security/SecureRandom.h"
 using beecrypt::security::SecureRandom;
 #include "beecrypt/c++/security/ProviderException.h"
 using beecrypt::security::ProviderException;
+#include "beecrypt/c++/security/Security.h"
+using beecrypt::security::Security;
 #include "beecrypt/c++/beeyond/BeeCertificate.h"
 using beecrypt::beeyond::BeeCertificate;
 #include "beecrypt/c++/beeyond/PKCS12PBEKey.h"
@@ -53,17 +61,83 @@ using beecrypt::provider::KeyProtector;
 #include <memory>
 using std::auto_ptr;
 
+#if HAVE_SYS_STAT_H
+# include <sys/stat.h>
+#endif
+
 using namespace beecrypt::provider;
 
 namespace {
 	const array<jchar> EMPTY_PASSWORD;
+
+	/* holds a lock until the end of the enclosing scope */
+	class Locker
+	{
+	private:
+		Lock& _lock;
+
+	public:
+		Locker(Lock& lock) : _lock(lock)
+		{
+			_lock.lock();
+		}
+
+		~Locker()
+		{
+			_lock.unlock();
+		}
+	};
+
+	jint decodeInt(const byte* data)
+	{
+		return (jint) (((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | ((uint32_t) data[3]));
+	}
+
+	jlong decodeLong(const byte* data)
+	{
+		return (jlong) (((uint64_t) (uint32_t) decodeInt(data) << 32) | (uint64_t) (uint32_t) decodeInt(data + 4));
+	}
+
+	void encodeInt(byte* data, jint value)
+	{
+		data[0] = (byte) (value >> 24);
+		data[1] = (byte) (value >> 16);
+		data[2] = (byte) (value >>  8);
+		data[3] = (byte) (value      );
+	}
+
+	void encodeLong(byte* data, jlong value)
+	{
+		encodeInt(data, (jint) (value >> 32));
+		encodeInt(data + 4, (jint) value);
+	}
+
+	PrivateKey* cloneKey(const PrivateKey& key)
+	{
+		const Cloneable* c = dynamic_cast<const Cloneable*>(&key);
+		if (c)
+		{
+			try
+			{
+				return dynamic_cast<PrivateKey*>(c->clone());
+			}
+			catch (CloneNotSupportedException&)
+			{
+			}
+		}
+		return 0;
+	}
 }
 
 #define BKS_MAGIC				((jint) 0xbeecceec)
 #define BKS_VERSION_1			((jint) 0x1)
+#define BKS_VERSION_2			((jint) 0x2)
 #define BKS_PRIVATEKEY_ENTRY	((jint) 0x1)
 #define BKS_CERTIFICATE_ENTRY	((jint) 0x2)
 
+/* hash of the alias, offset and length of the entry, and its SHA-256 digest */
+#define BKS_INDEX_ENTRY_SIZE	48
+
 BeeKeyStore::Names::Names(Hashtable<String,Entry>& h) : _list(h.size())
 {
 	Iterator<class Map<String,Entry>::Entry>* it = h.entrySet().iterator();
@@ -126,419 +200,1237 @@ BeeKeyStore::CertEntry::~CertEntry()
 	delete cert;
 }
 
-BeeKeyStore::BeeKeyStore()
+BeeKeyStore::Cache::Cache()
 {
+	_capacity = 0;
+
+	try
+	{
+		// check value of property beekeystore.cache.size in beecrypt.conf
+		const String* tmp = Security::getProperty("beekeystore.cache.size");
+		if (tmp)
+		{
+			_capacity = Integer::parseInteger(*tmp);
+
+			if (_capacity < 0)
+				throw ProviderException("beekeystore.cache.size must not be negative");
+		}
+	}
+	catch (NumberFormatException&)
+	{
+		throw ProviderException("beekeystore.cache.size not set to a numeric value");
+	}
 }
 
-Enumeration<const String>* BeeKeyStore::engineAliases()
+BeeKeyStore::Cache::~Cache()
 {
-	return new Names(_entries);
+	clear();
 }
 
-bool BeeKeyStore::engineContainsAlias(const String& alias)
+bool BeeKeyStore::Cache::enabled() const throw ()
 {
-	return _entries.containsKey(&alias);
+	return _capacity > 0;
 }
 
-void BeeKeyStore::engineDeleteEntry(const String& alias) throw (KeyStoreException)
+void BeeKeyStore::Cache::evictKey()
 {
-	delete _entries.remove(&alias);
+	if (_keyorder.empty())
+		return;
+
+	key_map::iterator lru = _keys.find(_keyorder.front());
+
+	delete lru->second.key;
+	_keys.erase(lru);
+	_keyorder.pop_front();
 }
 
-const Date* BeeKeyStore::engineGetCreationDate(const String& alias)
+void BeeKeyStore::Cache::evictProtector()
 {
-	const Date* result = 0;
+	if (_protectororder.empty())
+		return;
 
-	synchronized (this)
-	{
-		Entry* e = _entries.get(&alias);
-		if (e)
-			result = &e->date;
-	}
+	protector_map::iterator lru = _protectors.find(_protectororder.front());
 
-	return result;
+	delete lru->second.protector;
+	_protectors.erase(lru);
+	_protectororder.pop_front();
 }
 
-const Certificate* BeeKeyStore::engineGetCertificate(const String& alias)
+PrivateKey* BeeKeyStore::Cache::getKey(const String& alias, const std::string& digest)
 {
-	const Certificate* result = 0;
+	PrivateKey* result = 0;
 
 	synchronized (this)
 	{
-		Entry* e = _entries.get(&alias);
-		if (e)
+		key_map::iterator it = _keys.find(alias);
+		if (it != _keys.end() && it->second.digest == digest)
 		{
-			CertEntry* ce = dynamic_cast<CertEntry*>(e);
-			if (ce)
-			{
-				result = ce->cert;
-			}
-			else
-			{
-				KeyEntry* ke = dynamic_cast<KeyEntry*>(e);
-				if (ke)
-					result = ke->chain[0];
-			}
+			_keyorder.splice(_keyorder.end(), _keyorder, it->second.used);
+			result = cloneKey(*it->second.key);
 		}
 	}
 
 	return result;
 }
 
-const String* BeeKeyStore::engineGetCertificateAlias(const Certificate& cert)
+void BeeKeyStore::Cache::putKey(const String& alias, const std::string& digest, const PrivateKey& key)
 {
-	const String* result = 0;
+	if (!enabled())
+		return;
+
+	// keys which can't be copied aren't cached
+	PrivateKey* copy = cloneKey(key);
+	if (!copy)
+		return;
 
 	synchronized (this)
 	{
-		Iterator<class Map<String,Entry>::Entry>* it = _entries.entrySet().iterator();
-		assert(it != 0);
-		while (it->hasNext())
+		key_map::iterator it = _keys.find(alias);
+		if (it != _keys.end())
 		{
-			class Map<String,Entry>::Entry* e = it->next();
+			delete it->second.key;
+			_keyorder.splice(_keyorder.end(), _keyorder, it->second.used);
+		}
+		else
+		{
+			if ((jint) _keys.size() >= _capacity)
+				evictKey();
 
-			const CertEntry* ce = dynamic_cast<const CertEntry*>(e->getValue());
-			if (ce)
-			{
-				if (cert.equals(ce->cert))
-				{
-					result = e->getKey();
-					break;
-				}
-			}
+			it = _keys.insert(key_map::value_type(alias, KeyItem())).first;
+			it->second.used = _keyorder.insert(_keyorder.end(), alias);
 		}
-		delete it;
-	}
 
-	return result;
+		it->second.digest = digest;
+		it->second.key = copy;
+	}
 }
 
-const array<Certificate*>* BeeKeyStore::engineGetCertificateChain(const String& alias)
+KeyProtector* BeeKeyStore::Cache::getProtector(const std::string& digest)
 {
-	const array<Certificate*>* result = 0;
+	KeyProtector* result = 0;
 
 	synchronized (this)
 	{
-		KeyEntry* ke = dynamic_cast<KeyEntry*>(_entries.get(&alias));
-		if (ke)
-			result = &ke->chain;
+		protector_map::iterator it = _protectors.find(digest);
+		if (it != _protectors.end())
+		{
+			_protectororder.splice(_protectororder.end(), _protectororder, it->second.used);
+			result = new KeyProtector(*it->second.protector);
+		}
 	}
 
 	return result;
 }
 
-bool BeeKeyStore::engineIsCertificateEntry(const String& alias)
+void BeeKeyStore::Cache::putProtector(const std::string& digest, const KeyProtector& protector)
 {
-	return dynamic_cast<CertEntry*>(_entries.get(&alias)) != 0;
-}
+	if (!enabled())
+		return;
 
-void BeeKeyStore::engineSetCertificateEntry(const String& alias, const Certificate& cert) throw (KeyStoreException)
-{
-	delete _entries.put(new String(alias), new CertEntry(cert));
+	synchronized (this)
+	{
+		protector_map::iterator it = _protectors.find(digest);
+		if (it != _protectors.end())
+		{
+			// the same digest always gives the same protector
+			_protectororder.splice(_protectororder.end(), _protectororder, it->second.used);
+		}
+		else
+		{
+			if ((jint) _protectors.size() >= _capacity)
+				evictProtector();
+
+			it = _protectors.insert(protector_map::value_type(digest, ProtectorItem())).first;
+			it->second.protector = new KeyProtector(protector);
+			it->second.used = _protectororder.insert(_protectororder.end(), digest);
+		}
+	}
 }
 
-Key* BeeKeyStore::engineGetKey(const String& alias, const array<jchar>& password) throw (NoSuchAlgorithmException, UnrecoverableKeyException)
+void BeeKeyStore::Cache::invalidate(const String& alias)
 {
-	Key* result = 0;
-
 	synchronized (this)
 	{
-		Entry* e = _entries.get(&alias);
-		if (e)
+		key_map::iterator it = _keys.find(alias);
+		if (it != _keys.end())
 		{
-			KeyEntry* ke = dynamic_cast<KeyEntry*>(e);
-			if (ke)
-			{
-				PKCS12PBEKey pbekey(password, &_salt, _iter);
-
-				try
-				{
-					KeyProtector p(pbekey);
-
-					result = p.recover(ke->encryptedkey);
-				}
-				catch (InvalidKeyException& e)
-				{
-					throw UnrecoverableKeyException().initCause(e);
-				}
-			}
+			delete it->second.key;
+			_keyorder.erase(it->second.used);
+			_keys.erase(it);
 		}
 	}
-
-	return result;
 }
 
-bool BeeKeyStore::engineIsKeyEntry(const String& alias)
+void BeeKeyStore::Cache::clear()
 {
-	return dynamic_cast<KeyEntry*>(_entries.get(&alias)) != 0;
+	synchronized (this)
+	{
+		for (key_map::iterator it = _keys.begin(); it != _keys.end(); ++it)
+			delete it->second.key;
+		_keys.clear();
+		_keyorder.clear();
+
+		for (protector_map::iterator it = _protectors.begin(); it != _protectors.end(); ++it)
+			delete it->second.protector;
+		_protectors.clear();
+		_protectororder.clear();
+	}
 }
 
-void BeeKeyStore::engineSetKeyEntry(const String& alias, const bytearray& key, const array<Certificate*>& chain) throw (KeyStoreException)
+BeeKeyStore::Index::Index(InputStream& in) throw (IOException)
 {
-	delete _entries.put(new String(alias), new KeyEntry(key, chain));
+	ByteArrayOutputStream bos;
+	bytearray chunk(65536);
+	jint rc;
+
+	while ((rc = in.read(chunk.data(), 0, chunk.size())) > 0)
+		bos.write(chunk.data(), 0, rc);
+
+	bos.toByteArray(_buf);
+
+	_data = _buf.data();
+	_size = _buf.size();
+	_count = _slots = 0;
 }
 
-void BeeKeyStore::engineSetKeyEntry(const String& alias, const Key& key, const array<jchar>& password, const array<Certificate*>& chain) throw (KeyStoreException)
+BeeKeyStore::Index::Index(size_t size) : _buf(size)
 {
-	const PrivateKey* pri = dynamic_cast<const PrivateKey*>(&key);
-	if (pri)
-	{
-		PKCS12PBEKey pbekey(password, &_salt, _iter);
-		KeyProtector p(pbekey);
-
-		bytearray* tmp = p.protect(*pri);
-		if (tmp)
-		{
-			engineSetKeyEntry(alias, *tmp, chain);
-			delete tmp;
-		}
-		else
-			throw KeyStoreException("BeeKeyStore failed to protect key");
-	}
-	else
-			throw KeyStoreException("BeeKeyStore only supports storing of PrivateKey objects");
+	_data = _buf.data();
+	_size = _buf.size();
+	_count = _slots = 0;
 }
 
-int BeeKeyStore::engineSize() const
+BeeKeyStore::Index::~Index()
 {
-	return _entries.size();
 }
 
-void BeeKeyStore::engineLoad(InputStream* in, const array<jchar>* password) throw (IOException, CertificateException, NoSuchAlgorithmException)
+BeeKeyStore::Index* BeeKeyStore::Index::read(InputStream* in) throw (IOException)
 {
-	synchronized (this)
+	#if HAVE_SYS_STAT_H
+	FileInputStream* fis = dynamic_cast<FileInputStream*>(in);
+	if (fis && fis->getFile())
 	{
-		if (!in)
+		FILE* f = fis->getFile();
+		struct stat st;
+		long pos = ftell(f);
+		byte header[8];
+
+		if (pos < 0 || fstat(fileno(f), &st) || !S_ISREG(st.st_mode) || st.st_size < pos + 8)
+			return 0;
+
+		if (fread(header, 1, 8, f) == 8 && decodeInt(header) == BKS_MAGIC && decodeInt(header + 4) == BKS_VERSION_2)
 		{
-			randomGeneratorContext rngc;
+			/* the file's size is known, so read the rest in one go; the
+			 * caller may overwrite the file later, so nothing refers to it
+			 */
+			size_t size = st.st_size - pos - 8;
 
-			/* salt size default is 64 bytes */
-			_salt.resize(64);
-			/* generate a new salt */
-			randomGeneratorContextNext(&rngc, _salt.data(), _salt.size());
-			/* set default iteration count */
-			_iter = 1024;
+			auto_ptr<Index> result(new Index(size));
 
-			return;
+			if (fread(result->_buf.data(), 1, size, f) != size)
+				throw IOException("unable to read BeeKeyStore");
+
+			return result.release();
 		}
 
-		auto_ptr<Mac> m(Mac::getInstance("HMAC-SHA-256"));
+		fseek(f, pos, SEEK_SET);
+	}
+	#endif
 
-		MacInputStream mis(*in, *m.get());
-		DataInputStream dis(mis);
+	return 0;
+}
 
-		mis.on(false);
+void BeeKeyStore::Index::open(const array<jchar>* password, bytearray& salt, jint& iter) throw (IOException, NoSuchAlgorithmException)
+{
+	const byte* p = _data;
+	size_t avail = _size;
 
-		jint magic = dis.readInt();
-		jint version = dis.readInt();
+	if (avail < 4)
+		throw IOException("invalid BeeKeyStore salt size");
 
-		if (magic != BKS_MAGIC || version != BKS_VERSION_1)
-			throw IOException("invalid BeeKeyStore format");
+	jint saltsize = decodeInt(p);
+	if (saltsize <= 0 || avail - 4 < (size_t) saltsize + 4)
+		throw IOException("invalid BeeKeyStore salt size");
 
-		_entries.clear();
+	salt = bytearray(p + 4, saltsize);
 
-		jint saltsize = dis.readInt();
-		if (saltsize <= 0)
-			throw IOException("invalid BeeKeyStore salt size");
+	iter = decodeInt(p + 4 + saltsize);
+	if (iter <= 0)
+		throw IOException("invalid BeeKeyStore iteration count");
 
-		_salt.resize(saltsize);
-		dis.readFully(_salt);
+	p += 8 + saltsize;
+	avail -= 8 + saltsize;
 
-		_iter = dis.readInt();
-		if (_iter <= 0)
-			throw IOException("invalid BeeKeyStore iteration count");
+	auto_ptr<Mac> m(Mac::getInstance("HMAC-SHA-256"));
 
-		PKCS12PBEKey pbekey(password ? *password : EMPTY_PASSWORD, &_salt, _iter);
+	PKCS12PBEKey pbekey(password ? *password : EMPTY_PASSWORD, &salt, iter);
 
-		m->init(pbekey);
+	m->init(pbekey);
 
-		mis.on(true);
+	/* the MAC is at the end of the keystore */
+	size_t macsize = m->getMacLength();
+	if (avail < 8 + macsize)
+		throw IOException("invalid BeeKeyStore MAC size");
 
-		jint entrycount = dis.readInt();
+	avail -= macsize;
 
-		if (entrycount <= 0)
-			throw IOException("invalid BeeKeyStore entry count");
+	_count = decodeInt(p);
+	if (_count < 0)
+		throw IOException("invalid BeeKeyStore entry count");
 
-		for (jint i = 0; i < entrycount; i++)
-		{
-			String alias;
+	_slots = decodeInt(p + 4);
+	if (_slots <= _count || (_slots & (_slots - 1)))
+		throw IOException("invalid BeeKeyStore index size");
 
-			switch (dis.readInt())
-			{
-			case BKS_PRIVATEKEY_ENTRY:
-				{
-					alias = dis.readUTF();
+	size_t tables = 8 + 4 * (size_t) _slots + BKS_INDEX_ENTRY_SIZE * (size_t) _count;
+	if (avail < tables)
+		throw IOException("invalid BeeKeyStore index size");
 
-					auto_ptr<KeyEntry> e(new KeyEntry);
+	m->update(p, 0, (int) tables);
 
-					e->date.setTime(dis.readLong());
+	if (m->doFinal() != bytearray(p + avail, macsize))
+		throw IOException("BeeKeyStore has been tampered with, or password was incorrect; incorrect mac");
 
-					jint keysize = dis.readInt();
+	_slot = p + 8;
+	_table = _slot + 4 * _slots;
+	_region = p + tables;
+	_regionsize = avail - tables;
+}
 
-					if (keysize <= 0)
-						throw IOException("invalid BeeKeyStore key length");
+jint BeeKeyStore::Index::count() const throw ()
+{
+	return _count;
+}
 
-					e->encryptedkey.resize((int) keysize);
+jint BeeKeyStore::Index::pending() const throw ()
+{
+	jint result = 0;
 
-					dis.readFully(e->encryptedkey);
+	synchronized (this)
+	{
+		result = _count - _consumed.size();
+	}
 
-					jint certcount = dis.readInt();
+	return result;
+}
 
-					if (certcount <= 0)
-						throw IOException("invalid BeeKeyStore certificate count");
+bool BeeKeyStore::Index::consumed(jint n) const throw ()
+{
+	bool result = false;
 
-					e->chain.resize(certcount);
+	synchronized (this)
+	{
+		result = _consumed.find(n) != _consumed.end();
+	}
 
-					for (jint j = 0; j < certcount; j++)
-					{
-						String type = dis.readUTF();
+	return result;
+}
 
-						auto_ptr<CertificateFactory> cf(CertificateFactory::getInstance(type));
+void BeeKeyStore::Index::consume(jint n) throw ()
+{
+	synchronized (this)
+	{
+		_consumed.insert(n);
+	}
+}
 
-						jint certsize = dis.readInt();
+const byte* BeeKeyStore::Index::record(jint n, jint& length)
+{
+	const byte* t = _table + n * BKS_INDEX_ENTRY_SIZE;
 
-						if (certsize <= 0)
-							throw IOException("invalid BeeKeyStore certificate size");
-					
-						bytearray cert(certsize);
+	jlong offset = decodeLong(t + 4);
 
-						dis.readFully(cert);
+	length = decodeInt(t + 12);
 
-						ByteArrayInputStream bis(cert);
+	if (offset < 0 || length <= 4 || (size_t) offset > _regionsize || (size_t) length > _regionsize - offset)
+		throw ProviderException("BeeKeyStore index points outside the keystore");
 
-						e->chain[j] = cf->generateCertificate(bis);
-					}
+	const byte* result = _region + offset;
 
-					delete _entries.put(new String(alias), e.release());
-				}
-				break;
+	// the entry is only trusted once it matches the digest in the index
+	if (_verified.find(n) == _verified.end())
+	{
+		byte digest[32];
+		sha256Param sp;
 
-			case BKS_CERTIFICATE_ENTRY:
-				{
-					alias = dis.readUTF();
+		sha256Reset(&sp);
+		sha256Update(&sp, result, length);
+		sha256Digest(&sp, digest);
 
-					auto_ptr<CertEntry> e(new CertEntry);
+		if (memcmp(digest, t + 16, 32))
+			throw ProviderException("BeeKeyStore has been tampered with; incorrect entry digest");
 
-					e->date.setTime(dis.readLong());
+		_verified.insert(n);
+	}
 
-					String type = dis.readUTF();
+	return result;
+}
 
-					auto_ptr<CertificateFactory> cf(CertificateFactory::getInstance(type));
+String BeeKeyStore::Index::name(jint n)
+{
+	jint length;
 
-					jint certsize = dis.readInt();
+	const byte* r = record(n, length);
 
-					if (certsize <= 0)
-						throw IOException("invalid BeeKeyStore certificate size");
+	ByteArrayInputStream bis(r, 4, length - 4);
+	DataInputStream dis(bis);
 
-					bytearray cert(certsize);
+	try
+	{
+		return dis.readUTF();
+	}
+	catch (IOException&)
+	{
+		throw ProviderException("BeeKeyStore entry has an invalid alias");
+	}
+}
 
-					dis.readFully(cert);
+jint BeeKeyStore::Index::find(const String& alias)
+{
+	jint result = -1;
 
-					ByteArrayInputStream bis(cert);
+	jint h = hash(alias);
 
-					e->cert = cf->generateCertificate(bis);
+	synchronized (this)
+	{
+		for (jint i = h & (_slots - 1), probes = 0; probes < _slots; i = (i + 1) & (_slots - 1), probes++)
+		{
+			jint v = decodeInt(_slot + 4 * i);
 
-					delete _entries.put(new String(alias), e.release());
-				}
+			if (v <= 0 || v > _count)
 				break;
 
-			default:
-				throw IOException("invalid BeeKeyStore entry tag");
+			jint n = v - 1;
+
+			if (decodeInt(_table + n * BKS_INDEX_ENTRY_SIZE) == h && name(n).equals(alias))
+			{
+				if (_consumed.find(n) == _consumed.end())
+					result = n;
+				break;
 			}
 		}
+	}
 
-		bytearray computed_mac, original_mac;
+	return result;
+}
 
-		mis.on(false);
+BeeKeyStore::Entry* BeeKeyStore::Index::decode(jint n, String& alias)
+{
+	Entry* result = 0;
 
-		jint macsize = dis.available();
-		if (macsize <= 0)
-			throw IOException("invalid BeeKeyStore MAC size");
+	synchronized (this)
+	{
+		jint length;
 
-		computed_mac = m->doFinal();
-		// we can safely cast, since we've excluded negative numbers
-		if (macsize != computed_mac.size())
-			throw IOException("BeeKeyStore has been tampered with, or password was incorrect; incorrect mac size");
+		const byte* r = record(n, length);
 
-		original_mac.resize(macsize);
-		dis.readFully(original_mac);
+		ByteArrayInputStream bis(r, 0, length);
+		DataInputStream dis(bis);
 
-		if (computed_mac != original_mac)
-			throw IOException("BeeKeyStore has been tampered with, or password was incorrect; incorrect mac");
+		result = readEntry(dis, dis.readInt(), alias);
 	}
+
+	return result;
 }
 
-void BeeKeyStore::engineStore(OutputStream& out, const array<jchar>* password) throw (IOException, CertificateException, NoSuchAlgorithmException)
+BeeKeyStore::BeeKeyStore()
 {
-	synchronized (this)
-	{
-		auto_ptr<Mac> m(Mac::getInstance("HMAC-SHA-256"));
+	_index = 0;
+}
+
+BeeKeyStore::~BeeKeyStore()
+{
+	delete _index;
+}
 
-		PKCS12PBEKey pbekey(password ? *password : EMPTY_PASSWORD, &_salt, _iter);
+jint BeeKeyStore::hash(const String& alias) throw ()
+{
+	/* FNV-1a over the UTF-16 code units, big-endian, so that the index
+	 * doesn't depend on the hash function of the String class
+	 */
+	register uint32_t h = 0x811c9dc5U;
 
-		m->init(pbekey);
+	for (jint i = 0; i < alias.length(); i++)
+	{
+		jchar c = alias.charAt(i);
 
-		MacOutputStream mos(out, *m.get());
-		DataOutputStream dos(mos);
+		h = (h ^ (c >> 8)) * 0x01000193U;
+		h = (h ^ (c & 0xff)) * 0x01000193U;
+	}
 
-		mos.on(false);
-		dos.writeInt(BKS_MAGIC);
-		dos.writeInt(BKS_VERSION_1);
-		dos.writeInt(_salt.size());
-		dos.write(_salt);
-		dos.writeInt(_iter);
-		mos.on(true);
-		dos.writeInt(_entries.size());
+	return (jint) h;
+}
 
-		Iterator<class Map<String,Entry>::Entry>* it = _entries.entrySet().iterator();
-		assert(it != 0);
-		while (it->hasNext())
-		{
-			class Map<String,Entry>::Entry* e = it->next();
+BeeKeyStore::Entry* BeeKeyStore::lookup(const String& alias)
+{
+	Entry* e = _entries.get(&alias);
 
-			const KeyEntry* ke = dynamic_cast<const KeyEntry*>(e->getValue());
-			if (ke)
+	if (!e && _index)
+	{
+		synchronized (_index)
+		{
+			// another reader may have decoded it in the meantime
+			e = _entries.get(&alias);
+			if (!e)
 			{
-				dos.writeInt(BKS_PRIVATEKEY_ENTRY);
-				dos.writeUTF(*e->getKey());
-				dos.writeLong(ke->date.getTime());
-				dos.writeInt(ke->encryptedkey.size());
-				dos.write(ke->encryptedkey);
-				/* next do all the certificates for this key */
-				dos.writeInt(ke->chain.size());
-				for (int i = 0; i < ke->chain.size(); i++)
+				jint n = _index->find(alias);
+				if (n >= 0)
 				{
-					const Certificate* cert = ke->chain[i];
+					String name;
 
-					dos.writeUTF(cert->getType());
-					dos.writeInt(cert->getEncoded().size());
-					dos.write(cert->getEncoded());
+					try
+					{
+						e = _index->decode(n, name);
+					}
+					catch (Exception&)
+					{
+						throw ProviderException("BeeKeyStore failed to decode entry");
+					}
+
+					// into the table first, so that no reader finds it in neither
+					delete _entries.put(new String(name), e);
+
+					_index->consume(n);
 				}
-				continue;
 			}
+		}
+	}
 
-			const CertEntry* ce = dynamic_cast<const CertEntry*>(e->getValue());
-			if (ce)
+	return e;
+}
+
+void BeeKeyStore::drop(const String& alias)
+{
+	if (_index)
+	{
+		jint n = _index->find(alias);
+		if (n >= 0)
+			_index->consume(n);
+	}
+}
+
+void BeeKeyStore::decodeAll()
+{
+	if (_index)
+	{
+		synchronized (_index)
+		{
+			for (jint n = 0; n < _index->count(); n++)
 			{
-				dos.writeInt(BKS_CERTIFICATE_ENTRY);
-				dos.writeUTF(*e->getKey());
-				dos.writeLong(ce->date.getTime());
-				dos.writeUTF(ce->cert->getType());
-				dos.writeInt(ce->cert->getEncoded().size());
-				dos.write(ce->cert->getEncoded());
-				continue;
-			}
+				if (!_index->consumed(n))
+				{
+					String name;
+					Entry* e;
 
-			throw ProviderException("entry is neither KeyEntry nor CertEntry");
-		}
+					try
+					{
+						e = _index->decode(n, name);
+					}
+					catch (Exception&)
+					{
+						throw ProviderException("BeeKeyStore failed to decode entry");
+					}
 
-		/* don't call close on a FilterOutputStream because the
-		 * underlying stream still has to write data!
-		 */
-		dos.flush();
-		mos.flush();
+					// into the table first, so that no reader finds it in neither
+					delete _entries.put(new String(name), e);
 
-		out.write(m->doFinal());
-		out.close();
+					_index->consume(n);
+				}
+			}
+		}
 	}
 }
+
+std::string BeeKeyStore::digest(const array<jchar>& password) const
+{
+	byte d[32];
+	sha256Param sp;
+
+	auto_ptr<bytearray> enc(PKCS12PBEKey::encode(password));
+
+	sha256Reset(&sp);
+	sha256Update(&sp, _salt.data(), _salt.size());
+	sha256Update(&sp, enc->data(), enc->size());
+	sha256Digest(&sp, d);
+
+	memset(enc->data(), 0, enc->size());
+
+	std::string result((const char*) d, sizeof(d));
+
+	memset(d, 0, sizeof(d));
+
+	return result;
+}
+
+KeyProtector* BeeKeyStore::protector(const array<jchar>& password, const std::string& digest)
+{
+	KeyProtector* result = 0;
+
+	if (digest.size())
+		result = _cache.getProtector(digest);
+
+	if (!result)
+	{
+		PKCS12PBEKey pbekey(password, &_salt, _iter);
+
+		result = new KeyProtector(pbekey);
+	}
+
+	return result;
+}
+
+Enumeration<const String>* BeeKeyStore::engineAliases()
+{
+	Locker reader(_lock.readLock());
+
+	decodeAll();
+
+	return new Names(_entries);
+}
+
+bool BeeKeyStore::engineContainsAlias(const String& alias)
+{
+	Locker reader(_lock.readLock());
+
+	bool result = false;
+
+	// a reader may be moving the entry from the index into the table
+	if (_index)
+	{
+		synchronized (_index)
+		{
+			result = _entries.containsKey(&alias) || _index->find(alias) >= 0;
+		}
+	}
+	else
+		result = _entries.containsKey(&alias);
+
+	return result;
+}
+
+void BeeKeyStore::engineDeleteEntry(const String& alias) throw (KeyStoreException)
+{
+	Locker writer(_lock.writeLock());
+
+	try
+	{
+		drop(alias);
+	}
+	catch (ProviderException&)
+	{
+		throw KeyStoreException("BeeKeyStore index is corrupt");
+	}
+
+	delete _entries.remove(&alias);
+
+	_cache.invalidate(alias);
+}
+
+const Date* BeeKeyStore::engineGetCreationDate(const String& alias)
+{
+	const Date* result = 0;
+
+	Locker reader(_lock.readLock());
+
+	Entry* e = lookup(alias);
+	if (e)
+		result = &e->date;
+
+	return result;
+}
+
+const Certificate* BeeKeyStore::engineGetCertificate(const String& alias)
+{
+	const Certificate* result = 0;
+
+	Locker reader(_lock.readLock());
+
+	Entry* e = lookup(alias);
+	if (e)
+	{
+		CertEntry* ce = dynamic_cast<CertEntry*>(e);
+		if (ce)
+		{
+			result = ce->cert;
+		}
+		else
+		{
+			KeyEntry* ke = dynamic_cast<KeyEntry*>(e);
+			if (ke)
+				result = ke->chain[0];
+		}
+	}
+
+	return result;
+}
+
+const String* BeeKeyStore::engineGetCertificateAlias(const Certificate& cert)
+{
+	const String* result = 0;
+
+	Locker reader(_lock.readLock());
+
+	decodeAll();
+
+	Iterator<class Map<String,Entry>::Entry>* it = _entries.entrySet().iterator();
+	assert(it != 0);
+	while (it->hasNext())
+	{
+		class Map<String,Entry>::Entry* e = it->next();
+
+		const CertEntry* ce = dynamic_cast<const CertEntry*>(e->getValue());
+		if (ce)
+		{
+			if (cert.equals(ce->cert))
+			{
+				result = e->getKey();
+				break;
+			}
+		}
+	}
+	delete it;
+
+	return result;
+}
+
+const array<Certificate*>* BeeKeyStore::engineGetCertificateChain(const String& alias)
+{
+	const array<Certificate*>* result = 0;
+
+	Locker reader(_lock.readLock());
+
+	KeyEntry* ke = dynamic_cast<KeyEntry*>(lookup(alias));
+	if (ke)
+		result = &ke->chain;
+
+	return result;
+}
+
+bool BeeKeyStore::engineIsCertificateEntry(const String& alias)
+{
+	Locker reader(_lock.readLock());
+
+	return dynamic_cast<CertEntry*>(lookup(alias)) != 0;
+}
+
+void BeeKeyStore::engineSetCertificateEntry(const String& alias, const Certificate& cert) throw (KeyStoreException)
+{
+	Locker writer(_lock.writeLock());
+
+	try
+	{
+		drop(alias);
+	}
+	catch (ProviderException&)
+	{
+		throw KeyStoreException("BeeKeyStore index is corrupt");
+	}
+
+	delete _entries.put(new String(alias), new CertEntry(cert));
+
+	_cache.invalidate(alias);
+}
+
+Key* BeeKeyStore::engineGetKey(const String& alias, const array<jchar>& password) throw (NoSuchAlgorithmException, UnrecoverableKeyException)
+{
+	Key* result = 0;
+
+	/* the read lock is held throughout, so that a writer can't change
+	 * the entry, nor invalidate the cache, while the key is recovered
+	 */
+	Locker reader(_lock.readLock());
+
+	KeyEntry* ke;
+
+	try
+	{
+		ke = dynamic_cast<KeyEntry*>(lookup(alias));
+	}
+	catch (ProviderException&)
+	{
+		throw UnrecoverableKeyException("BeeKeyStore entry is corrupt");
+	}
+
+	if (ke)
+	{
+		std::string d;
+
+		if (_cache.enabled())
+		{
+			d = digest(password);
+
+			result = _cache.getKey(alias, d);
+			if (result)
+				return result;
+		}
+
+		try
+		{
+			auto_ptr<KeyProtector> p(protector(password, d));
+
+			PrivateKey* pri = p->recover(ke->encryptedkey);
+
+			// only now is the password known to be right
+			if (d.size())
+			{
+				_cache.putProtector(d, *p);
+				_cache.putKey(alias, d, *pri);
+			}
+
+			result = pri;
+		}
+		catch (InvalidKeyException& e)
+		{
+			throw UnrecoverableKeyException().initCause(e);
+		}
+	}
+
+	return result;
+}
+
+bool BeeKeyStore::engineIsKeyEntry(const String& alias)
+{
+	Locker reader(_lock.readLock());
+
+	return dynamic_cast<KeyEntry*>(lookup(alias)) != 0;
+}
+
+void BeeKeyStore::engineSetKeyEntry(const String& alias, const bytearray& key, const array<Certificate*>& chain) throw (KeyStoreException)
+{
+	Locker writer(_lock.writeLock());
+
+	try
+	{
+		drop(alias);
+	}
+	catch (ProviderException&)
+	{
+		throw KeyStoreException("BeeKeyStore index is corrupt");
+	}
+
+	delete _entries.put(new String(alias), new KeyEntry(key, chain));
+
+	_cache.invalidate(alias);
+}
+
+void BeeKeyStore::engineSetKeyEntry(const String& alias, const Key& key, const array<jchar>& password, const array<Certificate*>& chain) throw (KeyStoreException)
+{
+	const PrivateKey* pri = dynamic_cast<const PrivateKey*>(&key);
+	if (pri)
+	{
+		// the write lock is reentrant, so the entry is stored under the same salt
+		Locker writer(_lock.writeLock());
+
+		std::string d(_cache.enabled() ? digest(password) : std::string());
+
+		auto_ptr<KeyProtector> p(protector(password, d));
+
+		bytearray* tmp = p->protect(*pri);
+		if (tmp)
+		{
+			// the caller chose this password, so it is right by definition
+			if (d.size())
+				_cache.putProtector(d, *p);
+
+			engineSetKeyEntry(alias, *tmp, chain);
+			delete tmp;
+		}
+		else
+			throw KeyStoreException("BeeKeyStore failed to protect key");
+	}
+	else
+			throw KeyStoreException("BeeKeyStore only supports storing of PrivateKey objects");
+}
+
+int BeeKeyStore::engineSize() const
+{
+	Locker reader(_lock.readLock());
+
+	int result = 0;
+
+	// a reader may be moving an entry from the index into the table
+	if (_index)
+	{
+		synchronized (_index)
+		{
+			result = _entries.size() + _index->pending();
+		}
+	}
+	else
+		result = _entries.size();
+
+	return result;
+}
+
+BeeKeyStore::Entry* BeeKeyStore::readEntry(DataInputStream& dis, jint tag, String& alias) throw (IOException, CertificateException, NoSuchAlgorithmException)
+{
+	switch (tag)
+	{
+	case BKS_PRIVATEKEY_ENTRY:
+		{
+			alias = dis.readUTF();
+
+			auto_ptr<KeyEntry> e(new KeyEntry);
+
+			e->date.setTime(dis.readLong());
+
+			jint keysize = dis.readInt();
+
+			if (keysize <= 0)
+				throw IOException("invalid BeeKeyStore key length");
+
+			e->encryptedkey.resize((int) keysize);
+
+			dis.readFully(e->encryptedkey);
+
+			jint certcount = dis.readInt();
+
+			if (certcount <= 0)
+				throw IOException("invalid BeeKeyStore certificate count");
+
+			e->chain.resize(certcount);
+
+			for (jint j = 0; j < certcount; j++)
+			{
+				String type = dis.readUTF();
+
+				auto_ptr<CertificateFactory> cf(CertificateFactory::getInstance(type));
+
+				jint certsize = dis.readInt();
+
+				if (certsize <= 0)
+					throw IOException("invalid BeeKeyStore certificate size");
+			
+				bytearray cert(certsize);
+
+				dis.readFully(cert);
+
+				ByteArrayInputStream bis(cert);
+
+				e->chain[j] = cf->generateCertificate(bis);
+			}
+
+			return e.release();
+		}
+
+	case BKS_CERTIFICATE_ENTRY:
+		{
+			alias = dis.readUTF();
+
+			auto_ptr<CertEntry> e(new CertEntry);
+
+			e->date.setTime(dis.readLong());
+
+			String type = dis.readUTF();
+
+			auto_ptr<CertificateFactory> cf(CertificateFactory::getInstance(type));
+
+			jint certsize = dis.readInt();
+
+			if (certsize <= 0)
+				throw IOException("invalid BeeKeyStore certificate size");
+
+			bytearray cert(certsize);
+
+			dis.readFully(cert);
+
+			ByteArrayInputStream bis(cert);
+
+			e->cert = cf->generateCertificate(bis);
+
+			return e.release();
+		}
+
+	default:
+		throw IOException("invalid BeeKeyStore entry tag");
+	}
+}
+
+void BeeKeyStore::writeEntry(DataOutputStream& dos, const String& alias, const Entry* e) throw (IOException)
+{
+	const KeyEntry* ke = dynamic_cast<const KeyEntry*>(e);
+	if (ke)
+	{
+		dos.writeInt(BKS_PRIVATEKEY_ENTRY);
+		dos.writeUTF(alias);
+		dos.writeLong(ke->date.getTime());
+		dos.writeInt(ke->encryptedkey.size());
+		dos.write(ke->encryptedkey);
+		/* next do all the certificates for this key */
+		dos.writeInt(ke->chain.size());
+		for (int i = 0; i < ke->chain.size(); i++)
+		{
+			const Certificate* cert = ke->chain[i];
+
+			dos.writeUTF(cert->getType());
+			dos.writeInt(cert->getEncoded().size());
+			dos.write(cert->getEncoded());
+		}
+		return;
+	}
+
+	const CertEntry* ce = dynamic_cast<const CertEntry*>(e);
+	if (ce)
+	{
+		dos.writeInt(BKS_CERTIFICATE_ENTRY);
+		dos.writeUTF(alias);
+		dos.writeLong(ce->date.getTime());
+		dos.writeUTF(ce->cert->getType());
+		dos.writeInt(ce->cert->getEncoded().size());
+		dos.write(ce->cert->getEncoded());
+		return;
+	}
+
+	throw ProviderException("entry is neither KeyEntry nor CertEntry");
+}
+
+void BeeKeyStore::engineLoad(InputStream* in, const array<jchar>* password) throw (IOException, CertificateException, NoSuchAlgorithmException)
+{
+	Locker writer(_lock.writeLock());
+
+	_cache.clear();
+
+	delete _index;
+	_index = 0;
+
+	if (!in)
+	{
+		randomGeneratorContext rngc;
+
+		/* salt size default is 64 bytes */
+		_salt.resize(64);
+		/* generate a new salt */
+		randomGeneratorContextNext(&rngc, _salt.data(), _salt.size());
+		/* set default iteration count */
+		_iter = 1024;
+
+		return;
+	}
+
+	/* an indexed keystore in a file is read in one go, and left undecoded */
+	auto_ptr<Index> whole(Index::read(in));
+	if (whole.get())
+	{
+		_entries.clear();
+
+		whole->open(password, _salt, _iter);
+
+		_index = whole.release();
+
+		return;
+	}
+
+	auto_ptr<Mac> m(Mac::getInstance("HMAC-SHA-256"));
+
+	MacInputStream mis(*in, *m.get());
+	DataInputStream dis(mis);
+
+	mis.on(false);
+
+	jint magic = dis.readInt();
+	jint version = dis.readInt();
+
+	if (magic != BKS_MAGIC || (version != BKS_VERSION_1 && version != BKS_VERSION_2))
+		throw IOException("invalid BeeKeyStore format");
+
+	_entries.clear();
+
+	if (version == BKS_VERSION_2)
+	{
+		auto_ptr<Index> read(new Index(dis));
+
+		read->open(password, _salt, _iter);
+
+		_index = read.release();
+
+		return;
+	}
+
+	jint saltsize = dis.readInt();
+	if (saltsize <= 0)
+		throw IOException("invalid BeeKeyStore salt size");
+
+	_salt.resize(saltsize);
+	dis.readFully(_salt);
+
+	_iter = dis.readInt();
+	if (_iter <= 0)
+		throw IOException("invalid BeeKeyStore iteration count");
+
+	PKCS12PBEKey pbekey(password ? *password : EMPTY_PASSWORD, &_salt, _iter);
+
+	m->init(pbekey);
+
+	mis.on(true);
+
+	jint entrycount = dis.readInt();
+
+	if (entrycount <= 0)
+		throw IOException("invalid BeeKeyStore entry count");
+
+	for (jint i = 0; i < entrycount; i++)
+	{
+		String alias;
+
+		Entry* e = readEntry(dis, dis.readInt(), alias);
+
+		delete _entries.put(new String(alias), e);
+	}
+
+	bytearray computed_mac, original_mac;
+
+	mis.on(false);
+
+	jint macsize = dis.available();
+	if (macsize <= 0)
+		throw IOException("invalid BeeKeyStore MAC size");
+
+	computed_mac = m->doFinal();
+	// we can safely cast, since we've excluded negative numbers
+	if (macsize != computed_mac.size())
+		throw IOException("BeeKeyStore has been tampered with, or password was incorrect; incorrect mac size");
+
+	original_mac.resize(macsize);
+	dis.readFully(original_mac);
+
+	if (computed_mac != original_mac)
+		throw IOException("BeeKeyStore has been tampered with, or password was incorrect; incorrect mac");
+}
+
+void BeeKeyStore::engineStore(OutputStream& out, const array<jchar>* password) throw (IOException, CertificateException, NoSuchAlgorithmException)
+{
+	Locker reader(_lock.readLock());
+
+	try
+	{
+		decodeAll();
+	}
+	catch (ProviderException&)
+	{
+		throw IOException("BeeKeyStore entry is corrupt");
+	}
+
+	jint version = BKS_VERSION_2;
+
+	try
+	{
+		// check value of property beekeystore.version in beecrypt.conf
+		const String* tmp = Security::getProperty("beekeystore.version");
+		if (tmp)
+		{
+			version = Integer::parseInteger(*tmp);
+
+			if (version != BKS_VERSION_1 && version != BKS_VERSION_2)
+				throw ProviderException("beekeystore.version must be 1 or 2");
+		}
+	}
+	catch (NumberFormatException&)
+	{
+		throw ProviderException("beekeystore.version not set to a numeric value");
+	}
+
+	auto_ptr<Mac> m(Mac::getInstance("HMAC-SHA-256"));
+
+	PKCS12PBEKey pbekey(password ? *password : EMPTY_PASSWORD, &_salt, _iter);
+
+	m->init(pbekey);
+
+	MacOutputStream mos(out, *m.get());
+	DataOutputStream dos(mos);
+
+	mos.on(false);
+	dos.writeInt(BKS_MAGIC);
+	dos.writeInt(version);
+	dos.writeInt(_salt.size());
+	dos.write(_salt);
+	dos.writeInt(_iter);
+	mos.on(true);
+	dos.writeInt(_entries.size());
+
+	if (version == BKS_VERSION_2)
+	{
+		jint count = _entries.size(), slots = 2;
+
+		// keep the hash table at most half full
+		while (slots < 2 * count)
+			slots <<= 1;
+
+		array<jint> slot(slots);
+		bytearray table(count * BKS_INDEX_ENTRY_SIZE);
+
+		ByteArrayOutputStream bos;
+		DataOutputStream rec(bos);
+
+		Iterator<class Map<String,Entry>::Entry>* it = _entries.entrySet().iterator();
+		assert(it != 0);
+		for (jint n = 0; it->hasNext(); n++)
+		{
+			class Map<String,Entry>::Entry* e = it->next();
+
+			jint offset = bos.size();
+
+			writeEntry(rec, *e->getKey(), e->getValue());
+			rec.flush();
+
+			jint h = hash(*e->getKey());
+			jint i = h & (slots - 1);
+
+			while (slot[i])
+				i = (i + 1) & (slots - 1);
+
+			slot[i] = n + 1;
+
+			byte* t = table.data() + n * BKS_INDEX_ENTRY_SIZE;
+
+			encodeInt(t, h);
+			encodeLong(t + 4, offset);
+			encodeInt(t + 12, bos.size() - offset);
+		}
+		delete it;
+
+		bytearray region;
+
+		bos.toByteArray(region);
+
+		for (jint n = 0; n < count; n++)
+		{
+			byte* t = table.data() + n * BKS_INDEX_ENTRY_SIZE;
+
+			sha256Param sp;
+
+			sha256Reset(&sp);
+			sha256Update(&sp, region.data() + decodeLong(t + 4), decodeInt(t + 12));
+			sha256Digest(&sp, t + 16);
+		}
+
+		dos.writeInt(slots);
+		for (jint i = 0; i < slots; i++)
+			dos.writeInt(slot[i]);
+		dos.write(table);
+
+		/* the entries are covered by their digests in the table */
+		mos.on(false);
+		dos.write(region);
+	}
+	else
+	{
+		Iterator<class Map<String,Entry>::Entry>* it = _entries.entrySet().iterator();
+		assert(it != 0);
+		while (it->hasNext())
+		{
+			class Map<String,Entry>::Entry* e = it->next();
+
+			writeEntry(dos, *e->getKey(), e->getValue());
+		}
+		delete it;
+	}
+
+	/* don't call close on a FilterOutputStream because the
+	 * underlying stream still has to write data!
+	 */
+	dos.flush();
+	mos.flush();
+
+	out.write(m->doFinal());
+	out.close();
+}
@@ -21,6 +21,7 @@
 #endif
 
 #include "beecrypt/c++/provider/DHKeyAgreement.h"
+#include "beecrypt/c++/provider/DHPrivateKeyImpl.h"
 #include "beecrypt/c++/provider/DHPublicKeyImpl.h"
 
 #include "beecrypt/c++/crypto/interfaces/DHPrivateKey.h"
@@ -98,8 +99,15 @@ void DHKeyAgreement::engineInit(const Key& key, SecureRandom* random) throw (Inv
 	const DHPrivateKey* pri = dynamic_cast<const DHPrivateKey*>(&key);
 	if (pri)
 	{
-		transform(_param.p, pri->getParams().getP());
-		transform(_param.g, pri->getParams().getG());
+		const DHPrivateKeyImpl* impl = dynamic_cast<const DHPrivateKeyImpl*>(pri);
+
+		if (impl)
+			dldp_pCopy(&_param, &impl->prepared());
+		else
+		{
+			transform(_param.p, pri->getParams().getP());
+			transform(_param.g, pri->getParams().getG());
+		}
 
 		transform(_x, pri->getX());
 
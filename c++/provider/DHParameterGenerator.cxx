@@ -51,14 +51,14 @@ AlgorithmParameters* DHParameterGenerator::engineGenerateParameters()
 		if (_srng)
 		{
 			randomGeneratorContextAdapter rngc(_srng);
-			if (dldp_pgonMakeSafe(&param, &rngc, _size))
-				throw "unexpected error in dldp_pMake";
+			if (dldp_pgonMakeSafeParallel(&param, &rngc, _size, 0))
+				throw "unexpected error in dldp_pgonMakeSafeParallel";
 		}
 		else
 		{
 			randomGeneratorContext rngc(randomGeneratorDefault());
-			if (dldp_pgonMakeSafe(&param, &rngc, _size))
-				throw "unexpected error in dldp_pMake";
+			if (dldp_pgonMakeSafeParallel(&param, &rngc, _size, 0))
+				throw "unexpected error in dldp_pgonMakeSafeParallel";
 		}
 
 		_spec = new DHParameterSpec(BigInteger(param.p), BigInteger(param.g));
@@ -37,6 +37,7 @@ DHPrivateKeyImpl::DHPrivateKeyImpl(const DHPrivateKey& copy) : _x(copy.getX())
 {
 	_params = new DHParameterSpec(copy.getParams());
 	_enc = 0;
+	_pre = 0;
 }
 
 
@@ -44,30 +45,35 @@ DHPrivateKeyImpl::DHPrivateKeyImpl(const DHPrivateKeyImpl& copy) : _x(copy._x)
 {
 	_params = new DHParameterSpec(*copy._params);
 	_enc = 0;
+	_pre = 0;
 }
 
 DHPrivateKeyImpl::DHPrivateKeyImpl(const DHParams& params, const BigInteger& x) : _x(x)
 {
 	_params = new DHParameterSpec(params.getP(), params.getG(), params.getL());
 	_enc = 0;
+	_pre = 0;
 }
 
 DHPrivateKeyImpl::DHPrivateKeyImpl(const dhparam& params, const mpnumber& x) : _x(x)
 {
 	_params = new DHParameterSpec(BigInteger(params.p), BigInteger(params.g));
 	_enc = 0;
+	_pre = 0;
 }
 
 DHPrivateKeyImpl::DHPrivateKeyImpl(const BigInteger& p, const BigInteger& g, const BigInteger& x) : _x(x)
 {
 	_params = new DHParameterSpec(p, g);
 	_enc = 0;
+	_pre = 0;
 }
 
 DHPrivateKeyImpl::~DHPrivateKeyImpl()
 {
 	delete _params;
 	delete _enc;
+	delete _pre;
 }
 
 DHPrivateKeyImpl* DHPrivateKeyImpl::clone() const throw ()
@@ -141,3 +147,23 @@ const String* DHPrivateKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const dhparam& DHPrivateKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			dhparam* pre = new dhparam();
+
+			transform(pre->p, _params->getP());
+			transform(pre->g, _params->getG());
+
+			/* dlsvdp_pDHSecret uses the Montgomery context while it matches p */
+			mpmontset(&pre->pm, pre->p.size, pre->p.modl);
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
@@ -53,14 +53,14 @@ AlgorithmParameters* DSAParameterGenerator::engineGenerateParameters()
 		if (_srng)
 		{
 			randomGeneratorContextAdapter rngc(_srng);
-			if (dsaparamMake(&param, &rngc, _size))
-				throw "unexpected error in dsaparamMake";
+			if (dsaparamMakeParallel(&param, &rngc, _size, 0))
+				throw "unexpected error in dsaparamMakeParallel";
 		}
 		else
 		{
 			randomGeneratorContext rngc(randomGeneratorDefault());
-			if (dsaparamMake(&param, &rngc, _size))
-				throw "unexpected error in dsaparamMake";
+			if (dsaparamMakeParallel(&param, &rngc, _size, 0))
+				throw "unexpected error in dsaparamMakeParallel";
 		}
 
 		_spec = new DSAParameterSpec(BigInteger(param.p), BigInteger(param.q), BigInteger(param.g));
@@ -38,6 +38,7 @@ DSAPrivateKeyImpl::DSAPrivateKeyImpl(const DSAPrivateKey& copy)
 	_params = new DSAParameterSpec(copy.getParams());
 	_x = copy.getX();
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPrivateKeyImpl::DSAPrivateKeyImpl(const DSAPrivateKeyImpl& copy)
@@ -45,30 +46,35 @@ DSAPrivateKeyImpl::DSAPrivateKeyImpl(const DSAPrivateKeyImpl& copy)
 	_params = new DSAParameterSpec(*copy._params);
 	_x = copy._x;
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPrivateKeyImpl::DSAPrivateKeyImpl(const DSAParams& params, const BigInteger& x) : _x(x)
 {
 	_params = new DSAParameterSpec(params.getP(), params.getQ(), params.getG());
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPrivateKeyImpl::DSAPrivateKeyImpl(const dsaparam& params, const mpnumber& x) : _x(x)
 {
 	_params = new DSAParameterSpec(BigInteger(params.p), BigInteger(params.q), BigInteger(params.g));
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPrivateKeyImpl::DSAPrivateKeyImpl(const BigInteger& p, const BigInteger& q, const BigInteger& g, const BigInteger& x) : _x(x)
 {
 	_params = new DSAParameterSpec(p, q, g);
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPrivateKeyImpl::~DSAPrivateKeyImpl()
 {
 	delete _params;
 	delete _enc;
+	delete _pre;
 }
 
 DSAPrivateKeyImpl* DSAPrivateKeyImpl::clone() const throw ()
@@ -149,3 +155,24 @@ const String* DSAPrivateKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const dsaparam& DSAPrivateKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			dsaparam* pre = new dsaparam();
+
+			transform(pre->p, _params->getP());
+			transform(pre->q, _params->getQ());
+			transform(pre->g, _params->getG());
+
+			/* signing raises g to exponents below q */
+			dldp_pPrecompute(pre);
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
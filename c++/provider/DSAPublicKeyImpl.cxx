@@ -38,24 +38,28 @@ DSAPublicKeyImpl::DSAPublicKeyImpl(const DSAPublicKey& copy)
 	_params = new DSAParameterSpec(copy.getParams());
 	_y = copy.getY();
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPublicKeyImpl::DSAPublicKeyImpl(const DSAPublicKeyImpl& copy) : _y(copy._y)
 {
 	_params = new DSAParameterSpec(*copy._params);
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPublicKeyImpl::DSAPublicKeyImpl(const DSAParams& params, const BigInteger& y) : _y(y)
 {
 	_params = new DSAParameterSpec(params.getP(), params.getQ(), params.getG());
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPublicKeyImpl::DSAPublicKeyImpl(const dsaparam& params, const mpnumber& y) : _y(y)
 {
 	_params = new DSAParameterSpec(BigInteger(params.p), BigInteger(params.q), BigInteger(params.g));
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPublicKeyImpl::DSAPublicKeyImpl(const BigInteger& p, const BigInteger& q, const BigInteger& g, const BigInteger& y)
@@ -63,12 +67,14 @@ DSAPublicKeyImpl::DSAPublicKeyImpl(const BigInteger& p, const BigInteger& q, con
 	_params = new DSAParameterSpec(p, q, g);
 	_y = y;
 	_enc = 0;
+	_pre = 0;
 }
 
 DSAPublicKeyImpl::~DSAPublicKeyImpl()
 {
 	delete _params;
 	delete _enc;
+	delete _pre;
 }
 
 DSAPublicKeyImpl* DSAPublicKeyImpl::clone() const throw ()
@@ -149,3 +155,21 @@ const String* DSAPublicKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const dsaparam& DSAPublicKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			dsaparam* pre = new dsaparam();
+
+			transform(pre->p, _params->getP());
+			transform(pre->q, _params->getQ());
+			transform(pre->g, _params->getG());
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
@@ -93,14 +93,12 @@ KeyProtector::KeyProtector(PBEKey& key) throw (InvalidKeyException)
 
 	_iter = key.getIterationCount();
 
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_CIPHER, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _cipher_key, 32))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
+	const byte ids[3] = { PKCS12_ID_CIPHER, PKCS12_ID_MAC, PKCS12_ID_IV };
+	byte* const keys[3] = { _cipher_key, _mac_key, _iv };
+	const size_t sizes[3] = { 32, 32, 16 };
 
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_MAC, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _mac_key, 32))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
-
-	if (pkcs12_derive_key(&sha256, PKCS12_ID_IV, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, _iv, 16))
-        throw InvalidKeyException("pkcs12_derive_key returned error");
+	if (pkcs12_derive_keys(&sha256, _rawk.data(), _rawk.size(), _salt.data(), _salt.size(), _iter, 3, ids, keys, sizes))
+		throw InvalidKeyException("pkcs12_derive_keys returned error");
 }
 
 KeyProtector::~KeyProtector() throw ()
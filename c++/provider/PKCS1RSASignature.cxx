@@ -23,6 +23,9 @@
 #include "beecrypt/c++/lang/NullPointerException.h"
 using beecrypt::lang::NullPointerException;
 #include "beecrypt/c++/provider/PKCS1RSASignature.h"
+#include "beecrypt/c++/provider/RSAPrivateCrtKeyImpl.h"
+#include "beecrypt/c++/provider/RSAPrivateKeyImpl.h"
+#include "beecrypt/c++/provider/RSAPublicKeyImpl.h"
 #include "beecrypt/c++/security/interfaces/RSAPrivateKey.h"
 using beecrypt::security::interfaces::RSAPrivateKey;
 #include "beecrypt/c++/security/interfaces/RSAPrivateCrtKey.h"
@@ -53,13 +56,26 @@ void PKCS1RSASignature::engineInitSign(const PrivateKey& key, SecureRandom* rand
 	const RSAPrivateKey* rsa = dynamic_cast<const RSAPrivateKey*>(&key);
 	if (rsa)
 	{
-		/* copy key information */
-		transform(_pair.n, rsa->getModulus());
-		transform(_pair.d, rsa->getPrivateExponent());
-
+		const RSAPrivateCrtKeyImpl* crtimpl = dynamic_cast<const RSAPrivateCrtKeyImpl*>(rsa);
+		const RSAPrivateKeyImpl* impl = dynamic_cast<const RSAPrivateKeyImpl*>(rsa);
 		const RSAPrivateCrtKey* crt = dynamic_cast<const RSAPrivateCrtKey*>(rsa);
-		if (crt)
+
+		/* our own keys keep a prepared copy, mu included */
+		if (crtimpl)
+		{
+			rsakpCopy(&_pair, &crtimpl->prepared());
+			_crt = true;
+		}
+		else if (impl)
+		{
+			rsakpCopy(&_pair, &impl->prepared());
+			_crt = false;
+		}
+		else if (crt)
 		{
+			/* copy key information */
+			transform(_pair.n, rsa->getModulus());
+			transform(_pair.d, rsa->getPrivateExponent());
 			transform(_pair.p, crt->getPrimeP());
 			transform(_pair.q, crt->getPrimeQ());
 			transform(_pair.dp, crt->getPrimeExponentP());
@@ -68,7 +84,12 @@ void PKCS1RSASignature::engineInitSign(const PrivateKey& key, SecureRandom* rand
 			_crt = true;
 		}
 		else
+		{
+			/* copy key information */
+			transform(_pair.n, rsa->getModulus());
+			transform(_pair.d, rsa->getPrivateExponent());
 			_crt = false;
+		}
 
 		/* reset the hash function */
 		hashFunctionContextReset(&_hfc);
@@ -84,9 +105,19 @@ void PKCS1RSASignature::engineInitVerify(const PublicKey& key) throw (InvalidKey
 	const RSAPublicKey* rsa = dynamic_cast<const RSAPublicKey*>(&key);
 	if (rsa)
 	{
-		/* copy key information */
-		transform(_pair.n, rsa->getModulus());
-		transform(_pair.e, rsa->getPublicExponent());
+		const RSAPublicKeyImpl* impl = dynamic_cast<const RSAPublicKeyImpl*>(rsa);
+
+		if (impl)
+		{
+			mpbcopy(&_pair.n, &impl->prepared().n);
+			mpncopy(&_pair.e, &impl->prepared().e);
+		}
+		else
+		{
+			/* copy key information */
+			transform(_pair.n, rsa->getModulus());
+			transform(_pair.e, rsa->getPublicExponent());
+		}
 
 		/* reset the hash function */
 		hashFunctionContextReset(&_hfc);
@@ -140,8 +171,8 @@ int PKCS1RSASignature::engineSign(byte* signature, int offset, int len) throw (S
 
 	if (_crt)
 	{
-		if (rsapricrt(&_pair.n, &_pair.p, &_pair.q, &_pair.dp, &_pair.dq, &_pair.qi, &c, &m))
-			throw SignatureException("internal error in rsapricrt function");
+		if (rsapricrtkp(&_pair, &c, &m))
+			throw SignatureException("internal error in rsapricrtkp function");
 	}
 	else
 	{
@@ -36,21 +36,25 @@ namespace {
 RSAPrivateCrtKeyImpl::RSAPrivateCrtKeyImpl(const RSAPrivateCrtKey& copy) : _n(copy.getModulus()), _e(copy.getPublicExponent()), _d(copy.getPrivateExponent()), _p(copy.getPrimeP()), _q(copy.getPrimeQ()), _dp(copy.getPrimeExponentP()), _dq(copy.getPrimeExponentQ()), _qi(copy.getCrtCoefficient())
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateCrtKeyImpl::RSAPrivateCrtKeyImpl(const RSAPrivateCrtKeyImpl& copy) : _n(copy._n), _e(copy._e), _d(copy._d), _p(copy._p), _q(copy._q), _dp(copy._dp), _dq(copy._dq), _qi(copy._qi)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateCrtKeyImpl::RSAPrivateCrtKeyImpl(const BigInteger& n, const BigInteger& e, const BigInteger& d, const BigInteger& p, const BigInteger& q, const BigInteger& dp, const BigInteger& dq, const BigInteger& qi) : _n(n), _e(e), _d(d), _p(p), _q(q), _dp(dp), _dq(dq), _qi(qi)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateCrtKeyImpl::~RSAPrivateCrtKeyImpl()
 {
 	delete _enc;
+	delete _pre;
 }
 
 bool RSAPrivateCrtKeyImpl::equals(const Object* obj) const throw ()
@@ -158,3 +162,30 @@ const String* RSAPrivateCrtKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const rsakp& RSAPrivateCrtKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			rsakp* pre = new rsakp();
+
+			/* transforming an mpbarrett computes its mu */
+			transform(pre->n, _n);
+			transform(pre->e, _e);
+			transform(pre->d, _d);
+			transform(pre->p, _p);
+			transform(pre->q, _q);
+			transform(pre->dp, _dp);
+			transform(pre->dq, _dq);
+			transform(pre->qi, _qi);
+
+			/* without the contexts, the Montgomery engine sets them up on every call */
+			rsakpPrecompute(pre);
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
@@ -36,21 +36,25 @@ namespace {
 RSAPrivateKeyImpl::RSAPrivateKeyImpl(const RSAPrivateKey& copy) : _n(copy.getModulus()), _d(copy.getPrivateExponent())
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateKeyImpl::RSAPrivateKeyImpl(const RSAPrivateKeyImpl& copy) : _n(copy._n), _d(copy._d)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateKeyImpl::RSAPrivateKeyImpl(const BigInteger& n, const BigInteger& d) : _n(n), _d(d)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPrivateKeyImpl::~RSAPrivateKeyImpl()
 {
 	delete _enc;
+	delete _pre;
 }
 
 RSAPrivateKeyImpl* RSAPrivateKeyImpl::clone() const throw ()
@@ -122,3 +126,20 @@ const String* RSAPrivateKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const rsakp& RSAPrivateKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			rsakp* pre = new rsakp();
+
+			transform(pre->n, _n);
+			transform(pre->d, _d);
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
@@ -36,21 +36,25 @@ namespace {
 RSAPublicKeyImpl::RSAPublicKeyImpl(const RSAPublicKey& copy) : _n(copy.getModulus()), _e(copy.getPublicExponent())
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPublicKeyImpl::RSAPublicKeyImpl(const RSAPublicKeyImpl& copy) : _n(copy._n), _e(copy._e)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPublicKeyImpl::RSAPublicKeyImpl(const BigInteger& n, const BigInteger& e) : _n(n), _e(e)
 {
 	_enc = 0;
+	_pre = 0;
 }
 
 RSAPublicKeyImpl::~RSAPublicKeyImpl()
 {
 	delete _enc;
+	delete _pre;
 }
 
 RSAPublicKeyImpl* RSAPublicKeyImpl::clone() const throw ()
@@ -122,3 +126,20 @@ const String* RSAPublicKeyImpl::getFormat() const throw ()
 {
 	return &FORMAT_BEE;
 }
+
+const rsapk& RSAPublicKeyImpl::prepared() const
+{
+	synchronized (this)
+	{
+		if (!_pre)
+		{
+			rsapk* pre = new rsapk();
+
+			transform(pre->n, _n);
+			transform(pre->e, _e);
+
+			_pre = pre;
+		}
+	}
+	return *_pre;
+}
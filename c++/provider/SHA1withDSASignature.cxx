@@ -24,6 +24,8 @@
 #include "beecrypt/c++/lang/NullPointerException.h"
 using beecrypt::lang::NullPointerException;
 #include "beecrypt/c++/provider/SHA1withDSASignature.h"
+#include "beecrypt/c++/provider/DSAPrivateKeyImpl.h"
+#include "beecrypt/c++/provider/DSAPublicKeyImpl.h"
 #include "beecrypt/c++/security/interfaces/DSAPrivateKey.h"
 using beecrypt::security::interfaces::DSAPrivateKey;
 #include "beecrypt/c++/security/interfaces/DSAPublicKey.h"
@@ -268,10 +270,19 @@ void SHA1withDSASignature::engineInitSign(const PrivateKey& key, SecureRandom* r
 	const DSAPrivateKey* dsa = dynamic_cast<const DSAPrivateKey*>(&key);
 	if (dsa)
 	{
-		/* copy key information */
-		transform(_params.p, dsa->getParams().getP());
-		transform(_params.q, dsa->getParams().getQ());
-		transform(_params.g, dsa->getParams().getG());
+		const DSAPrivateKeyImpl* impl = dynamic_cast<const DSAPrivateKeyImpl*>(dsa);
+
+		/* our own keys keep prepared parameters, with the table of powers of g */
+		if (impl)
+			dldp_pCopy(&_params, &impl->prepared());
+		else
+		{
+			/* copy key information */
+			transform(_params.p, dsa->getParams().getP());
+			transform(_params.q, dsa->getParams().getQ());
+			transform(_params.g, dsa->getParams().getG());
+			mpbfbfree(&_params.gfb);
+		}
 		transform(_x, dsa->getX());
 
 		/* reset the hash function */
@@ -288,10 +299,18 @@ void SHA1withDSASignature::engineInitVerify(const PublicKey& key) throw (Invalid
 	const DSAPublicKey* dsa = dynamic_cast<const DSAPublicKey*>(&key);
 	if (dsa)
 	{
-		/* copy key information */
-		transform(_params.p, dsa->getParams().getP());
-		transform(_params.q, dsa->getParams().getQ());
-		transform(_params.g, dsa->getParams().getG());
+		const DSAPublicKeyImpl* impl = dynamic_cast<const DSAPublicKeyImpl*>(dsa);
+
+		if (impl)
+			dldp_pCopy(&_params, &impl->prepared());
+		else
+		{
+			/* copy key information */
+			transform(_params.p, dsa->getParams().getP());
+			transform(_params.q, dsa->getParams().getQ());
+			transform(_params.g, dsa->getParams().getG());
+			mpbfbfree(&_params.gfb);
+		}
 		transform(_y, dsa->getY());
 
 		/* reset the hash function */
@@ -313,6 +332,15 @@ void SHA1withDSASignature::engineUpdate(const byte* data, int offset, int len)
 	sha1Update(&_sp, data+offset, len);
 }
 
+int SHA1withDSASignature::rawsign(randomGeneratorContext* rngc, const mpnumber& hm, mpnumber& r, mpnumber& s) throw ()
+{
+	/* with the table, g is raised to the random exponent much faster */
+	if (_params.gfb.base)
+		return dsasignfb(&_params.p, &_params.q, &_params.gfb, rngc, &hm, &_x, &r, &s);
+	else
+		return dsasign(&_params.p, &_params.q, &_params.g, rngc, &hm, &_x, &r, &s);
+}
+
 void SHA1withDSASignature::rawsign(mpnumber& r, mpnumber& s) throw (SignatureException)
 {
 	mpnumber hm;
@@ -324,13 +352,13 @@ void SHA1withDSASignature::rawsign(mpnumber& r, mpnumber& s) throw (SignatureExc
 	if (_srng)
 	{
 		randomGeneratorContextAdapter rngc(_srng);
-		if (dsasign(&_params.p, &_params.q, &_params.g, &rngc, &hm, &_x, &r, &s))
+		if (rawsign(&rngc, hm, r, s))
 			throw SignatureException("internal error in dsasign function");
 	}
 	else
 	{
 		randomGeneratorContext rngc(randomGeneratorDefault());
-		if (dsasign(&_params.p, &_params.q, &_params.g, &rngc, &hm, &_x, &r, &s))
+		if (rawsign(&rngc, hm, r, s))
 			throw SignatureException("internal error in dsasign function");
 	}
 }
@@ -347,6 +347,14 @@ void KeyStore::setCertificateEntry(const String& alias, const Certificate& cert)
 	_kspi->engineSetCertificateEntry(alias, cert);
 }
 
+void KeyStore::deleteEntry(const String& alias) throw (KeyStoreException)
+{
+	if (!_init)
+		throw KeyStoreException("uninitialized keystore");
+
+	_kspi->engineDeleteEntry(alias);
+}
+
 bool KeyStore::isCertificateEntry(const String& alias) throw (KeyStoreException)
 {
 	if (!_init)
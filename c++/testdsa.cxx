@@ -66,6 +66,17 @@ int main(int argc, char* argv[])
 
 		PublicKey* pub = kf->generatePublic(*spec);
 
+		/* a second round reuses the keys' prepared parameters */
+		sig->initSign(pair->getPrivate());
+
+		bytearray* again = sig->sign();
+
+		sig->initVerify(*pub);
+
+		if (!sig->verify(*again) || !sig->verify(*tmp))
+			failures++;
+
+		delete again;
 		delete pub;
 		delete spec;
 		delete kf;
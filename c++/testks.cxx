@@ -38,6 +38,8 @@ using std::endl;
 
 int main(int argc, char* argv[])
 {
+	int failures = 0;
+
 	try
 	{
 		array<jchar> password(4);
@@ -78,7 +80,126 @@ int main(int argc, char* argv[])
 			// create an empty stream
 			ks->load((InputStream*) 0, &password);
 			ks->setKeyEntry("rsa", pair->getPrivate(), password, chain);
+
+			// the second recovery may come from the cache, and must give the same key
+			Key* k1 = ks->getKey("rsa", password);
+			Key* k2 = ks->getKey("rsa", password);
+
+			if (!k1 || !k2 || *k1->getEncoded() != *k2->getEncoded())
+			{
+				cout << "recovered keys differ" << endl;
+				failures++;
+			}
+
+			delete k1;
+			delete k2;
+
+			// a cached key must not be returned for the wrong password
+			array<jchar> wrong(password);
+
+			wrong[0] = (jchar) 'T';
+
+			try
+			{
+				delete ks->getKey("rsa", wrong);
+
+				cout << "key recovered with wrong password" << endl;
+				failures++;
+			}
+			catch (UnrecoverableKeyException&)
+			{
+			}
+
 			ks->store(fos, &password);
+
+			// entries of the reloaded keystore are only decoded when used
+			KeyStore* copy = KeyStore::getInstance(KeyStore::getDefaultType());
+			FileInputStream fin(fopen("keystore", "rb"));
+
+			copy->load(&fin, &password);
+			fin.close();
+
+			if (copy->size() != 1 || !copy->containsAlias("rsa") || copy->containsAlias("dsa"))
+			{
+				cout << "reloaded keystore has the wrong aliases" << endl;
+				failures++;
+			}
+
+			Key* k = copy->getKey("rsa", password);
+
+			if (!k || *k->getEncoded() != *pair->getPrivate().getEncoded())
+			{
+				cout << "reloaded key differs" << endl;
+				failures++;
+			}
+
+			delete k;
+
+			const Certificate* cert = copy->getCertificate("rsa");
+
+			if (!cert || !cert->equals(chain[0]))
+			{
+				cout << "reloaded certificate differs" << endl;
+				failures++;
+			}
+
+			delete copy;
+
+			// a loaded keystore can be changed and stored over its own file
+			for (int i = 0; i < 200; i++)
+				ks->setCertificateEntry(String("cert") + String::valueOf(i), *chain[0]);
+
+			FileOutputStream bigout(fopen("keystore.big", "wb"));
+
+			ks->store(bigout, &password);
+			bigout.close();
+
+			KeyStore* big = KeyStore::getInstance(KeyStore::getDefaultType());
+			FileInputStream bigin(fopen("keystore.big", "rb"));
+
+			big->load(&bigin, &password);
+			bigin.close();
+
+			big->setCertificateEntry("extra", *chain[0]);
+
+			FileOutputStream bigover(fopen("keystore.big", "wb"));
+
+			big->store(bigover, &password);
+			bigover.close();
+
+			delete big;
+
+			big = KeyStore::getInstance(KeyStore::getDefaultType());
+			FileInputStream bigagain(fopen("keystore.big", "rb"));
+
+			big->load(&bigagain, &password);
+			bigagain.close();
+
+			if (big->size() != 202 || !big->containsAlias("extra") || !big->containsAlias("cert199"))
+			{
+				cout << "keystore stored over its own file has the wrong aliases" << endl;
+				failures++;
+			}
+
+			k = big->getKey("rsa", password);
+
+			if (!k || *k->getEncoded() != *pair->getPrivate().getEncoded())
+			{
+				cout << "keystore stored over its own file has a different key" << endl;
+				failures++;
+			}
+
+			delete k;
+			delete big;
+
+			// nor for an entry which has been deleted
+			ks->deleteEntry("rsa");
+
+			if (ks->getKey("rsa", password))
+			{
+				cout << "key recovered after deleting its entry" << endl;
+				failures++;
+			}
 		}
 
 		delete ks;
@@ -87,5 +208,8 @@ int main(int argc, char* argv[])
 	{
 		if (e.getMessage())
 			cout << "Exception: " + *e.getMessage() << endl;
+		failures++;
 	}
+
+	return failures;
 }
@@ -65,6 +65,21 @@ int main(int argc, char* argv[])
 			failures++;
 		}
 
+		/* a second round reuses the keys' prepared form */
+		sig->initSign(pair->getPrivate());
+
+		bytearray* again = sig->sign();
+
+		sig->initVerify(pair->getPublic());
+
+		if (!sig->verify(*again) || (*again != *tmp))
+		{
+			cerr << "signature failure" << endl;
+			failures++;
+		}
+
+		delete again;
+
 		delete tmp;
 		delete sig;
 		delete pair;
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define BEECRYPT_CXX_DLL_EXPORT
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/c++/lang/Error.h"
+using beecrypt::lang::Error;
+#include "beecrypt/c++/lang/UnsupportedOperationException.h"
+using beecrypt::lang::UnsupportedOperationException;
+
+#include "beecrypt/c++/util/concurrent/locks/ReentrantReadWriteLock.h"
+
+using namespace beecrypt::util::concurrent::locks;
+
+namespace {
+	inline bc_threadid_t self()
+	{
+		#if WIN32
+		return GetCurrentThreadId();
+		#elif HAVE_SYNCH_H
+		return thr_self();
+		#elif HAVE_PTHREAD_H
+		return pthread_self();
+		#else
+		# error
+		#endif
+	}
+}
+
+ReentrantReadWriteLock::ReadLock::ReadLock(ReentrantReadWriteLock* rw) : _rw(rw)
+{
+}
+
+void ReentrantReadWriteLock::ReadLock::lock()
+{
+	while (true)
+	{
+		try
+		{
+			lockInterruptibly();
+
+			return;
+		}
+		catch (InterruptedException&)
+		{
+		}
+	}
+}
+
+void ReentrantReadWriteLock::ReadLock::lockInterruptibly() throw (InterruptedException)
+{
+	bc_threadid_t t = self();
+
+	synchronized (_rw)
+	{
+		while (!_rw->readable(t))
+			_rw->wait(0);
+
+		_rw->_readers++;
+		_rw->_read_holds[t]++;
+	}
+}
+
+Condition* ReentrantReadWriteLock::ReadLock::newCondition()
+{
+	throw UnsupportedOperationException("ReentrantReadWriteLock doesn't support conditions");
+}
+
+bool ReentrantReadWriteLock::ReadLock::tryLock()
+{
+	bool result = false;
+
+	bc_threadid_t t = self();
+
+	synchronized (_rw)
+	{
+		if (_rw->readable(t))
+		{
+			_rw->_readers++;
+			_rw->_read_holds[t]++;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+void ReentrantReadWriteLock::ReadLock::unlock()
+{
+	bc_threadid_t t = self();
+
+	synchronized (_rw)
+	{
+		map<bc_threadid_t, unsigned int>::iterator it = _rw->_read_holds.find(t);
+
+		if (it == _rw->_read_holds.end())
+			throw IllegalMonitorStateException("read lock is not held by this thread");
+
+		if (--it->second == 0)
+			_rw->_read_holds.erase(it);
+
+		// the last reader out lets a waiting writer in
+		if (--_rw->_readers == 0)
+			_rw->notifyAll();
+	}
+}
+
+ReentrantReadWriteLock::WriteLock::WriteLock(ReentrantReadWriteLock* rw) : _rw(rw)
+{
+}
+
+void ReentrantReadWriteLock::WriteLock::lock()
+{
+	while (true)
+	{
+		try
+		{
+			lockInterruptibly();
+
+			return;
+		}
+		catch (InterruptedException&)
+		{
+		}
+	}
+}
+
+void ReentrantReadWriteLock::WriteLock::lockInterruptibly() throw (InterruptedException)
+{
+	bc_threadid_t t = self();
+
+	synchronized (_rw)
+	{
+		if (_rw->_write_count && _rw->_writer == t)
+		{
+			if (++_rw->_write_count == 0)
+				throw Error("maximum lock count exceeded");
+		}
+		else
+		{
+			_rw->_writers_waiting++;
+
+			try
+			{
+				while (!_rw->writable())
+					_rw->wait(0);
+			}
+			catch (InterruptedException&)
+			{
+				// readers held back by this writer may proceed
+				if (--_rw->_writers_waiting == 0)
+					_rw->notifyAll();
+				throw;
+			}
+
+			_rw->_writers_waiting--;
+			_rw->_writer = t;
+			_rw->_write_count = 1;
+		}
+	}
+}
+
+Condition* ReentrantReadWriteLock::WriteLock::newCondition()
+{
+	throw UnsupportedOperationException("ReentrantReadWriteLock doesn't support conditions");
+}
+
+bool ReentrantReadWriteLock::WriteLock::tryLock()
+{
+	bool result = false;
+
+	bc_threadid_t t = self();
+
+	synchronized (_rw)
+	{
+		if (_rw->_write_count && _rw->_writer == t)
+		{
+			if (++_rw->_write_count == 0)
+				throw Error("maximum lock count exceeded");
+
+			result = true;
+		}
+		else if (_rw->writable())
+		{
+			_rw->_writer = t;
+			_rw->_write_count = 1;
+			result = true;
+		}
+	}
+
+	return result;
+}
+
+void ReentrantReadWriteLock::WriteLock::unlock()
+{
+	synchronized (_rw)
+	{
+		if (_rw->_write_count == 0 || _rw->_writer != self())
+			throw IllegalMonitorStateException("write lock is not held by this thread");
+
+		if (--_rw->_write_count == 0)
+		{
+			_rw->_writer = 0;
+			_rw->notifyAll();
+		}
+	}
+}
+
+ReentrantReadWriteLock::ReentrantReadWriteLock() : _rlock(this), _wlock(this)
+{
+	_readers = 0;
+	_writers_waiting = 0;
+	_write_count = 0;
+	_writer = 0;
+}
+
+bool ReentrantReadWriteLock::readable(bc_threadid_t t) const
+{
+	// the writer may always read; other threads wait for it
+	if (_write_count)
+		return _writer == t;
+
+	// queued writers hold back new readers, but not the ones already in
+	return _writers_waiting == 0 || _read_holds.find(t) != _read_holds.end();
+}
+
+bool ReentrantReadWriteLock::writable() const
+{
+	return _write_count == 0 && _readers == 0;
+}
+
+Lock& ReentrantReadWriteLock::readLock()
+{
+	return _rlock;
+}
+
+Lock& ReentrantReadWriteLock::writeLock()
+{
+	return _wlock;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/c++/lang/Thread.h"
+using beecrypt::lang::Thread;
+#include "beecrypt/c++/util/concurrent/locks/ReentrantReadWriteLock.h"
+using beecrypt::util::concurrent::locks::ReentrantReadWriteLock;
+
+#include <iostream>
+using namespace std;
+#include <unicode/ustream.h>
+
+class Writer : public Thread
+{
+private:
+	ReentrantReadWriteLock& _rw;
+
+public:
+	volatile bool locked;
+
+	Writer(ReentrantReadWriteLock& rw) : Thread("writer"), _rw(rw), locked(false)
+	{
+	}
+
+	virtual void run()
+	{
+		_rw.writeLock().lock();
+		locked = true;
+		_rw.writeLock().unlock();
+	}
+};
+
+class Reader : public Thread
+{
+private:
+	ReentrantReadWriteLock& _rw;
+
+public:
+	volatile bool locked;
+
+	Reader(ReentrantReadWriteLock& rw) : Thread("reader"), _rw(rw), locked(false)
+	{
+	}
+
+	virtual void run()
+	{
+		if (_rw.readLock().tryLock())
+		{
+			locked = true;
+			_rw.readLock().unlock();
+		}
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	int failures = 0;
+
+	try
+	{
+		ReentrantReadWriteLock rw;
+		Writer w(rw);
+
+		rw.readLock().lock();
+
+		// the writer queues up behind the read lock we hold
+		w.start();
+		Thread::sleep(100);
+
+		if (w.locked)
+		{
+			cout << "writer got in while the read lock was held" << endl;
+			failures++;
+		}
+
+		// a thread which holds the read lock takes it again, even now
+		if (rw.readLock().tryLock())
+		{
+			rw.readLock().lock();
+			rw.readLock().unlock();
+			rw.readLock().unlock();
+		}
+		else
+		{
+			cout << "nested read lock refused while a writer waits" << endl;
+			failures++;
+		}
+
+		// but a new reader waits behind the writer
+		Reader r(rw);
+
+		r.start();
+		r.join();
+
+		if (r.locked)
+		{
+			cout << "new reader got past a waiting writer" << endl;
+			failures++;
+		}
+
+		rw.readLock().unlock();
+
+		w.join();
+
+		if (!w.locked)
+		{
+			cout << "writer never got in" << endl;
+			failures++;
+		}
+
+		// only the thread which took the read lock may release it
+		try
+		{
+			rw.readLock().unlock();
+
+			cout << "read lock released without being held" << endl;
+			failures++;
+		}
+		catch (IllegalMonitorStateException&)
+		{
+		}
+	}
+	catch (Exception& e)
+	{
+		if (e.getMessage())
+			cout << "Exception: " + *e.getMessage() << endl;
+		failures++;
+	}
+
+	return failures;
+}
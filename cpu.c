@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file cpu.c
+ * \brief Run-time detection of processor features.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/cpu.h"
+
+#if HAVE_CPUID_H
+# include <cpuid.h>
+#endif
+
+/* set once the processor has been probed; this way the result can be
+ * published with a single store, which makes a racing first call harmless
+ */
+#define CPU_PROBED	0x80000000
+
+static uint32_t _cpu_features = 0;
+
+#if HAVE_CPUID_H && (defined(__x86_64__) || defined(__i386__))
+static uint32_t cpuProbe(void)
+{
+	unsigned int eax, ebx, ecx, edx, xcr0 = 0, max;
+	uint32_t features = 0;
+
+	max = __get_cpuid_max(0, (unsigned int*) 0);
+
+	if (max < 1)
+		return 0;
+
+	__cpuid(1, eax, ebx, ecx, edx);
+
+	if (edx & (1 << 26))
+		features |= CPU_FEATURE_SSE2;
+	if (ecx & (1 <<  9))
+		features |= CPU_FEATURE_SSSE3;
+	if (ecx & (1 << 19))
+		features |= CPU_FEATURE_SSE41;
+	if (ecx & (1 << 25))
+		features |= CPU_FEATURE_AESNI;
+	if (ecx & (1 <<  1))
+		features |= CPU_FEATURE_PCLMUL;
+	if (ecx & (1 << 30))
+		features |= CPU_FEATURE_RDRAND;
+
+	/* AVX needs the operating system to save the ymm registers */
+	if (ecx & (1 << 27))
+	{
+		__asm__ __volatile__ ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+
+		if ((ecx & (1 << 28)) && ((xcr0 & 0x06) == 0x06))
+			features |= CPU_FEATURE_AVX;
+	}
+
+	if (max >= 7)
+	{
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+		if ((ebx & (1 <<  5)) && (features & CPU_FEATURE_AVX))
+			features |= CPU_FEATURE_AVX2;
+		if (ebx & (1 <<  8))
+			features |= CPU_FEATURE_BMI2;
+		if (ebx & (1 << 19))
+			features |= CPU_FEATURE_ADX;
+		if (ebx & (1 << 29))
+			features |= CPU_FEATURE_SHA;
+		if (ebx & (1 << 18))
+			features |= CPU_FEATURE_RDSEED;
+
+		/* AVX-512 additionally needs the opmask and zmm state */
+		if ((features & CPU_FEATURE_AVX) && ((xcr0 & 0xe0) == 0xe0))
+		{
+			if (ebx & (1 << 16))
+				features |= CPU_FEATURE_AVX512F;
+			if (ebx & (1 << 30))
+				features |= CPU_FEATURE_AVX512BW;
+		}
+	}
+
+	return features;
+}
+#else
+static uint32_t cpuProbe(void)
+{
+	return 0;
+}
+#endif
+
+uint32_t cpuFeatures()
+{
+	register uint32_t features = _cpu_features;
+
+	if (features == 0)
+	{
+		const char* mask = getenv("BEECRYPT_CPU_MASK");
+
+		features = cpuProbe();
+
+		if (mask)
+			features &= (uint32_t) strtoul(mask, (char**) 0, 16);
+
+		_cpu_features = (features |= CPU_PROBED);
+	}
+
+	return features & ~CPU_PROBED;
+}
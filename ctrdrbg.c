@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file ctrdrbg.c
+ * \brief NIST SP 800-90A CTR_DRBG pseudo-random number generator.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup PRNG_m PRNG_ctrdrbg_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/ctrdrbg.h"
+
+/*!\addtogroup PRNG_ctrdrbg_m
+ * \{
+ */
+
+/* the number of counter blocks which are encrypted together when the
+ * output buffer can't take them directly
+ */
+#define CTRDRBG_BATCH	64
+
+const randomGenerator ctrdrbg = {
+	"CTR_DRBG AES-256",
+	sizeof(ctrdrbgParam),
+	(randomGeneratorSetup) ctrdrbgSetup,
+	(randomGeneratorSeed) ctrdrbgSeed,
+	(randomGeneratorNext) ctrdrbgNext,
+	(randomGeneratorCleanup) ctrdrbgCleanup
+};
+
+static void ctrdrbgIncrement(byte* v)
+{
+	register int i = 16;
+
+	while (i-- > 0)
+		if (++v[i])
+			break;
+}
+
+/* fills blocks with the successive counter values after v, and encrypts them */
+static void ctrdrbgBlocks(ctrdrbgParam* dp, uint32_t* blocks, unsigned int nblocks)
+{
+	register byte* b = (byte*) blocks;
+	register unsigned int i;
+
+	for (i = 0; i < nblocks; i++, b += 16)
+	{
+		ctrdrbgIncrement(dp->v);
+		memcpy(b, dp->v, 16);
+	}
+
+	aesEncryptN(&dp->key, blocks, blocks, nblocks);
+}
+
+/* the update function; provided is either null or CTRDRBG_SEED_SIZE bytes */
+static void ctrdrbgUpdate(ctrdrbgParam* dp, const byte* provided)
+{
+	uint32_t temp[CTRDRBG_SEED_SIZE >> 2];
+	byte* t = (byte*) temp;
+
+	ctrdrbgBlocks(dp, temp, CTRDRBG_SEED_SIZE >> 4);
+
+	if (provided)
+	{
+		register int i;
+
+		for (i = 0; i < CTRDRBG_SEED_SIZE; i++)
+			t[i] ^= provided[i];
+	}
+
+	aesSetup(&dp->key, t, 256, ENCRYPT);
+	memcpy(dp->v, t + 32, 16);
+
+	memset(temp, 0, sizeof(temp));
+}
+
+/* the BCC function, over the block with counter i followed by the padded
+ * string S, which is made up of the lengths, the pieces of input, and
+ * the 0x80 marker
+ */
+static void ctrdrbgBCC(aesParam* kp, uint32_t i, const byte* const* in, const size_t* insize, int pieces, byte* out)
+{
+	uint32_t chain[4];
+	byte* c = (byte*) chain;
+	size_t total = 0;
+	int fill, k;
+
+	memset(chain, 0, sizeof(chain));
+
+	/* the first block holds the counter, big-endian, and zeroes */
+	c[0] = (byte)(i >> 24);
+	c[1] = (byte)(i >> 16);
+	c[2] = (byte)(i >>  8);
+	c[3] = (byte)(i      );
+	aesEncrypt(kp, chain, chain);
+
+	for (k = 0; k < pieces; k++)
+		total += insize[k];
+
+	/* the next eight bytes hold the lengths of the input and the output */
+	c[0] ^= (byte)(total >> 24);
+	c[1] ^= (byte)(total >> 16);
+	c[2] ^= (byte)(total >>  8);
+	c[3] ^= (byte)(total      );
+	c[7] ^= CTRDRBG_SEED_SIZE;
+	fill = 8;
+
+	for (k = 0; k < pieces; k++)
+	{
+		register const byte* data = in[k];
+		register size_t size = insize[k];
+
+		while (size--)
+		{
+			c[fill++] ^= *(data++);
+			if (fill == 16)
+			{
+				aesEncrypt(kp, chain, chain);
+				fill = 0;
+			}
+		}
+	}
+
+	/* the marker, followed by zeroes up to the end of the block */
+	c[fill] ^= 0x80;
+	aesEncrypt(kp, chain, chain);
+
+	memcpy(out, chain, 16);
+	memset(chain, 0, sizeof(chain));
+}
+
+/* the derivation function, which reduces the concatenated pieces of input
+ * to CTRDRBG_SEED_SIZE bytes
+ */
+static void ctrdrbgDF(const byte* const* in, const size_t* insize, int pieces, byte* out)
+{
+	static const byte dfkey[32] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+		0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+	};
+
+	aesParam kp;
+	uint32_t temp[CTRDRBG_SEED_SIZE >> 2];
+	byte* t = (byte*) temp;
+	uint32_t i;
+
+	aesSetup(&kp, dfkey, 256, ENCRYPT);
+
+	for (i = 0; i < (CTRDRBG_SEED_SIZE >> 4); i++)
+		ctrdrbgBCC(&kp, i, in, insize, pieces, t + (i << 4));
+
+	/* the first 32 bytes are the new key, the last 16 the chaining value */
+	aesSetup(&kp, t, 256, ENCRYPT);
+
+	for (i = 0; i < (CTRDRBG_SEED_SIZE >> 4); i++)
+		aesEncrypt(&kp, temp + 4 * i, (i == 0) ? temp + 8 : temp + 4 * (i - 1));
+
+	memcpy(out, temp, CTRDRBG_SEED_SIZE);
+
+	memset(temp, 0, sizeof(temp));
+	memset(&kp, 0, sizeof(kp));
+}
+
+int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize)
+{
+	static const byte zero[32] = { 0 };
+
+	const byte* in[3];
+	size_t insize[3];
+	byte seed[CTRDRBG_SEED_SIZE];
+
+	if (dp == (ctrdrbgParam*) 0 || entropy == (const byte*) 0)
+		return -1;
+
+	in[0] = entropy;
+	insize[0] = entropysize;
+	in[1] = nonce;
+	insize[1] = nonce ? noncesize : 0;
+	in[2] = pers;
+	insize[2] = pers ? perssize : 0;
+
+	ctrdrbgDF(in, insize, 3, seed);
+
+	aesSetup(&dp->key, zero, 256, ENCRYPT);
+	memset(dp->v, 0, 16);
+
+	ctrdrbgUpdate(dp, seed);
+
+	dp->reseed = 1;
+
+	memset(seed, 0, sizeof(seed));
+
+	return 0;
+}
+
+int ctrdrbgReseed(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize)
+{
+	const byte* in[2];
+	size_t insize[2];
+	byte seed[CTRDRBG_SEED_SIZE];
+
+	if (dp == (ctrdrbgParam*) 0 || entropy == (const byte*) 0)
+		return -1;
+
+	in[0] = entropy;
+	insize[0] = entropysize;
+	in[1] = add;
+	insize[1] = add ? addsize : 0;
+
+	ctrdrbgDF(in, insize, 2, seed);
+	ctrdrbgUpdate(dp, seed);
+
+	dp->reseed = 1;
+
+	memset(seed, 0, sizeof(seed));
+
+	return 0;
+}
+
+int ctrdrbgGenerate(ctrdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize)
+{
+	byte seed[CTRDRBG_SEED_SIZE];
+	const byte* provided = (const byte*) 0;
+
+	if (dp == (ctrdrbgParam*) 0 || size > CTRDRBG_MAX_REQUEST)
+		return -1;
+
+	if (add && addsize)
+	{
+		ctrdrbgDF(&add, &addsize, 1, seed);
+		ctrdrbgUpdate(dp, seed);
+		provided = seed;
+	}
+
+	/* if the output is aligned, encrypt the counter blocks right there */
+	if ((((size_t) data) & 3) == 0 && size >= 16)
+	{
+		unsigned int nblocks = (unsigned int) (size >> 4);
+
+		ctrdrbgBlocks(dp, (uint32_t*) data, nblocks);
+
+		data += nblocks << 4;
+		size -= nblocks << 4;
+	}
+
+	while (size > 0)
+	{
+		uint32_t buf[CTRDRBG_BATCH * 4];
+		unsigned int nblocks = (unsigned int) ((size + 15) >> 4);
+		size_t copy;
+
+		if (nblocks > CTRDRBG_BATCH)
+			nblocks = CTRDRBG_BATCH;
+
+		ctrdrbgBlocks(dp, buf, nblocks);
+
+		copy = (size > (nblocks << 4)) ? (nblocks << 4) : size;
+		memcpy(data, buf, copy);
+		memset(buf, 0, nblocks << 4);
+
+		data += copy;
+		size -= copy;
+	}
+
+	ctrdrbgUpdate(dp, provided);
+
+	dp->reseed++;
+
+	memset(seed, 0, sizeof(seed));
+
+	return 0;
+}
+
+int ctrdrbgSetup(ctrdrbgParam* dp)
+{
+	if (dp)
+	{
+		byte entropy[CTRDRBG_SEED_SIZE + 16];
+		int rc;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!(dp->lock = CreateMutex(NULL, FALSE, NULL)))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_init(&dp->lock, USYNC_THREAD, (void *) 0))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_init(&dp->lock, (pthread_mutexattr_t *) 0))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		/* the entropy input, followed by the nonce */
+		if (entropyGatherNext(entropy, sizeof(entropy)))
+			return -1;
+
+		rc = ctrdrbgInstantiate(dp, entropy, CTRDRBG_SEED_SIZE, entropy + CTRDRBG_SEED_SIZE, 16, (const byte*) 0, 0);
+
+		memset(entropy, 0, sizeof(entropy));
+
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgSeed(ctrdrbgParam* dp, const byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(dp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		if (data)
+			rc = ctrdrbgReseed(dp, data, size, (const byte*) 0, 0);
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!ReleaseMutex(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_unlock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_unlock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgNext(ctrdrbgParam* dp, byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(dp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		/* large requests are served as a series of generate calls */
+		while (size > 0 && rc == 0)
+		{
+			size_t chunk = (size > CTRDRBG_MAX_REQUEST) ? CTRDRBG_MAX_REQUEST : size;
+
+			if (dp->reseed > CTRDRBG_RESEED_INTERVAL)
+			{
+				byte entropy[CTRDRBG_SEED_SIZE];
+
+				rc = entropyGatherNext(entropy, sizeof(entropy));
+				if (rc == 0)
+					rc = ctrdrbgReseed(dp, entropy, sizeof(entropy), (const byte*) 0, 0);
+
+				memset(entropy, 0, sizeof(entropy));
+			}
+
+			if (rc == 0)
+				rc = ctrdrbgGenerate(dp, data, chunk, (const byte*) 0, 0);
+
+			data += chunk;
+			size -= chunk;
+		}
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!ReleaseMutex(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_unlock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_unlock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return rc;
+	}
+	return -1;
+}
+
+int ctrdrbgCleanup(ctrdrbgParam* dp)
+{
+	if (dp)
+	{
+		memset(&dp->key, 0, sizeof(dp->key));
+		memset(dp->v, 0, 16);
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!CloseHandle(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_destroy(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_destroy(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return 0;
+	}
+	return -1;
+}
+
+/*!\}
+ */
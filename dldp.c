@@ -39,6 +39,17 @@
 static int dldp_pgoqGenerator_w(dldp_p*, randomGeneratorContext*, mpw*);
 static int dldp_pgonGenerator_w(dldp_p*, randomGeneratorContext*, mpw*);
 
+/*
+ * computes y = g^x mod p, using the precomputed table if there is one
+ */
+static void dldp_pPowG(const dldp_p* dp, const mpnumber* x, mpnumber* y)
+{
+	if (mpbfbmatch(&dp->gfb, &dp->p, dp->g.size, dp->g.data))
+		mpbnfbpowmod(&dp->gfb, &dp->p, x, y);
+	else
+		mpbnpowmod(&dp->p, &dp->g, x, y);
+}
+
 int dldp_pPrivate(const dldp_p* dp, randomGeneratorContext* rgc, mpnumber* x)
 {
 	/*
@@ -71,7 +82,7 @@ int dldp_pPublic(const dldp_p* dp, const mpnumber* x, mpnumber* y)
 	 * Public key y is computed as g^x mod p
 	 */
 
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pPowG(dp, x, y);
 
 	return 0;
 }
@@ -83,7 +94,7 @@ int dldp_pPair(const dldp_p* dp, randomGeneratorContext* rgc, mpnumber* x, mpnum
 	 */
 
 	mpbnrnd(&dp->q, rgc, x);
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pPowG(dp, x, y);
 
 	return 0;
 }
@@ -92,7 +103,7 @@ int dldp_pPair_s(const dldp_p* dp, randomGeneratorContext* rgc, mpnumber* x, mpn
 {
 	mpbnrnd(&dp->q, rgc, x);
 	mpntrbits(x, xbits);
-	mpbnpowmod(&dp->p, &dp->g, x, y);
+	dldp_pPowG(dp, x, y);
 
 	return 0;
 }
@@ -162,6 +173,8 @@ int dldp_pInit(dldp_p* dp)
 	mpnzero(&dp->g);
 	mpnzero(&dp->r);
 	mpbzero(&dp->n);
+	mpbfbzero(&dp->gfb);
+	mpmontzero(&dp->pm);
 
 	return 0;
 }
@@ -173,6 +186,8 @@ int dldp_pFree(dldp_p* dp)
 	mpnfree(&dp->g);
 	mpnfree(&dp->r);
 	mpbfree(&dp->n);
+	mpbfbfree(&dp->gfb);
+	mpmontfree(&dp->pm);
 
 	return 0;
 }
@@ -185,10 +200,37 @@ int dldp_pCopy(dldp_p* dst, const dldp_p* src)
 	mpncopy(&dst->g, &src->g);
 	mpbcopy(&dst->n, &src->n);
 
-	return 0;
+	if (mpmontcopy(&dst->pm, &src->pm))
+		return -1;
+
+	return mpbfbcopy(&dst->gfb, &src->gfb);
+}
+
+int dldp_pPrecompute(dldp_p* dp)
+{
+	/*
+	 * Private keys are smaller than q, the random values in ElGamal
+	 * signatures smaller than n = p-1, if that is set; exponents which turn
+	 * out to be larger are still handled, without the table
+	 */
+
+	register size_t bits = (dp->n.size) ? mpbbits(&dp->n) : mpbbits(&dp->q);
+
+	if (bits == 0)
+		bits = mpbbits(&dp->p);
+
+	if (mpmontset(&dp->pm, dp->p.size, dp->p.modl))
+		return -1;
+
+	return mpbfbinit(&dp->gfb, &dp->p, dp->g.size, dp->g.data, bits);
 }
 
 int dldp_pgoqMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t qbits, int cofactor)
+{
+	return dldp_pgoqMakeParallel(dp, rgc, pbits, qbits, cofactor, 1);
+}
+
+int dldp_pgoqMakeParallel(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t qbits, int cofactor, unsigned int workers)
 {
 	/*
 	 * Generate parameters as described by IEEE P1363, A.16.1
@@ -202,7 +244,11 @@ int dldp_pgoqMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 		mpprnd_w(&dp->q, rgc, qbits, mpptrials(qbits), (const mpnumber*) 0, temp);
 
 		/* generate p with the appropriate congruences */
-		mpprndconone_w(&dp->p, rgc, pbits, mpptrials(pbits), &dp->q, (const mpnumber*) 0, &dp->r, cofactor, temp);
+		if (mpprndcononepar(&dp->p, rgc, pbits, mpptrials(pbits), &dp->q, (const mpnumber*) 0, &dp->r, cofactor, workers))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* clear n */
 		mpbzero(&dp->n);
@@ -221,6 +267,11 @@ int dldp_pgoqMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 }
 
 int dldp_pgoqMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t bits)
+{
+	return dldp_pgoqMakeSafeParallel(dp, rgc, bits, 1);
+}
+
+int dldp_pgoqMakeSafeParallel(dldp_p* dp, randomGeneratorContext* rgc, size_t bits, unsigned int workers)
 {
 	/*
 	 * Generate parameters with a safe prime; p = 2q+1 i.e. r=2
@@ -233,7 +284,11 @@ int dldp_pgoqMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t bits)
 	if (temp)
 	{
 		/* generate p */
-		mpprndsafe_w(&dp->p, rgc, bits, mpptrials(bits), temp);
+		if (mpprndsafepar(&dp->p, rgc, bits, mpptrials(bits), workers))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* set q */
 		mpcopy(size, temp, dp->p.modl);
@@ -263,6 +318,9 @@ int dldp_pgoqGenerator_w(dldp_p* dp, randomGeneratorContext* rgc, mpw* wksp)
 
 	register size_t size = dp->p.size;
 
+	/* the table of powers of the old generator is no longer valid */
+	mpbfbfree(&dp->gfb);
+
 	mpnfree(&dp->g);
 	mpnsize(&dp->g, size);
 
@@ -315,6 +373,11 @@ int dldp_pgoqValidate(const dldp_p* dp, randomGeneratorContext* rgc, int cofacto
 }
 
 int dldp_pgonMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t qbits)
+{
+	return dldp_pgonMakeParallel(dp, rgc, pbits, qbits, 1);
+}
+
+int dldp_pgonMakeParallel(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t qbits, unsigned int workers)
 {
 	/*
 	 * Generate parameters with a prime p such that p = qr+1, with q prime, and r = 2s, with s prime
@@ -329,7 +392,11 @@ int dldp_pgonMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 		mpprnd_w(&dp->q, rgc, qbits, mpptrials(qbits), (const mpnumber*) 0, temp);
 
 		/* generate p with the appropriate congruences */
-		mpprndconone_w(&dp->p, rgc, pbits, mpptrials(pbits), &dp->q, (const mpnumber*) 0, &dp->r, 2, temp);
+		if (mpprndcononepar(&dp->p, rgc, pbits, mpptrials(pbits), &dp->q, (const mpnumber*) 0, &dp->r, 2, workers))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* set n */
 		mpbsubone(&dp->p, temp);
@@ -345,6 +412,11 @@ int dldp_pgonMake(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, size_t
 }
 
 int dldp_pgonMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits)
+{
+	return dldp_pgonMakeSafeParallel(dp, rgc, pbits, 1);
+}
+
+int dldp_pgonMakeSafeParallel(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits, unsigned int workers)
 {
 	/*
 	 * Generate parameters with a safe prime; i.e. p = 2q+1, where q is prime
@@ -356,7 +428,11 @@ int dldp_pgonMakeSafe(dldp_p* dp, randomGeneratorContext* rgc, size_t pbits)
 	if (temp)
 	{
 		/* generate safe p */
-		mpprndsafe_w(&dp->p, rgc, pbits, mpptrials(pbits), temp);
+		if (mpprndsafepar(&dp->p, rgc, pbits, mpptrials(pbits), workers))
+		{
+			free(temp);
+			return -1;
+		}
 
 		/* set n */
 		mpbsubone(&dp->p, temp);
@@ -382,6 +458,9 @@ int dldp_pgonGenerator_w(dldp_p* dp, randomGeneratorContext* rgc, mpw* wksp)
 {
 	register size_t size = dp->p.size;
 
+	/* the table of powers of the old generator is no longer valid */
+	mpbfbfree(&dp->gfb);
+
 	mpnfree(&dp->g);
 	mpnsize(&dp->g, size);
 
@@ -34,6 +34,7 @@
 #endif
 
 #include "beecrypt/dlsvdp-dh.h"
+#include "beecrypt/mpmont.h"
 
 /*!\addtogroup DL_dh_m
  * \{
@@ -46,6 +47,9 @@
  *
  * \li \f$s=y^{x}\ \textrm{mod}\ p\f$
  *
+ * The exponentiation uses the engine selected with mpengineSetup, and the
+ * Montgomery context in the parameters, if one was prepared.
+ *
  * \param dp The domain parameters.
  * \param x The private value.
  * \param y The public value (of the peer).
@@ -56,7 +60,18 @@
  */
 int dlsvdp_pDHSecret(const dhparam* dp, const mpnumber* x, const mpnumber* y, mpnumber* s)
 {
-	mpbnpowmod(&dp->p, y, x, s);
+	register size_t size = dp->p.size;
+	register mpw* temp = (mpw*) malloc((4*size+2)*sizeof(mpw));
+
+	if (temp == (mpw*) 0)
+		return -1;
+
+	mpnfree(s);
+	mpnsize(s, size);
+
+	mpenginepowmod_w(&dp->p, &dp->pm, y->size, y->data, x->size, x->data, s->data, temp);
+
+	free(temp);
 
 	return 0;
 }
@@ -30,50 +30,40 @@
 
 #include "beecrypt/dsa.h"
 #include "beecrypt/dldp.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpwksp.h"
 
-int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+/*
+ * computes the signature with either g or a table of its powers
+ */
+static int dsasign_g(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
 {
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
-
-	register mpw* pwksp;
-	register mpw* qwksp;
-
-	register int rc = -1;
-
-	ptemp = (mpw*) malloc((5*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return rc;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+5*psize+2;
 
-	qtemp = (mpw*) malloc((9*qsize+6)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
-		return rc;
-	}
-
-	pwksp = ptemp+psize;
-	qwksp = qtemp+3*qsize;
+	register mpw* pwksp = ptemp+psize;
+	register mpw* qwksp = qtemp+3*qsize;
 
 	/* allocate r */
-	mpnfree(r);
 	mpnsize(r, qsize);
 
 	/* get a random k, invertible modulo q; store k @ qtemp, inv(k) @ qtemp+qsize */
 	mpbrndinv_w(q, rgc, qtemp, qtemp+qsize, qwksp);
 
 	/* g^k mod p */
-	mpbpowmod_w(p, g->size, g->data, qsize, qtemp, ptemp, pwksp);
+	if (gfb)
+		mpbfbpowmod_w(gfb, p, qsize, qtemp, ptemp, pwksp);
+	else
+		mpenginepowmod_w(p, (const mpmont*) 0, g->size, g->data, qsize, qtemp, ptemp, pwksp);
 
 	/* (g^k mod p) mod q - simple modulo */
 	mpmod(qtemp+2*qsize, psize, ptemp, qsize, q->modl, pwksp);
 	mpcopy(qsize, r->data, qtemp+psize+qsize);
 
 	/* allocate s */
-	mpnfree(s);
 	mpnsize(s, qsize);
 
 	/* x*r mod q */
@@ -85,24 +75,52 @@ int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGen
 	/* multiply inv(k) mod q */
 	mpbmulmod_w(q, qsize, qtemp+qsize, qsize, qtemp+2*qsize, s->data, qwksp);
 
-	rc = 0;
+	return 0;
+}
 
-	free(qtemp);
-	free(ptemp);
+int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+{
+	return dsasign_g(p, q, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, wksp);
+}
+
+int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget((5*p->size+2)+(9*q->size+6));
+
+	if (temp)
+	{
+		rc = dsasign_g(p, q, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, temp);
 
+		mpwkspput(temp);
+	}
 	return rc;
 }
 
-int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+int dsasignfb(const mpbarrett* p, const mpbarrett* q, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget((5*p->size+2)+(9*q->size+6));
+
+	if (temp)
+	{
+		rc = dsasign_g(p, q, (const mpnumber*) 0, gfb, rgc, hm, x, r, s, temp);
+
+		mpwkspput(temp);
+	}
+	return rc;
+}
+
+int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
 {
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+6*psize+2;
 
-	register mpw* pwksp;
-	register mpw* qwksp;
+	register mpw* pwksp = ptemp+2*psize;
+	register mpw* qwksp = qtemp+2*qsize;
 
 	register int rc = 0;
 
@@ -124,20 +142,6 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 	if (mpgex(s->size, s->data, qsize, q->modl))
 		return rc;
 
-	ptemp = (mpw*) malloc((6*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return rc;
-
-	qtemp = (mpw*) malloc((8*qsize+6)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
-		return rc;
-	}
-
-	pwksp = ptemp+2*psize;
-	qwksp = qtemp+2*qsize;
-
 	mpsetx(qsize, qtemp+qsize, s->size, s->data);
 
 	/* compute w = inv(s) mod q */
@@ -149,14 +153,8 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 		/* compute u2 = r*w mod q */
 		mpbmulmod_w(q, r->size, r->data, qsize, qtemp, qtemp, qwksp);
 
-		/* compute g^u1 mod p */
-		mpbpowmod_w(p, g->size, g->data, qsize, qtemp+qsize, ptemp, pwksp);
-
-		/* compute y^u2 mod p */
-		mpbpowmod_w(p, y->size, y->data, qsize, qtemp, ptemp+psize, pwksp);
-
-		/* multiply mod p */
-		mpbmulmod_w(p, psize, ptemp, psize, ptemp+psize, ptemp, pwksp);
+		/* compute g^u1 * y^u2 mod p */
+		mpbsm2powmod_w(p, g->size, g->data, qsize, qtemp+qsize, y->size, y->data, qsize, qtemp, ptemp, pwksp);
 
 		/* modulo q */
 		mpmod(ptemp+psize, psize, ptemp, qsize, q->modl, pwksp);
@@ -164,13 +162,29 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 		rc = mpeqx(r->size, r->data, psize, ptemp+psize);
 	}
 
-	free(qtemp);
-	free(ptemp);
+	return rc;
+}
+
+int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+{
+	register int rc = 0;
+	register mpw* temp = mpwkspget((6*p->size+2)+(8*q->size+6));
 
+	if (temp)
+	{
+		rc = dsavrfy_w(p, q, g, hm, y, r, s, temp);
+
+		mpwkspput(temp);
+	}
 	return rc;
 }
 
 int dsaparamMake(dsaparam* dp, randomGeneratorContext* rgc, size_t psize)
+{
+	return dsaparamMakeParallel(dp, rgc, psize, 1);
+}
+
+int dsaparamMakeParallel(dsaparam* dp, randomGeneratorContext* rgc, size_t psize, unsigned int workers)
 {
 	/* psize must be >= 512 and <= 1024 */
 	if ((psize < 512) || (psize > 1024))
@@ -180,5 +194,5 @@ int dsaparamMake(dsaparam* dp, randomGeneratorContext* rgc, size_t psize)
 	if ((psize & 0x3f) != 0)
 		return -1;
 
-	return dldp_pgoqMake(dp, rgc, psize, 160, 1);
+	return dldp_pgoqMakeParallel(dp, rgc, psize, 160, 1, workers);
 }
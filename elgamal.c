@@ -30,48 +30,77 @@
 
 #include "beecrypt/elgamal.h"
 #include "beecrypt/dldp.h"
+#include "beecrypt/mpwksp.h"
 
-int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+static void elgv1sign_g(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* temp)
 {
 	register size_t size = p->size;
-	register mpw* temp = (mpw*) malloc((8*size+6)*sizeof(mpw));
 
-	if (temp)
-	{
-		/* get a random k, invertible modulo (p-1) */
-		mpbrndinv_w(n, rgc, temp, temp+size, temp+2*size);
+	/* get a random k, invertible modulo (p-1) */
+	mpbrndinv_w(n, rgc, temp, temp+size, temp+2*size);
 
-		/* compute r = g^k mod p */
-		mpnfree(r);
-		mpnsize(r, size);
+	/* compute r = g^k mod p */
+	mpnsize(r, size);
+	if (gfb)
+		mpbfbpowmod_w(gfb, p, size, temp, r->data, temp+2*size);
+	else
 		mpbpowmod_w(p, g->size, g->data, size, temp, r->data, temp+2*size);
 
-		/* compute x*r mod n */
-		mpbmulmod_w(n, x->size, x->data, r->size, r->data, temp, temp+2*size);
+	/* compute x*r mod n */
+	mpbmulmod_w(n, x->size, x->data, r->size, r->data, temp, temp+2*size);
+
+	/* compute -(x*r) mod n */
+	mpneg(size, temp);
+	mpadd(size, temp, n->modl);
+
+	/* compute h(m) - x*r mod n */
+	mpbaddmod_w(n, hm->size, hm->data, size, temp, temp, temp+2*size);
+
+	/* compute s = inv(k)*(h(m) - x*r) mod n */
+	mpnsize(s, size);
+	mpbmulmod_w(n, size, temp, size, temp+size, s->data, temp+2*size);
+}
+
+int elgv1sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+{
+	elgv1sign_g(p, n, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, wksp);
 
-		/* compute -(x*r) mod n */
-		mpneg(size, temp);
-		mpadd(size, temp, n->modl);
+	return 0;
+}
 
-		/* compute h(m) - x*r mod n */
-		mpbaddmod_w(n, hm->size, hm->data, size, temp, temp, temp+2*size);
+int elgv1sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register mpw* temp = mpwkspget(8*p->size+6);
 
-		/* compute s = inv(k)*(h(m) - x*r) mod n */
-		mpnfree(s);
-		mpnsize(s, size);
-		mpbmulmod_w(n, size, temp, size, temp+size, s->data, temp+2*size);
+	if (temp)
+	{
+		elgv1sign_g(p, n, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, temp);
 
-		free(temp);
+		mpwkspput(temp);
 
 		return 0;
 	}
 	return -1;
 }
 
-int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+int elgv1signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register mpw* temp = mpwkspget(8*p->size+6);
+
+	if (temp)
+	{
+		elgv1sign_g(p, n, (const mpnumber*) 0, gfb, rgc, hm, x, r, s, temp);
+
+		mpwkspput(temp);
+
+		return 0;
+	}
+	return -1;
+}
+
+int elgv1vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
 {
 	register size_t size = p->size;
-	register mpw* temp;
 
 	if (mpz(r->size, r->data))
 		return 0;
@@ -85,70 +114,94 @@ int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 	if (mpgex(s->size, s->data, n->size, n->modl))
 		return 0;
 
-	temp = (mpw*) malloc((6*size+2)*sizeof(mpw));
+	/* compute v1 = y^r * r^s mod p */
+	mpbsm2powmod_w(p, y->size, y->data, r->size, r->data, r->size, r->data, s->size, s->data, wksp+size, wksp+2*size);
+
+	/* compute v2 = g^h(m) mod p */
+	mpbpowmod_w(p, g->size, g->data, hm->size, hm->data, wksp, wksp+2*size);
+
+	return mpeq(size, wksp, wksp+size);
+}
+
+int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+{
+	register int rc = 0;
+	register mpw* temp = mpwkspget(6*p->size+2);
 
 	if (temp)
 	{
-		register int rc;
+		rc = elgv1vrfy_w(p, n, g, hm, y, r, s, temp);
 
-		/* compute u1 = y^r mod p */
-		mpbpowmod_w(p, y->size, y->data, r->size, r->data, temp, temp+2*size);
+		mpwkspput(temp);
+	}
+	return rc;
+}
 
-		/* compute u2 = r^s mod p */
-		mpbpowmod_w(p, r->size, r->data, s->size, s->data, temp+size, temp+2*size);
+static void elgv3sign_g(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* temp)
+{
+	register size_t size = p->size;
 
-		/* compute v1 = u1*u2 mod p */
-		mpbmulmod_w(p, size, temp, size, temp+size, temp+size, temp+2*size);
+	/* get a random k */
+	mpbrnd_w(p, rgc, temp, temp+2*size);
 
-		/* compute v2 = g^h(m) mod p */
-		mpbpowmod_w(p, g->size, g->data, hm->size, hm->data, temp, temp+2*size);
+	/* compute r = g^k mod p */
+	mpnsize(r, size);
+	if (gfb)
+		mpbfbpowmod_w(gfb, p, size, temp, r->data, temp+2*size);
+	else
+		mpbpowmod_w(p, g->size, g->data, size, temp, r->data, temp+2*size);
 
-		rc = mpeq(size, temp, temp+size);
+	/* compute u1 = x*r mod n */
+	mpbmulmod_w(n, x->size, x->data, size, r->data, temp+size, temp+2*size);
 
-		free(temp);
+	/* compute u2 = k*h(m) mod n */
+	mpbmulmod_w(n, size, temp, hm->size, hm->data, temp, temp+2*size);
+
+	/* compute s = u1+u2 mod n */
+	mpnsize(s, n->size);
+	mpbaddmod_w(n, size, temp, size, temp+size, s->data, temp+2*size);
+}
+
+int elgv3sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+{
+	elgv3sign_g(p, n, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, wksp);
 
-		return rc;
-	}
 	return 0;
 }
 
 int elgv3sign(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
 {
-	register size_t size = p->size;
-	register mpw* temp = (mpw*) malloc((6*size+2)*sizeof(mpw));
+	register mpw* temp = mpwkspget(6*p->size+2);
 
 	if (temp)
 	{
-		/* get a random k */
-		mpbrnd_w(p, rgc, temp, temp+2*size);
+		elgv3sign_g(p, n, g, (const mpbfixedbase*) 0, rgc, hm, x, r, s, temp);
 
-		/* compute r = g^k mod p */
-		mpnfree(r);
-		mpnsize(r, size);
-		mpbpowmod_w(p, g->size, g->data, size, temp, r->data, temp+2*size);
+		mpwkspput(temp);
 
-		/* compute u1 = x*r mod n */
-		mpbmulmod_w(n, x->size, x->data, size, r->data, temp+size, temp+2*size);
+		return 0;
+	}
+	return -1;
+}
 
-		/* compute u2 = k*h(m) mod n */
-		mpbmulmod_w(n, size, temp, hm->size, hm->data, temp, temp+2*size);
+int elgv3signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+{
+	register mpw* temp = mpwkspget(6*p->size+2);
 
-		/* compute s = u1+u2 mod n */
-		mpnfree(s);
-		mpnsize(s, n->size);
-		mpbaddmod_w(n, size, temp, size, temp+size, s->data, temp+2*size);
+	if (temp)
+	{
+		elgv3sign_g(p, n, (const mpnumber*) 0, gfb, rgc, hm, x, r, s, temp);
 
-		free(temp);
+		mpwkspput(temp);
 
 		return 0;
 	}
 	return -1;
 }
 
-int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+int elgv3vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
 {
 	register size_t size = p->size;
-	register mpw* temp;
 
 	if (mpz(r->size, r->data))
 		return 0;
@@ -162,31 +215,27 @@ int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 	if (mpgex(s->size, s->data, n->size, n->modl))
 		return 0;
 
-	temp = (mpw*) malloc((6*size+2)*sizeof(mpw));
-
-	if (temp)
-	{
-		register int rc;
-
-		/* compute u1 = y^r mod p */
-		mpbpowmod_w(p, y->size, y->data, r->size, r->data, temp, temp+2*size);
-
-		/* compute u2 = r^h(m) mod p */
-		mpbpowmod_w(p, r->size, r->data, hm->size, hm->data, temp+size, temp+2*size);
+	/* compute v2 = y^r * r^h(m) mod p */
+	mpbsm2powmod_w(p, y->size, y->data, r->size, r->data, r->size, r->data, hm->size, hm->data, wksp+size, wksp+2*size);
 
-		/* compute v2 = u1*u2 mod p */
-		mpbmulmod_w(p, size, temp, size, temp+size, temp+size, temp+2*size);
+	/* compute v1 = g^s mod p */
+	mpbpowmod_w(p, g->size, g->data, s->size, s->data, wksp, wksp+2*size);
 
-		/* compute v1 = g^s mod p */
-		mpbpowmod_w(p, g->size, g->data, s->size, s->data, temp, temp+2*size);
+	return mpeq(size, wksp, wksp+size);
+}
 
-		rc = mpeq(size, temp, temp+size);
+int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
+{
+	register int rc = 0;
+	register mpw* temp = mpwkspget(6*p->size+2);
 
-		free(temp);
+	if (temp)
+	{
+		rc = elgv3vrfy_w(p, n, g, hm, y, r, s, temp);
 
-		return rc;
+		mpwkspput(temp);
 	}
-	return 0;
+	return rc;
 }
 
 /*!\}
@@ -19,7 +19,7 @@
 
 /*!\file entropy.c
  * \author Bob Deblier <bob.deblier@telenet.be>
- * \ingroup ES_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
+ * \ingroup ES_m ES_getrandom_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
  */
 
 #define BEECRYPT_DLL_EXPORT
@@ -30,6 +30,7 @@
 
 #include "beecrypt/entropy.h"
 #include "beecrypt/endianness.h"
+#include "beecrypt/cpu.h"
 
 #if WIN32
 # include <mmsystem.h>
@@ -74,10 +75,16 @@
 # if HAVE_AIO_H
 #  include <aio.h>
 # endif
+# if HAVE_GETRANDOM
+#  include <sys/random.h>
+# endif
 #endif
 #if HAVE_FCNTL_H
 # include <fcntl.h>
 #endif
+#if HAVE_UNISTD_H
+# include <unistd.h>
+#endif
 #if HAVE_ERRNO_H
 # include <errno.h>
 #endif
@@ -714,6 +721,33 @@ int entropy_wincrypt(byte* data, size_t size)
 
 #else
 
+#if HAVE_GETRANDOM
+/*!\addtogroup ES_getrandom_m
+ * \{
+ */
+#define GETRANDOM_POOL_SIZE	256
+
+/* the bytes which haven't been handed out yet are at the end of the pool */
+static byte getrandom_pool[GETRANDOM_POOL_SIZE];
+static size_t getrandom_avail = 0;
+# ifdef _REENTRANT
+#  if HAVE_THREAD_H && HAVE_SYNCH_H
+static mutex_t getrandom_lock = DEFAULTMUTEX;
+#  elif HAVE_PTHREAD_H
+#   define GETRANDOM_ATFORK	1
+static pthread_mutex_t getrandom_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t getrandom_once = PTHREAD_ONCE_INIT;
+#  else
+#   error Need locking mechanism
+#  endif
+# endif
+# if !GETRANDOM_ATFORK
+static pid_t getrandom_pid = 0;
+# endif
+/*!\}
+ */
+#endif
+
 #if HAVE_DEV_AUDIO
 /*!\addtogroup ES_audio_m
  * \{
@@ -1076,6 +1110,200 @@ static int entropy_ttybits(int fd, byte* data, size_t size)
 }
 #endif
 
+#if HAVE_GETRANDOM
+/* a child process must never hand out the bytes which its parent still
+ * has in the pool
+ */
+# if GETRANDOM_ATFORK
+static void getrandom_prepare(void)
+{
+	pthread_mutex_lock(&getrandom_lock);
+}
+
+static void getrandom_parent(void)
+{
+	pthread_mutex_unlock(&getrandom_lock);
+}
+
+static void getrandom_child(void)
+{
+	memset(getrandom_pool, 0, sizeof(getrandom_pool));
+	getrandom_avail = 0;
+
+	pthread_mutex_unlock(&getrandom_lock);
+}
+
+static void getrandom_init(void)
+{
+	pthread_atfork(getrandom_prepare, getrandom_parent, getrandom_child);
+}
+# endif
+
+static int getrandom_fill(byte* data, size_t size)
+{
+	while (size > 0)
+	{
+		ssize_t rc = getrandom(data, size, GRND_NONBLOCK);
+
+		if (rc < 0)
+		{
+			#if HAVE_ERRNO_H
+			if (errno == EINTR)
+				continue;
+			#endif
+			return -1;
+		}
+
+		data += rc;
+		size -= rc;
+	}
+
+	return 0;
+}
+
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/* these instructions clear the carry flag when the hardware has
+ * momentarily run out of values; they are then retried a few times
+ */
+static int cpu_rdseed(unsigned long* r)
+{
+	register int i;
+	unsigned char ok;
+
+	for (i = 0; i < 16; i++)
+	{
+		__asm__ __volatile__ ("rdseed %0; setc %1" : "=r" (*r), "=qm" (ok) : : "cc");
+		if (ok)
+			return 0;
+	}
+	return -1;
+}
+
+static int cpu_rdrand(unsigned long* r)
+{
+	register int i;
+	unsigned char ok;
+
+	for (i = 0; i < 10; i++)
+	{
+		__asm__ __volatile__ ("rdrand %0; setc %1" : "=r" (*r), "=qm" (ok) : : "cc");
+		if (ok)
+			return 0;
+	}
+	return -1;
+}
+
+/* the processor's output is added with exclusive-or, which can't take away
+ * from what the kernel delivered, even if the instructions can't be trusted;
+ * RDRAND is preferred, since RDSEED is many times slower, and the kernel's
+ * output needs no further conditioning
+ */
+static void getrandom_mix(byte* data, size_t size)
+{
+	register uint32_t features = cpuFeatures();
+	int (*next)(unsigned long*);
+
+	if (features & CPU_FEATURE_RDRAND)
+		next = cpu_rdrand;
+	else if (features & CPU_FEATURE_RDSEED)
+		next = cpu_rdseed;
+	else
+		return;
+
+	while (size > 0)
+	{
+		unsigned long r;
+		register size_t i, len = size > sizeof(r) ? sizeof(r) : size;
+
+		/* if the hardware keeps failing, the kernel's output stands alone */
+		if (next(&r))
+			break;
+
+		for (i = 0; i < len; i++, r >>= 8)
+			data[i] ^= (byte) r;
+
+		data += len;
+		size -= len;
+	}
+}
+# else
+#  define getrandom_mix(data, size)
+# endif
+
+/*!\ingroup ES_getrandom_m
+ */
+int entropy_getrandom(byte* data, size_t size)
+{
+	register int rc = 0;
+
+	/* big requests gain nothing from the pool */
+	if (size >= GETRANDOM_POOL_SIZE / 4)
+		rc = getrandom_fill(data, size);
+	else
+	{
+		byte* dst = data;
+		size_t remain = size;
+
+		#ifdef _REENTRANT
+		# if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&getrandom_lock))
+			return -1;
+		# elif HAVE_PTHREAD_H
+		if (pthread_once(&getrandom_once, getrandom_init))
+			return -1;
+		if (pthread_mutex_lock(&getrandom_lock))
+			return -1;
+		# endif
+		#endif
+
+		#if !GETRANDOM_ATFORK
+		if (getrandom_pid != getpid())
+		{
+			getrandom_pid = getpid();
+			getrandom_avail = 0;
+		}
+		#endif
+
+		while (remain > 0)
+		{
+			byte* src;
+			size_t len;
+
+			if (getrandom_avail == 0)
+			{
+				if ((rc = getrandom_fill(getrandom_pool, GETRANDOM_POOL_SIZE)))
+					break;
+
+				getrandom_avail = GETRANDOM_POOL_SIZE;
+			}
+
+			len = remain > getrandom_avail ? getrandom_avail : remain;
+			src = getrandom_pool + GETRANDOM_POOL_SIZE - getrandom_avail;
+
+			memcpy(dst, src, len);
+			memset(src, 0, len);
+
+			getrandom_avail -= len;
+			dst += len;
+			remain -= len;
+		}
+
+		#ifdef _REENTRANT
+		# if HAVE_THREAD_H && HAVE_SYNCH_H
+		mutex_unlock(&getrandom_lock);
+		# elif HAVE_PTHREAD_H
+		pthread_mutex_unlock(&getrandom_lock);
+		# endif
+		#endif
+	}
+
+	if (rc == 0)
+		getrandom_mix(data, size);
+
+	return rc;
+}
+#endif
+
 #if HAVE_DEV_AUDIO
 /*!\ingroup ES_audio_m
  */
@@ -31,6 +31,13 @@
 
 #include "beecrypt/fips186.h"
 
+#if ENABLE_THREAD_LOCAL_STORAGE
+# if defined(_REENTRANT) && HAVE_PTHREAD_H && !(HAVE_THREAD_H && HAVE_SYNCH_H)
+#  include <pthread.h>
+#  define FIPS186_PER_THREAD	1
+# endif
+#endif
+
 /*!\addtogroup PRNG_fips186_m
  * \{
  */
@@ -46,12 +53,101 @@ const randomGenerator fips186prng = {
 	(randomGeneratorCleanup) fips186Cleanup
 };
 
+static int fips186ptSetup  (fips186Param*);
+static int fips186ptSeed   (fips186Param*, const byte*, size_t);
+static int fips186ptNext   (fips186Param*, byte*, size_t);
+static int fips186ptCleanup(fips186Param*);
+
+const randomGenerator fips186ptprng = {
+	"FIPS 186 per thread",
+	sizeof(fips186Param),
+	(randomGeneratorSetup) fips186ptSetup,
+	(randomGeneratorSeed) fips186ptSeed,
+	(randomGeneratorNext) fips186ptNext,
+	(randomGeneratorCleanup) fips186ptCleanup
+};
+
 static int fips186init(register sha1Param* p)
 {
 	memcpy(p->h, fips186hinit, 5 * sizeof(uint32_t));
 	return 0;
 }
 
+/* adds the seed data to the state; the caller holds the lock */
+static void fips186Stir(fips186Param* fp, const byte* data, size_t size)
+{
+	mpw seed[FIPS186_STATE_SIZE];
+
+	/* if there's too much data, cut off at what we can deal with */
+	if (size > MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE))
+		size = MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE);
+
+	/* convert to multi-precision integer, and add to the state */
+	if (os2ip(seed, FIPS186_STATE_SIZE, data, size) == 0)
+		mpadd(FIPS186_STATE_SIZE, fp->state, seed);
+}
+
+/* generates the requested data; the caller holds the lock */
+static void fips186Generate(fips186Param* fp, byte* data, size_t size)
+{
+	mpw dig[FIPS186_STATE_SIZE];
+
+	while (size > 0)
+	{
+		register size_t copy;
+
+		if (fp->digestremain == 0)
+		{
+			fips186init(&fp->param);
+			/* copy the 512 bits of state data into the sha1Param */
+			memcpy(fp->param.data, fp->state, MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE));
+			/* process the data */
+			sha1Process(&fp->param);
+			
+			#if WORDS_BIGENDIAN
+			memcpy(fp->digest, fp->param.h, 20);
+			#else
+			/* encode 5 integers big-endian style */
+			fp->digest[ 0] = (byte)(fp->param.h[0] >> 24);
+			fp->digest[ 1] = (byte)(fp->param.h[0] >> 16);
+			fp->digest[ 2] = (byte)(fp->param.h[0] >>  8);
+			fp->digest[ 3] = (byte)(fp->param.h[0] >>  0);
+			fp->digest[ 4] = (byte)(fp->param.h[1] >> 24);
+			fp->digest[ 5] = (byte)(fp->param.h[1] >> 16);
+			fp->digest[ 6] = (byte)(fp->param.h[1] >>  8);
+			fp->digest[ 7] = (byte)(fp->param.h[1] >>  0);
+			fp->digest[ 8] = (byte)(fp->param.h[2] >> 24);
+			fp->digest[ 9] = (byte)(fp->param.h[2] >> 16);
+			fp->digest[10] = (byte)(fp->param.h[2] >>  8);
+			fp->digest[11] = (byte)(fp->param.h[2] >>  0);
+			fp->digest[12] = (byte)(fp->param.h[3] >> 24);
+			fp->digest[13] = (byte)(fp->param.h[3] >> 16);
+			fp->digest[14] = (byte)(fp->param.h[3] >>  8);
+			fp->digest[15] = (byte)(fp->param.h[3] >>  0);
+			fp->digest[16] = (byte)(fp->param.h[4] >> 24);
+			fp->digest[17] = (byte)(fp->param.h[4] >> 16);
+			fp->digest[18] = (byte)(fp->param.h[4] >>  8);
+			fp->digest[19] = (byte)(fp->param.h[4] >>  0);
+			#endif
+
+			if (os2ip(dig, FIPS186_STATE_SIZE, fp->digest, 20) == 0)
+			{
+				/* set state to state + digest + 1 mod 2^512 */
+				mpadd (FIPS186_STATE_SIZE, fp->state, dig);
+				mpaddw(FIPS186_STATE_SIZE, fp->state, 1);
+			}
+			/* else shouldn't occur */
+			/* we now have 5 words of pseudo-random data */
+			fp->digestremain = 20;
+		}
+		copy = (size > fp->digestremain) ? fp->digestremain : size;
+		memcpy(data, fp->digest+20-fp->digestremain, copy);
+		fp->digestremain -= copy;
+		size -= copy;
+		data += copy;
+	}
+}
+
 int fips186Setup(fips186Param* fp)
 {
 	if (fp)
@@ -97,17 +193,7 @@ int fips186Seed(fips186Param* fp, const byte* data, size_t size)
 		# endif
 		#endif
 		if (data)
-		{
-			mpw seed[FIPS186_STATE_SIZE];
-
-			/* if there's too much data, cut off at what we can deal with */
-			if (size > MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE))
-				size = MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE);
-
-			/* convert to multi-precision integer, and add to the state */
-			if (os2ip(seed, FIPS186_STATE_SIZE, data, size) == 0)
-				mpadd(FIPS186_STATE_SIZE, fp->state, seed);
-		}
+			fips186Stir(fp, data, size);
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(fp->lock))
@@ -131,8 +217,6 @@ int fips186Next(fips186Param* fp, byte* data, size_t size)
 {
 	if (fp)
 	{
-		mpw dig[FIPS186_STATE_SIZE];
-
 		#ifdef _REENTRANT
 		# if WIN32
 		if (WaitForSingleObject(fp->lock, INFINITE) != WAIT_OBJECT_0)
@@ -148,60 +232,8 @@ int fips186Next(fips186Param* fp, byte* data, size_t size)
 		# endif
 		#endif
 
-		while (size > 0)
-		{
-			register size_t copy;
+		fips186Generate(fp, data, size);
 
-			if (fp->digestremain == 0)
-			{
-				fips186init(&fp->param);
-				/* copy the 512 bits of state data into the sha1Param */
-				memcpy(fp->param.data, fp->state, MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE));
-				/* process the data */
-				sha1Process(&fp->param);
-				
-				#if WORDS_BIGENDIAN
-				memcpy(fp->digest, fp->param.h, 20);
-				#else
-				/* encode 5 integers big-endian style */
-				fp->digest[ 0] = (byte)(fp->param.h[0] >> 24);
-				fp->digest[ 1] = (byte)(fp->param.h[0] >> 16);
-				fp->digest[ 2] = (byte)(fp->param.h[0] >>  8);
-				fp->digest[ 3] = (byte)(fp->param.h[0] >>  0);
-				fp->digest[ 4] = (byte)(fp->param.h[1] >> 24);
-				fp->digest[ 5] = (byte)(fp->param.h[1] >> 16);
-				fp->digest[ 6] = (byte)(fp->param.h[1] >>  8);
-				fp->digest[ 7] = (byte)(fp->param.h[1] >>  0);
-				fp->digest[ 8] = (byte)(fp->param.h[2] >> 24);
-				fp->digest[ 9] = (byte)(fp->param.h[2] >> 16);
-				fp->digest[10] = (byte)(fp->param.h[2] >>  8);
-				fp->digest[11] = (byte)(fp->param.h[2] >>  0);
-				fp->digest[12] = (byte)(fp->param.h[3] >> 24);
-				fp->digest[13] = (byte)(fp->param.h[3] >> 16);
-				fp->digest[14] = (byte)(fp->param.h[3] >>  8);
-				fp->digest[15] = (byte)(fp->param.h[3] >>  0);
-				fp->digest[16] = (byte)(fp->param.h[4] >> 24);
-				fp->digest[17] = (byte)(fp->param.h[4] >> 16);
-				fp->digest[18] = (byte)(fp->param.h[4] >>  8);
-				fp->digest[19] = (byte)(fp->param.h[4] >>  0);
-				#endif
-
-				if (os2ip(dig, FIPS186_STATE_SIZE, fp->digest, 20) == 0)
-				{
-					/* set state to state + digest + 1 mod 2^512 */
-					mpadd (FIPS186_STATE_SIZE, fp->state, dig);
-					mpaddw(FIPS186_STATE_SIZE, fp->state, 1);
-				}
-				/* else shouldn't occur */
-				/* we now have 5 words of pseudo-random data */
-				fp->digestremain = 20;
-			}
-			copy = (size > fp->digestremain) ? fp->digestremain : size;
-			memcpy(data, fp->digest+20-fp->digestremain, copy);
-			fp->digestremain -= copy;
-			size -= copy;
-			data += copy;
-		}
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(fp->lock))
@@ -244,5 +276,164 @@ int fips186Cleanup(fips186Param* fp)
 	return -1;
 }
 
+#if FIPS186_PER_THREAD
+/* every thread runs its own generator, without locking; it takes its
+ * initial state from a shared root generator, which is the only one that
+ * needs the lock; after a fork the child's threads all take a new state
+ * from the root, which first stirs in fresh entropy, so that parent and
+ * child never produce the same output
+ */
+static fips186Param _fips186root;
+static int _fips186rootrc = -1;
+static volatile int _fips186rootstir = 0;
+static pthread_once_t _fips186once = PTHREAD_ONCE_INIT;
+
+/* bumped in the child after every fork */
+static volatile unsigned int _fips186generation = 1;
+
+static __thread fips186Param _fips186pt;
+static __thread unsigned int _fips186ptgeneration = 0;
+
+/* wipes a thread's state when it exits */
+static pthread_key_t _fips186key;
+
+static void fips186ptexit(void* state)
+{
+	memset(state, 0, sizeof(fips186Param));
+	_fips186ptgeneration = 0;
+}
+
+static void fips186prepare(void)
+{
+	pthread_mutex_lock(&_fips186root.lock);
+}
+
+static void fips186parent(void)
+{
+	pthread_mutex_unlock(&_fips186root.lock);
+}
+
+static void fips186child(void)
+{
+	pthread_mutex_unlock(&_fips186root.lock);
+
+	_fips186rootstir = 1;
+	_fips186generation++;
+}
+
+static void fips186rootinit(void)
+{
+	_fips186rootrc = fips186Setup(&_fips186root);
+
+	if (_fips186rootrc == 0)
+		_fips186rootrc = pthread_key_create(&_fips186key, fips186ptexit);
+
+	if (_fips186rootrc == 0)
+		pthread_atfork(fips186prepare, fips186parent, fips186child);
+}
+
+static fips186Param* fips186ptState(void)
+{
+	if (_fips186ptgeneration != _fips186generation)
+	{
+		unsigned int generation = _fips186generation;
+
+		pthread_once(&_fips186once, fips186rootinit);
+
+		if (_fips186rootrc)
+			return (fips186Param*) 0;
+
+		if (pthread_mutex_lock(&_fips186root.lock))
+			return (fips186Param*) 0;
+
+		if (_fips186rootstir)
+		{
+			byte entropy[MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE)];
+
+			/* without fresh entropy the child would repeat the parent's
+			 * output; fail, and try again on the next call
+			 */
+			if (entropyGatherNext(entropy, sizeof(entropy)))
+			{
+				pthread_mutex_unlock(&_fips186root.lock);
+				return (fips186Param*) 0;
+			}
+
+			fips186Stir(&_fips186root, entropy, sizeof(entropy));
+			_fips186rootstir = 0;
+
+			memset(entropy, 0, sizeof(entropy));
+		}
+
+		fips186Generate(&_fips186root, (byte*) _fips186pt.state, MP_WORDS_TO_BYTES(FIPS186_STATE_SIZE));
+
+		pthread_mutex_unlock(&_fips186root.lock);
+
+		if (_fips186ptgeneration == 0)
+			pthread_setspecific(_fips186key, (void*) &_fips186pt);
+
+		_fips186pt.digestremain = 0;
+		_fips186ptgeneration = generation;
+	}
+	return &_fips186pt;
+}
+
+static int fips186ptSetup(fips186Param* fp)
+{
+	return fips186ptState() ? 0 : -1;
+}
+
+static int fips186ptSeed(fips186Param* fp, const byte* data, size_t size)
+{
+	fips186Param* pt = fips186ptState();
+
+	if (pt == (fips186Param*) 0)
+		return -1;
+
+	if (data)
+		fips186Stir(pt, data, size);
+
+	return 0;
+}
+
+static int fips186ptNext(fips186Param* fp, byte* data, size_t size)
+{
+	fips186Param* pt = fips186ptState();
+
+	if (pt == (fips186Param*) 0)
+		return -1;
+
+	fips186Generate(pt, data, size);
+
+	return 0;
+}
+
+static int fips186ptCleanup(fips186Param* fp)
+{
+	return 0;
+}
+#else
+/* without thread-local storage, each context gets its own locked generator */
+static int fips186ptSetup(fips186Param* fp)
+{
+	return fips186Setup(fp);
+}
+
+static int fips186ptSeed(fips186Param* fp, const byte* data, size_t size)
+{
+	return fips186Seed(fp, data, size);
+}
+
+static int fips186ptNext(fips186Param* fp, byte* data, size_t size)
+{
+	return fips186Next(fp, data, size);
+}
+
+static int fips186ptCleanup(fips186Param* fp)
+{
+	return fips186Cleanup(fp);
+}
+#endif
+
 /*!\}
  */
@@ -249,3 +249,94 @@ LOCAL(mpaddsqrtrc_loop):
 	movq %r8,%rax
 	ret
 C_FUNCTION_END(mpaddsqrtrc)
+
+
+dnl  mpmontmul(size, result, xdata, ydata, modl, minv)
+dnl  fused word-by-word multiply and Montgomery reduction (CIOS);
+dnl  result = x*y/(2^64)^size, returned carry is the top bit of result
+C_FUNCTION_BEGIN(mpmontmul)
+	pushq %rbx
+	pushq %rbp
+	pushq %r12
+	pushq %r13
+	pushq %r14
+	pushq %r15
+
+	movq %rdx,%r10
+	movq %rcx,%r11
+
+	movq %rdi,%rcx
+	movq %rsi,%rdx
+	xorq %rax,%rax
+	pushq %rdi
+	movq %rdx,%rdi
+	rep stosq
+	popq %rdi
+
+	xorq %rcx,%rcx
+	movq %rdi,%r12
+
+	.align 4
+LOCAL(mpmontmul_outer):
+	decq %r12
+	js LOCAL(mpmontmul_done)
+	movq (%r11,%r12,8),%r14
+
+	leaq -1(%rdi),%r13
+	movq (%r10,%r13,8),%rax
+	mulq %r14
+	addq (%rsi,%r13,8),%rax
+	adcq `$'0,%rdx
+	movq %rdx,%rbx
+	movq %rax,%rbp
+	imulq %r9,%rax
+	movq %rax,%r15
+	mulq (%r8,%r13,8)
+	addq %rbp,%rax
+	adcq `$'0,%rdx
+	movq %rdx,%rbp
+
+	.align 4
+LOCAL(mpmontmul_inner):
+	decq %r13
+	js LOCAL(mpmontmul_top)
+	movq (%r10,%r13,8),%rax
+	mulq %r14
+	addq %rbx,%rax
+	adcq `$'0,%rdx
+	addq (%rsi,%r13,8),%rax
+	adcq `$'0,%rdx
+	movq %rdx,%rbx
+	movq %rax,(%rsi,%r13,8)
+	movq (%r8,%r13,8),%rax
+	mulq %r15
+	addq %rbp,%rax
+	adcq `$'0,%rdx
+	addq (%rsi,%r13,8),%rax
+	adcq `$'0,%rdx
+	movq %rdx,%rbp
+	movq %rax,8(%rsi,%r13,8)
+	jmp LOCAL(mpmontmul_inner)
+
+LOCAL(mpmontmul_top):
+	xorq %rdx,%rdx
+	movq %rcx,%rax
+	addq %rbx,%rax
+	adcq `$'0,%rdx
+	addq %rbp,%rax
+	adcq `$'0,%rdx
+	movq %rax,(%rsi)
+	movq %rdx,%rcx
+	jmp LOCAL(mpmontmul_outer)
+
+LOCAL(mpmontmul_done):
+	movq %rcx,%rax
+
+	popq %r15
+	popq %r14
+	popq %r13
+	popq %r12
+	popq %rbp
+	popq %rbx
+	ret
+C_FUNCTION_END(mpmontmul)
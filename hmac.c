@@ -118,5 +118,53 @@ int hmacDigest(const byte* kxo, const hashFunction* hash, hashFunctionParam* par
 	return 0;
 }
 
+int hmacSetupState(byte* kxi, byte* kxo, hashFunctionParam* istate, hashFunctionParam* ostate, const hashFunction* hash, hashFunctionParam* param, const byte* key, size_t keybits)
+{
+	if (hmacSetup(kxi, kxo, hash, param, key, keybits))
+		return -1;
+
+	if (hash->copy == (hashFunctionCopy) 0)
+		return 0;
+
+	/* param has absorbed kxi */
+	if (hash->copy(istate, param))
+		return -1;
+
+	if (hash->reset(param))
+		return -1;
+	if (hash->update(param, kxo, hash->blocksize))
+		return -1;
+	if (hash->copy(ostate, param))
+		return -1;
+
+	return hash->copy(param, istate);
+}
+
+int hmacResetState(const byte* kxi, const hashFunctionParam* istate, const hashFunction* hash, hashFunctionParam* param)
+{
+	if (hash->copy == (hashFunctionCopy) 0)
+		return hmacReset(kxi, hash, param);
+
+	return hash->copy(param, istate);
+}
+
+int hmacDigestState(const byte* kxo, const hashFunctionParam* istate, const hashFunctionParam* ostate, const hashFunction* hash, hashFunctionParam* param, byte* data)
+{
+	if (hash->copy == (hashFunctionCopy) 0)
+		return hmacDigest(kxo, hash, param, data);
+
+	if (hash->digest(param, data))
+		return -1;
+	if (hash->copy(param, ostate))
+		return -1;
+	if (hash->update(param, data, hash->digestsize))
+		return -1;
+	if (hash->digest(param, data))
+		return -1;
+
+	/* ready for the next message */
+	return hash->copy(param, istate);
+}
+
 /*!\}
  */
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file hmacdrbg.c
+ * \brief NIST SP 800-90A HMAC_DRBG pseudo-random number generator.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup PRNG_m PRNG_hmacdrbg_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/hmacdrbg.h"
+
+/*!\addtogroup PRNG_hmacdrbg_m
+ * \{
+ */
+
+const randomGenerator hmacdrbg = {
+	"HMAC_DRBG SHA-256",
+	sizeof(hmacdrbgParam),
+	(randomGeneratorSetup) hmacdrbgSetup,
+	(randomGeneratorSeed) hmacdrbgSeed,
+	(randomGeneratorNext) hmacdrbgNext,
+	(randomGeneratorCleanup) hmacdrbgCleanup
+};
+
+/* the update function, with the concatenated pieces as provided data */
+static void hmacdrbgUpdate(hmacdrbgParam* dp, const byte* const* in, const size_t* insize, int pieces)
+{
+	byte k[32], separator;
+	size_t total = 0;
+	int i;
+
+	for (i = 0; i < pieces; i++)
+		total += insize[i];
+
+	for (separator = 0; separator < 2; separator++)
+	{
+		/* without provided data, only the first round is done */
+		if (separator && total == 0)
+			break;
+
+		/* K = HMAC(K, V || separator || provided data) */
+		hmacsha256Update(&dp->mac, dp->v, 32);
+		hmacsha256Update(&dp->mac, &separator, 1);
+		for (i = 0; i < pieces; i++)
+			if (insize[i])
+				hmacsha256Update(&dp->mac, in[i], insize[i]);
+		hmacsha256Digest(&dp->mac, k);
+
+		hmacsha256Setup(&dp->mac, k, 256);
+
+		/* V = HMAC(K, V) */
+		hmacsha256Update(&dp->mac, dp->v, 32);
+		hmacsha256Digest(&dp->mac, dp->v);
+	}
+
+	memset(k, 0, sizeof(k));
+}
+
+static void hmacdrbgEncode(byte* data, const uint32_t* h)
+{
+	register int i;
+
+	for (i = 0; i < 8; i++, data += 4)
+	{
+		data[0] = (byte)(h[i] >> 24);
+		data[1] = (byte)(h[i] >> 16);
+		data[2] = (byte)(h[i] >>  8);
+		data[3] = (byte)(h[i]      );
+	}
+}
+
+int hmacdrbgInstantiate(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize)
+{
+	static const byte zero[32] = { 0 };
+
+	const byte* in[3];
+	size_t insize[3];
+
+	if (dp == (hmacdrbgParam*) 0 || entropy == (const byte*) 0)
+		return -1;
+
+	in[0] = entropy;
+	insize[0] = entropysize;
+	in[1] = nonce;
+	insize[1] = nonce ? noncesize : 0;
+	in[2] = pers;
+	insize[2] = pers ? perssize : 0;
+
+	if (hmacsha256Setup(&dp->mac, zero, 256))
+		return -1;
+
+	memset(dp->v, 0x01, 32);
+
+	hmacdrbgUpdate(dp, in, insize, 3);
+
+	dp->reseed = 1;
+
+	return 0;
+}
+
+int hmacdrbgReseed(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize)
+{
+	const byte* in[2];
+	size_t insize[2];
+
+	if (dp == (hmacdrbgParam*) 0 || entropy == (const byte*) 0)
+		return -1;
+
+	in[0] = entropy;
+	insize[0] = entropysize;
+	in[1] = add;
+	insize[1] = add ? addsize : 0;
+
+	hmacdrbgUpdate(dp, in, insize, 2);
+
+	dp->reseed = 1;
+
+	return 0;
+}
+
+int hmacdrbgGenerate(hmacdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize)
+{
+	sha256Param sp;
+	uint32_t block[16];
+	byte* b = (byte*) block;
+
+	if (dp == (hmacdrbgParam*) 0 || size > HMACDRBG_MAX_REQUEST)
+		return -1;
+
+	if (add == (const byte*) 0)
+		addsize = 0;
+
+	if (addsize)
+		hmacdrbgUpdate(dp, &add, &addsize, 1);
+
+	/* V = HMAC(K, V) hashes a message of fixed length, in one block after
+	 * the key's; so we pad it once, and run the compression function from
+	 * the cached inner and outer states directly
+	 */
+	memset(block, 0, sizeof(block));
+	memcpy(b, dp->v, 32);
+	b[32] = 0x80;
+	b[62] = 0x03;
+
+	while (size > 0)
+	{
+		size_t copy = (size > 32) ? 32 : size;
+
+		memcpy(sp.h, dp->mac.istate.h, sizeof(sp.h));
+		sha256ProcessBlocks(&sp, b, 1);
+		hmacdrbgEncode(b, sp.h);
+
+		memcpy(sp.h, dp->mac.ostate.h, sizeof(sp.h));
+		sha256ProcessBlocks(&sp, b, 1);
+		hmacdrbgEncode(b, sp.h);
+
+		memcpy(data, b, copy);
+		data += copy;
+		size -= copy;
+	}
+
+	memcpy(dp->v, b, 32);
+
+	hmacdrbgUpdate(dp, &add, &addsize, 1);
+
+	dp->reseed++;
+
+	memset(block, 0, sizeof(block));
+	memset(&sp, 0, sizeof(sp));
+
+	return 0;
+}
+
+int hmacdrbgSetup(hmacdrbgParam* dp)
+{
+	if (dp)
+	{
+		byte entropy[48];
+		int rc;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!(dp->lock = CreateMutex(NULL, FALSE, NULL)))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_init(&dp->lock, USYNC_THREAD, (void *) 0))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_init(&dp->lock, (pthread_mutexattr_t *) 0))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		/* the entropy input, followed by the nonce */
+		if (entropyGatherNext(entropy, sizeof(entropy)))
+			return -1;
+
+		rc = hmacdrbgInstantiate(dp, entropy, 32, entropy + 32, 16, (const byte*) 0, 0);
+
+		memset(entropy, 0, sizeof(entropy));
+
+		return rc;
+	}
+	return -1;
+}
+
+int hmacdrbgSeed(hmacdrbgParam* dp, const byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(dp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		if (data)
+			rc = hmacdrbgReseed(dp, data, size, (const byte*) 0, 0);
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!ReleaseMutex(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_unlock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_unlock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return rc;
+	}
+	return -1;
+}
+
+int hmacdrbgNext(hmacdrbgParam* dp, byte* data, size_t size)
+{
+	if (dp)
+	{
+		int rc = 0;
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (WaitForSingleObject(dp->lock, INFINITE) != WAIT_OBJECT_0)
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_lock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_lock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+
+		/* large requests are served as a series of generate calls */
+		while (size > 0 && rc == 0)
+		{
+			size_t chunk = (size > HMACDRBG_MAX_REQUEST) ? HMACDRBG_MAX_REQUEST : size;
+
+			if (dp->reseed > HMACDRBG_RESEED_INTERVAL)
+			{
+				byte entropy[32];
+
+				rc = entropyGatherNext(entropy, sizeof(entropy));
+				if (rc == 0)
+					rc = hmacdrbgReseed(dp, entropy, sizeof(entropy), (const byte*) 0, 0);
+
+				memset(entropy, 0, sizeof(entropy));
+			}
+
+			if (rc == 0)
+				rc = hmacdrbgGenerate(dp, data, chunk, (const byte*) 0, 0);
+
+			data += chunk;
+			size -= chunk;
+		}
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!ReleaseMutex(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_unlock(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_unlock(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return rc;
+	}
+	return -1;
+}
+
+int hmacdrbgCleanup(hmacdrbgParam* dp)
+{
+	if (dp)
+	{
+		memset(&dp->mac, 0, sizeof(dp->mac));
+		memset(dp->v, 0, 32);
+
+		#ifdef _REENTRANT
+		# if WIN32
+		if (!CloseHandle(dp->lock))
+			return -1;
+		# else
+		#  if HAVE_THREAD_H && HAVE_SYNCH_H
+		if (mutex_destroy(&dp->lock))
+			return -1;
+		#  elif HAVE_PTHREAD_H
+		if (pthread_mutex_destroy(&dp->lock))
+			return -1;
+		#  endif
+		# endif
+		#endif
+		return 0;
+	}
+	return -1;
+}
+
+/*!\}
+ */
@@ -55,12 +55,12 @@ const keyedHashFunction hmacsha1 = {
 
 int hmacsha1Setup (hmacsha1Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &sha1, &sp->sparam, key, keybits);
+	return hmacSetupState(sp->kxi, sp->kxo, &sp->istate, &sp->ostate, &sha1, &sp->sparam, key, keybits);
 }
 
 int hmacsha1Reset (hmacsha1Param* sp)
 {
-	return hmacReset(sp->kxi, &sha1, &sp->sparam);
+	return hmacResetState(sp->kxi, &sp->istate, &sha1, &sp->sparam);
 }
 
 int hmacsha1Update(hmacsha1Param* sp, const byte* data, size_t size)
@@ -70,7 +70,7 @@ int hmacsha1Update(hmacsha1Param* sp, const byte* data, size_t size)
 
 int hmacsha1Digest(hmacsha1Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &sha1, &sp->sparam, data);
+	return hmacDigestState(sp->kxo, &sp->istate, &sp->ostate, &sha1, &sp->sparam, data);
 }
 
 /*!\}
@@ -51,12 +51,12 @@ const keyedHashFunction hmacsha224 = {
 
 int hmacsha224Setup (hmacsha224Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &sha224, &sp->sparam, key, keybits);
+	return hmacSetupState(sp->kxi, sp->kxo, &sp->istate, &sp->ostate, &sha224, &sp->sparam, key, keybits);
 }
 
 int hmacsha224Reset (hmacsha224Param* sp)
 {
-	return hmacReset(sp->kxi, &sha224, &sp->sparam);
+	return hmacResetState(sp->kxi, &sp->istate, &sha224, &sp->sparam);
 }
 
 int hmacsha224Update(hmacsha224Param* sp, const byte* data, size_t size)
@@ -66,7 +66,7 @@ int hmacsha224Update(hmacsha224Param* sp, const byte* data, size_t size)
 
 int hmacsha224Digest(hmacsha224Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &sha224, &sp->sparam, data);
+	return hmacDigestState(sp->kxo, &sp->istate, &sp->ostate, &sha224, &sp->sparam, data);
 }
 
 /*!\}
@@ -51,12 +51,12 @@ const keyedHashFunction hmacsha256 = {
 
 int hmacsha256Setup (hmacsha256Param* sp, const byte* key, size_t keybits)
 {
-	return hmacSetup(sp->kxi, sp->kxo, &sha256, &sp->sparam, key, keybits);
+	return hmacSetupState(sp->kxi, sp->kxo, &sp->istate, &sp->ostate, &sha256, &sp->sparam, key, keybits);
 }
 
 int hmacsha256Reset (hmacsha256Param* sp)
 {
-	return hmacReset(sp->kxi, &sha256, &sp->sparam);
+	return hmacResetState(sp->kxi, &sp->istate, &sha256, &sp->sparam);
 }
 
 int hmacsha256Update(hmacsha256Param* sp, const byte* data, size_t size)
@@ -66,7 +66,7 @@ int hmacsha256Update(hmacsha256Param* sp, const byte* data, size_t size)
 
 int hmacsha256Digest(hmacsha256Param* sp, byte* data)
 {
-	return hmacDigest(sp->kxo, &sha256, &sp->sparam, data);
+	return hmacDigestState(sp->kxo, &sp->istate, &sp->ostate, &sha256, &sp->sparam, data);
 }
 
 /*!\}
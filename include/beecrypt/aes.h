@@ -121,6 +121,30 @@ int			aesEncrypt (aesParam* ap, uint32_t* dst, const uint32_t* src);
 BEECRYPTAPI
 int			aesDecrypt (aesParam* ap, uint32_t* dst, const uint32_t* src);
 
+/*!\fn aesEncryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+ * \brief This function performs the raw AES encryption of a number of
+ *  independent blocks of 128 bits; several blocks are processed in parallel.
+ * \param ap The cipher's parameter block.
+ * \param dst The ciphertext; should be aligned on 32-bit boundary.
+ * \param src The cleartext; should be aligned on 32-bit boundary.
+ * \param nblocks The number of blocks to be encrypted.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int			aesEncryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
+
+/*!\fn aesDecryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+ * \brief This function performs the raw AES decryption of a number of
+ *  independent blocks of 128 bits; several blocks are processed in parallel.
+ * \param ap The cipher's parameter block.
+ * \param dst The cleartext; should be aligned on 32-bit boundary.
+ * \param src The ciphertext; should be aligned on 32-bit boundary.
+ * \param nblocks The number of blocks to be decrypted.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int			aesDecryptN(aesParam* ap, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
+
 BEECRYPTAPI
 uint32_t*	aesFeedback(aesParam* ap);
 
@@ -971,3 +971,111 @@ static const uint32_t _arc[] = {
         (_ad4[(t1 >> 16) & 0xff] & 0x00ff0000) ^ \
         (_ad4[(t0 >> 24)       ] & 0xff000000) ^ \
         rk[3];
+
+/* The following macros perform one round on a single block held in the
+ * variables named <s>0..<s>3, storing the result in <d>0..<d>3; they allow
+ * several independent blocks to be interleaved within one function.
+ */
+#define etfsn(d,s,i) \
+	d##0 = \
+		_ae0[(s##0      ) & 0xff] ^ \
+		_ae1[(s##1 >>  8) & 0xff] ^ \
+		_ae2[(s##2 >> 16) & 0xff] ^ \
+		_ae3[(s##3 >> 24)       ] ^ \
+		rk[i+0]; \
+	d##1 = \
+		_ae0[(s##1      ) & 0xff] ^ \
+		_ae1[(s##2 >>  8) & 0xff] ^ \
+		_ae2[(s##3 >> 16) & 0xff] ^ \
+		_ae3[(s##0 >> 24)       ] ^ \
+		rk[i+1]; \
+	d##2 = \
+		_ae0[(s##2      ) & 0xff] ^ \
+		_ae1[(s##3 >>  8) & 0xff] ^ \
+		_ae2[(s##0 >> 16) & 0xff] ^ \
+		_ae3[(s##1 >> 24)       ] ^ \
+		rk[i+2]; \
+	d##3 = \
+		_ae0[(s##3      ) & 0xff] ^ \
+		_ae1[(s##0 >>  8) & 0xff] ^ \
+		_ae2[(s##1 >> 16) & 0xff] ^ \
+		_ae3[(s##2 >> 24)       ] ^ \
+		rk[i+3];
+
+#define elrn(d,s,i) \
+	d##0 = \
+		(_ae4[(s##0      ) & 0xff] & 0x000000ff) ^ \
+		(_ae4[(s##1 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ae4[(s##2 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ae4[(s##3 >> 24)       ] & 0xff000000) ^ \
+		rk[i+0]; \
+	d##1 = \
+		(_ae4[(s##1      ) & 0xff] & 0x000000ff) ^ \
+		(_ae4[(s##2 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ae4[(s##3 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ae4[(s##0 >> 24)       ] & 0xff000000) ^ \
+		rk[i+1]; \
+	d##2 = \
+		(_ae4[(s##2      ) & 0xff] & 0x000000ff) ^ \
+		(_ae4[(s##3 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ae4[(s##0 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ae4[(s##1 >> 24)       ] & 0xff000000) ^ \
+		rk[i+2]; \
+	d##3 = \
+		(_ae4[(s##3      ) & 0xff] & 0x000000ff) ^ \
+		(_ae4[(s##0 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ae4[(s##1 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ae4[(s##2 >> 24)       ] & 0xff000000) ^ \
+		rk[i+3];
+
+#define dtfsn(d,s,i) \
+	d##0 = \
+		_ad0[(s##0      ) & 0xff] ^ \
+		_ad1[(s##3 >>  8) & 0xff] ^ \
+		_ad2[(s##2 >> 16) & 0xff] ^ \
+		_ad3[(s##1 >> 24)       ] ^ \
+		rk[i+0]; \
+	d##1 = \
+		_ad0[(s##1      ) & 0xff] ^ \
+		_ad1[(s##0 >>  8) & 0xff] ^ \
+		_ad2[(s##3 >> 16) & 0xff] ^ \
+		_ad3[(s##2 >> 24)       ] ^ \
+		rk[i+1]; \
+	d##2 = \
+		_ad0[(s##2      ) & 0xff] ^ \
+		_ad1[(s##1 >>  8) & 0xff] ^ \
+		_ad2[(s##0 >> 16) & 0xff] ^ \
+		_ad3[(s##3 >> 24)       ] ^ \
+		rk[i+2]; \
+	d##3 = \
+		_ad0[(s##3      ) & 0xff] ^ \
+		_ad1[(s##2 >>  8) & 0xff] ^ \
+		_ad2[(s##1 >> 16) & 0xff] ^ \
+		_ad3[(s##0 >> 24)       ] ^ \
+		rk[i+3];
+
+#define dlrn(d,s,i) \
+	d##0 = \
+		(_ad4[(s##0      ) & 0xff] & 0x000000ff) ^ \
+		(_ad4[(s##3 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ad4[(s##2 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ad4[(s##1 >> 24)       ] & 0xff000000) ^ \
+		rk[i+0]; \
+	d##1 = \
+		(_ad4[(s##1      ) & 0xff] & 0x000000ff) ^ \
+		(_ad4[(s##0 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ad4[(s##3 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ad4[(s##2 >> 24)       ] & 0xff000000) ^ \
+		rk[i+1]; \
+	d##2 = \
+		(_ad4[(s##2      ) & 0xff] & 0x000000ff) ^ \
+		(_ad4[(s##1 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ad4[(s##0 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ad4[(s##3 >> 24)       ] & 0xff000000) ^ \
+		rk[i+2]; \
+	d##3 = \
+		(_ad4[(s##3      ) & 0xff] & 0x000000ff) ^ \
+		(_ad4[(s##2 >>  8) & 0xff] & 0x0000ff00) ^ \
+		(_ad4[(s##1 >> 16) & 0xff] & 0x00ff0000) ^ \
+		(_ad4[(s##0 >> 24)       ] & 0xff000000) ^ \
+		rk[i+3];
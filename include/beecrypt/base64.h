@@ -45,6 +45,55 @@ extern int b64encode_chars_per_line;
 extern const char* b64encode_eolstr;
 #define B64ENCODE_EOLSTR	"\n"
 
+/*!\brief Holds the state of an incremental base64 encoding.
+ */
+typedef struct
+{
+	/*!\var pending
+	 * \brief Input bytes which don't yet make up a group of three.
+	 */
+	byte		pending[3];
+	/*!\var npending
+	 * \brief The number of bytes in pending.
+	 */
+	size_t		npending;
+	/*!\var linelen
+	 * \brief The number of characters per line; 0 means a single line.
+	 */
+	size_t		linelen;
+	/*!\var column
+	 * \brief The number of characters on the current line.
+	 */
+	size_t		column;
+	/*!\var eolstr
+	 * \brief The end-of-line string.
+	 */
+	const char*	eolstr;
+	/*!\var eollen
+	 * \brief The length of the end-of-line string.
+	 */
+	size_t		eollen;
+} b64encodeContext;
+
+/*!\brief Holds the state of an incremental base64 decoding.
+ */
+typedef struct
+{
+	/*!\var bits
+	 * \brief The bits of the current group of four characters.
+	 */
+	uint32_t	bits;
+	/*!\var count
+	 * \brief The number of characters in the current group.
+	 */
+	int			count;
+	/*!\var padding
+	 * \brief The number of '=' characters which are still expected; -1
+	 *  before the padding starts.
+	 */
+	int			padding;
+} b64decodeContext;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -69,6 +118,8 @@ char* b64crc(const unsigned char* data, size_t ns);
 
 /*!
  * Decode chunks of 4 bytes of base64 input into 3 bytes of binary output.
+ * The input must consist of whole groups of four, and '=' may only occur
+ * as padding at the end.
  * \param s base64 string
  * \retval datap address of (malloc'd) binary data
  * \retval lenp	 address of no. bytes of binary data
@@ -78,15 +129,171 @@ BEECRYPTAPI
 int b64decode(const char* s, void** datap, size_t* lenp);
 
 /*!
+ * Encode a memchunk into base64, with a line break after every 64
+ * characters; a full last line is terminated as well, a partial one isn't.
+ * \return (malloc'd) base64 string
  */
 BEECRYPTAPI
 char*		b64enc(const memchunk*);
 
 /*!
+ * Decode a base64 string into a memchunk. White space is skipped. For
+ * compatibility with older versions, padding is optional: a partial group
+ * at the end without padding is dropped, e.g. "QUJ" decodes to no bytes,
+ * and a single '=' suffices after a group of two characters. Anything but
+ * white space after the padding is rejected.
+ * \return (malloc'd) memchunk, or NULL for bad input
  */
 BEECRYPTAPI
 memchunk*	b64dec(const char*);
 
+/*!\fn size_t b64encodesize(size_t ns, int chars_per_line, const char* eolstr)
+ * \brief This function returns the exact length of the base64 encoding of
+ *  ns bytes, as written by b64encodeto.
+ * \param ns The number of bytes to encode.
+ * \param chars_per_line The number of characters per line; 0 or less
+ *  means no line breaks.
+ * \param eolstr The end-of-line string; null means no line breaks.
+ * \return The length of the encoding, without a terminating null.
+ */
+BEECRYPTAPI
+size_t b64encodesize(size_t ns, int chars_per_line, const char* eolstr);
+
+/*!\fn int b64encodeto(const void* data, size_t ns, char* s, size_t* slen, int chars_per_line, const char* eolstr)
+ * \brief This function base64 encodes into a buffer supplied by the caller.
+ *
+ * The line length is rounded up to a multiple of four; a line break
+ * follows every full line, but a partial last line is not terminated.
+ * No terminating null is written.
+ * \param data The binary data.
+ * \param ns The number of bytes of data.
+ * \param s The buffer which receives the encoding.
+ * \param slen On entry, the size of the buffer; on return, the number
+ *  of characters written.
+ * \param chars_per_line The number of characters per line; 0 or less
+ *  means no line breaks.
+ * \param eolstr The end-of-line string; null means no line breaks.
+ * \retval 0 on success.
+ * \retval -1 if the buffer is too small.
+ */
+BEECRYPTAPI
+int b64encodeto(const void* data, size_t ns, char* s, size_t* slen, int chars_per_line, const char* eolstr);
+
+/*!\fn size_t b64decodesize(size_t ns)
+ * \brief This function returns an upper bound for the number of bytes
+ *  which ns characters of base64 decode into.
+ * \param ns The number of characters.
+ * \return The upper bound.
+ */
+BEECRYPTAPI
+size_t b64decodesize(size_t ns);
+
+/*!\fn int b64decodeto(const char* s, size_t ns, void* data, size_t* datalen)
+ * \brief This function decodes base64 into a buffer supplied by the caller.
+ *
+ * The characters in b64decode_whitespace are skipped; the final group may
+ * be padded or not.
+ * \param s The base64 characters.
+ * \param ns The number of characters.
+ * \param data The buffer which receives the binary data.
+ * \param datalen On entry, the size of the buffer; on return, the number
+ *  of bytes written.
+ * \retval 0 on success.
+ * \retval -1 if the input is not valid base64, or the buffer is too small.
+ */
+BEECRYPTAPI
+int b64decodeto(const char* s, size_t ns, void* data, size_t* datalen);
+
+/*!\fn int b64encodeInit(b64encodeContext* ctxt, int chars_per_line, const char* eolstr)
+ * \brief This function starts an incremental base64 encoding.
+ * \param ctxt The encoding context.
+ * \param chars_per_line The number of characters per line; 0 or less
+ *  means no line breaks.
+ * \param eolstr The end-of-line string; null means no line breaks.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int b64encodeInit(b64encodeContext* ctxt, int chars_per_line, const char* eolstr);
+
+/*!\fn size_t b64encodeUpdateSize(const b64encodeContext* ctxt, size_t ns)
+ * \brief This function returns the exact number of characters which
+ *  b64encodeUpdate writes for ns more bytes.
+ * \param ctxt The encoding context.
+ * \param ns The number of bytes.
+ * \return The number of characters.
+ */
+BEECRYPTAPI
+size_t b64encodeUpdateSize(const b64encodeContext* ctxt, size_t ns);
+
+/*!\fn int b64encodeUpdate(b64encodeContext* ctxt, const void* data, size_t ns, char* s, size_t* slen)
+ * \brief This function encodes the next piece of the input.
+ * \param ctxt The encoding context.
+ * \param data The binary data.
+ * \param ns The number of bytes of data.
+ * \param s The buffer which receives the characters.
+ * \param slen On entry, the size of the buffer; on return, the number
+ *  of characters written.
+ * \retval 0 on success.
+ * \retval -1 if the buffer is too small; nothing is consumed then.
+ */
+BEECRYPTAPI
+int b64encodeUpdate(b64encodeContext* ctxt, const void* data, size_t ns, char* s, size_t* slen);
+
+/*!\fn int b64encodeFinal(b64encodeContext* ctxt, char* s, size_t* slen)
+ * \brief This function encodes the remaining bytes, with padding.
+ *
+ * At most 4 characters and one end-of-line string are written.
+ * \param ctxt The encoding context.
+ * \param s The buffer which receives the characters.
+ * \param slen On entry, the size of the buffer; on return, the number
+ *  of characters written.
+ * \retval 0 on success.
+ * \retval -1 if the buffer is too small.
+ */
+BEECRYPTAPI
+int b64encodeFinal(b64encodeContext* ctxt, char* s, size_t* slen);
+
+/*!\fn int b64decodeInit(b64decodeContext* ctxt)
+ * \brief This function starts an incremental base64 decoding.
+ * \param ctxt The decoding context.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int b64decodeInit(b64decodeContext* ctxt);
+
+/*!\fn int b64decodeUpdate(b64decodeContext* ctxt, const char* s, size_t ns, void* data, size_t* datalen)
+ * \brief This function decodes the next piece of the input.
+ *
+ * A buffer of b64decodesize(ns) bytes is always large enough.
+ * \param ctxt The decoding context.
+ * \param s The base64 characters.
+ * \param ns The number of characters.
+ * \param data The buffer which receives the binary data.
+ * \param datalen On entry, the size of the buffer; on return, the number
+ *  of bytes written.
+ * \retval 0 on success.
+ * \retval -1 if the input is not valid base64, or the buffer is too small.
+ */
+BEECRYPTAPI
+int b64decodeUpdate(b64decodeContext* ctxt, const char* s, size_t ns, void* data, size_t* datalen);
+
+/*!\fn int b64decodeFinal(b64decodeContext* ctxt, void* data, size_t* datalen)
+ * \brief This function decodes an unpadded last group, and checks that
+ *  the input was complete.
+ *
+ * At most 2 bytes are written.
+ * \param ctxt The decoding context.
+ * \param data The buffer which receives the binary data.
+ * \param datalen On entry, the size of the buffer; on return, the number
+ *  of bytes written.
+ * \retval 0 on success.
+ * \retval -1 if the input ended in the middle of a group.
+ */
+BEECRYPTAPI
+int b64decodeFinal(b64decodeContext* ctxt, void* data, size_t* datalen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -207,6 +207,9 @@ typedef struct _randomGenerator randomGenerator;
  *
  * randomGeneratorFind returns the random generator with the given name, or
  * NULL if no random generator exists with that name.
+ *
+ * randomGeneratorDefault returns the generator named by the environment
+ * variable BEECRYPT_RANDOM, or else the per-thread FIPS 186 generator.
  */
 
 #ifdef __cplusplus
@@ -270,6 +273,21 @@ int randomGeneratorContextNext(randomGeneratorContext*, byte*, size_t);
 BEECRYPTAPI
 int randomGeneratorContextSeed(randomGeneratorContext*, const byte*, size_t);
 
+/*!\fn int randomGeneratorContextFork(randomGeneratorContext* child, randomGeneratorContext* parent)
+ * \brief Initializes a context with a generator of its own, seeded from the
+ *  output of another.
+ *
+ * The child is a CTR_DRBG instance; it can be used in another thread than
+ * the parent, and its output is determined by what it drew from the parent.
+ * \param child The context to initialize; free it with
+ *  randomGeneratorContextFree.
+ * \param parent The context to draw the seed from.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int randomGeneratorContextFork(randomGeneratorContext* child, randomGeneratorContext* parent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -286,6 +304,9 @@ typedef void hashFunctionParam;
 typedef int (*hashFunctionReset )(hashFunctionParam*);
 typedef int (*hashFunctionUpdate)(hashFunctionParam*, const byte*, size_t);
 typedef int (*hashFunctionDigest)(hashFunctionParam*, byte*);
+typedef int (*hashFunctionBatch )(size_t, const byte* const*, const size_t*, byte* const*);
+typedef int (*hashFunctionCopy  )(hashFunctionParam*, const hashFunctionParam*);
+typedef int (*hashFunctionCheck )(const hashFunctionParam*);
 
 /*
  * The struct 'hashFunction' holds information and pointers to code specific
@@ -296,6 +317,15 @@ typedef int (*hashFunctionDigest)(hashFunctionParam*, byte*);
  * in the hashFunction struct.
  * NOTE: for safety reasons, after calling digest, each specific implementation
  * MUST reset itself so that previous values in the parameters are erased.
+ * NOTE: batch, if present, computes the digests of many independent messages
+ * in one call; hash functions which don't provide it leave it null.
+ * NOTE: copy, if present, duplicates the state of a hash computation in
+ * progress into another parameter block; hash functions which don't provide
+ * it leave it null.
+ * NOTE: check, if present, returns 0 if a parameter block holds a state the
+ * other functions can safely continue from, e.g. after it was restored with
+ * hashFunctionContextDeserialize; the state of hash functions which leave it
+ * null can't be restored.
  */
 #ifdef __cplusplus
 struct BEECRYPTAPI hashFunction
@@ -310,6 +340,9 @@ struct _hashFunction
 	const hashFunctionReset		reset;
 	const hashFunctionUpdate	update;
 	const hashFunctionDigest	digest;
+	const hashFunctionBatch		batch;		/* may be null */
+	const hashFunctionCopy		copy;		/* may be null */
+	const hashFunctionCheck		check;		/* may be null */
 };
 
 #ifndef __cplusplus
@@ -400,6 +433,35 @@ int hashFunctionContextDigestMP(hashFunctionContext*, mpnumber*);
 BEECRYPTAPI
 int hashFunctionContextDigestMatch(hashFunctionContext*, const mpnumber*);
 
+/*
+ * hashFunctionContextClone initializes a new context with the hash function
+ * and the state of an existing one; both can then continue independently,
+ * e.g. to hash a common prefix only once.
+ *
+ * hashFunctionContextSerialize stores the state of a hash computation in
+ * progress in an opaque form, which hashFunctionContextDeserialize restores
+ * into a context initialized with the same hash function; the data only
+ * makes sense to the same build of the library on the same kind of machine.
+ * Restoring fails, and leaves the context as it was, when the data doesn't
+ * pass the hash function's check.
+ * hashFunctionContextStateSize returns the number of bytes needed.
+ */
+BEECRYPTAPI
+int hashFunctionContextClone(hashFunctionContext*, const hashFunctionContext*);
+BEECRYPTAPI
+size_t hashFunctionContextStateSize(const hashFunctionContext*);
+BEECRYPTAPI
+int hashFunctionContextSerialize(const hashFunctionContext*, byte*, size_t);
+BEECRYPTAPI
+int hashFunctionContextDeserialize(hashFunctionContext*, const byte*, size_t);
+
+/*
+ * hashFunctionMultiDigest computes the digests of count independent messages,
+ * through the hash function's batch routine if it has one.
+ */
+BEECRYPTAPI
+int hashFunctionMultiDigest(const hashFunction*, size_t, const byte* const*, const size_t*, byte* const*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -620,12 +682,34 @@ typedef int (*blockCipherRawcrypt)(blockCipherParam*, uint32_t*, const uint32_t*
  */
 typedef int (*blockCipherModcrypt)(blockCipherParam*, uint32_t*, const uint32_t*, unsigned int);
 
+/*!\typedef int (*blockCipherRawcryptN)(blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+ * \brief Prototype for a \e raw encryption or decryption function which
+ *        operates on multiple independent blocks.
+ *
+ * Unlike a blockCipherModcrypt function, this function doesn't use or
+ * modify the cipher's feedback; each block is processed as if by the
+ * corresponding blockCipherRawcrypt function, which allows implementations
+ * to interleave the processing of several blocks.
+ *
+ * \param bp The blockcipher's parameters.
+ * \param dst The ciphertext address; must be aligned on 32-bit boundary.
+ * \param src The cleartext address; must be aligned on 32-bit boundary.
+ * \param nblocks The number of blocks to process.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ * \ingroup BC_m
+ */
+typedef int (*blockCipherRawcryptN)(blockCipherParam*, uint32_t*, const uint32_t*, unsigned int);
+
 typedef uint32_t* (*blockCipherFeedback)(blockCipherParam*);
 
 typedef struct
 {
 	const blockCipherRawcrypt encrypt;
 	const blockCipherRawcrypt decrypt;
+	/* the following may be null, in which case the single block functions are used */
+	const blockCipherRawcryptN encryptN;
+	const blockCipherRawcryptN decryptN;
 } blockCipherRaw;
 
 typedef struct
@@ -819,6 +903,9 @@ int blockCipherContextCBC(blockCipherContext*, uint32_t*, const uint32_t*, int);
 BEECRYPTAPI
 int blockCipherContextCTR(blockCipherContext*, uint32_t*, const uint32_t*, int);
 
+BEECRYPTAPI
+int blockCipherContextCTRParallel(blockCipherContext*, uint32_t*, const uint32_t*, int);
+
 BEECRYPTAPI
 int blockCipherContextValidKeylen(blockCipherContext*, size_t);
 
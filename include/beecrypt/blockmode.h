@@ -85,12 +85,59 @@ int blockEncryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst,
 BEECRYPTAPI
 int blockDecryptCBC(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
 
+/*!\fn int blockKeystreamCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, unsigned int nblocks)
+ * \brief This function generates a number of keystream blocks in Counter
+ *  mode, and advances the counter accordingly.
+ *
+ * The successive counter blocks are encrypted together, which lets ciphers
+ * with a multi-block raw function process them in parallel.
+ * \param bc The blockcipher.
+ * \param bp The cipher's parameter block.
+ * \param dst The keystream data; should be aligned on a 32-bit boundary.
+ * \param nblocks The number of keystream blocks to be generated.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int blockKeystreamCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, unsigned int nblocks);
+
 BEECRYPTAPI
 int blockEncryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
 
 BEECRYPTAPI
 int blockDecryptCTR(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
 
+/*!\fn int blockEncryptCTRParallel(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks)
+ * \brief This function encrypts a number of data blocks in Counter mode,
+ *  using multiple threads.
+ *
+ * The data is split in chunks which are processed in parallel, each with
+ * its own copy of the cipher's parameters and with the counter derived from
+ * the chunk's offset. The result, including the final counter value, is the
+ * same as that of blockEncryptCTR.
+ * \param bc The blockcipher.
+ * \param bp The cipher's parameter block.
+ * \param dst The ciphertext data; should be aligned on a 32-bit boundary.
+ * \param src The cleartext data; should be aligned on a 32-bit boundary.
+ * \param nblocks The number of blocks to be encrypted.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int blockEncryptCTRParallel(const blockCipher* bc, blockCipherParam* bp, uint32_t* dst, const uint32_t* src, unsigned int nblocks);
+
+/*!\fn int blockModeParallelSetup(unsigned int threads, size_t minchunk)
+ * \brief This function sets how the ECB functions and
+ *  blockEncryptCTRParallel divide their work among threads.
+ * \param threads The maximum number of threads; 0 means the OpenMP
+ *  default.
+ * \param minchunk The minimum number of bytes each thread should process;
+ *  smaller inputs use fewer threads, or only the calling thread. 0 restores
+ *  the default of 64 KB.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int blockModeParallelSetup(unsigned int threads, size_t minchunk);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,11 @@ namespace beecrypt {
 			FileInputStream(FILE* f);
 			virtual ~FileInputStream();
 
+			/*!\brief Returns the stdio stream this object reads from,
+			 *  or null once it has been closed.
+			 */
+			FILE* getFile() const throw ();
+
 			virtual jint available() throw (IOException);
 			virtual void close() throw (IOException);
 			virtual void mark(jint readlimit) throw ();
@@ -31,14 +31,49 @@ using beecrypt::security::KeyStoreSpi;
 using beecrypt::security::KeyFactory;
 #include "beecrypt/c++/security/cert/CertificateFactory.h"
 using beecrypt::security::cert::CertificateFactory;
+#include "beecrypt/c++/io/DataInputStream.h"
+using beecrypt::io::DataInputStream;
+#include "beecrypt/c++/io/DataOutputStream.h"
+using beecrypt::io::DataOutputStream;
 #include "beecrypt/c++/util/Enumeration.h"
 using beecrypt::util::Enumeration;
 #include "beecrypt/c++/util/Hashtable.h"
 using beecrypt::util::Hashtable;
+#include "beecrypt/c++/util/concurrent/locks/ReentrantReadWriteLock.h"
+using beecrypt::util::concurrent::locks::ReentrantReadWriteLock;
+#include "beecrypt/c++/provider/KeyProtector.h"
+using beecrypt::provider::KeyProtector;
+
+#include <list>
+using std::list;
+#include <map>
+using std::map;
+#include <set>
+using std::set;
+#include <string>
 
 namespace beecrypt {
 	namespace provider {
 		/*!\brief The default BeeCrypt KeyStore.
+		 *
+		 * Lookups share a read lock, so that several threads can recover
+		 * keys at the same time; changes and load take the write lock.
+		 *
+		 * If the property beekeystore.cache.size is set to a positive
+		 * number, each keystore keeps up to that many recovered keys, and
+		 * as many sets of keys derived from a password, so that a repeated
+		 * getKey with the same password skips the key derivation and the
+		 * decryption. Cached keys are dropped when their entry is replaced
+		 * or deleted, and the whole cache when the keystore is loaded.
+		 *
+		 * Keystores are stored in an indexed format, unless the property
+		 * beekeystore.version is set to 1. The entries follow a hash table
+		 * of their aliases and a table holding the position and SHA-256
+		 * digest of each; the MAC covers only the tables. Loading such a
+		 * keystore still reads the whole file into memory, from a file in
+		 * one go, but only verifies the MAC over the tables; entries are
+		 * decoded on first use, after their digest is checked. Keystores
+		 * in the original format are decoded in full at load time.
 		 * \ingroup CXX_PROVIDER_m
 		 */
 		class BeeKeyStore : public KeyStoreSpi
@@ -86,6 +121,110 @@ namespace beecrypt {
 				virtual const String* nextElement() throw (NoSuchElementException);
 			};
 
+			/*!\brief Bounded cache of recovered keys and of key protectors.
+			 *
+			 * Passwords are only held as a SHA-256 digest of the salt and
+			 * the password; when full, the least recently used item is
+			 * dropped. Each map keeps its keys in a list ordered from least
+			 * to most recently used, so that neither a lookup nor an
+			 * eviction has to scan the cache.
+			 */
+			class Cache : public beecrypt::lang::Object
+			{
+			private:
+				typedef list<String> key_list;
+				typedef list<std::string> protector_list;
+
+				struct KeyItem
+				{
+					std::string digest;
+					PrivateKey* key;
+					key_list::iterator used;
+				};
+
+				struct ProtectorItem
+				{
+					KeyProtector* protector;
+					protector_list::iterator used;
+				};
+
+				typedef map<String, KeyItem> key_map;
+				typedef map<std::string, ProtectorItem> protector_map;
+
+				key_map _keys;
+				key_list _keyorder;
+				protector_map _protectors;
+				protector_list _protectororder;
+				jint _capacity;
+
+				void evictKey();
+				void evictProtector();
+
+			public:
+				Cache();
+				virtual ~Cache();
+
+				bool enabled() const throw ();
+
+				PrivateKey* getKey(const String& alias, const std::string& digest);
+				void putKey(const String& alias, const std::string& digest, const PrivateKey& key);
+				KeyProtector* getProtector(const std::string& digest);
+				void putProtector(const std::string& digest, const KeyProtector& protector);
+
+				void invalidate(const String& alias);
+				void clear();
+			};
+
+			/*!\brief The undecoded entries of a keystore in the indexed
+			 *  format.
+			 *
+			 * The image is read into memory, which the index owns; from
+			 * a file it is read in one go. An entry is consumed when it
+			 * is decoded, or when its alias is set or deleted; from then
+			 * on the entry lives in, or is absent from, the keystore's
+			 * table.
+			 */
+			class Index : public beecrypt::lang::Object
+			{
+			private:
+				bytearray _buf;
+
+				const byte* _data;
+				size_t _size;
+
+				jint _count;
+				jint _slots;
+				const byte* _slot;
+				const byte* _table;
+				const byte* _region;
+				size_t _regionsize;
+
+				set<jint> _verified;
+				set<jint> _consumed;
+
+				Index(size_t size);
+
+				const byte* record(jint n, jint& length);
+				String name(jint n);
+
+			public:
+				Index(InputStream&) throw (IOException);
+				virtual ~Index();
+
+				static Index* read(InputStream*) throw (IOException);
+
+				void open(const array<jchar>* password, bytearray& salt, jint& iter) throw (IOException, NoSuchAlgorithmException);
+
+				jint count() const throw ();
+				jint pending() const throw ();
+
+				bool consumed(jint n) const throw ();
+				void consume(jint n) throw ();
+
+				jint find(const String& alias);
+				Entry* decode(jint n, String& alias);
+			};
+
 			#if 0
 			typedef map<String, KeyFactory*> keyfactory_map;
 			keyfactory_map _keyfactories;
@@ -121,6 +260,21 @@ namespace beecrypt {
 
 			Hashtable<String,Entry> _entries;
 
+			mutable ReentrantReadWriteLock _lock;
+			Cache _cache;
+			Index* _index;
+
+			static jint hash(const String& alias) throw ();
+			static Entry* readEntry(DataInputStream&, jint tag, String& alias) throw (IOException, CertificateException, NoSuchAlgorithmException);
+			static void writeEntry(DataOutputStream&, const String& alias, const Entry*) throw (IOException);
+
+			Entry* lookup(const String& alias);
+			void drop(const String& alias);
+			void decodeAll();
+
+			std::string digest(const array<jchar>& password) const;
+			KeyProtector* protector(const array<jchar>& password, const std::string& digest);
+
 		protected:
 			virtual Enumeration<const String>* engineAliases();
 
@@ -147,7 +301,7 @@ namespace beecrypt {
 
 		public:
 			BeeKeyStore();
-			virtual ~BeeKeyStore() {}
+			virtual ~BeeKeyStore();
 		};
 	}
 }
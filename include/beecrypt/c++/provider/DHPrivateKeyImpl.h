@@ -48,6 +48,7 @@ namespace beecrypt {
 			DHParameterSpec* _params;
 			BigInteger _x;
 			mutable bytearray* _enc;
+			mutable dhparam* _pre;
 
 		public:
 			DHPrivateKeyImpl(const DHPrivateKey&);
@@ -68,6 +69,14 @@ namespace beecrypt {
 
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the domain parameters in the form the DH
+			 *  primitives take, with the Barrett constant of p computed.
+			 *
+			 * They are built on first use; once returned, they never change,
+			 * so several key agreements can share them across threads.
+			 */
+			const dhparam& prepared() const;
 		};
 	}
 }
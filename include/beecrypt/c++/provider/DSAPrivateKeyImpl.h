@@ -44,6 +44,7 @@ namespace beecrypt {
 			DSAParameterSpec* _params;
 			BigInteger _x;
 			mutable bytearray* _enc;
+			mutable dsaparam* _pre;
 
 		public:
 			DSAPrivateKeyImpl(const DSAPrivateKey&);
@@ -63,6 +64,16 @@ namespace beecrypt {
 			virtual const bytearray* getEncoded() const throw ();
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the domain parameters in the form the DSA
+			 *  primitives take, with the Barrett constants of p and q, and
+			 *  a table of powers of g for signing.
+			 *
+			 * The table is built on first use, under the key's lock; after
+			 * that the parameters don't change, and any number of threads
+			 * may read them at once.
+			 */
+			const dsaparam& prepared() const;
 		};
 	}
 }
@@ -44,6 +44,7 @@ namespace beecrypt {
 			DSAParameterSpec* _params;
 			BigInteger _y;
 			mutable bytearray* _enc;
+			mutable dsaparam* _pre;
 
 		public:
 			DSAPublicKeyImpl(const DSAPublicKey&);
@@ -63,6 +64,12 @@ namespace beecrypt {
 			virtual const bytearray* getEncoded() const throw ();
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the domain parameters in the form the DSA
+			 *  primitives take, with the Barrett constants of p and q; built
+			 *  on first use, like DSAPrivateKeyImpl::prepared().
+			 */
+			const dsaparam& prepared() const;
 		};
 	}
 }
@@ -23,6 +23,8 @@
 #ifndef _CLASS_RSAPRIVATECRTKEYIMPL_H
 #define _CLASS_RSAPRIVATECRTKEYIMPL_H
 
+#include "beecrypt/rsakp.h"
+
 #ifdef __cplusplus
 
 #include "beecrypt/c++/lang/Cloneable.h"
@@ -46,6 +48,7 @@ namespace beecrypt {
 			BigInteger _dq;
 			BigInteger _qi;
 			mutable bytearray* _enc;
+			mutable rsakp* _pre;
 
 		public:
 			RSAPrivateCrtKeyImpl(const RSAPrivateCrtKey&);
@@ -69,6 +72,14 @@ namespace beecrypt {
 			virtual const bytearray* getEncoded() const throw ();
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the key in the form the RSA primitives take, with
+			 *  the Barrett constants of n, p and q computed.
+			 *
+			 * It is built on first use, and doesn't change afterwards; any
+			 * number of threads may use it at once.
+			 */
+			const rsakp& prepared() const;
 		};
 	}
 }
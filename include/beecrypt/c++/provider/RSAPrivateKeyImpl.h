@@ -23,6 +23,8 @@
 #ifndef _CLASS_RSAPRIVATEKEYIMPL_H
 #define _CLASS_RSAPRIVATEKEYIMPL_H
 
+#include "beecrypt/rsakp.h"
+
 #ifdef __cplusplus
 
 #include "beecrypt/c++/lang/Cloneable.h"
@@ -40,6 +42,7 @@ namespace beecrypt {
 			BigInteger _n;
 			BigInteger _d;
 			mutable bytearray* _enc;
+			mutable rsakp* _pre;
 
 		public:
 			RSAPrivateKeyImpl(const RSAPrivateKey&);
@@ -57,6 +60,12 @@ namespace beecrypt {
 			virtual const bytearray* getEncoded() const throw ();
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the key in the form the RSA primitives take, with
+			 *  the Barrett constant of n computed; only n and d are set. It
+			 *  is built on first use, as RSAPrivateCrtKeyImpl::prepared() is.
+			 */
+			const rsakp& prepared() const;
 		};
 	}
 }
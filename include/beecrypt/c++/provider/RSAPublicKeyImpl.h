@@ -23,6 +23,8 @@
 #ifndef _CLASS_RSAPUBLICKEYIMPL_H
 #define _CLASS_RSAPUBLICKEYIMPL_H
 
+#include "beecrypt/rsapk.h"
+
 #ifdef __cplusplus
 
 #include "beecrypt/c++/lang/Cloneable.h"
@@ -40,6 +42,7 @@ namespace beecrypt {
 			BigInteger _n;
 			BigInteger _e;
 			mutable bytearray* _enc;
+			mutable rsapk* _pre;
 
 		public:
 			RSAPublicKeyImpl(const RSAPublicKey&);
@@ -57,6 +60,12 @@ namespace beecrypt {
 			virtual const bytearray* getEncoded() const throw ();
 			virtual const String& getAlgorithm() const throw ();
 			virtual const String* getFormat() const throw ();
+
+			/*!\brief Returns the key in the form the RSA primitives take, with
+			 *  the Barrett constant of n computed; built on first use, and
+			 *  shared by every signature which verifies with this key.
+			 */
+			const rsapk& prepared() const;
 		};
 	}
 }
@@ -54,6 +54,7 @@ namespace beecrypt {
 			sha1Param _sp;
 			SecureRandom* _srng;
 
+			int rawsign(randomGeneratorContext*, const mpnumber& hm, mpnumber& r, mpnumber& s) throw ();
 			void rawsign(mpnumber &r, mpnumber&s) throw (SignatureException);
 			bool rawvrfy(const mpnumber &r, const mpnumber&s) throw ();
 
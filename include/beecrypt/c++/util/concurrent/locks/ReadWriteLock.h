@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*!\file ReadWriteLock.h
+ * \ingroup CXX_UTIL_CONCURRENT_LOCKS_m
+ */
+
+#ifndef _INTERFACE_BEE_UTIL_CONCURRENT_LOCKS_READWRITELOCK_H
+#define _INTERFACE_BEE_UTIL_CONCURRENT_LOCKS_READWRITELOCK_H
+
+#ifdef __cplusplus
+
+#include "beecrypt/c++/util/concurrent/locks/Lock.h"
+using beecrypt::util::concurrent::locks::Lock;
+
+namespace beecrypt {
+	namespace util {
+		namespace concurrent {
+			namespace locks {
+				/*!\brief A pair of locks: the read lock may be held by
+				 *  several threads at once, the write lock by only one,
+				 *  and never together with the read lock of another
+				 *  thread.
+				 * \ingroup CXX_UTIL_CONCURRENT_LOCKS_m
+				 */
+				class BEECRYPTCXXAPI ReadWriteLock
+				{
+				public:
+					virtual ~ReadWriteLock() {}
+
+					virtual Lock& readLock() = 0;
+					virtual Lock& writeLock() = 0;
+				};
+			}
+		}
+	}
+}
+
+#endif
+
+#endif
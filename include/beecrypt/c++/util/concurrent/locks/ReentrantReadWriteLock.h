@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*!\file ReentrantReadWriteLock.h
+ * \ingroup CXX_UTIL_CONCURRENT_LOCKS_m
+ */
+
+#ifndef _CLASS_BEE_UTIL_CONCURRENT_LOCKS_REENTRANTREADWRITELOCK_H
+#define _CLASS_BEE_UTIL_CONCURRENT_LOCKS_REENTRANTREADWRITELOCK_H
+
+#ifdef __cplusplus
+
+#include "beecrypt/c++/lang/Object.h"
+using beecrypt::lang::Object;
+#include "beecrypt/c++/util/concurrent/locks/ReadWriteLock.h"
+using beecrypt::util::concurrent::locks::ReadWriteLock;
+
+#include <map>
+using std::map;
+
+namespace beecrypt {
+	namespace util {
+		namespace concurrent {
+			namespace locks {
+				/*!\brief A ReadWriteLock built on the monitor of this
+				 *  object.
+				 *
+				 * Both locks are reentrant, and the holder of the write
+				 * lock may also take the read lock. Once a writer is
+				 * waiting, threads which don't hold the read lock yet wait
+				 * behind it, so that a steady stream of readers cannot
+				 * starve it; a thread which already holds the read lock
+				 * takes it again right away. The read lock can't be
+				 * upgraded to the write lock, and has to be released by
+				 * the thread which took it.
+				 *
+				 * Neither lock supports conditions.
+				 * \ingroup CXX_UTIL_CONCURRENT_LOCKS_m
+				 */
+				class BEECRYPTCXXAPI ReentrantReadWriteLock : public Object, public virtual ReadWriteLock
+				{
+				private:
+					class BEECRYPTCXXAPI ReadLock : public Object, public virtual Lock
+					{
+					private:
+						ReentrantReadWriteLock* _rw;
+
+					public:
+						ReadLock(ReentrantReadWriteLock*);
+						virtual ~ReadLock() {}
+
+						virtual void lock();
+						virtual void lockInterruptibly() throw (InterruptedException);
+						virtual Condition* newCondition();
+						virtual bool tryLock();
+						virtual void unlock();
+					};
+
+					class BEECRYPTCXXAPI WriteLock : public Object, public virtual Lock
+					{
+					private:
+						ReentrantReadWriteLock* _rw;
+
+					public:
+						WriteLock(ReentrantReadWriteLock*);
+						virtual ~WriteLock() {}
+
+						virtual void lock();
+						virtual void lockInterruptibly() throw (InterruptedException);
+						virtual Condition* newCondition();
+						virtual bool tryLock();
+						virtual void unlock();
+					};
+
+					ReadLock _rlock;
+					WriteLock _wlock;
+
+					unsigned int _readers;
+					map<bc_threadid_t, unsigned int> _read_holds;
+					unsigned int _writers_waiting;
+					unsigned int _write_count;
+					bc_threadid_t _writer;
+
+					bool readable(bc_threadid_t) const;
+					bool writable() const;
+
+				public:
+					ReentrantReadWriteLock();
+					virtual ~ReentrantReadWriteLock() {}
+
+					virtual Lock& readLock();
+					virtual Lock& writeLock();
+				};
+			}
+		}
+	}
+}
+
+#endif
+
+#endif
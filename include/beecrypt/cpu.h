@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file cpu.h
+ * \brief Run-time detection of processor features, headers.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ */
+
+#ifndef _CPU_H
+#define _CPU_H
+
+#include "beecrypt/beecrypt.h"
+
+#define CPU_FEATURE_SSE2	0x00000001
+#define CPU_FEATURE_SSSE3	0x00000002
+#define CPU_FEATURE_SSE41	0x00000004
+#define CPU_FEATURE_AESNI	0x00000008
+#define CPU_FEATURE_PCLMUL	0x00000010
+#define CPU_FEATURE_AVX		0x00000020
+#define CPU_FEATURE_AVX2	0x00000040
+#define CPU_FEATURE_BMI2	0x00000080
+#define CPU_FEATURE_ADX		0x00000100
+#define CPU_FEATURE_SHA		0x00000200
+#define CPU_FEATURE_RDRAND	0x00000400
+#define CPU_FEATURE_RDSEED	0x00000800
+#define CPU_FEATURE_AVX512F	0x00001000
+#define CPU_FEATURE_AVX512BW	0x00002000
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn uint32_t cpuFeatures()
+ * \brief This function returns the processor features which the library
+ *  may use on this host.
+ *
+ * The processor is probed on the first call; features which need operating
+ * system support (such as the AVX register state) are only reported if the
+ * operating system has enabled them.
+ *
+ * Environment variable BEECRYPT_CPU_MASK can be set to a hexadecimal mask
+ * of the features the library is allowed to use; setting it to 0 forces the
+ * portable code paths.
+ *
+ * \return A combination of the CPU_FEATURE_* flags.
+ */
+BEECRYPTAPI
+uint32_t cpuFeatures(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
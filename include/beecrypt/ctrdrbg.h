@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file ctrdrbg.h
+ * \brief NIST SP 800-90A CTR_DRBG pseudo-random number generator, headers.
+ *
+ * The generator uses AES-256 with the derivation function. The
+ * randomGenerator functions take the lock and seed themselves from the
+ * entropy sources; the instantiate, reseed and generate functions are the
+ * bare algorithm, for callers which supply their own entropy input.
+ *
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup PRNG_m PRNG_ctrdrbg_m
+ */
+
+#ifndef _CTRDRBG_H
+#define _CTRDRBG_H
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/aes.h"
+
+#ifdef _REENTRANT
+# if WIN32
+#  include <windows.h>
+#  include <winbase.h>
+# endif
+#endif
+
+/*!\brief The length of the seed, in bytes: a key plus a block.
+ */
+#define CTRDRBG_SEED_SIZE			48
+
+/*!\brief The largest number of bytes a single generate call may return.
+ */
+#define CTRDRBG_MAX_REQUEST			65536
+
+/*!\brief The number of generate calls after which the randomGenerator
+ *  functions reseed from the entropy sources.
+ */
+#define CTRDRBG_RESEED_INTERVAL		(1 << 24)
+
+/*!\ingroup PRNG_ctrdrbg_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI ctrdrbgParam
+#else
+struct _ctrdrbgParam
+#endif
+{
+	#ifdef _REENTRANT
+	bc_mutex_t	lock;
+	#endif
+	/*!\var key
+	 * \brief Holds the key expansion of the current key.
+	 */
+	aesParam	key;
+	/*!\var v
+	 * \brief The counter block, big-endian.
+	 */
+	byte		v[16];
+	/*!\var reseed
+	 * \brief The number of generate calls since the last reseed.
+	 */
+	uint64_t	reseed;
+};
+
+#ifndef __cplusplus
+typedef struct _ctrdrbgParam ctrdrbgParam;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern BEECRYPTAPI const randomGenerator ctrdrbg;
+
+BEECRYPTAPI
+int ctrdrbgSetup  (ctrdrbgParam*);
+BEECRYPTAPI
+int ctrdrbgSeed   (ctrdrbgParam*, const byte*, size_t);
+BEECRYPTAPI
+int ctrdrbgNext   (ctrdrbgParam*, byte*, size_t);
+BEECRYPTAPI
+int ctrdrbgCleanup(ctrdrbgParam*);
+
+/*!\fn int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize)
+ * \brief This function sets up the generator's state from the entropy
+ *  input, the nonce and the personalization string.
+ * \param dp The generator's parameters.
+ * \param entropy The entropy input.
+ * \param entropysize The size of the entropy input.
+ * \param nonce The nonce; may be null.
+ * \param noncesize The size of the nonce.
+ * \param pers The personalization string; may be null.
+ * \param perssize The size of the personalization string.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int ctrdrbgInstantiate(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize);
+
+/*!\fn int ctrdrbgReseed(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize)
+ * \brief This function mixes new entropy input into the generator's state.
+ * \param dp The generator's parameters.
+ * \param entropy The entropy input.
+ * \param entropysize The size of the entropy input.
+ * \param add The additional input; may be null.
+ * \param addsize The size of the additional input.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int ctrdrbgReseed(ctrdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize);
+
+/*!\fn int ctrdrbgGenerate(ctrdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize)
+ * \brief This function generates random data.
+ *
+ * Whole blocks are encrypted in place in the output buffer, all at once.
+ * \param dp The generator's parameters.
+ * \param data The buffer which receives the random data.
+ * \param size The number of bytes to generate; at most CTRDRBG_MAX_REQUEST.
+ * \param add The additional input; may be null.
+ * \param addsize The size of the additional input.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int ctrdrbgGenerate(ctrdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 #define _DLDP_H
 
 #include "beecrypt/mpbarrett.h"
+#include "beecrypt/mpmont.h"
 
 /*
  * Discrete Logarithm Domain Parameters - Prime
@@ -84,6 +85,20 @@ struct _dldp_p
 	 * \f$n=p-1=qr\f$
 	 */
 	mpbarrett n;
+	/*!\var gfb
+	 * \brief Optional precomputed powers of \f$g\f$.
+	 *
+	 * Filled in by dldp_pPrecompute; while present, it speeds up the
+	 * computation of powers of \f$g\f$ modulo \f$p\f$.
+	 */
+	mpbfixedbase gfb;
+	/*!\var pm
+	 * \brief Optional Montgomery context for \f$p\f$.
+	 *
+	 * Filled in by dldp_pPrecompute; dlsvdp_pDHSecret uses it while it
+	 * matches \f$p\f$.
+	 */
+	mpmont pm;
 #ifdef __cplusplus
 	dldp_p();
 	dldp_p(const dldp_p&);
@@ -110,6 +125,24 @@ int dldp_pFree(dldp_p*);
 BEECRYPTAPI
 int dldp_pCopy(dldp_p*, const dldp_p*);
 
+/*!\fn int dldp_pPrecompute(dldp_p* dp)
+ * \brief This function precomputes a table of powers of the generator.
+ *
+ * Afterwards, dldp_pPublic and dldp_pPair compute \f$g^x\ \textrm{mod}\ p\f$
+ * from the table, which is several times faster than an ordinary modular
+ * exponentiation. The table covers exponents up to the size of \f$n\f$ if
+ * it is set, otherwise of \f$q\f$. It can also be passed to dsasignfb,
+ * elgv1signfb and elgv3signfb, and is only read after this call, so the
+ * parameters can be shared between threads.
+ * The table is discarded when a new generator is made, or by dldp_pFree.
+ * The Montgomery context for \f$p\f$ is prepared as well.
+ * \param dp The domain parameters.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int dldp_pPrecompute(dldp_p*);
+
 /*
  * Functions for generating keys
  */
@@ -133,7 +166,9 @@ BEECRYPTAPI
 int  dldp_pEqual  (const dldp_p*, const dldp_p*);
 
 /*
- * Functions for generating and validating dldp_pgoq variant domain parameters
+ * Functions for generating and validating dldp_pgoq variant domain parameters;
+ * the Parallel variants race the given number of workers for the prime p,
+ * 0 meaning the default number of threads, as mpprndsafepar does
  */
 
 BEECRYPTAPI
@@ -141,6 +176,10 @@ int dldp_pgoqMake     (dldp_p*, randomGeneratorContext*, size_t, size_t, int);
 BEECRYPTAPI
 int dldp_pgoqMakeSafe (dldp_p*, randomGeneratorContext*, size_t);
 BEECRYPTAPI
+int dldp_pgoqMakeParallel    (dldp_p*, randomGeneratorContext*, size_t, size_t, int, unsigned int);
+BEECRYPTAPI
+int dldp_pgoqMakeSafeParallel(dldp_p*, randomGeneratorContext*, size_t, unsigned int);
+BEECRYPTAPI
 int dldp_pgoqGenerator(dldp_p*, randomGeneratorContext*);
 BEECRYPTAPI
 int  dldp_pgoqValidate (const dldp_p*, randomGeneratorContext*, int);
@@ -154,6 +193,10 @@ int dldp_pgonMake     (dldp_p*, randomGeneratorContext*, size_t, size_t);
 BEECRYPTAPI
 int dldp_pgonMakeSafe (dldp_p*, randomGeneratorContext*, size_t);
 BEECRYPTAPI
+int dldp_pgonMakeParallel    (dldp_p*, randomGeneratorContext*, size_t, size_t, unsigned int);
+BEECRYPTAPI
+int dldp_pgonMakeSafeParallel(dldp_p*, randomGeneratorContext*, size_t, unsigned int);
+BEECRYPTAPI
 int dldp_pgonGenerator(dldp_p*, randomGeneratorContext*);
 BEECRYPTAPI
 int dldp_pgonValidate (const dldp_p*, randomGeneratorContext*);
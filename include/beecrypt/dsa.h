@@ -50,6 +50,9 @@ extern "C" {
  * \li \f$r=(g^{k}\ \textrm{mod}\ p)\ \textrm{mod}\ q\f$
  * \li \f$s=k^{-1}(h(m)+xr)\ \textrm{mod}\ q\f$
  *
+ * The exponentiation uses the engine selected with mpengineSetup; the
+ * workspace comes from the calling thread's arena, see mpwksp.h.
+ *
  * \param p The prime.
  * \param q The cofactor.
  * \param g The generator.
@@ -64,6 +67,35 @@ extern "C" {
 BEECRYPTAPI
 int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
 
+/*!\fn int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+ * \brief Like dsasign, with a caller-provided workspace of
+ *  (5*psize+2)+(9*qsize+6) words.
+ *
+ * If \a r and \a s already have the size of \a q, this function doesn't
+ * allocate any memory. The workspace holds the secret \e k afterwards, and
+ * should be wiped before it is released.
+ */
+BEECRYPTAPI
+int dsasign_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp);
+
+/*!\fn int dsasignfb(const mpbarrett* p, const mpbarrett* q, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs a raw DSA signature, like dsasign, but
+ *  with precomputed powers of the generator.
+ * \param p The prime.
+ * \param q The cofactor.
+ * \param gfb The powers of the generator, as precomputed by
+ *  dldp_pPrecompute or mpbfbinit.
+ * \param rgc The pseudo-random generator context.
+ * \param hm The hash to be signed.
+ * \param x The private key value.
+ * \param r The signature's \e r value.
+ * \param s The signature's \e s value.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int dsasignfb(const mpbarrett* p, const mpbarrett* q, const mpbfixedbase* gfb, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
 /*!\fn int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s)
  * \brief This function performs a raw DSA verification.
  *
@@ -88,6 +120,13 @@ int dsasign(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, randomGen
 BEECRYPTAPI
 int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s);
 
+/*!\fn int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
+ * \brief Like dsavrfy, with a caller-provided workspace of
+ *  (6*psize+2)+(8*qsize+6) words.
+ */
+BEECRYPTAPI
+int dsavrfy_w(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp);
+
 /*!\fn int dsaparamMake(dsaparam* dp, randomGeneratorContext* rgc, size_t psize)
  * \brief This function generates a set of DSA parameters.
  *
@@ -103,6 +142,22 @@ int dsavrfy(const mpbarrett* p, const mpbarrett* q, const mpnumber* g, const mpn
 BEECRYPTAPI
 int dsaparamMake(dsaparam*, randomGeneratorContext*, size_t);
 
+/*!\fn int dsaparamMakeParallel(dsaparam* dp, randomGeneratorContext* rgc, size_t psize, unsigned int workers)
+ * \brief Like dsaparamMake, with several workers racing for the prime p.
+ *
+ * This function calls dldp_pgoqMakeParallel; the parameters don't depend
+ * on rgc alone, but also on which worker finishes first.
+ *
+ * \param dp The parameters to be generated.
+ * \param rgc The random generator context.
+ * \param psize The size of prime parameter p, as for dsaparamMake.
+ * \param workers The number of workers; 0 means the default number of threads.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int dsaparamMakeParallel(dsaparam*, randomGeneratorContext*, size_t, unsigned int);
+
 #ifdef __cplusplus
 }
 #endif
@@ -134,6 +134,80 @@ int elgv1vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const m
 BEECRYPTAPI
 int elgv3vrfy(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s);
 
+/*!\fn int elgv1signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs raw ElGamal signing, variant 1, like
+ *  elgv1sign, but with precomputed powers of the generator.
+ * \param p The prime.
+ * \param n The reducer mod (p-1).
+ * \param gfb The powers of the generator, as precomputed by
+ *  dldp_pPrecompute or mpbfbinit.
+ * \param rgc The pseudo-random generator context.
+ * \param hm The hash to be signed.
+ * \param x The private key value.
+ * \param r The signature's \e r value.
+ * \param s The signature's \e s value.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int elgv1signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
+/*!\fn int elgv3signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s)
+ * \brief This function performs raw ElGamal signing, variant 3, like
+ *  elgv3sign, but with precomputed powers of the generator.
+ * \param p The prime.
+ * \param n The reducer mod (p-1).
+ * \param gfb The powers of the generator, as precomputed by
+ *  dldp_pPrecompute or mpbfbinit.
+ * \param rgc The pseudo-random generator context.
+ * \param hm The hash to be signed.
+ * \param x The private key value.
+ * \param r The signature's \e r value.
+ * \param s The signature's \e s value.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int elgv3signfb(const mpbarrett* p, const mpbarrett* n, const mpbfixedbase* gfb, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s);
+
+/*!\name Variants with a caller-provided workspace
+ *
+ * These never allocate memory of their own, as long as \a r and \a s
+ * already have the right size. The variants above take their workspace
+ * from the calling thread's arena; see mpwksp.h.
+ *
+ * After signing, the workspace holds the secret \e k; wipe it before it
+ * is released.
+ * \{
+ */
+
+/*!\fn int elgv1sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+ * \brief Like elgv1sign; needs (8*size+6) words of workspace.
+ */
+BEECRYPTAPI
+int elgv1sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp);
+
+/*!\fn int elgv1vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
+ * \brief Like elgv1vrfy; needs (6*size+2) words of workspace.
+ */
+BEECRYPTAPI
+int elgv1vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp);
+
+/*!\fn int elgv3sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext* rgc, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp)
+ * \brief Like elgv3sign; needs (6*size+2) words of workspace.
+ */
+BEECRYPTAPI
+int elgv3sign_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, randomGeneratorContext*, const mpnumber* hm, const mpnumber* x, mpnumber* r, mpnumber* s, mpw* wksp);
+
+/*!\fn int elgv3vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp)
+ * \brief Like elgv3vrfy; needs (6*size+2) words of workspace.
+ */
+BEECRYPTAPI
+int elgv3vrfy_w(const mpbarrett* p, const mpbarrett* n, const mpnumber* g, const mpnumber* hm, const mpnumber* y, const mpnumber* r, const mpnumber* s, mpw* wksp);
+
+/*!\}
+ */
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,7 +20,7 @@
 /*!\file entropy.h
  * \brief Entropy sources, headers.
  * \author Bob Deblier <bob.deblier@telenet.be>
- * \ingroup ES_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
+ * \ingroup ES_m ES_getrandom_m ES_audio_m ES_dsp_m ES_random_m ES_urandom_m ES_tty_m
  */
 
 #ifndef _ENTROPY_H
@@ -49,6 +49,23 @@ int entropy_console(byte*, size_t);
 BEECRYPTAPI
 int entropy_wincrypt(byte*, size_t);
 #else
+#if HAVE_GETRANDOM
+/*!\fn int entropy_getrandom(byte* data, size_t size)
+ * \brief This function gathers entropy with the getrandom system call.
+ *
+ * It needs no file descriptor and never blocks; if the kernel's pool is
+ * not yet initialized it fails, so that the next source is tried. Small
+ * requests are served from a buffer, which is refilled with one call for
+ * many requests. If the processor has the RDRAND or RDSEED instruction,
+ * its output is mixed in; environment variable BEECRYPT_CPU_MASK can be
+ * used to turn this off.
+ * \param data The buffer which receives the entropy.
+ * \param size The number of bytes requested.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+int entropy_getrandom  (byte*, size_t);
+#endif
 #if HAVE_DEV_AUDIO
 int entropy_dev_audio  (byte*, size_t);
 #endif
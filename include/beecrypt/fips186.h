@@ -73,6 +73,16 @@ extern "C" {
 
 extern BEECRYPTAPI const randomGenerator fips186prng;
 
+/*!\var fips186ptprng
+ * \brief FIPS 186 generator which keeps a separate state for each thread.
+ *
+ * All contexts in a thread share that thread's state, so generating data
+ * takes no lock. Each thread's state comes from a shared root generator,
+ * and is replaced after a fork. Without thread-local storage, every context
+ * gets its own generator, as with fips186prng.
+ */
+extern BEECRYPTAPI const randomGenerator fips186ptprng;
+
 BEECRYPTAPI
 int fips186Setup  (fips186Param*);
 BEECRYPTAPI
@@ -46,6 +46,19 @@ int hmacUpdate(                          const hashFunction*, hashFunctionParam*
 BEECRYPTAPI
 int hmacDigest(             const byte*, const hashFunction*, hashFunctionParam*, byte*);
 
+/* these variants also keep the hash state after absorbing each of the key
+ * pads, in two extra parameter blocks; if the hash function can copy its
+ * state, resetting and finishing then restore those instead of hashing the
+ * pads again
+ */
+
+BEECRYPTAPI
+int hmacSetupState (      byte*,       byte*, hashFunctionParam*, hashFunctionParam*, const hashFunction*, hashFunctionParam*, const byte*, size_t);
+BEECRYPTAPI
+int hmacResetState (const byte*,              const hashFunctionParam*,                     const hashFunction*, hashFunctionParam*);
+BEECRYPTAPI
+int hmacDigestState(             const byte*, const hashFunctionParam*, const hashFunctionParam*, const hashFunction*, hashFunctionParam*, byte*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file hmacdrbg.h
+ * \brief NIST SP 800-90A HMAC_DRBG pseudo-random number generator, headers.
+ *
+ * The generator uses HMAC-SHA-256. The randomGenerator functions take the
+ * lock and seed themselves from the entropy sources; the instantiate,
+ * reseed and generate functions are the bare algorithm, for callers which
+ * supply their own entropy input.
+ *
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup PRNG_m PRNG_hmacdrbg_m
+ */
+
+#ifndef _HMACDRBG_H
+#define _HMACDRBG_H
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/hmacsha256.h"
+
+#ifdef _REENTRANT
+# if WIN32
+#  include <windows.h>
+#  include <winbase.h>
+# endif
+#endif
+
+/*!\brief The largest number of bytes a single generate call may return.
+ */
+#define HMACDRBG_MAX_REQUEST		65536
+
+/*!\brief The number of generate calls after which the randomGenerator
+ *  functions reseed from the entropy sources.
+ */
+#define HMACDRBG_RESEED_INTERVAL	(1 << 24)
+
+/*!\ingroup PRNG_hmacdrbg_m
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI hmacdrbgParam
+#else
+struct _hmacdrbgParam
+#endif
+{
+	#ifdef _REENTRANT
+	bc_mutex_t	lock;
+	#endif
+	/*!\var mac
+	 * \brief Holds the HMAC set up with the current key.
+	 */
+	hmacsha256Param	mac;
+	/*!\var v
+	 * \brief The current value.
+	 */
+	byte		v[32];
+	/*!\var reseed
+	 * \brief The number of generate calls since the last reseed.
+	 */
+	uint64_t	reseed;
+};
+
+#ifndef __cplusplus
+typedef struct _hmacdrbgParam hmacdrbgParam;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern BEECRYPTAPI const randomGenerator hmacdrbg;
+
+BEECRYPTAPI
+int hmacdrbgSetup  (hmacdrbgParam*);
+BEECRYPTAPI
+int hmacdrbgSeed   (hmacdrbgParam*, const byte*, size_t);
+BEECRYPTAPI
+int hmacdrbgNext   (hmacdrbgParam*, byte*, size_t);
+BEECRYPTAPI
+int hmacdrbgCleanup(hmacdrbgParam*);
+
+/*!\fn int hmacdrbgInstantiate(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize)
+ * \brief This function sets up the generator's state from the entropy
+ *  input, the nonce and the personalization string.
+ * \param dp The generator's parameters.
+ * \param entropy The entropy input.
+ * \param entropysize The size of the entropy input.
+ * \param nonce The nonce; may be null.
+ * \param noncesize The size of the nonce.
+ * \param pers The personalization string; may be null.
+ * \param perssize The size of the personalization string.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int hmacdrbgInstantiate(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* nonce, size_t noncesize, const byte* pers, size_t perssize);
+
+/*!\fn int hmacdrbgReseed(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize)
+ * \brief This function mixes new entropy input into the generator's state.
+ * \param dp The generator's parameters.
+ * \param entropy The entropy input.
+ * \param entropysize The size of the entropy input.
+ * \param add The additional input; may be null.
+ * \param addsize The size of the additional input.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int hmacdrbgReseed(hmacdrbgParam* dp, const byte* entropy, size_t entropysize, const byte* add, size_t addsize);
+
+/*!\fn int hmacdrbgGenerate(hmacdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize)
+ * \brief This function generates random data.
+ *
+ * Each block of output takes two runs of the compression function, which
+ * start from the inner and outer states cached by the HMAC.
+ * \param dp The generator's parameters.
+ * \param data The buffer which receives the random data.
+ * \param size The number of bytes to generate; at most HMACDRBG_MAX_REQUEST.
+ * \param add The additional input; may be null.
+ * \param addsize The size of the additional input.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int hmacdrbgGenerate(hmacdrbgParam* dp, byte* data, size_t size, const byte* add, size_t addsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,6 +36,8 @@ typedef struct
 	md5Param mparam;
 	byte kxi[64];
 	byte kxo[64];
+	md5Param istate;	/* mparam after absorbing kxi */
+	md5Param ostate;	/* mparam after absorbing kxo */
 } hmacmd5Param;
 
 #ifdef __cplusplus
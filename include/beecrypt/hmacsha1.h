@@ -36,6 +36,8 @@ typedef struct
 	sha1Param sparam;
 	byte kxi[64];
 	byte kxo[64];
+	sha1Param istate;	/* sparam after absorbing kxi */
+	sha1Param ostate;	/* sparam after absorbing kxo */
 } hmacsha1Param;
 
 #ifdef __cplusplus
@@ -36,6 +36,8 @@ typedef struct
 	sha224Param sparam;
 	byte kxi[64];
 	byte kxo[64];
+	sha224Param istate;	/* sparam after absorbing kxi */
+	sha224Param ostate;	/* sparam after absorbing kxo */
 } hmacsha224Param;
 
 #ifdef __cplusplus
@@ -36,6 +36,8 @@ typedef struct
 	sha256Param sparam;
 	byte kxi[64];
 	byte kxo[64];
+	sha256Param istate;	/* sparam after absorbing kxi */
+	sha256Param ostate;	/* sparam after absorbing kxo */
 } hmacsha256Param;
 
 #ifdef __cplusplus
@@ -36,6 +36,8 @@ typedef struct
 	sha384Param sparam;
 	byte kxi[128];
 	byte kxo[128];
+	sha384Param istate;	/* sparam after absorbing kxi */
+	sha384Param ostate;	/* sparam after absorbing kxo */
 } hmacsha384Param;
 
 #ifdef __cplusplus
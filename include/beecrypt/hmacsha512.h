@@ -36,6 +36,8 @@ typedef struct
 	sha512Param sparam;
 	byte kxi[128];
 	byte kxo[128];
+	sha512Param istate;	/* sparam after absorbing kxi */
+	sha512Param ostate;	/* sparam after absorbing kxo */
 } hmacsha512Param;
 
 #ifdef __cplusplus
@@ -84,6 +84,16 @@ BEECRYPTAPI
 void md4Process(md4Param* mp)
 	/*@modifies mp @*/;
 
+/*!\fn void md4ProcessBlocks(md4Param* mp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param mp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void md4ProcessBlocks(md4Param* mp, const byte* blocks, size_t nblocks);
+
 /*!\fn int md4Reset(md4Param* mp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -94,6 +104,26 @@ BEECRYPTAPI
 int md4Reset   (md4Param* mp)
 	/*@modifies mp @*/;
 
+/*!\fn int md4Copy(md4Param* dst, const md4Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int md4Copy    (md4Param* dst, const md4Param* src)
+	/*@modifies dst @*/;
+
+/*!\fn int md4Check(const md4Param* mp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param mp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int md4Check   (const md4Param* mp);
+
 /*!\fn int md4Update(md4Param* mp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data
  *  to be hashed.
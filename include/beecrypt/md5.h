@@ -83,6 +83,16 @@ extern BEECRYPTAPI const hashFunction md5;
 BEECRYPTAPI
 void md5Process(md5Param* mp);
 
+/*!\fn void md5ProcessBlocks(md5Param* mp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param mp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void md5ProcessBlocks(md5Param* mp, const byte* blocks, size_t nblocks);
+
 /*!\fn int md5Reset(md5Param* mp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -92,6 +102,25 @@ void md5Process(md5Param* mp);
 BEECRYPTAPI
 int md5Reset   (md5Param* mp);
 
+/*!\fn int md5Copy(md5Param* dst, const md5Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int md5Copy(md5Param* dst, const md5Param* src);
+
+/*!\fn int md5Check(const md5Param* mp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param mp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int md5Check(const md5Param* mp);
+
 /*!\fn int md5Update(md5Param* mp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data
  *  to be hashed.
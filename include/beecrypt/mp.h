@@ -70,6 +70,21 @@
 #define MP_LSBMASK	 ((mpw) 0x1)
 #define MP_ALLMASK	~((mpw) 0x0)
 
+/*!\name Karatsuba thresholds
+ * \brief Operand sizes, in words, from which multiplication and squaring
+ *  switch from the schoolbook method to Karatsuba; see mpkaratsubaSetup.
+ * \{
+ */
+#define MP_KARATSUBA_MIN_THRESHOLD	8
+#ifndef MP_KARATSUBA_MUL_THRESHOLD
+# define MP_KARATSUBA_MUL_THRESHOLD	32
+#endif
+#ifndef MP_KARATSUBA_SQR_THRESHOLD
+# define MP_KARATSUBA_SQR_THRESHOLD	48
+#endif
+/*!\}
+ */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -664,6 +679,9 @@ void mpaddsqrtrc(size_t size, mpw* result, const mpw* data);
 
 /*!\fn void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
  * \brief This function computes a full multi-precision product.
+ *
+ * Operands above the Karatsuba threshold are multiplied with a workspace
+ * on the stack, up to a limit; beyond that use mpmul_w.
  */
 BEECRYPTAPI
 void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata);
@@ -674,6 +692,35 @@ void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw*
 BEECRYPTAPI
 void mpsqr(mpw* result, size_t size, const mpw* data);
 
+/*!\fn void mpmul_w(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata, mpw* wksp)
+ * \brief This function computes a full multi-precision product, using
+ *  Karatsuba multiplication for large operands.
+ * \param result The product; (xsize+ysize) words, which may not overlap
+ *  either operand.
+ * \param wksp The workspace; (6*size) words, with size the smaller of
+ *  xsize and ysize.
+ */
+BEECRYPTAPI
+void mpmul_w(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata, mpw* wksp);
+
+/*!\fn void mpsqr_w(mpw* result, size_t size, const mpw* data, mpw* wksp)
+ * \brief This function computes a full multi-precision square, using
+ *  Karatsuba squaring for large operands.
+ * \param result The square; (2*size) words, which may not overlap data.
+ * \param wksp The workspace; (4*size) words.
+ */
+BEECRYPTAPI
+void mpsqr_w(mpw* result, size_t size, const mpw* data, mpw* wksp);
+
+/*!\fn int mpkaratsubaSetup(size_t mulsize, size_t sqrsize)
+ * \brief This function sets the operand sizes, in words, from which
+ *  multiplication and squaring use the Karatsuba method.
+ * \retval 0 on success.
+ * \retval -1 if either size is below MP_KARATSUBA_MIN_THRESHOLD.
+ */
+BEECRYPTAPI
+int mpkaratsubaSetup(size_t mulsize, size_t sqrsize);
+
 BEECRYPTAPI
 void mpgcd_w(size_t size, const mpw* xdata, const mpw* ydata, mpw* result, mpw* wksp);
 
@@ -63,6 +63,28 @@ BEECRYPTAPI
 std::ostream& operator<<(std::ostream&, const mpbarrett&);
 #endif
 
+/*!\brief Precomputed powers of a fixed base, modulo a Barrett modulus.
+ *
+ * Built once with mpbfbinit, the table only needs to be read when computing
+ * powers, so it can be shared between threads.
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI mpbfixedbase
+#else
+struct _mpbfixedbase
+#endif
+{
+	size_t	size;	/* size of the modulus, in words */
+	size_t	bits;	/* number of exponent bits covered by the table */
+	mpw*	base;	/* (size) words, followed by the modulus and the table */
+	mpw*	modl;	/* (size) words, a copy of the modulus */
+	mpw*	table;	/* (15*(bits/4)*size) words */
+};
+
+#ifndef __cplusplus
+typedef struct _mpbfixedbase mpbfixedbase;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -119,13 +141,24 @@ void mpbpowmodsld_w(const mpbarrett*, const mpw*, size_t, const mpw*, mpw*, mpw*
 BEECRYPTAPI
 void mpbtwopowmod_w(const mpbarrett*, size_t, const mpw*, mpw*, mpw*);
 
-/* To be added:
- * simultaneous multiple exponentiation, for use in dsa and elgamal signature verification
- */
 BEECRYPTAPI
-void mpbsm2powmod(const mpbarrett*, const mpw*, const mpw*, const mpw*, const mpw*);
+void mpbfbzero(mpbfixedbase*);
+BEECRYPTAPI
+int  mpbfbinit(mpbfixedbase*, const mpbarrett*, size_t, const mpw*, size_t);
+BEECRYPTAPI
+void mpbfbfree(mpbfixedbase*);
 BEECRYPTAPI
-void mpbsm3powmod(const mpbarrett*, const mpw*, const mpw*, const mpw*, const mpw*, const mpw*, const mpw*);
+int  mpbfbcopy(mpbfixedbase*, const mpbfixedbase*);
+BEECRYPTAPI
+int  mpbfbmatch(const mpbfixedbase*, const mpbarrett*, size_t, const mpw*);
+BEECRYPTAPI
+void mpbfbpowmod_w(const mpbfixedbase*, const mpbarrett*, size_t, const mpw*, mpw*, mpw*);
+
+/* simultaneous multiple exponentiation, for use in dsa and elgamal signature verification */
+BEECRYPTAPI
+void mpbsm2powmod_w(const mpbarrett*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpbsm3powmod_w(const mpbarrett*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
 
 BEECRYPTAPI
 int  mpbpprime_w(const mpbarrett*, randomGeneratorContext*, int, mpw*);
@@ -144,6 +177,12 @@ BEECRYPTAPI
 void mpbnpowmod   (const mpbarrett*, const mpnumber*, const mpnumber*, mpnumber*);
 BEECRYPTAPI
 void mpbnpowmodsld(const mpbarrett*, const mpw*, const mpnumber*, mpnumber*);
+BEECRYPTAPI
+void mpbnfbpowmod (const mpbfixedbase*, const mpbarrett*, const mpnumber*, mpnumber*);
+BEECRYPTAPI
+void mpbsm2powmod (const mpbarrett*, const mpnumber*, const mpnumber*, const mpnumber*, const mpnumber*, mpnumber*);
+BEECRYPTAPI
+void mpbsm3powmod (const mpbarrett*, const mpnumber*, const mpnumber*, const mpnumber*, const mpnumber*, const mpnumber*, const mpnumber*, mpnumber*);
 
 BEECRYPTAPI
 size_t mpbbits(const mpbarrett*);
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpmont.h
+ * \brief Multi-precision integer routines using Montgomery modular reduction, headers.
+ *
+ * Values are kept in Montgomery form, i.e. multiplied by R = 2^(MP_WBITS*size)
+ * modulo m, which turns every modular reduction into a series of
+ * multiply-and-add steps without any division. The modulus must be odd.
+ *
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup MP_m
+ */
+
+#ifndef _MPMONT_H
+#define _MPMONT_H
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpnumber.h"
+#include "beecrypt/mpbarrett.h"
+
+/*!\brief Montgomery reduction context for an odd modulus.
+ */
+#ifdef __cplusplus
+struct BEECRYPTAPI mpmont
+#else
+struct _mpmont
+#endif
+{
+	size_t	size;
+	mpw*	modl;	/* (size) words */
+	mpw*	rr;		/* (size) words, R^2 mod m */
+	mpw		minv;	/* -1/m mod 2^MP_WBITS */
+};
+
+#ifndef __cplusplus
+typedef struct _mpmont mpmont;
+#endif
+
+/*!\name Modular exponentiation engines
+ * \{
+ */
+#define MP_ENGINE_BARRETT		0
+#define MP_ENGINE_MONTGOMERY	1
+/*!\}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn mpw mpmontmul(size_t size, mpw* result, const mpw* xdata, const mpw* ydata, const mpw* modl, mpw minv)
+ * \brief Fused multiply and Montgomery reduction kernel.
+ *
+ * Computes x*y/R modulo m, without the final subtraction: the result is
+ * less than 2*m, with its top bit returned as carry.
+ *
+ * \param size The size of x, y, m and the result, in words.
+ * \param result The result; may not overlap x or y.
+ * \param minv -1/m modulo 2^MP_WBITS.
+ * \return The carry out of the top word.
+ */
+BEECRYPTAPI
+mpw mpmontmul(size_t size, mpw* result, const mpw* xdata, const mpw* ydata, const mpw* modl, mpw minv);
+
+BEECRYPTAPI
+void mpmontzero(mpmont*);
+BEECRYPTAPI
+int  mpmontset(mpmont*, size_t, const mpw*);
+BEECRYPTAPI
+void mpmontfree(mpmont*);
+BEECRYPTAPI
+int  mpmontcopy(mpmont*, const mpmont*);
+
+/*!\fn int mpmontmatch(const mpmont* m, const mpbarrett* b)
+ * \brief Checks whether a context was set up for a given modulus.
+ * \param m The context, or a null pointer.
+ * \param b The modulus.
+ * \retval 1 if \a m is set up for the modulus of \a b.
+ * \retval 0 otherwise.
+ */
+BEECRYPTAPI
+int  mpmontmatch(const mpmont* m, const mpbarrett* b);
+
+/* conversions into and out of Montgomery form; workspace (4*size+2) words */
+BEECRYPTAPI
+void mpmonttomont_w  (const mpmont*, size_t, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontfrommont_w(const mpmont*, const mpw*, mpw*, mpw*);
+
+/* operations on values in Montgomery form; workspace (4*size+2) words */
+BEECRYPTAPI
+void mpmontmulmod_w(const mpmont*, const mpw*, const mpw*, mpw*, mpw*);
+BEECRYPTAPI
+void mpmontsqrmod_w(const mpmont*, const mpw*, mpw*, mpw*);
+
+/* exponentiation of a value in normal form; workspace (4*size+2) words;
+ * returns -1 if there is no memory for the window table */
+BEECRYPTAPI
+int  mpmontpowmod_w(const mpmont*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+
+/*!\fn void mpmontpowmodn_w(const mpmont* m, size_t lanes, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+ * \brief Raises several values to the same power.
+ *
+ * The lanes walk the exponent in lockstep, one operation for every lane at
+ * a time; their multiplications don't depend on each other, so the
+ * processor can overlap them.
+ *
+ * \param lanes The number of values.
+ * \param xdata The values, each of size words, one after the other.
+ * \param result The results, laid out like \a xdata.
+ * \param wksp Workspace of ((8*lanes+4)*size+2) words.
+ */
+BEECRYPTAPI
+void mpmontpowmodn_w(const mpmont* m, size_t lanes, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp);
+
+BEECRYPTAPI
+int  mpmontnpowmod(const mpmont*, const mpnumber*, const mpnumber*, mpnumber*);
+
+/*!\fn int mpengineSetup(int engine)
+ * \brief Selects the engine used for private key exponentiations.
+ *
+ * With MP_ENGINE_MONTGOMERY, rsapri, rsapricrt, dsasign and
+ * dlsvdp_pDHSecret exponentiate with Montgomery reduction whenever the
+ * modulus is odd; the default is MP_ENGINE_BARRETT.
+ *
+ * The engine is a single setting for the whole process, read without any
+ * locking; select it once, before other threads start using private keys.
+ *
+ * \param engine MP_ENGINE_BARRETT or MP_ENGINE_MONTGOMERY.
+ * \retval 0 on success.
+ * \retval -1 on unknown engine.
+ */
+BEECRYPTAPI
+int  mpengineSetup(int engine);
+BEECRYPTAPI
+int  mpengine(void);
+
+/*!\fn void mpenginepowmod_w(const mpbarrett* b, const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+ * \brief Computes x^p mod b with the selected engine.
+ *
+ * Needs the same (4*size+2) words of workspace as mpbpowmod_w.
+ *
+ * \param m A Montgomery context prepared for \a b, or a null pointer; it
+ *  is only used if it matches \a b, otherwise the Montgomery engine sets up
+ *  a temporary context, which costs a division.
+ */
+BEECRYPTAPI
+void mpenginepowmod_w(const mpbarrett*, const mpmont*, size_t, const mpw*, size_t, const mpw*, mpw*, mpw*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
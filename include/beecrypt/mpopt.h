@@ -135,6 +135,7 @@
 #  define ASM_MPSETMUL
 #  define ASM_MPADDMUL
 #  define ASM_MPADDSQRTRC
+#  define ASM_MPMONTMUL
 # endif
 #endif
 
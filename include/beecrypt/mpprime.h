@@ -52,6 +52,56 @@ void mpprndcon_w   (mpbarrett*, randomGeneratorContext*, size_t, int, const mpnu
 BEECRYPTAPI
 void mpprndconone_w(mpbarrett*, randomGeneratorContext*, size_t, int, const mpbarrett*, const mpnumber*, mpnumber*, int, mpw*);
 
+/*!\fn int mpprimeParallelSetup(unsigned int threads)
+ * \brief Tunes the prime search of mpprndr_w and mpprndsafe_w.
+ *
+ * The candidates which survive the sieve take the first round of
+ * Miller-Rabin concurrently; the result doesn't depend on the number of
+ * threads.
+ * \param threads The maximum number of threads; 0 means the OpenMP
+ *  default.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int mpprimeParallelSetup(unsigned int threads);
+
+/*!\fn int mpprndsafepar(mpbarrett* p, randomGeneratorContext* rc, size_t bits, int t, unsigned int workers)
+ * \brief Generates a probable safe prime, with several workers racing.
+ *
+ * Every worker searches with its own generator, forked from rc; the first
+ * one to find a safe prime wins, and the others stop. Which prime comes
+ * out therefore depends on timing; with one worker, this is the same
+ * search as mpprndsafe_w.
+ * \param p The prime.
+ * \param rc The random generator context.
+ * \param bits The size of the prime, in bits.
+ * \param t The number of Miller-Rabin rounds.
+ * \param workers The number of workers; 0 means the thread count set with
+ *  mpprimeParallelSetup, or else the OpenMP default.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int mpprndsafepar(mpbarrett* p, randomGeneratorContext* rc, size_t bits, int t, unsigned int workers);
+
+/*!\fn int mpprndcononepar(mpbarrett* p, randomGeneratorContext* rc, size_t bits, int t, const mpbarrett* q, const mpnumber* f, mpnumber* r, int cofactor, unsigned int workers)
+ * \brief Generates a probable prime p = qr+1, with several workers racing,
+ *  as mpprndsafepar does for mpprndsafe_w.
+ * \param p The prime.
+ * \param rc The random generator context.
+ * \param bits The size of the prime, in bits.
+ * \param t The number of Miller-Rabin rounds.
+ * \param q The prime which divides p-1.
+ * \param f If not null, p-1 must be coprime to f.
+ * \param r Receives the cofactor r.
+ * \param cofactor The condition on r, as for mpprndconone_w.
+ * \param workers The number of workers, as for mpprndsafepar.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int mpprndcononepar(mpbarrett* p, randomGeneratorContext* rc, size_t bits, int t, const mpbarrett* q, const mpnumber* f, mpnumber* r, int cofactor, unsigned int workers);
+
 #ifdef __cplusplus
 }
 #endif
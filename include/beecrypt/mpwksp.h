@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpwksp.h
+ * \brief Per-thread multi-precision workspace arena, headers.
+ *
+ * The routines which don't take a workspace from their caller get one here.
+ * Every thread keeps a few buffers, which only grow; after the first
+ * operations at a given key size, they no longer touch the heap.
+ *
+ * Without thread-local storage, every request goes straight to malloc.
+ *
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup MP_m
+ */
+
+#ifndef _MPWKSP_H
+#define _MPWKSP_H
+
+#include "beecrypt/api.h"
+#include "beecrypt/mp.h"
+
+/*!\brief The number of buffers each thread keeps; this is also how deep
+ *  requests can nest before falling back to malloc.
+ */
+#define MPWKSP_SLOTS	6
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\fn mpw* mpwkspget(size_t size)
+ * \brief Obtains a workspace of at least \a size words.
+ * \return The workspace, or a null pointer when out of memory.
+ */
+BEECRYPTAPI
+mpw* mpwkspget(size_t size);
+
+/*!\fn void mpwkspput(mpw* wksp)
+ * \brief Returns a workspace obtained from mpwkspget; its contents are wiped.
+ *
+ * Another thread than the one which obtained the workspace may return it;
+ * the buffer then goes back to the original thread's arena.
+ */
+BEECRYPTAPI
+void mpwkspput(mpw* wksp);
+
+/*!\fn void mpwkspfree(void)
+ * \brief Frees the buffers kept by the calling thread.
+ *
+ * A buffer which is still in use is freed when it is returned, by whichever
+ * thread returns it. With POSIX threads this happens automatically when a
+ * thread exits.
+ */
+BEECRYPTAPI
+void mpwkspfree(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -67,6 +67,12 @@ extern "C" {
  */
 extern BEECRYPTAPI const randomGenerator mtprng;
 
+/* like mtprng, but with a separate state for each thread, which comes from
+ * a shared root generator and is replaced after a fork; no lock is taken
+ * to generate data
+ */
+extern BEECRYPTAPI const randomGenerator mtprngpt;
+
 /*
  */
 BEECRYPTAPI
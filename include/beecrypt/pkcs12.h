@@ -36,9 +36,45 @@ extern "C" {
 #define PKCS12_ID_IV		0x2
 #define PKCS12_ID_MAC		0x3
 
+/*!\fn int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+ * \brief This function derives a key from a password and salt.
+ * \param h The hash function to use.
+ * \param id The diversifier; one of PKCS12_ID_CIPHER, PKCS12_ID_IV or PKCS12_ID_MAC.
+ * \param pdata The password data.
+ * \param psize The size of the password data.
+ * \param sdata The salt data.
+ * \param ssize The size of the salt data.
+ * \param iterationcount The number of iterations.
+ * \param ndata The buffer which receives the derived key.
+ * \param nsize The size of the derived key.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
 BEECRYPTAPI
 int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize);
 
+/*!\fn int pkcs12_derive_keys(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, size_t count, const byte* ids, byte* const* ndata, const size_t* nsize)
+ * \brief This function derives several keys from the same password and salt.
+ *
+ * The result is the same as calling pkcs12_derive_key() once for each
+ * diversifier, but the salt and password input is only set up once.
+ *
+ * \param h The hash function to use.
+ * \param pdata The password data.
+ * \param psize The size of the password data.
+ * \param sdata The salt data.
+ * \param ssize The size of the salt data.
+ * \param iterationcount The number of iterations.
+ * \param count The number of keys to derive.
+ * \param ids The diversifier of each key.
+ * \param ndata The buffer which receives each derived key.
+ * \param nsize The size of each derived key.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int pkcs12_derive_keys(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, size_t count, const byte* ids, byte* const* ndata, const size_t* nsize);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,6 +81,16 @@ extern BEECRYPTAPI const hashFunction ripemd160;
 BEECRYPTAPI
 void ripemd160Process(ripemd160Param* mp);
 
+/*!\fn void ripemd160ProcessBlocks(ripemd160Param* mp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param mp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void ripemd160ProcessBlocks(ripemd160Param* mp, const byte* blocks, size_t nblocks);
+
 /*!\fn int ripemd160Reset(ripemd160Param* mp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -90,6 +100,25 @@ void ripemd160Process(ripemd160Param* mp);
 BEECRYPTAPI
 int  ripemd160Reset  (ripemd160Param* mp);
 
+/*!\fn int ripemd160Copy(ripemd160Param* dst, const ripemd160Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int  ripemd160Copy   (ripemd160Param* dst, const ripemd160Param* src);
+
+/*!\fn int ripemd160Check(const ripemd160Param* mp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param mp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int  ripemd160Check  (const ripemd160Param* mp);
+
 /*!\fn int ripemd160Update(ripemd160Param* mp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data 
  *  to be hashed.
@@ -81,6 +81,16 @@ extern BEECRYPTAPI const hashFunction ripemd256;
 BEECRYPTAPI
 void ripemd256Process(ripemd256Param* mp);
 
+/*!\fn void ripemd256ProcessBlocks(ripemd256Param* mp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param mp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void ripemd256ProcessBlocks(ripemd256Param* mp, const byte* blocks, size_t nblocks);
+
 /*!\fn int ripemd256Reset(ripemd256Param* mp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -90,6 +100,25 @@ void ripemd256Process(ripemd256Param* mp);
 BEECRYPTAPI
 int  ripemd256Reset  (ripemd256Param* mp);
 
+/*!\fn int ripemd256Copy(ripemd256Param* dst, const ripemd256Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int  ripemd256Copy   (ripemd256Param* dst, const ripemd256Param* src);
+
+/*!\fn int ripemd256Check(const ripemd256Param* mp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param mp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int  ripemd256Check  (const ripemd256Param* mp);
+
 /*!\fn int ripemd256Update(ripemd256Param* mp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data 
  *  to be hashed.
@@ -81,6 +81,16 @@ extern BEECRYPTAPI const hashFunction ripemd320;
 BEECRYPTAPI
 void ripemd320Process(ripemd320Param* mp);
 
+/*!\fn void ripemd320ProcessBlocks(ripemd320Param* mp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param mp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void ripemd320ProcessBlocks(ripemd320Param* mp, const byte* blocks, size_t nblocks);
+
 /*!\fn int ripemd320Reset(ripemd320Param* mp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -90,6 +100,25 @@ void ripemd320Process(ripemd320Param* mp);
 BEECRYPTAPI
 int  ripemd320Reset  (ripemd320Param* mp);
 
+/*!\fn int ripemd320Copy(ripemd320Param* dst, const ripemd320Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int  ripemd320Copy   (ripemd320Param* dst, const ripemd320Param* src);
+
+/*!\fn int ripemd320Check(const ripemd320Param* mp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param mp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int  ripemd320Check  (const ripemd320Param* mp);
+
 /*!\fn int ripemd320Update(ripemd320Param* mp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data 
  *  to be hashed.
@@ -28,6 +28,12 @@
 
 #include "beecrypt/rsakp.h"
 
+/*!\brief The default number of ciphertexts rsapricrt_batch exponentiates
+ *  in lockstep.
+ */
+#define RSA_BATCH_LANES		4
+#define RSA_BATCH_MAXLANES	16
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +46,8 @@ extern "C" {
  * It performs the following operation:
  * \li \f$c=m^{e}\ \textrm{mod}\ n\f$
  *
+ * Workspace comes from the calling thread's arena; see mpwksp.h.
+ *
  * \param n The RSA modulus.
  * \param e The RSA public exponent.
  * \param m The message.
@@ -51,6 +59,17 @@ BEECRYPTAPI
 int rsapub(const mpbarrett* n, const mpnumber* e,
            const mpnumber* m, mpnumber* c);
 
+/*!\fn int rsapub_w(const mpbarrett* n, const mpnumber* e, const mpnumber* m, mpnumber* c, mpw* wksp)
+ * \brief Like rsapub, with a caller-provided workspace of (4*size+2)
+ *  words, where size is the size of \a n.
+ *
+ * If \a c already has the size of \a n, this function doesn't allocate
+ * any memory.
+ */
+BEECRYPTAPI
+int rsapub_w(const mpbarrett* n, const mpnumber* e,
+             const mpnumber* m, mpnumber* c, mpw* wksp);
+
 /*!\fn int rsapri(const mpbarrett* n, const mpnumber* d, const mpnumber* c, mpnumber* m)
  * \brief This function performs a raw RSA private key operation.
  *
@@ -59,6 +78,8 @@ int rsapub(const mpbarrett* n, const mpnumber* e,
  * It performs the operation:
  * \li \f$m=c^{d}\ \textrm{mod}\ n\f$
  *
+ * The exponentiation uses the engine selected with mpengineSetup.
+ *
  * \param n The modulus.
  * \param d The private exponent.
  * \param c The ciphertext.
@@ -70,6 +91,14 @@ BEECRYPTAPI
 int rsapri(const mpbarrett* n, const mpnumber* d,
            const mpnumber* c, mpnumber* m);
 
+/*!\fn int rsapri_w(const mpbarrett* n, const mpnumber* d, const mpnumber* c, mpnumber* m, mpw* wksp)
+ * \brief Like rsapri, with a caller-provided workspace of (4*size+2)
+ *  words, where size is the size of \a n.
+ */
+BEECRYPTAPI
+int rsapri_w(const mpbarrett* n, const mpnumber* d,
+             const mpnumber* c, mpnumber* m, mpw* wksp);
+
 /*!\fn int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q, const mpnumber* dp, const mpnumber* dq, const mpnumber* qi, const mpnumber* c, mpnumber* m)
  *
  * \brief This function performs a raw RSA private key operation, with
@@ -81,6 +110,8 @@ int rsapri(const mpbarrett* n, const mpnumber* d,
  * \li \f$h=qi \cdot (j_1-j_2)\ \textrm{mod}\ p\f$
  * \li \f$m=j_2+hq\f$
  *
+ * Both exponentiations use the engine selected with mpengineSetup.
+ *
  * \param n The modulus.
  * \param p The first prime factor.
  * \param q The second prime factor.
@@ -97,6 +128,64 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
               const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
               const mpnumber* c, mpnumber* m);
 
+/*!\fn int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q, const mpnumber* dp, const mpnumber* dq, const mpnumber* qi, const mpnumber* c, mpnumber* m, mpw* wksp)
+ * \brief Like rsapricrt, with a caller-provided workspace of
+ *  (6*(psize+qsize)+4) words.
+ */
+BEECRYPTAPI
+int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+                const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+                const mpnumber* c, mpnumber* m, mpw* wksp);
+
+/*!\fn int rsapricrtkp(const rsakp* kp, const mpnumber* c, mpnumber* m)
+ * \brief Like rsapricrt, taking the components from a keypair.
+ *
+ * With the Montgomery engine, the contexts prepared by rsakpPrecompute are
+ * used instead of being set up for every call.
+ *
+ * \param kp The keypair; it needs n, p, q, dp, dq and qi.
+ * \param c The ciphertext.
+ * \param m The message.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int rsapricrtkp(const rsakp* kp, const mpnumber* c, mpnumber* m);
+
+/*!\fn int rsapricrt_batch(const rsakp* kp, size_t count, const mpnumber* c, mpnumber* m)
+ * \brief This function performs the raw RSA private key operation, with
+ *  the Chinese Remainder Theorem, on a batch of ciphertexts.
+ *
+ * The result for each ciphertext is the same as that of rsapricrt; the
+ * batch as a whole runs faster:
+ * \li The Montgomery contexts for \a p and \a q are set up once.
+ * \li Groups of ciphertexts are exponentiated in lockstep; see
+ *     mpmontpowmodn_w.
+ * \li Groups are spread over threads, as set with rsaBatchSetup.
+ *
+ * \param kp The keypair; it needs n, p, q, dp, dq and qi.
+ * \param count The number of ciphertexts.
+ * \param c The ciphertexts.
+ * \param m The messages; the array must hold \a count numbers.
+ * \retval 0 on success.
+ * \retval -1 on failure; if any ciphertext is out of range, none are
+ *  processed.
+ */
+BEECRYPTAPI
+int rsapricrt_batch(const rsakp* kp, size_t count, const mpnumber* c, mpnumber* m);
+
+/*!\fn int rsaBatchSetup(unsigned int threads, unsigned int lanes)
+ * \brief Tunes rsapricrt_batch.
+ * \param threads The maximum number of threads; 0 means the OpenMP
+ *  default.
+ * \param lanes The number of ciphertexts exponentiated in lockstep, at
+ *  most RSA_BATCH_MAXLANES; 0 restores the default of RSA_BATCH_LANES.
+ * \retval 0 on success.
+ * \retval -1 on an invalid number of lanes.
+ */
+BEECRYPTAPI
+int rsaBatchSetup(unsigned int threads, unsigned int lanes);
+
 /*!\fn int rsavrfy(const mpbarrett* n, const mpnumber* e, const mpnumber* m, const mpnumber* c)
  * \brief This function performs a raw RSA verification.
  *
@@ -114,6 +203,14 @@ BEECRYPTAPI
 int rsavrfy(const mpbarrett* n, const mpnumber* e,
             const mpnumber* m, const mpnumber* c);
 
+/*!\fn int rsavrfy_w(const mpbarrett* n, const mpnumber* e, const mpnumber* m, const mpnumber* c, mpw* wksp)
+ * \brief Like rsavrfy, with a caller-provided workspace of (5*size+2)
+ *  words, where size is the size of \a n.
+ */
+BEECRYPTAPI
+int rsavrfy_w(const mpbarrett* n, const mpnumber* e,
+              const mpnumber* m, const mpnumber* c, mpw* wksp);
+
 #ifdef __cplusplus
 }
 #endif
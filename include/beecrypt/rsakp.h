@@ -27,6 +27,7 @@
 #define _RSAKP_H
 
 #include "beecrypt/rsapk.h"
+#include "beecrypt/mpmont.h"
 
 /*!\brief RSA keypair.
  * \ingroup IF_rsa_m
@@ -74,6 +75,17 @@ struct _rsakp
 	 * \f$qi=q^{-1}\ \textrm{mod}\ p\f$
 	 */
 	mpnumber qi;
+	/*!\var pm
+	 * \brief Optional Montgomery context for p.
+	 *
+	 * Filled in by rsakpPrecompute, together with qm; rsapricrtkp uses
+	 * them while they match p and q.
+	 */
+	mpmont pm;
+	/*!\var qm
+	 * \brief Optional Montgomery context for q.
+	 */
+	mpmont qm;
 	#ifdef __cplusplus
 	rsakp();
 	rsakp(const rsakp&);
@@ -98,6 +110,19 @@ int rsakpFree(rsakp*);
 BEECRYPTAPI
 int rsakpCopy(rsakp*, const rsakp*);
 
+/*!\fn int rsakpPrecompute(rsakp* kp)
+ * \brief Prepares the Montgomery contexts for p and q.
+ *
+ * Afterwards rsapricrtkp no longer sets them up on every call when
+ * the Montgomery engine is selected. The contexts are only read after this
+ * call, so the keypair can be shared between threads.
+ * \param kp The keypair.
+ * \retval 0 on success.
+ * \retval -1 on failure.
+ */
+BEECRYPTAPI
+int rsakpPrecompute(rsakp*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -83,6 +83,16 @@ extern BEECRYPTAPI const hashFunction sha1;
 BEECRYPTAPI
 void sha1Process(sha1Param* sp);
 
+/*!\fn void sha1ProcessBlocks(sha1Param* sp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param sp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void sha1ProcessBlocks(sha1Param* sp, const byte* blocks, size_t nblocks);
+
 /*!\fn int sha1Reset(sha1Param* sp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -92,6 +102,25 @@ void sha1Process(sha1Param* sp);
 BEECRYPTAPI
 int  sha1Reset  (sha1Param* sp);
 
+/*!\fn int sha1Copy(sha1Param* dst, const sha1Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int sha1Copy(sha1Param* dst, const sha1Param* src);
+
+/*!\fn int sha1Check(const sha1Param* sp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param sp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int sha1Check(const sha1Param* sp);
+
 /*!\fn int sha1Update(sha1Param* sp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data 
  *  to be hashed.
@@ -113,6 +142,22 @@ int  sha1Update (sha1Param* sp, const byte* data, size_t size);
 BEECRYPTAPI
 int  sha1Digest (sha1Param* sp, byte* digest);
 
+/*!\fn int sha1MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+ * \brief This function computes the digests of \a count independent messages.
+ *
+ * Where the processor allows, the messages are hashed in parallel, eight
+ * (AVX2) or sixteen (AVX-512) at a time, each in its own vector lane; as a
+ * lane finishes its message, it picks up the next one.
+ *
+ * \param count The number of messages.
+ * \param msgs The messages.
+ * \param lens The length of each message, in bytes.
+ * \param digests The places to store the 20-byte digests.
+ * \retval 0 on success, -1 on failure.
+ */
+BEECRYPTAPI
+int  sha1MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests);
+
 #ifdef __cplusplus
 }
 #endif
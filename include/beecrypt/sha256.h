@@ -82,6 +82,16 @@ extern BEECRYPTAPI const hashFunction sha256;
 BEECRYPTAPI
 void sha256Process(sha256Param* sp);
 
+/*!\fn void sha256ProcessBlocks(sha256Param* sp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 64 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param sp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void sha256ProcessBlocks(sha256Param* sp, const byte* blocks, size_t nblocks);
+
 /*!\fn int sha256Reset(sha256Param* sp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -91,6 +101,25 @@ void sha256Process(sha256Param* sp);
 BEECRYPTAPI
 int  sha256Reset  (sha256Param* sp);
 
+/*!\fn int sha256Copy(sha256Param* dst, const sha256Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int sha256Copy(sha256Param* dst, const sha256Param* src);
+
+/*!\fn int sha256Check(const sha256Param* sp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param sp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int sha256Check(const sha256Param* sp);
+
 /*!\fn int sha256Update(sha256Param* sp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data
  *  to be hashed.
@@ -112,6 +141,22 @@ int  sha256Update (sha256Param* sp, const byte* data, size_t size);
 BEECRYPTAPI
 int  sha256Digest (sha256Param* sp, byte* digest);
 
+/*!\fn int sha256MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+ * \brief This function computes the digests of \a count independent messages.
+ *
+ * Where the processor allows, the messages are hashed in parallel, eight
+ * (AVX2) or sixteen (AVX-512) at a time, each in its own vector lane; as a
+ * lane finishes its message, it picks up the next one.
+ *
+ * \param count The number of messages.
+ * \param msgs The messages.
+ * \param lens The length of each message, in bytes.
+ * \param digests The places to store the 32-byte digests.
+ * \retval 0 on success, -1 on failure.
+ */
+BEECRYPTAPI
+int  sha256MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests);
+
 #ifdef __cplusplus
 }
 #endif
@@ -82,6 +82,16 @@ extern BEECRYPTAPI const hashFunction sha512;
 BEECRYPTAPI
 void sha512Process(sha512Param* sp);
 
+/*!\fn void sha512ProcessBlocks(sha512Param* sp, const byte* blocks, size_t nblocks)
+ * \brief This function processes \a nblocks consecutive blocks of 128 bytes,
+ *  reading them directly from \a blocks, which needs no particular alignment.
+ * \param sp The hash function's parameter block.
+ * \param blocks The message blocks.
+ * \param nblocks The number of blocks.
+ */
+BEECRYPTAPI
+void sha512ProcessBlocks(sha512Param* sp, const byte* blocks, size_t nblocks);
+
 /*!\fn int sha512Reset(sha512Param* sp)
  * \brief This function resets the parameter block so that it's ready for a
  *  new hash.
@@ -91,6 +101,25 @@ void sha512Process(sha512Param* sp);
 BEECRYPTAPI
 int  sha512Reset  (sha512Param* sp);
 
+/*!\fn int sha512Copy(sha512Param* dst, const sha512Param* src)
+ * \brief This function copies the state of a hash computation in progress;
+ *  both parameter blocks can then continue independently.
+ * \param dst The destination parameter block.
+ * \param src The source parameter block.
+ * \retval 0 on success.
+ */
+BEECRYPTAPI
+int sha512Copy(sha512Param* dst, const sha512Param* src);
+
+/*!\fn int sha512Check(const sha512Param* sp)
+ * \brief This function checks that a parameter block holds a consistent
+ *  state, e.g. one restored from outside.
+ * \param sp The hash function's parameter block.
+ * \retval 0 on success, -1 if the state is not usable.
+ */
+BEECRYPTAPI
+int sha512Check(const sha512Param* sp);
+
 /*!\fn int sha512Update(sha512Param* sp, const byte* data, size_t size)
  * \brief This function should be used to pass successive blocks of data
  *  to be hashed.
@@ -20,6 +20,9 @@ const hashFunction md4 = {
 	(hashFunctionReset) md4Reset,
 	(hashFunctionUpdate) md4Update,
 	(hashFunctionDigest) md4Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) md4Copy,
+	(hashFunctionCheck) md4Check
 };
 /*@=sizeoftype@*/
 
@@ -40,6 +43,20 @@ int md4Reset(md4Param* mp)
 	return 0;
 }
 
+int md4Copy(md4Param* dst, const md4Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int md4Check(const md4Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define F(x, y, z) (z ^ (x & (y ^ z)))
 #define G(x, y, z) ((x & y) | (z & (x | y)))
 #define H(x, y, z) ((x) ^ (y) ^ (z))
@@ -54,25 +71,36 @@ int md4Reset(md4Param* mp)
     a = ROTL32((b^c^d) + a + w + 0x6ed9eba1U, s);
 
 #ifndef ASM_MD4PROCESS
-void md4Process(md4Param *mp)
-	/*@modifies mp @*/
+/* processes one block; it may be mp->data itself */
+static void md4Block(md4Param* mp, const byte* block)
 {
 	uint32_t a, b, c, d;
 
-	register uint32_t* w;
+	register const uint32_t* w;
 	#ifdef WORDS_BIGENDIAN
+	register uint32_t* load = mp->data;
 	register byte t;
-	#endif
 
-	w = mp->data;
-	#ifdef WORDS_BIGENDIAN
 	t = 16;
 	while (t--)
 	{
-		register uint32_t temp = swapu32(*w);
-		*(w++) = temp;
+		uint32_t word;
+		memcpy(&word, block, 4);
+		*(load++) = swapu32(word);
+		block += 4;
 	}
 	w = mp->data;
+	#else
+	/* the words are already in the right order; only copy when they are
+	 * not suitably aligned
+	 */
+	if (((size_t) block) & (sizeof(uint32_t)-1))
+	{
+		memcpy(mp->data, block, 64);
+		w = mp->data;
+	}
+	else
+		w = (const uint32_t*) block;
 	#endif
 
 	a = mp->h[0]; b = mp->h[1]; c = mp->h[2]; d = mp->h[3];
@@ -133,6 +161,30 @@ void md4Process(md4Param *mp)
 	mp->h[2] +=  c;
 	mp->h[3] +=  d;
 }
+
+void md4ProcessBlocks(md4Param* mp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		md4Block(mp, blocks);
+		blocks += 64;
+	}
+}
+
+void md4Process(md4Param* mp)
+{
+	md4Block(mp, (const byte*) mp->data);
+}
+#else
+void md4ProcessBlocks(md4Param* mp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(mp->data, blocks, 64);
+		md4Process(mp);
+		blocks += 64;
+	}
+}
 #endif
 
 int md4Update(md4Param* mp, const byte* data, size_t size)
@@ -153,12 +205,11 @@ int md4Update(md4Param* mp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (mp->offset > 0)
 	{
 		proclength = ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
-/*@-mayaliasunique@*/
 		memcpy(((byte *) mp->data) + mp->offset, data, proclength);
-/*@=mayaliasunique@*/
 		size -= proclength;
 		data += proclength;
 		mp->offset += proclength;
@@ -169,6 +220,23 @@ int md4Update(md4Param* mp, const byte* data, size_t size)
 			mp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 64U)
+	{
+		register size_t nblocks = size >> 6;
+
+		md4ProcessBlocks(mp, data, nblocks);
+		data += nblocks << 6;
+		size -= nblocks << 6;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(mp->data, data, size);
+		mp->offset = (uint32_t) size;
+	}
 	return 0;
 }
 
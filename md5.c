@@ -45,7 +45,10 @@ const hashFunction md5 = {
 	16,
 	(hashFunctionReset) md5Reset,
 	(hashFunctionUpdate) md5Update,
-	(hashFunctionDigest) md5Digest
+	(hashFunctionDigest) md5Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) md5Copy,
+	(hashFunctionCheck) md5Check
 };
 
 int md5Reset(register md5Param* mp)
@@ -63,6 +66,20 @@ int md5Reset(register md5Param* mp)
 	return 0;
 }
 
+int md5Copy(register md5Param* dst, const md5Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int md5Check(const md5Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define FF(a, b, c, d, w, s, t)	\
 	a = ROTL32(((b&(c^d))^d) + a + w + t, s) + b;
 
@@ -76,23 +93,35 @@ int md5Reset(register md5Param* mp)
 	a = ROTL32((c^(b|~d)) + a + w + t, s) + b;
 
 #ifndef ASM_MD5PROCESS
-void md5Process(md5Param* mp)
+/* processes one block; it may be mp->data itself */
+static void md5Block(md5Param* mp, const byte* block)
 {
 	register uint32_t a,b,c,d;
-	register uint32_t* w;
+	register const uint32_t* w;
 	#if WORDS_BIGENDIAN
+	register uint32_t* x = mp->data;
 	register byte t;
-	#endif
 
-	w = mp->data;
-	#if WORDS_BIGENDIAN
 	t = 16;
 	while (t--)
 	{
-		register uint32_t temp = swapu32(*w);
-		*(w++) = temp;
+		uint32_t load;
+		memcpy(&load, block, 4);
+		*(x++) = swapu32(load);
+		block += 4;
 	}
 	w = mp->data;
+	#else
+	/* the words are already in the right order; only copy when they are
+	 * not suitably aligned
+	 */
+	if (((size_t) block) & (sizeof(uint32_t)-1))
+	{
+		memcpy(mp->data, block, 64);
+		w = mp->data;
+	}
+	else
+		w = (const uint32_t*) block;
 	#endif
 
 	a = mp->h[0]; b = mp->h[1]; c = mp->h[2]; d = mp->h[3];
@@ -170,6 +199,30 @@ void md5Process(md5Param* mp)
 	mp->h[2] += c;
 	mp->h[3] += d;
 }
+
+void md5ProcessBlocks(md5Param* mp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		md5Block(mp, blocks);
+		blocks += 64;
+	}
+}
+
+void md5Process(md5Param* mp)
+{
+	md5Block(mp, (const byte*) mp->data);
+}
+#else
+void md5ProcessBlocks(md5Param* mp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(mp->data, blocks, 64);
+		md5Process(mp);
+		blocks += 64;
+	}
+}
 #endif
 
 int md5Update(md5Param* mp, const byte* data, size_t size)
@@ -190,7 +243,8 @@ int md5Update(md5Param* mp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (mp->offset > 0)
 	{
 		/* no truncation of data is possible here: maximum value returned is 64! */
 		proclength = (uint32_t) ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
@@ -205,6 +259,23 @@ int md5Update(md5Param* mp, const byte* data, size_t size)
 			mp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 64U)
+	{
+		register size_t nblocks = size >> 6;
+
+		md5ProcessBlocks(mp, data, nblocks);
+		data += nblocks << 6;
+		size -= nblocks << 6;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(mp->data, data, size);
+		mp->offset = (uint32_t) size;
+	}
 	return 0;
 }
 
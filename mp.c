@@ -754,7 +754,7 @@ mpw mpaddmul(size_t size, mpw* result, const mpw* data, mpw y)
 #endif
 
 #ifndef ASM_MPMUL
-void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
+static void mpbasemul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
 {
 	/* preferred passing of parameters is x the larger of the two numbers */
 	if (xsize >= ysize)
@@ -790,6 +790,8 @@ void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw*
 		}
 	}
 }
+#else
+# define mpbasemul mpmul
 #endif
 
 #ifndef ASM_MPADDSQRTRC
@@ -855,7 +857,7 @@ void mpaddsqrtrc(size_t size, mpw* result, const mpw* data)
 #endif
 
 #ifndef ASM_MPSQR
-void mpsqr(mpw* result, size_t size, const mpw* data)
+static void mpbasesqr(mpw* result, size_t size, const mpw* data)
 {
 	register mpw rc;
 	register size_t n = size-1;
@@ -880,6 +882,211 @@ void mpsqr(mpw* result, size_t size, const mpw* data)
 
 	mpaddsqrtrc(size, result, data);
 }
+#else
+# define mpbasesqr mpsqr
+#endif
+
+/*
+ * Karatsuba multiplication and squaring
+ *
+ * Splitting x = xh*B^l + xl and y = yh*B^l + yl, with B = 2^MP_WBITS:
+ *
+ *   x*y = z2*B^2l + (z2 + z0 - (xh-xl)*(yh-yl))*B^l + z0
+ *
+ * where z2 = xh*yh and z0 = xl*yl; this needs three half-size products
+ * instead of four. The differences are kept in the result, which only gets
+ * filled with z2 and z0 after their product has been computed.
+ */
+
+/* largest workspace mpmul and mpsqr will put on the stack */
+#define MP_KARATSUBA_STACKWORDS	1536
+
+static size_t _mp_karatsuba_mul = MP_KARATSUBA_MUL_THRESHOLD;
+static size_t _mp_karatsuba_sqr = MP_KARATSUBA_SQR_THRESHOLD;
+
+int mpkaratsubaSetup(size_t mulsize, size_t sqrsize)
+{
+	if (mulsize < MP_KARATSUBA_MIN_THRESHOLD || sqrsize < MP_KARATSUBA_MIN_THRESHOLD)
+		return -1;
+
+	_mp_karatsuba_mul = mulsize;
+	_mp_karatsuba_sqr = sqrsize;
+
+	return 0;
+}
+
+/*
+ * mpabsdiff
+ *  computes |x-y| into diff, with ysize <= xsize; returns 1 if y > x
+ */
+static int mpabsdiff(size_t xsize, mpw* diff, const mpw* xdata, size_t ysize, const mpw* ydata)
+{
+	if (mpgex(xsize, xdata, ysize, ydata))
+	{
+		mpcopy(xsize, diff, xdata);
+		mpsubx(xsize, diff, ysize, ydata);
+		return 0;
+	}
+	mpsetx(xsize, diff, ysize, ydata);
+	mpsub(xsize, diff, xdata);
+	return 1;
+}
+
+/*
+ * mpkmul_w
+ *  needs workspace of (4*size) words
+ */
+static void mpkmul_w(mpw* result, size_t size, const mpw* xdata, const mpw* ydata, mpw* wksp)
+{
+	register size_t l, h;
+	register int neg;
+
+	if (size < _mp_karatsuba_mul)
+	{
+		mpbasemul(result, size, xdata, size, ydata);
+		return;
+	}
+
+	l = size >> 1;
+	h = size - l;
+
+	/* |xh-xl|*|yh-yl| @ wksp */
+	neg  = mpabsdiff(h, result,   xdata, l, xdata+h);
+	neg ^= mpabsdiff(h, result+h, ydata, l, ydata+h);
+
+	*wksp = 0;
+	mpkmul_w(wksp+1, h, result, result+h, wksp+2*h+1);
+
+	/* z2 @ result, z0 @ result+2*h */
+	mpkmul_w(result,     h, xdata,   ydata,   wksp+2*h+1);
+	mpkmul_w(result+2*h, l, xdata+h, ydata+h, wksp+2*h+1);
+
+	/* middle term z2 + z0 -/+ |xh-xl|*|yh-yl| */
+	if (!neg)
+		mpneg(2*h+1, wksp);
+	mpaddx(2*h+1, wksp, 2*h, result);
+	mpaddx(2*h+1, wksp, 2*l, result+2*h);
+
+	mpaddx(2*h+l, result, 2*h+1, wksp);
+}
+
+/*
+ * mpksqr_w
+ *  needs workspace of (4*size) words
+ */
+static void mpksqr_w(mpw* result, size_t size, const mpw* xdata, mpw* wksp)
+{
+	register size_t l, h;
+
+	if (size < _mp_karatsuba_sqr)
+	{
+		mpbasesqr(result, size, xdata);
+		return;
+	}
+
+	l = size >> 1;
+	h = size - l;
+
+	/* (xh-xl)^2 @ wksp */
+	mpabsdiff(h, result, xdata, l, xdata+h);
+
+	*wksp = 0;
+	mpksqr_w(wksp+1, h, result, wksp+2*h+1);
+
+	/* z2 @ result, z0 @ result+2*h */
+	mpksqr_w(result,     h, xdata,   wksp+2*h+1);
+	mpksqr_w(result+2*h, l, xdata+h, wksp+2*h+1);
+
+	/* middle term z2 + z0 - (xh-xl)^2 */
+	mpneg(2*h+1, wksp);
+	mpaddx(2*h+1, wksp, 2*h, result);
+	mpaddx(2*h+1, wksp, 2*l, result+2*h);
+
+	mpaddx(2*h+l, result, 2*h+1, wksp);
+}
+
+void mpmul_w(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata, mpw* wksp)
+{
+	register size_t size, done;
+
+	/* make x the larger of the two numbers */
+	if (xsize < ysize)
+	{
+		const mpw* swap = xdata;
+
+		xdata = ydata;
+		ydata = swap;
+		size = xsize;
+		xsize = ysize;
+		ysize = size;
+	}
+
+	if (ysize < _mp_karatsuba_mul)
+	{
+		mpbasemul(result, xsize, xdata, ysize, ydata);
+		return;
+	}
+
+	if (xsize == ysize)
+	{
+		mpkmul_w(result, ysize, xdata, ydata, wksp);
+		return;
+	}
+
+	/* unbalanced: split x into pieces of ysize words, starting with the remainder at the top */
+	done = xsize % ysize;
+
+	if (done)
+		mpmul_w(result, ysize, ydata, done, xdata, wksp);
+	else
+	{
+		mpkmul_w(result, ysize, xdata, ydata, wksp);
+		done = ysize;
+	}
+
+	mpzero(xsize-done, result+done+ysize);
+
+	while (done < xsize)
+	{
+		mpkmul_w(wksp, ysize, xdata+done, ydata, wksp+2*ysize);
+		mpaddx(done+2*ysize, result, 2*ysize, wksp);
+		done += ysize;
+	}
+}
+
+void mpsqr_w(mpw* result, size_t size, const mpw* xdata, mpw* wksp)
+{
+	mpksqr_w(result, size, xdata, wksp);
+}
+
+#ifndef ASM_MPMUL
+void mpmul(mpw* result, size_t xsize, const mpw* xdata, size_t ysize, const mpw* ydata)
+{
+	register size_t size = (xsize < ysize) ? xsize : ysize;
+
+	if (size >= _mp_karatsuba_mul && size <= (MP_KARATSUBA_STACKWORDS / 6))
+	{
+		mpw wksp[MP_KARATSUBA_STACKWORDS];
+
+		mpmul_w(result, xsize, xdata, ysize, ydata, wksp);
+	}
+	else
+		mpbasemul(result, xsize, xdata, ysize, ydata);
+}
+#endif
+
+#ifndef ASM_MPSQR
+void mpsqr(mpw* result, size_t size, const mpw* data)
+{
+	if (size >= _mp_karatsuba_sqr && size <= (MP_KARATSUBA_STACKWORDS / 4))
+	{
+		mpw wksp[MP_KARATSUBA_STACKWORDS];
+
+		mpksqr_w(result, size, data, wksp);
+	}
+	else
+		mpbasesqr(result, size, data);
+}
 #endif
 
 #ifndef ASM_MPSIZE
@@ -37,6 +37,7 @@
 #include "beecrypt/mpprime.h"
 #include "beecrypt/mpnumber.h"
 #include "beecrypt/mpbarrett.h"
+#include "beecrypt/mpwksp.h"
 
 /*
  * mpbzero
@@ -530,6 +531,37 @@ static byte mpbslide_mulg[16] =
 static byte mpbslide_postsq[16] =
 { 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
 
+/*
+ * mpbpowmodbin_w
+ *  left-to-right binary exponentiation, for when there is no memory for a
+ *  sliding window table; pdata must start with a non-zero word
+ *  needs workspace of 4*size+2 words
+ */
+static void mpbpowmodbin_w(const mpbarrett* b, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	register size_t size = b->size;
+	register mpw temp;
+	register short count;
+
+	mpsetw(size, result, 1);
+
+	while (psize--)
+	{
+		temp = *(pdata++);
+		count = MP_WBITS;
+
+		while (count--)
+		{
+			mpbsqrmod_w(b, size, result, result, wksp);
+
+			if (temp & MP_MSBMASK)
+				mpbmulmod_w(b, xsize, xdata, size, result, result, wksp);
+
+			temp <<= 1;
+		}
+	}
+}
+
 /*
  * needs workspace of 4*size+2 words
  */
@@ -557,13 +589,19 @@ void mpbpowmod_w(const mpbarrett* b, size_t xsize, const mpw* xdata, size_t psiz
 	/* if temp is still zero, then we're trying to raise x to power zero, and result stays one */
 	if (temp)
 	{
-		mpw* slide = (mpw*) malloc((8*size)*sizeof(mpw));
+		mpw* slide = mpwkspget(8*size);
+
+		if (slide == (mpw*) 0)
+		{
+			mpbpowmodbin_w(b, xsize, xdata, psize, pdata-1, result, wksp);
+			return;
+		}
 
 		mpbslide_w(b, xsize, xdata, slide, wksp);
 
 		mpbpowmodsld_w(b, slide, psize, pdata-1, result, wksp);
 
-		free(slide);
+		mpwkspput(slide);
 	}
 }
 
@@ -663,6 +701,311 @@ void mpbpowmodsld_w(const mpbarrett* b, const mpw* slide, size_t psize, const mp
 	}
 }
 
+/*
+ * Simultaneous multiple exponentiation, computing x1^p1 * x2^p2 [* x3^p3]
+ * with a single chain of squarings.
+ *
+ * Every base gets its own sliding window table (see mpbslide_w); the
+ * exponents are scanned from the most significant bit down, and for each
+ * one a window of up to four bits, starting and ending with a one, is
+ * multiplied in at the position of its last bit. Compared to separate
+ * exponentiations this saves all but one set of squarings.
+ */
+
+#define mpbsmbit(size, data, k)	(((data)[(size)-1-((k)/MP_WBITS)] >> ((k)%MP_WBITS)) & 1)
+
+static void mpbsmpowmod_w(const mpbarrett* b, unsigned int n, const size_t* xsize, const mpw** xdata, const size_t* psize, const mpw** pdata, mpw* result, mpw* wksp)
+{
+	register size_t size = b->size;
+	register unsigned int j;
+	size_t bits = 0, k, pbits[3], end[3];
+	unsigned int value[3];
+	int first = 1;
+	mpw* slide;
+
+	for (j = 0; j < n; j++)
+	{
+		pbits[j] = mpbits(psize[j], pdata[j]);
+		end[j] = (size_t) -1;
+		if (bits < pbits[j])
+			bits = pbits[j];
+	}
+
+	mpsetw(size, result, 1);
+
+	if (bits == 0)
+		return;
+
+	slide = mpwkspget(8*n*size);
+
+	if (slide == (mpw*) 0)
+	{
+		/* no memory for the tables; multiply in every bit on its own */
+		for (k = bits; k--; )
+		{
+			mpbsqrmod_w(b, size, result, result, wksp);
+
+			for (j = 0; j < n; j++)
+				if ((k < pbits[j]) && mpbsmbit(psize[j], pdata[j], k))
+					mpbmulmod_w(b, xsize[j], xdata[j], size, result, result, wksp);
+		}
+		return;
+	}
+
+	for (j = 0; j < n; j++)
+		if (pbits[j])
+			mpbslide_w(b, xsize[j], xdata[j], slide+8*j*size, wksp);
+
+	k = bits;
+	while (k--)
+	{
+		if (!first)
+			mpbsqrmod_w(b, size, result, result, wksp);
+
+		for (j = 0; j < n; j++)
+		{
+			/* start a new window here? */
+			if ((end[j] == (size_t) -1) && (k < pbits[j]) && mpbsmbit(psize[j], pdata[j], k))
+			{
+				register size_t l = (k >= 3) ? k-3 : 0;
+
+				/* drop trailing zeroes, so that the window value is odd */
+				while (!mpbsmbit(psize[j], pdata[j], l))
+					l++;
+
+				end[j] = l;
+				value[j] = 0;
+				for (l = k+1; l-- > end[j]; )
+					value[j] = (value[j] << 1) | (unsigned int) mpbsmbit(psize[j], pdata[j], l);
+			}
+
+			/* multiply in the window which ends here */
+			if (end[j] == k)
+			{
+				register const mpw* x = slide + (8*j + (value[j] >> 1))*size;
+
+				if (first)
+				{
+					mpcopy(size, result, x);
+					first = 0;
+				}
+				else
+					mpbmulmod_w(b, size, result, size, x, result, wksp);
+
+				end[j] = (size_t) -1;
+			}
+		}
+	}
+
+	mpwkspput(slide);
+}
+
+/*
+ * mpbsm2powmod_w
+ *  computes x1^p1 * x2^p2 mod b; x1 and x2 must be smaller than b
+ *  needs workspace of 4*size+2 words
+ */
+void mpbsm2powmod_w(const mpbarrett* b, size_t x1size, const mpw* x1data, size_t p1size, const mpw* p1data, size_t x2size, const mpw* x2data, size_t p2size, const mpw* p2data, mpw* result, mpw* wksp)
+{
+	size_t xsize[2], psize[2];
+	const mpw* xdata[2];
+	const mpw* pdata[2];
+
+	xsize[0] = x1size; xdata[0] = x1data; psize[0] = p1size; pdata[0] = p1data;
+	xsize[1] = x2size; xdata[1] = x2data; psize[1] = p2size; pdata[1] = p2data;
+
+	mpbsmpowmod_w(b, 2, xsize, xdata, psize, pdata, result, wksp);
+}
+
+/*
+ * mpbsm3powmod_w
+ *  computes x1^p1 * x2^p2 * x3^p3 mod b; x1, x2 and x3 must be smaller than b
+ *  needs workspace of 4*size+2 words
+ */
+void mpbsm3powmod_w(const mpbarrett* b, size_t x1size, const mpw* x1data, size_t p1size, const mpw* p1data, size_t x2size, const mpw* x2data, size_t p2size, const mpw* p2data, size_t x3size, const mpw* x3data, size_t p3size, const mpw* p3data, mpw* result, mpw* wksp)
+{
+	size_t xsize[3], psize[3];
+	const mpw* xdata[3];
+	const mpw* pdata[3];
+
+	xsize[0] = x1size; xdata[0] = x1data; psize[0] = p1size; pdata[0] = p1data;
+	xsize[1] = x2size; xdata[1] = x2data; psize[1] = p2size; pdata[1] = p2data;
+	xsize[2] = x3size; xdata[2] = x3data; psize[2] = p3size; pdata[2] = p3data;
+
+	mpbsmpowmod_w(b, 3, xsize, xdata, psize, pdata, result, wksp);
+}
+
+/*
+ * Fixed-base exponentiation with a precomputed table.
+ *
+ * The exponent is split in 4-bit digits d_i; for each digit position i the
+ * table holds x^(d << 4i) for d = 1..15, so that x^e is the product of one
+ * table entry per non-zero digit, without any squarings. Building the table
+ * costs about as much as four ordinary exponentiations, so it pays off when
+ * the same base (typically a generator g) is used many times.
+ */
+
+#define MPBFB_DIGITS	15
+
+#define mpbfbentry(fb, i, d)	((fb)->table + ((i) * MPBFB_DIGITS + (d) - 1) * (fb)->size)
+
+void mpbfbzero(mpbfixedbase* fb)
+{
+	fb->size = 0;
+	fb->bits = 0;
+	fb->base = fb->modl = fb->table = (mpw*) 0;
+}
+
+/*
+ * mpbfbinit
+ *  precomputes the table for raising x to powers of up to bits bits,
+ *  modulo b; x must be smaller than b
+ */
+int mpbfbinit(mpbfixedbase* fb, const mpbarrett* b, size_t xsize, const mpw* xdata, size_t bits)
+{
+	register size_t size = b->size;
+	register size_t windows = (bits + 3) >> 2;
+	register size_t i, d;
+	register mpw* wksp;
+
+	mpbfbfree(fb);
+
+	if (size == 0 || windows == 0)
+		return -1;
+
+	fb->base = (mpw*) malloc((windows * MPBFB_DIGITS + 2) * size * sizeof(mpw));
+	if (fb->base == (mpw*) 0)
+		return -1;
+
+	wksp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	if (wksp == (mpw*) 0)
+	{
+		free(fb->base);
+		fb->base = (mpw*) 0;
+		return -1;
+	}
+
+	fb->size = size;
+	fb->bits = windows << 2;
+	fb->modl = fb->base + size;
+	fb->table = fb->modl + size;
+
+	mpsetx(size, fb->base, xsize, xdata);
+	mpcopy(size, fb->modl, b->modl);
+	mpcopy(size, mpbfbentry(fb, 0, 1), fb->base);
+
+	for (i = 0; i < windows; i++)
+	{
+		/* x^(1 << 4i) = x^(15 << 4(i-1)) * x^(1 << 4(i-1)) */
+		if (i)
+			mpbmulmod_w(b, size, mpbfbentry(fb, i-1, MPBFB_DIGITS), size, mpbfbentry(fb, i-1, 1), mpbfbentry(fb, i, 1), wksp);
+
+		for (d = 2; d <= MPBFB_DIGITS; d++)
+			mpbmulmod_w(b, size, mpbfbentry(fb, i, d-1), size, mpbfbentry(fb, i, 1), mpbfbentry(fb, i, d), wksp);
+	}
+
+	free(wksp);
+
+	return 0;
+}
+
+void mpbfbfree(mpbfixedbase* fb)
+{
+	if (fb->base)
+	{
+		/* the table can reveal the base, which may be secret */
+		mpzero(((fb->bits >> 2) * MPBFB_DIGITS + 2) * fb->size, fb->base);
+		free(fb->base);
+	}
+	mpbfbzero(fb);
+}
+
+int mpbfbcopy(mpbfixedbase* fb, const mpbfixedbase* copy)
+{
+	mpbfbfree(fb);
+
+	if (copy->base)
+	{
+		register size_t words = ((copy->bits >> 2) * MPBFB_DIGITS + 2) * copy->size;
+
+		fb->base = (mpw*) malloc(words * sizeof(mpw));
+		if (fb->base == (mpw*) 0)
+			return -1;
+
+		mpcopy(words, fb->base, copy->base);
+
+		fb->size = copy->size;
+		fb->bits = copy->bits;
+		fb->modl = fb->base + fb->size;
+		fb->table = fb->modl + fb->size;
+	}
+
+	return 0;
+}
+
+/*
+ * mpbfbmatch
+ *  returns 1 if the table was built for modulus b and base x
+ */
+int mpbfbmatch(const mpbfixedbase* fb, const mpbarrett* b, size_t xsize, const mpw* xdata)
+{
+	return fb->base && (fb->size == b->size) && mpeq(fb->size, fb->modl, b->modl) && mpeqx(fb->size, fb->base, xsize, xdata);
+}
+
+/*
+ * mpbfbpowmod_w
+ *  computes x^p mod b, with x and b as given to mpbfbinit
+ *  exponents with more bits than the table covers use mpbpowmod_w
+ *  needs workspace of 4*size+2 words
+ */
+void mpbfbpowmod_w(const mpbfixedbase* fb, const mpbarrett* b, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	register size_t size = b->size;
+	register size_t i, j;
+	register int first = 1;
+
+	while (psize && (*pdata == 0))
+	{
+		pdata++;
+		psize--;
+	}
+
+	if (psize == 0)
+	{
+		mpsetw(size, result, 1);
+		return;
+	}
+
+	if (mpbits(psize, pdata) > fb->bits)
+	{
+		mpbpowmod_w(b, size, fb->base, psize, pdata, result, wksp);
+		return;
+	}
+
+	for (i = 0; i < psize; i++)
+	{
+		register mpw temp = pdata[psize-1-i];
+
+		for (j = 0; temp; j++, temp >>= 4)
+		{
+			register unsigned int d = (unsigned int) (temp & 0xf);
+
+			if (d)
+			{
+				register const mpw* entry = mpbfbentry(fb, i * (MP_WBITS >> 2) + j, d);
+
+				if (first)
+				{
+					mpcopy(size, result, entry);
+					first = 0;
+				}
+				else
+					mpbmulmod_w(b, size, result, size, entry, result, wksp);
+			}
+		}
+	}
+}
+
 /*
  * mpbtwopowmod_w
  *  needs workspace of (4*size+2) words
@@ -780,25 +1123,23 @@ int mpbpprime_w(const mpbarrett* b, randomGeneratorContext* r, int t, mpw* wksp)
 void mpbnrnd(const mpbarrett* b, randomGeneratorContext* rc, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc(size * sizeof(mpw));
+	register mpw* temp = mpwkspget(size);
 
-	mpnfree(result);
 	mpnsize(result, size);
 	mpbrnd_w(b, rc, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnmulmod(const mpbarrett* b, const mpnumber* x, const mpnumber* y, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	/* xsize and ysize must be <= b->size */
 	register size_t  fill = 2*size-x->size-y->size;
 	register mpw* opnd = temp+size*2+2;
 
-	mpnfree(result);
 	mpnsize(result, size);
 
 	if (fill)
@@ -807,13 +1148,13 @@ void mpbnmulmod(const mpbarrett* b, const mpnumber* x, const mpnumber* y, mpnumb
 	mpmul(opnd+fill, x->size, x->data, y->size, y->data);
 	mpbmod_w(b, opnd, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnsqrmod(const mpbarrett* b, const mpnumber* x, mpnumber* result)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc(size * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
 	/* xsize must be <= b->size */
 	register size_t  fill = 2*(size-x->size);
@@ -826,33 +1167,67 @@ void mpbnsqrmod(const mpbarrett* b, const mpnumber* x, mpnumber* result)
 	mpnsize(result, size);
 	mpbmod_w(b, opnd, result->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnpowmod(const mpbarrett* b, const mpnumber* x, const mpnumber* pow, mpnumber* y)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
-	mpnfree(y);
 	mpnsize(y, size);
 
 	mpbpowmod_w(b, x->size, x->data, pow->size, pow->data, y->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
 }
 
 void mpbnpowmodsld(const mpbarrett* b, const mpw* slide, const mpnumber* pow, mpnumber* y)
 {
 	register size_t  size = b->size;
-	register mpw* temp = (mpw*) malloc((4*size+2) * sizeof(mpw));
+	register mpw* temp = mpwkspget(4*size+2);
 
-	mpnfree(y);
 	mpnsize(y, size);
 
 	mpbpowmodsld_w(b, slide, pow->size, pow->data, y->data, temp);
 
-	free(temp);
+	mpwkspput(temp);
+}
+
+void mpbsm2powmod(const mpbarrett* b, const mpnumber* x1, const mpnumber* p1, const mpnumber* x2, const mpnumber* p2, mpnumber* y)
+{
+	register size_t  size = b->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnsize(y, size);
+
+	mpbsm2powmod_w(b, x1->size, x1->data, p1->size, p1->data, x2->size, x2->data, p2->size, p2->data, y->data, temp);
+
+	mpwkspput(temp);
+}
+
+void mpbsm3powmod(const mpbarrett* b, const mpnumber* x1, const mpnumber* p1, const mpnumber* x2, const mpnumber* p2, const mpnumber* x3, const mpnumber* p3, mpnumber* y)
+{
+	register size_t  size = b->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnsize(y, size);
+
+	mpbsm3powmod_w(b, x1->size, x1->data, p1->size, p1->data, x2->size, x2->data, p2->size, p2->data, x3->size, x3->data, p3->size, p3->data, y->data, temp);
+
+	mpwkspput(temp);
+}
+
+void mpbnfbpowmod(const mpbfixedbase* fb, const mpbarrett* b, const mpnumber* pow, mpnumber* y)
+{
+	register size_t  size = b->size;
+	register mpw* temp = mpwkspget(4*size+2);
+
+	mpnsize(y, size);
+
+	mpbfbpowmod_w(fb, b, pow->size, pow->data, y->data, temp);
+
+	mpwkspput(temp);
 }
 
 size_t mpbbits(const mpbarrett* b)
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpmont.c
+ * \brief Multi-precision integer routines using Montgomery modular reduction.
+ *        For more information on this algorithm, see:
+ *        "Handbook of Applied Cryptography", Chapter 14.3.2
+ *        Menezes, van Oorschot, Vanstone
+ *        CRC Press
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup MP__m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpwksp.h"
+
+static int _mp_engine = MP_ENGINE_BARRETT;
+
+#ifndef ASM_MPMONTMUL
+mpw mpmontmul(size_t size, mpw* result, const mpw* xdata, const mpw* ydata, const mpw* modl, mpw minv)
+{
+	register mpw c1, c2, top, carry = 0;
+	register size_t i = size;
+
+	mpzero(size, result);
+
+	while (i--)
+	{
+		c1 = mpaddmul(size, result, xdata, ydata[i]);
+		c2 = mpaddmul(size, result, modl, result[size-1] * minv);
+
+		/* the least significant word is now zero; shift it out */
+		mpmove(size-1, result+1, result);
+
+		top = carry + c1;
+		carry = (top < c1);
+		top += c2;
+		carry += (top < c2);
+
+		result[0] = top;
+	}
+	return carry;
+}
+#endif
+
+/*
+ * mpmontredc
+ *  reduces the (2*size) words in tdata, which must be less than m*R, to
+ *  tdata/R mod m; tdata is destroyed in the process
+ */
+static void mpmontredc(const mpmont* m, mpw* tdata, mpw* result)
+{
+	register size_t size = m->size;
+	register size_t i;
+	register mpw load, temp, c, carry = 0;
+
+	for (i = 0; i < size; i++)
+	{
+		c = mpaddmul(size, tdata+size-i, m->modl, tdata[2*size-1-i] * m->minv);
+
+		/* propagate the carry into the word just above the window */
+		load = tdata[size-1-i];
+		temp = load + c;
+		c = (temp < load);
+		load = temp;
+		temp += carry;
+		tdata[size-1-i] = temp;
+		carry = c + (temp < load);
+	}
+
+	if (carry || mpge(size, tdata, m->modl))
+		mpsub(size, tdata, m->modl);
+
+	mpcopy(size, result, tdata);
+}
+
+/*
+ * mpmontzero
+ */
+void mpmontzero(mpmont* m)
+{
+	m->size = 0;
+	m->modl = m->rr = (mpw*) 0;
+	m->minv = 0;
+}
+
+/*
+ * mpmontinit
+ *  sets up the context in (2*size) words of storage; needs workspace of (6*size+3) words
+ */
+static void mpmontinit(mpmont* m, size_t size, const mpw* modl, mpw* storage, mpw* wksp)
+{
+	register mpw inv, load;
+	register size_t bits;
+
+	m->size = size;
+	m->modl = storage;
+	m->rr = storage+size;
+
+	mpcopy(size, m->modl, modl);
+
+	/* Newton iteration for 1/m mod 2^MP_WBITS; m*m = 1 mod 8 gives the first three bits */
+	load = modl[size-1];
+	inv = load;
+	for (bits = 3; bits < MP_WBITS; bits <<= 1)
+		inv *= 2 - load * inv;
+
+	m->minv = -inv;
+
+	/* R^2 mod m */
+	mpzero(2*size+1, wksp);
+	wksp[0] = 1;
+	mpmod(wksp+2*size+1, 2*size+1, wksp, size, m->modl, wksp+4*size+2);
+	mpcopy(size, m->rr, wksp+3*size+2);
+}
+
+/*
+ * mpmontset
+ *  sets up the context for odd modulus m; will allocate 2*size words
+ */
+int mpmontset(mpmont* m, size_t size, const mpw* modl)
+{
+	register mpw* storage;
+	register mpw* temp;
+
+	if (size == 0 || mpeven(size, modl))
+		return -1;
+
+	temp = mpwkspget(6*size+3);
+	if (temp == (mpw*) 0)
+		return -1;
+
+	storage = (mpw*) malloc(2*size * sizeof(mpw));
+	if (storage == (mpw*) 0)
+	{
+		mpwkspput(temp);
+		return -1;
+	}
+
+	mpmontfree(m);
+	mpmontinit(m, size, modl, storage, temp);
+
+	mpwkspput(temp);
+
+	return 0;
+}
+
+/*
+ * mpmontfree
+ *  wipes the context, since the modulus may be a secret prime
+ */
+void mpmontfree(mpmont* m)
+{
+	if (m->modl != (mpw*) 0)
+	{
+		mpzero(2*m->size, m->modl);
+		free(m->modl);
+		m->modl = m->rr = (mpw*) 0;
+	}
+	m->size = 0;
+	m->minv = 0;
+}
+
+/*
+ * mpmontcopy
+ */
+int mpmontcopy(mpmont* m, const mpmont* copy)
+{
+	register size_t size = copy->size;
+
+	mpmontfree(m);
+
+	if (size)
+	{
+		m->modl = (mpw*) malloc(2*size * sizeof(mpw));
+		if (m->modl == (mpw*) 0)
+			return -1;
+
+		m->size = size;
+		m->rr = m->modl+size;
+		m->minv = copy->minv;
+
+		mpcopy(2*size, m->modl, copy->modl);
+	}
+	return 0;
+}
+
+/*
+ * mpmontmatch
+ *  returns 1 if the context was set up for modulus b
+ */
+int mpmontmatch(const mpmont* m, const mpbarrett* b)
+{
+	return m && m->modl && (m->size == b->size) && mpeq(m->size, m->modl, b->modl);
+}
+
+/*
+ * mpmonttomont_w
+ *  computes x*R mod m
+ *  needs workspace of (4*size+2) words
+ */
+void mpmonttomont_w(const mpmont* m, size_t xsize, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	/* xsize must be <= m->size */
+	register size_t size = m->size;
+	register mpw* opnd = wksp;
+
+	mpsetx(size, opnd, xsize, xdata);
+
+	if (mpge(size, opnd, m->modl))
+	{
+		mpmod(wksp+size, size, opnd, size, m->modl, wksp+2*size);
+		opnd = wksp+size;
+	}
+
+	if (mpmontmul(size, result, opnd, m->rr, m->modl, m->minv) || mpge(size, result, m->modl))
+		mpsub(size, result, m->modl);
+}
+
+/*
+ * mpmontfrommont_w
+ *  computes x/R mod m
+ *  needs workspace of (2*size) words
+ */
+void mpmontfrommont_w(const mpmont* m, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+
+	mpzero(size, wksp);
+	mpcopy(size, wksp+size, xdata);
+
+	mpmontredc(m, wksp, result);
+}
+
+/*
+ * mpmontmulmod_w
+ *  computes x*y/R mod m, with x and y in Montgomery form
+ *  needs workspace of (size) words
+ */
+void mpmontmulmod_w(const mpmont* m, const mpw* xdata, const mpw* ydata, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+
+	if (mpmontmul(size, wksp, xdata, ydata, m->modl, m->minv) || mpge(size, wksp, m->modl))
+		mpsub(size, wksp, m->modl);
+
+	mpcopy(size, result, wksp);
+}
+
+/*
+ * mpmontsqrmod_w
+ *  computes x*x/R mod m, with x in Montgomery form
+ *  needs workspace of (2*size) words
+ */
+void mpmontsqrmod_w(const mpmont* m, const mpw* xdata, mpw* result, mpw* wksp)
+{
+	/* squaring first and reducing afterwards saves almost half the multiplications */
+	mpsqr(wksp, m->size, xdata);
+	mpmontredc(m, wksp, result);
+}
+
+/*
+ * the sliding window tables are the same as in mpbarrett.c
+ */
+static byte mpmslide_presq[16] =
+{ 0, 1, 1, 2, 1, 3, 2, 3, 1, 4, 3, 4, 2, 4, 3, 4 };
+
+static byte mpmslide_mulg[16] =
+{ 0, 0, 0, 1, 0, 2, 1, 3, 0, 4, 2, 5, 1, 6, 3, 7 };
+
+static byte mpmslide_postsq[16] =
+{ 0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+/*
+ * mpmontslidestep_w
+ *  applies one window of the exponent to every lane, one operation at a
+ *  time, so that the lanes' independent multiplications can overlap
+ */
+static void mpmontslidestep_w(const mpmont* m, size_t lanes, const mpw* slide, short n, mpw* result, mpw* wksp)
+{
+	register size_t size = m->size;
+	register size_t i;
+	byte s = mpmslide_presq[n];
+
+	while (s--)
+		for (i = 0; i < lanes; i++)
+			mpmontsqrmod_w(m, result+i*size, result+i*size, wksp);
+
+	for (i = 0; i < lanes; i++)
+		mpmontmulmod_w(m, result+i*size, slide+(8*i+mpmslide_mulg[n])*size, result+i*size, wksp);
+
+	s = mpmslide_postsq[n];
+
+	while (s--)
+		for (i = 0; i < lanes; i++)
+			mpmontsqrmod_w(m, result+i*size, result+i*size, wksp);
+}
+
+/*
+ * mpmontpowlanes_w
+ *  computes x[i]^p mod m for each lane i, where x[i] has xsize words at
+ *  xdata+i*xsize and result[i] has size words at result+i*size
+ *  needs a slide table of (8*lanes*size) words, and workspace of (4*size+2) words
+ */
+static void mpmontpowlanes_w(const mpmont* m, size_t lanes, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* slide, mpw* wksp)
+{
+	size_t size = m->size;
+	mpw temp = 0;
+	register size_t i;
+
+	while (psize)
+	{
+		if ((temp = *(pdata++))) /* break when first non-zero word found */
+			break;
+		psize--;
+	}
+
+	/* if temp is still zero, then we're trying to raise x to power zero */
+	if (temp)
+	{
+		short l = 0, n = 0, count = MP_WBITS;
+		register int j;
+		mpw one = 1;
+
+		for (i = 0; i < lanes; i++)
+		{
+			register mpw* lslide = slide+8*i*size;
+
+			/* odd powers x^1 .. x^15, in Montgomery form */
+			mpmonttomont_w(m, xsize, xdata+i*xsize, lslide, wksp);
+			mpmontsqrmod_w(m, lslide, result, wksp);
+			for (j = 1; j < 8; j++)
+				mpmontmulmod_w(m, lslide+(j-1)*size, result, lslide+j*size, wksp);
+		}
+
+		/* R mod m is one in Montgomery form */
+		mpmonttomont_w(m, 1, &one, result, wksp);
+		for (i = 1; i < lanes; i++)
+			mpcopy(size, result+i*size, result);
+
+		/* first skip bits until we reach a one */
+		while (count)
+		{
+			if (temp & MP_MSBMASK)
+				break;
+			temp <<= 1;
+			count--;
+		}
+
+		while (psize)
+		{
+			while (count)
+			{
+				byte bit = (temp & MP_MSBMASK) ? 1 : 0;
+
+				n <<= 1;
+				n += bit;
+
+				if (n)
+				{
+					if (l)
+						l++;
+					else if (bit)
+						l = 1;
+
+					if (l == 4)
+					{
+						mpmontslidestep_w(m, lanes, slide, n, result, wksp);
+						l = n = 0;
+					}
+				}
+				else
+					for (i = 0; i < lanes; i++)
+						mpmontsqrmod_w(m, result+i*size, result+i*size, wksp);
+
+				temp <<= 1;
+				count--;
+			}
+			if (--psize)
+			{
+				count = MP_WBITS;
+				temp = *(pdata++);
+			}
+		}
+
+		if (n)
+			mpmontslidestep_w(m, lanes, slide, n, result, wksp);
+
+		for (i = 0; i < lanes; i++)
+			mpmontfrommont_w(m, result+i*size, result+i*size, wksp);
+	}
+	else
+		for (i = 0; i < lanes; i++)
+			mpsetw(size, result+i*size, 1);
+}
+
+/*
+ * mpmontpowmod_w
+ *  computes x^p mod m, with x and the result in normal form
+ *  needs workspace of (4*size+2) words
+ */
+int mpmontpowmod_w(const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	mpw* slide = mpwkspget(8*m->size);
+
+	if (slide == (mpw*) 0)
+		return -1;
+
+	mpmontpowlanes_w(m, 1, xsize, xdata, psize, pdata, result, slide, wksp);
+
+	mpwkspput(slide);
+
+	return 0;
+}
+
+/*
+ * mpmontpowmodn_w
+ *  computes x[i]^p mod m for lanes values x[i] of size words each
+ *  needs workspace of ((8*lanes+4)*size+2) words
+ */
+void mpmontpowmodn_w(const mpmont* m, size_t lanes, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	mpmontpowlanes_w(m, lanes, m->size, xdata, psize, pdata, result, wksp, wksp+8*lanes*m->size);
+}
+
+int mpmontnpowmod(const mpmont* m, const mpnumber* x, const mpnumber* pow, mpnumber* y)
+{
+	register size_t  size = m->size;
+	register mpw* temp = mpwkspget(4*size+2);
+	register int rc = -1;
+
+	if (temp)
+	{
+		mpnsize(y, size);
+
+		if (y->data)
+			rc = mpmontpowmod_w(m, x->size, x->data, pow->size, pow->data, y->data, temp);
+
+		mpwkspput(temp);
+	}
+	return rc;
+}
+
+int mpengineSetup(int engine)
+{
+	if (engine != MP_ENGINE_BARRETT && engine != MP_ENGINE_MONTGOMERY)
+		return -1;
+
+	_mp_engine = engine;
+
+	return 0;
+}
+
+int mpengine()
+{
+	return _mp_engine;
+}
+
+void mpenginepowmod_w(const mpbarrett* b, const mpmont* m, size_t xsize, const mpw* xdata, size_t psize, const mpw* pdata, mpw* result, mpw* wksp)
+{
+	if (_mp_engine == MP_ENGINE_MONTGOMERY && mpodd(b->size, b->modl))
+	{
+		if (mpmontmatch(m, b))
+		{
+			if (mpmontpowmod_w(m, xsize, xdata, psize, pdata, result, wksp) == 0)
+				return;
+		}
+		else
+		{
+			/* no prepared context; set up a temporary one */
+			register size_t size = b->size;
+			register mpw* storage = mpwkspget(2*size);
+			register int rc = -1;
+
+			if (storage)
+			{
+				mpmont t;
+
+				/* the caller's workspace isn't large enough for the setup */
+				register mpw* temp = mpwkspget(6*size+3);
+
+				if (temp)
+				{
+					mpmontinit(&t, size, b->modl, storage, temp);
+					mpwkspput(temp);
+
+					rc = mpmontpowmod_w(&t, xsize, xdata, psize, pdata, result, wksp);
+				}
+				mpwkspput(storage);
+
+				if (rc == 0)
+					return;
+			}
+		}
+	}
+
+	mpbpowmod_w(b, xsize, xdata, psize, pdata, result, wksp);
+}
@@ -49,7 +49,8 @@ void mpnsize(mpnumber* n, size_t size)
 				{
 					register size_t offset = n->size - size;
 
-					memmove(n->data, n->data + offset, offset * sizeof(mpw));
+					/* keep the least significant words */
+					memmove(n->data, n->data + offset, size * sizeof(mpw));
 				}
 				n->data = (mpw*) realloc(n->data, size * sizeof(mpw));
 			}
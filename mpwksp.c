@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file mpwksp.c
+ * \brief Per-thread multi-precision workspace arena.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup MP_m
+ */
+
+#define BEECRYPT_DLL_EXPORT
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "beecrypt/mpwksp.h"
+
+#if ENABLE_THREAD_LOCAL_STORAGE
+# if defined(_REENTRANT) && HAVE_PTHREAD_H && !(HAVE_THREAD_H && HAVE_SYNCH_H)
+#  include <pthread.h>
+#  define MPWKSP_PTHREAD_KEY	1
+# endif
+
+/*
+ * Every buffer starts with a two word header, in front of the words handed
+ * out: its state, and the number of words in use. A buffer may be returned
+ * by another thread than the one it came from; that thread can't touch the
+ * owner's slots, so it only marks the header, and the owner picks the
+ * buffer up again on its next call. If the owner lets go of its slots while
+ * a buffer is still lent out, it marks the buffer orphaned instead, and
+ * whichever thread returns it frees it.
+ *
+ * The state word is shared between threads, so it is only accessed
+ * atomically: the release when returning orders the wipe before the
+ * owner's acquire, and the exchanges settle which thread frees an orphan.
+ */
+#define MPWKSP_HEADER	2
+
+#define MPWKSP_HEAP		0	/* not from a slot; freed when returned */
+#define MPWKSP_LENT		1	/* from a slot, in use */
+#define MPWKSP_RETURNED	2	/* from a slot, returned by another thread */
+#define MPWKSP_ORPHANED	3	/* from a slot whose owner let go; freed when returned */
+
+#define mpwkspload(data)		__atomic_load_n((data), __ATOMIC_ACQUIRE)
+#define mpwkspstore(data, val)	__atomic_store_n((data), (mpw) (val), __ATOMIC_RELEASE)
+
+/*
+ * mpwkspswap
+ *  changes the state from old to val; returns 1 if it succeeded, 0 if the
+ *  state was something else
+ */
+static int mpwkspswap(mpw* data, mpw old, mpw val)
+{
+	return __atomic_compare_exchange_n(data, &old, val, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+typedef struct
+{
+	mpw*	data;	/* the header, followed by the buffer */
+	size_t	size;	/* allocated words, excluding the header */
+	int		busy;
+} mpwkspslot;
+
+static __thread mpwkspslot _mpwksp[MPWKSP_SLOTS];
+
+# if MPWKSP_PTHREAD_KEY
+static __thread int _mpwksp_registered = 0;
+
+static pthread_key_t _mpwksp_key;
+static pthread_once_t _mpwksp_once = PTHREAD_ONCE_INIT;
+
+static void mpwkspexit(void* dummy)
+{
+	mpwkspfree();
+}
+
+static void mpwkspkey(void)
+{
+	pthread_key_create(&_mpwksp_key, mpwkspexit);
+}
+# endif
+
+/*
+ * mpwkspbusy
+ *  returns 1 if the slot's buffer is still in use, clearing a slot whose
+ *  buffer was returned by another thread
+ */
+static int mpwkspbusy(mpwkspslot* slot)
+{
+	if (slot->busy && mpwkspload(slot->data) == MPWKSP_RETURNED)
+		slot->busy = 0;
+
+	return slot->busy;
+}
+#endif
+
+mpw* mpwkspget(size_t size)
+{
+	#if ENABLE_THREAD_LOCAL_STORAGE
+	register int i, pick = -1;
+	register mpw* data;
+
+	/* prefer a free slot which is already large enough */
+	for (i = 0; i < MPWKSP_SLOTS; i++)
+	{
+		if (mpwkspbusy(_mpwksp+i))
+			continue;
+
+		if (_mpwksp[i].size >= size)
+		{
+			pick = i;
+			break;
+		}
+
+		if (pick < 0)
+			pick = i;
+	}
+
+	if (pick >= 0)
+	{
+		register mpwkspslot* slot = _mpwksp+pick;
+
+		if (slot->size < size)
+		{
+			/* the old contents don't matter, so don't realloc */
+			if (slot->data)
+				free(slot->data);
+
+			slot->data = (mpw*) malloc((MPWKSP_HEADER + size) * sizeof(mpw));
+			slot->size = slot->data ? size : 0;
+
+			if (slot->data == (mpw*) 0)
+				return (mpw*) 0;
+
+			# if MPWKSP_PTHREAD_KEY
+			if (!_mpwksp_registered)
+			{
+				pthread_once(&_mpwksp_once, mpwkspkey);
+				pthread_setspecific(_mpwksp_key, (void*) _mpwksp);
+				_mpwksp_registered = 1;
+			}
+			# endif
+		}
+
+		mpwkspstore(slot->data, MPWKSP_LENT);
+		slot->data[1] = (mpw) size;
+		slot->busy = 1;
+
+		return slot->data + MPWKSP_HEADER;
+	}
+
+	data = (mpw*) malloc((MPWKSP_HEADER + size) * sizeof(mpw));
+	if (data == (mpw*) 0)
+		return (mpw*) 0;
+
+	mpwkspstore(data, MPWKSP_HEAP);
+	data[1] = (mpw) size;
+
+	return data + MPWKSP_HEADER;
+	#else
+	return (mpw*) malloc(size * sizeof(mpw));
+	#endif
+}
+
+void mpwkspput(mpw* wksp)
+{
+	#if ENABLE_THREAD_LOCAL_STORAGE
+	register int i;
+	register mpw* data;
+
+	if (wksp == (mpw*) 0)
+		return;
+
+	data = wksp - MPWKSP_HEADER;
+
+	mpzero((size_t) data[1], wksp);
+
+	for (i = 0; i < MPWKSP_SLOTS; i++)
+	{
+		if (_mpwksp[i].busy && _mpwksp[i].data == data)
+		{
+			_mpwksp[i].busy = 0;
+			return;
+		}
+	}
+
+	/* it belongs to a slot of another thread, unless that thread let go */
+	if (mpwkspload(data) != MPWKSP_HEAP && mpwkspswap(data, MPWKSP_LENT, MPWKSP_RETURNED))
+		return;
+
+	free(data);
+	#else
+	if (wksp)
+		free(wksp);
+	#endif
+}
+
+void mpwkspfree()
+{
+	#if ENABLE_THREAD_LOCAL_STORAGE
+	register int i;
+
+	for (i = 0; i < MPWKSP_SLOTS; i++)
+	{
+		register mpw* data = _mpwksp[i].data;
+
+		if (data == (mpw*) 0)
+			continue;
+
+		/* a buffer still in use is freed by whoever returns it */
+		if (!mpwkspbusy(_mpwksp+i) || !mpwkspswap(data, MPWKSP_LENT, MPWKSP_ORPHANED))
+			free(data);
+
+		_mpwksp[i].data = (mpw*) 0;
+		_mpwksp[i].size = 0;
+		_mpwksp[i].busy = 0;
+	}
+	#endif
+}
@@ -40,6 +40,13 @@
 
 #include "beecrypt/mtprng.h"
 
+#if ENABLE_THREAD_LOCAL_STORAGE
+# if defined(_REENTRANT) && HAVE_PTHREAD_H && !(HAVE_THREAD_H && HAVE_SYNCH_H)
+#  include <pthread.h>
+#  define MTPRNG_PER_THREAD	1
+# endif
+#endif
+
 #define hiBit(a)		((a) & 0x80000000U)
 #define loBit(a)		((a) & 0x1U)
 #define loBits(a)		((a) & 0x7FFFFFFFU)
@@ -47,6 +54,13 @@
 
 const randomGenerator mtprng = { "Mersenne Twister", sizeof(mtprngParam), (randomGeneratorSetup) mtprngSetup, (randomGeneratorSeed) mtprngSeed, (randomGeneratorNext) mtprngNext, (randomGeneratorCleanup) mtprngCleanup };
 
+static int mtprngptSetup  (mtprngParam*);
+static int mtprngptSeed   (mtprngParam*, const byte*, size_t);
+static int mtprngptNext   (mtprngParam*, byte*, size_t);
+static int mtprngptCleanup(mtprngParam*);
+
+const randomGenerator mtprngpt = { "Mersenne Twister per thread", sizeof(mtprngParam), (randomGeneratorSetup) mtprngptSetup, (randomGeneratorSeed) mtprngptSeed, (randomGeneratorNext) mtprngptNext, (randomGeneratorCleanup) mtprngptCleanup };
+
 static void mtprngReload(mtprngParam* mp)
 {
     register uint32_t *p0 = mp->state;
@@ -65,6 +79,54 @@ static void mtprngReload(mtprngParam* mp)
     mp->nextw = mp->state;
 }
 
+/* replaces the state by the seed data, repeated as often as necessary;
+ * the caller holds the lock
+ */
+static void mtprngFill(mtprngParam* mp, const byte* data, size_t size)
+{
+	size_t	needed = (N+1) * sizeof(uint32_t);
+	byte*	dest = (byte*) mp->state;
+
+	while (size < needed)
+	{
+		memcpy(dest, data, size);
+		dest += size;
+		needed -= size;
+	}
+	memcpy(dest, data, needed);
+}
+
+/* generates the requested data; the caller holds the lock */
+static void mtprngGenerate(mtprngParam* mp, byte* data, size_t size)
+{
+	uint32_t tmp;
+
+	while (size > 0)
+	{
+		if (mp->left == 0)
+			mtprngReload(mp);
+
+		tmp = *(mp->nextw++);
+		tmp ^= (tmp >> 11);
+		tmp ^= (tmp << 7) & 0x9D2C5680U;
+		tmp ^= (tmp << 15) & 0xEFC60000U;
+		tmp ^= (tmp >> 18);
+		mp->left--;
+
+		if (size >= 4)
+		{
+			memcpy(data, &tmp, 4);
+			data += 4;
+			size -= 4;
+		}
+		else
+		{
+			memcpy(data, &tmp, size);
+			size = 0;
+		}
+	}
+}
+
 int mtprngSetup(mtprngParam* mp)
 {
 	if (mp)
@@ -95,9 +157,6 @@ int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
 {
 	if (mp)
 	{
-		size_t	needed = (N+1) * sizeof(uint32_t);
-		byte*	dest = (byte*) mp->state;
-
 		#ifdef _REENTRANT
 		# if WIN32
 		if (WaitForSingleObject(mp->lock, INFINITE) != WAIT_OBJECT_0)
@@ -112,13 +171,7 @@ int mtprngSeed(mtprngParam* mp, const byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		while (size < needed)
-		{
-			memcpy(dest, data, size);
-			dest += size;
-			needed -= size;
-		}
-		memcpy(dest, data, needed);
+		mtprngFill(mp, data, size);
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(mp->lock))
@@ -142,8 +195,6 @@ int mtprngNext(mtprngParam* mp, byte* data, size_t size)
 {
 	if (mp)
 	{
-		uint32_t tmp;
-
 		#ifdef _REENTRANT
 		# if WIN32
 		if (WaitForSingleObject(mp->lock, INFINITE) != WAIT_OBJECT_0)
@@ -158,29 +209,7 @@ int mtprngNext(mtprngParam* mp, byte* data, size_t size)
 		#  endif
 		# endif
 		#endif
-		while (size > 0)
-		{
-			if (mp->left == 0)
-				mtprngReload(mp);
-
-			tmp = *(mp->nextw++);
-			tmp ^= (tmp >> 11);
-			tmp ^= (tmp << 7) & 0x9D2C5680U;
-			tmp ^= (tmp << 15) & 0xEFC60000U;
-			tmp ^= (tmp >> 18);
-			mp->left--;
-
-			if (size >= 4)
-			{
-				memcpy(data, &tmp, 4);
-				size -= 4;
-			}
-			else
-			{
-				memcpy(data, &tmp, size);
-				size = 0;
-			}
-		}
+		mtprngGenerate(mp, data, size);
 		#ifdef _REENTRANT
 		# if WIN32
 		if (!ReleaseMutex(mp->lock))
@@ -222,3 +251,157 @@ int mtprngCleanup(mtprngParam* mp)
 	}
 	return -1;
 }
+
+#if MTPRNG_PER_THREAD
+/* every thread runs its own generator, without locking; it takes its
+ * initial state from a shared root generator, which is the only one that
+ * needs the lock; after a fork, the root takes a fresh state from the
+ * entropy source before the child's threads take theirs from it
+ */
+static mtprngParam _mtprngroot;
+static int _mtprngrootrc = -1;
+static volatile int _mtprngrootstir = 0;
+static pthread_once_t _mtprngonce = PTHREAD_ONCE_INIT;
+
+/* bumped in the child after every fork */
+static volatile unsigned int _mtprnggeneration = 1;
+
+static __thread mtprngParam _mtprngpt;
+static __thread unsigned int _mtprngptgeneration = 0;
+
+/* wipes a thread's state when it exits */
+static pthread_key_t _mtprngkey;
+
+static void mtprngptexit(void* state)
+{
+	memset(state, 0, sizeof(mtprngParam));
+	_mtprngptgeneration = 0;
+}
+
+static void mtprngprepare(void)
+{
+	pthread_mutex_lock(&_mtprngroot.lock);
+}
+
+static void mtprngparent(void)
+{
+	pthread_mutex_unlock(&_mtprngroot.lock);
+}
+
+static void mtprngchild(void)
+{
+	pthread_mutex_unlock(&_mtprngroot.lock);
+
+	_mtprngrootstir = 1;
+	_mtprnggeneration++;
+}
+
+static void mtprngrootinit(void)
+{
+	_mtprngrootrc = mtprngSetup(&_mtprngroot);
+
+	if (_mtprngrootrc == 0)
+		_mtprngrootrc = pthread_key_create(&_mtprngkey, mtprngptexit);
+
+	if (_mtprngrootrc == 0)
+		pthread_atfork(mtprngprepare, mtprngparent, mtprngchild);
+}
+
+static mtprngParam* mtprngptState(void)
+{
+	if (_mtprngptgeneration != _mtprnggeneration)
+	{
+		unsigned int generation = _mtprnggeneration;
+
+		pthread_once(&_mtprngonce, mtprngrootinit);
+
+		if (_mtprngrootrc)
+			return (mtprngParam*) 0;
+
+		if (pthread_mutex_lock(&_mtprngroot.lock))
+			return (mtprngParam*) 0;
+
+		if (_mtprngrootstir)
+		{
+			/* without fresh entropy the child would repeat the parent's
+			 * output; fail, and try again on the next call
+			 */
+			if (entropyGatherNext((byte*) _mtprngroot.state, (N+1) * sizeof(uint32_t)))
+			{
+				pthread_mutex_unlock(&_mtprngroot.lock);
+				return (mtprngParam*) 0;
+			}
+
+			_mtprngroot.left = 0;
+			_mtprngrootstir = 0;
+		}
+
+		mtprngGenerate(&_mtprngroot, (byte*) _mtprngpt.state, (N+1) * sizeof(uint32_t));
+
+		pthread_mutex_unlock(&_mtprngroot.lock);
+
+		if (_mtprngptgeneration == 0)
+			pthread_setspecific(_mtprngkey, (void*) &_mtprngpt);
+
+		_mtprngpt.left = 0;
+		_mtprngptgeneration = generation;
+	}
+	return &_mtprngpt;
+}
+
+static int mtprngptSetup(mtprngParam* mp)
+{
+	return mtprngptState() ? 0 : -1;
+}
+
+static int mtprngptSeed(mtprngParam* mp, const byte* data, size_t size)
+{
+	mtprngParam* pt = mtprngptState();
+
+	if (pt == (mtprngParam*) 0)
+		return -1;
+
+	if (data && size)
+		mtprngFill(pt, data, size);
+
+	return 0;
+}
+
+static int mtprngptNext(mtprngParam* mp, byte* data, size_t size)
+{
+	mtprngParam* pt = mtprngptState();
+
+	if (pt == (mtprngParam*) 0)
+		return -1;
+
+	mtprngGenerate(pt, data, size);
+
+	return 0;
+}
+
+static int mtprngptCleanup(mtprngParam* mp)
+{
+	return 0;
+}
+#else
+/* without thread-local storage, each context gets its own locked generator */
+static int mtprngptSetup(mtprngParam* mp)
+{
+	return mtprngSetup(mp);
+}
+
+static int mtprngptSeed(mtprngParam* mp, const byte* data, size_t size)
+{
+	return mtprngSeed(mp, data, size);
+}
+
+static int mtprngptNext(mtprngParam* mp, byte* data, size_t size)
+{
+	return mtprngNext(mp, data, size);
+}
+
+static int mtprngptCleanup(mtprngParam* mp)
+{
+	return mtprngCleanup(mp);
+}
+#endif
@@ -1,71 +1,281 @@
 #define BEECRYPT_DLL_EXPORT
 
 #include "beecrypt/pkcs12.h"
+#include "beecrypt/md5.h"
+#include "beecrypt/sha1.h"
+#include "beecrypt/sha256.h"
+#include "beecrypt/sha384.h"
+#include "beecrypt/sha512.h"
 
-int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+/*!\typedef void (*pkcs12Iterate)(byte* digest, size_t count)
+ * \brief Replaces a digest by the result of hashing it count times over.
+ */
+typedef void (*pkcs12Iterate)(byte*, size_t);
+
+/* once the derivation is underway, each iteration hashes nothing but the
+ * previous digest; since its length is fixed, the padded block can be set
+ * up once, after which each iteration is a single call of the compression
+ * function on a freshly initialized state, which writes its result back
+ * into the block
+ */
+
+static void pkcs12EncodeBE32(byte* data, const uint32_t* h, int words)
+{
+	while (words--)
+	{
+		data[0] = (byte)(*h >> 24);
+		data[1] = (byte)(*h >> 16);
+		data[2] = (byte)(*h >>  8);
+		data[3] = (byte)(*h      );
+		data += 4;
+		h++;
+	}
+}
+
+static void pkcs12EncodeBE64(byte* data, const uint64_t* h, int words)
+{
+	while (words--)
+	{
+		data[0] = (byte)(*h >> 56);
+		data[1] = (byte)(*h >> 48);
+		data[2] = (byte)(*h >> 40);
+		data[3] = (byte)(*h >> 32);
+		data[4] = (byte)(*h >> 24);
+		data[5] = (byte)(*h >> 16);
+		data[6] = (byte)(*h >>  8);
+		data[7] = (byte)(*h      );
+		data += 8;
+		h++;
+	}
+}
+
+static void pkcs12IterateMD5(byte* digest, size_t count)
+{
+	md5Param mp;
+	uint32_t init[4];
+	byte block[64];
+	int i;
+
+	md5Reset(&mp);
+	memcpy(init, mp.h, sizeof(init));
+
+	memset(block, 0, sizeof(block));
+	memcpy(block, digest, 16);
+	block[16] = 0x80;
+	block[56] = 0x80;
+
+	while (count--)
+	{
+		memcpy(mp.h, init, sizeof(init));
+		md5ProcessBlocks(&mp, block, 1);
+		for (i = 0; i < 4; i++)
+		{
+			block[4*i  ] = (byte)(mp.h[i]      );
+			block[4*i+1] = (byte)(mp.h[i] >>  8);
+			block[4*i+2] = (byte)(mp.h[i] >> 16);
+			block[4*i+3] = (byte)(mp.h[i] >> 24);
+		}
+	}
+
+	memcpy(digest, block, 16);
+}
+
+static void pkcs12IterateSHA1(byte* digest, size_t count)
+{
+	sha1Param sp;
+	uint32_t init[5];
+	byte block[64];
+
+	sha1Reset(&sp);
+	memcpy(init, sp.h, sizeof(init));
+
+	memset(block, 0, sizeof(block));
+	memcpy(block, digest, 20);
+	block[20] = 0x80;
+	block[63] = 0xa0;
+
+	while (count--)
+	{
+		memcpy(sp.h, init, sizeof(init));
+		sha1ProcessBlocks(&sp, block, 1);
+		pkcs12EncodeBE32(block, sp.h, 5);
+	}
+
+	memcpy(digest, block, 20);
+}
+
+static void pkcs12IterateSHA256(byte* digest, size_t count)
+{
+	sha256Param sp;
+	uint32_t init[8];
+	byte block[64];
+
+	sha256Reset(&sp);
+	memcpy(init, sp.h, sizeof(init));
+
+	memset(block, 0, sizeof(block));
+	memcpy(block, digest, 32);
+	block[32] = 0x80;
+	block[62] = 0x01;
+
+	while (count--)
+	{
+		memcpy(sp.h, init, sizeof(init));
+		sha256ProcessBlocks(&sp, block, 1);
+		pkcs12EncodeBE32(block, sp.h, 8);
+	}
+
+	memcpy(digest, block, 32);
+}
+
+static void pkcs12IterateSHA384(byte* digest, size_t count)
+{
+	sha384Param sp;
+	uint64_t init[8];
+	byte block[128];
+
+	sha384Reset(&sp);
+	memcpy(init, sp.h, sizeof(init));
+
+	memset(block, 0, sizeof(block));
+	memcpy(block, digest, 48);
+	block[48] = 0x80;
+	block[126] = 0x01;
+	block[127] = 0x80;
+
+	while (count--)
+	{
+		memcpy(sp.h, init, sizeof(init));
+		sha384ProcessBlocks(&sp, block, 1);
+		pkcs12EncodeBE64(block, sp.h, 6);
+	}
+
+	memcpy(digest, block, 48);
+}
+
+static void pkcs12IterateSHA512(byte* digest, size_t count)
+{
+	sha512Param sp;
+	uint64_t init[8];
+	byte block[128];
+
+	sha512Reset(&sp);
+	memcpy(init, sp.h, sizeof(init));
+
+	memset(block, 0, sizeof(block));
+	memcpy(block, digest, 64);
+	block[64] = 0x80;
+	block[126] = 0x02;
+
+	while (count--)
+	{
+		memcpy(sp.h, init, sizeof(init));
+		sha512ProcessBlocks(&sp, block, 1);
+		pkcs12EncodeBE64(block, sp.h, 8);
+	}
+
+	memcpy(digest, block, 64);
+}
+
+static pkcs12Iterate pkcs12Iterator(const hashFunction* h)
+{
+	if (h == &md5)
+		return pkcs12IterateMD5;
+	if (h == &sha1)
+		return pkcs12IterateSHA1;
+	if (h == &sha256)
+		return pkcs12IterateSHA256;
+	if (h == &sha384)
+		return pkcs12IterateSHA384;
+	if (h == &sha512)
+		return pkcs12IterateSHA512;
+
+	return (pkcs12Iterate) 0;
+}
+
+int pkcs12_derive_keys(const hashFunction* h, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, size_t count, const byte* ids, byte* const* ndata, const size_t* nsize)
 {
 	int rc = -1;
-	size_t i, remain;
+	size_t i, slen = 0, plen = 0, ilen, remain;
+	pkcs12Iterate iterate = pkcs12Iterator(h);
 	hashFunctionContext ctxt;
-	byte *digest;
+	byte *input = (byte*) 0, *digest = (byte*) 0, *tmp;
+
+	/* salt and password are each concatenated until we have a whole
+	 * number of blocks; note that existing keystores depend on this
+	 * exact length
+	 */
+	if (ssize)
+		slen = ((ssize / h->blocksize) + (ssize % h->blocksize)) * h->blocksize;
+	if (psize)
+		plen = ((psize / h->blocksize) + (psize % h->blocksize)) * h->blocksize;
+
+	/* the input is the diversifier block, followed by salt and password */
+	ilen = h->blocksize + slen + plen;
 
 	digest = (byte*) malloc(h->digestsize);
 	if (!digest)
 		goto cleanup;
 
-	if (hashFunctionContextInit(&ctxt, h))
+	input = (byte*) malloc(ilen);
+	if (!input)
 		goto cleanup;
 
-	/* we start by hashing the diversifier; don't allocate a buffer for this */
-	for (i = 0; i < h->blocksize; i++)
-		hashFunctionContextUpdate(&ctxt, &id, 1);
-
-	/* next we hash the salt data, concatenating until we have a whole number of blocks */
-	if (ssize)
+	for (tmp = input + h->blocksize, remain = slen; remain > 0; )
 	{
-		remain = ((ssize / h->blocksize) + (ssize % h->blocksize)) * h->blocksize;
-		while (remain > 0)
-		{
-			size_t tmp = remain > ssize ? ssize : remain;
-
-			hashFunctionContextUpdate(&ctxt, sdata, tmp);
+		size_t len = remain > ssize ? ssize : remain;
 
-			remain -= tmp;
-		}
+		memcpy(tmp, sdata, len);
+		tmp += len;
+		remain -= len;
 	}
 
-	/* next we hash the password data, concatenating until we have a whole number of blocks */
-	if (psize)
+	for (remain = plen; remain > 0; )
 	{
-		remain = ((psize / h->blocksize) + (psize % h->blocksize)) * h->blocksize;
-		while (remain > 0)
-		{
-			size_t tmp = remain > psize ? psize : remain;
-
-			hashFunctionContextUpdate(&ctxt, pdata, tmp);
+		size_t len = remain > psize ? psize : remain;
 
-			remain -= tmp;
-		}
+		memcpy(tmp, pdata, len);
+		tmp += len;
+		remain -= len;
 	}
 
-	/* now we iterate through the following loop */
-	while (iterationcount-- > 0)
+	if (hashFunctionContextInit(&ctxt, h))
+		goto cleanup;
+
+	for (i = 0; i < count; i++)
 	{
+		byte* key = ndata[i];
+		size_t keysize = nsize[i];
+
+		/* only the diversifier differs from one key to the next */
+		memset(input, ids[i], h->blocksize);
+
+		hashFunctionContextUpdate(&ctxt, input, ilen);
 		hashFunctionContextDigest(&ctxt, digest);
-		hashFunctionContextUpdate(&ctxt, digest, h->digestsize);
-	}
 
-	/* do the final digest */
-	hashFunctionContextDigest(&ctxt, digest);
+		/* now we iterate through the following loop */
+		if (iterate)
+			iterate(digest, iterationcount);
+		else
+		{
+			size_t j;
 
-	/* fill key */
-	while (nsize > 0)
-	{
-		size_t tmp = nsize > h->digestsize ? h->digestsize : nsize;
+			for (j = 0; j < iterationcount; j++)
+			{
+				hashFunctionContextUpdate(&ctxt, digest, h->digestsize);
+				hashFunctionContextDigest(&ctxt, digest);
+			}
+		}
+
+		/* fill key */
+		while (keysize > 0)
+		{
+			size_t len = keysize > h->digestsize ? h->digestsize : keysize;
 
-		memcpy(ndata, digest, tmp);
-		ndata += tmp;
-		nsize -= tmp;
+			memcpy(key, digest, len);
+			key += len;
+			keysize -= len;
+		}
 	}
 
 	if (hashFunctionContextFree(&ctxt))
@@ -74,8 +284,21 @@ int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t
 	rc = 0;
 
 cleanup:
+	if (input)
+	{
+		memset(input, 0, ilen);
+		free(input);
+	}
 	if (digest)
+	{
+		memset(digest, 0, h->digestsize);
 		free(digest);
+	}
 
 	return rc;
 }
+
+int pkcs12_derive_key(const hashFunction* h, byte id, const byte* pdata, size_t psize, const byte* sdata, size_t ssize, size_t iterationcount, byte* ndata, size_t nsize)
+{
+	return pkcs12_derive_keys(h, pdata, psize, sdata, ssize, iterationcount, 1, &id, &ndata, &nsize);
+}
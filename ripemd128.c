@@ -49,7 +49,10 @@ const hashFunction ripemd128 = {
 	16,
 	(hashFunctionReset) ripemd128Reset,
 	(hashFunctionUpdate) ripemd128Update,
-	(hashFunctionDigest) ripemd128Digest
+	(hashFunctionDigest) ripemd128Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) ripemd128Copy,
+	(hashFunctionCheck) ripemd128Check
 };
 /*@=sizeoftype@*/
 
@@ -70,6 +73,20 @@ int ripemd128Reset(register ripemd128Param* mp)
         return 0;
 }
 
+int ripemd128Copy(register ripemd128Param* dst, const ripemd128Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int ripemd128Check(const ripemd128Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define LSR1(a, b, c, d, x, s) \
 	a = ROTL32((b^c^d) + a + x, s);
 #define LSR2(a, b, c, d, x, s) \
@@ -89,24 +106,36 @@ int ripemd128Reset(register ripemd128Param* mp)
 	a = ROTL32(((b&d)|(c&~d)) + a + x + 0x50a28be6U, s);
 
 #ifndef ASM_RIPEMD128PROCESS
-void ripemd128Process(ripemd128Param* mp)
+/* processes one block; it may be mp->data itself */
+static void ripemd128Block(ripemd128Param* mp, const byte* block)
 {
 	register uint32_t la, lb, lc, ld;
 	register uint32_t ra, rb, rc, rd;
-	register uint32_t* x;
+	register const uint32_t* x;
         #ifdef WORDS_BIGENDIAN
+        register uint32_t* load = mp->data;
         register byte t;
-        #endif
 
-        x = mp->data;
-        #ifdef WORDS_BIGENDIAN
         t = 16;
         while (t--)
         {
-                register uint32_t temp = swapu32(*x);
-                *(x++) = temp;
+                uint32_t word;
+                memcpy(&word, block, 4);
+                *(load++) = swapu32(word);
+                block += 4;
         }
         x = mp->data;
+        #else
+        /* the words are already in the right order; only copy when they are
+         * not suitably aligned
+         */
+        if (((size_t) block) & (sizeof(uint32_t)-1))
+        {
+                memcpy(mp->data, block, 64);
+                x = mp->data;
+        }
+        else
+                x = (const uint32_t*) block;
         #endif
 
         la = mp->h[0]; lb = mp->h[1]; lc = mp->h[2]; ld = mp->h[3];
@@ -267,6 +296,30 @@ void ripemd128Process(ripemd128Param* mp)
         mp->h[3] = mp->h[0] + lb + rc;
         mp->h[0] = rd;
 }
+
+void ripemd128ProcessBlocks(ripemd128Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                ripemd128Block(mp, blocks);
+                blocks += 64;
+        }
+}
+
+void ripemd128Process(ripemd128Param* mp)
+{
+        ripemd128Block(mp, (const byte*) mp->data);
+}
+#else
+void ripemd128ProcessBlocks(ripemd128Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                memcpy(mp->data, blocks, 64);
+                ripemd128Process(mp);
+                blocks += 64;
+        }
+}
 #endif
 
 int ripemd128Update(ripemd128Param* mp, const byte* data, size_t size)
@@ -287,12 +340,11 @@ int ripemd128Update(ripemd128Param* mp, const byte* data, size_t size)
         # error
         #endif
 
-        while (size > 0)
+        /* complete a partial block first */
+        if (mp->offset > 0)
         {
                 proclength = ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
-/*@-mayaliasunique@*/
                 memcpy(((byte *) mp->data) + mp->offset, data, proclength);
-/*@=mayaliasunique@*/
                 size -= proclength;
                 data += proclength;
                 mp->offset += proclength;
@@ -303,6 +355,23 @@ int ripemd128Update(ripemd128Param* mp, const byte* data, size_t size)
                         mp->offset = 0;
                 }
         }
+
+        /* whole blocks are processed straight from the caller's buffer */
+        if (size >= 64U)
+        {
+                register size_t nblocks = size >> 6;
+
+                ripemd128ProcessBlocks(mp, data, nblocks);
+                data += nblocks << 6;
+                size -= nblocks << 6;
+        }
+
+        /* keep the remainder */
+        if (size > 0)
+        {
+                memcpy(mp->data, data, size);
+                mp->offset = (uint32_t) size;
+        }
         return 0;
 }
 
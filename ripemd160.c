@@ -49,7 +49,10 @@ const hashFunction ripemd160 = {
 	20,
 	(hashFunctionReset) ripemd160Reset,
 	(hashFunctionUpdate) ripemd160Update,
-	(hashFunctionDigest) ripemd160Digest
+	(hashFunctionDigest) ripemd160Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) ripemd160Copy,
+	(hashFunctionCheck) ripemd160Check
 };
 /*@=sizeoftype@*/
 
@@ -70,6 +73,20 @@ int ripemd160Reset(register ripemd160Param* mp)
         return 0;
 }
 
+int ripemd160Copy(register ripemd160Param* dst, const ripemd160Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int ripemd160Check(const ripemd160Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define LSR1(a, b, c, d, e, x, s) \
 	a = ROTL32((b^c^d) + a + x, s) + e;\
 	c = ROTL32(c, 10);
@@ -103,24 +120,36 @@ int ripemd160Reset(register ripemd160Param* mp)
 	c = ROTL32(c, 10);
 
 #ifndef ASM_RIPEMD160PROCESS
-void ripemd160Process(ripemd160Param* mp)
+/* processes one block; it may be mp->data itself */
+static void ripemd160Block(ripemd160Param* mp, const byte* block)
 {
 	register uint32_t la, lb, lc, ld, le;
 	register uint32_t ra, rb, rc, rd, re;
-	register uint32_t* x;
+	register const uint32_t* x;
         #ifdef WORDS_BIGENDIAN
+        register uint32_t* load = mp->data;
         register byte t;
-        #endif
 
-        x = mp->data;
-        #ifdef WORDS_BIGENDIAN
         t = 16;
         while (t--)
         {
-                register uint32_t temp = swapu32(*x);
-                *(x++) = temp;
+                uint32_t word;
+                memcpy(&word, block, 4);
+                *(load++) = swapu32(word);
+                block += 4;
         }
         x = mp->data;
+        #else
+        /* the words are already in the right order; only copy when they are
+         * not suitably aligned
+         */
+        if (((size_t) block) & (sizeof(uint32_t)-1))
+        {
+                memcpy(mp->data, block, 64);
+                x = mp->data;
+        }
+        else
+                x = (const uint32_t*) block;
         #endif
 
         la = mp->h[0]; lb = mp->h[1]; lc = mp->h[2]; ld = mp->h[3]; le = mp->h[4];
@@ -318,6 +347,30 @@ void ripemd160Process(ripemd160Param* mp)
         mp->h[4] = mp->h[0] + lb + rc;
         mp->h[0] = rd;
 }
+
+void ripemd160ProcessBlocks(ripemd160Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                ripemd160Block(mp, blocks);
+                blocks += 64;
+        }
+}
+
+void ripemd160Process(ripemd160Param* mp)
+{
+        ripemd160Block(mp, (const byte*) mp->data);
+}
+#else
+void ripemd160ProcessBlocks(ripemd160Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                memcpy(mp->data, blocks, 64);
+                ripemd160Process(mp);
+                blocks += 64;
+        }
+}
 #endif
 
 int ripemd160Update(ripemd160Param* mp, const byte* data, size_t size)
@@ -338,12 +391,11 @@ int ripemd160Update(ripemd160Param* mp, const byte* data, size_t size)
         # error
         #endif
 
-        while (size > 0)
+        /* complete a partial block first */
+        if (mp->offset > 0)
         {
                 proclength = ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
-/*@-mayaliasunique@*/
                 memcpy(((byte *) mp->data) + mp->offset, data, proclength);
-/*@=mayaliasunique@*/
                 size -= proclength;
                 data += proclength;
                 mp->offset += proclength;
@@ -354,6 +406,23 @@ int ripemd160Update(ripemd160Param* mp, const byte* data, size_t size)
                         mp->offset = 0;
                 }
         }
+
+        /* whole blocks are processed straight from the caller's buffer */
+        if (size >= 64U)
+        {
+                register size_t nblocks = size >> 6;
+
+                ripemd160ProcessBlocks(mp, data, nblocks);
+                data += nblocks << 6;
+                size -= nblocks << 6;
+        }
+
+        /* keep the remainder */
+        if (size > 0)
+        {
+                memcpy(mp->data, data, size);
+                mp->offset = (uint32_t) size;
+        }
         return 0;
 }
 
@@ -50,7 +50,10 @@ const hashFunction ripemd256 = {
 	32,
 	(hashFunctionReset) ripemd256Reset,
 	(hashFunctionUpdate) ripemd256Update,
-	(hashFunctionDigest) ripemd256Digest
+	(hashFunctionDigest) ripemd256Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) ripemd256Copy,
+	(hashFunctionCheck) ripemd256Check
 };
 /*@=sizeoftype@*/
 
@@ -71,6 +74,20 @@ int ripemd256Reset(register ripemd256Param* mp)
         return 0;
 }
 
+int ripemd256Copy(register ripemd256Param* dst, const ripemd256Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int ripemd256Check(const ripemd256Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define LSR1(a, b, c, d, x, s) \
 	a = ROTL32((b^c^d) + a + x, s);
 #define LSR2(a, b, c, d, x, s) \
@@ -90,25 +107,37 @@ int ripemd256Reset(register ripemd256Param* mp)
 	a = ROTL32(((b&d)|(c&~d)) + a + x + 0x50a28be6U, s);
 
 #ifndef ASM_RIPEMD256PROCESS
-void ripemd256Process(ripemd256Param* mp)
+/* processes one block; it may be mp->data itself */
+static void ripemd256Block(ripemd256Param* mp, const byte* block)
 {
 	register uint32_t la, lb, lc, ld;
 	register uint32_t ra, rb, rc, rd;
 	register uint32_t temp;
-	register uint32_t* x;
+	register const uint32_t* x;
         #ifdef WORDS_BIGENDIAN
+        register uint32_t* load = mp->data;
         register byte t;
-        #endif
 
-        x = mp->data;
-        #ifdef WORDS_BIGENDIAN
         t = 16;
         while (t--)
         {
-                temp = swapu32(*x);
-                *(x++) = temp;
+                uint32_t word;
+                memcpy(&word, block, 4);
+                *(load++) = swapu32(word);
+                block += 4;
         }
         x = mp->data;
+        #else
+        /* the words are already in the right order; only copy when they are
+         * not suitably aligned
+         */
+        if (((size_t) block) & (sizeof(uint32_t)-1))
+        {
+                memcpy(mp->data, block, 64);
+                x = mp->data;
+        }
+        else
+                x = (const uint32_t*) block;
         #endif
 
         la = mp->h[0]; lb = mp->h[1]; lc = mp->h[2]; ld = mp->h[3];
@@ -280,6 +309,30 @@ void ripemd256Process(ripemd256Param* mp)
         mp->h[6] += rc;
         mp->h[7] += rd;
 }
+
+void ripemd256ProcessBlocks(ripemd256Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                ripemd256Block(mp, blocks);
+                blocks += 64;
+        }
+}
+
+void ripemd256Process(ripemd256Param* mp)
+{
+        ripemd256Block(mp, (const byte*) mp->data);
+}
+#else
+void ripemd256ProcessBlocks(ripemd256Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                memcpy(mp->data, blocks, 64);
+                ripemd256Process(mp);
+                blocks += 64;
+        }
+}
 #endif
 
 int ripemd256Update(ripemd256Param* mp, const byte* data, size_t size)
@@ -300,12 +353,11 @@ int ripemd256Update(ripemd256Param* mp, const byte* data, size_t size)
         # error
         #endif
 
-        while (size > 0)
+        /* complete a partial block first */
+        if (mp->offset > 0)
         {
                 proclength = ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
-/*@-mayaliasunique@*/
                 memcpy(((byte *) mp->data) + mp->offset, data, proclength);
-/*@=mayaliasunique@*/
                 size -= proclength;
                 data += proclength;
                 mp->offset += proclength;
@@ -316,6 +368,23 @@ int ripemd256Update(ripemd256Param* mp, const byte* data, size_t size)
                         mp->offset = 0;
                 }
         }
+
+        /* whole blocks are processed straight from the caller's buffer */
+        if (size >= 64U)
+        {
+                register size_t nblocks = size >> 6;
+
+                ripemd256ProcessBlocks(mp, data, nblocks);
+                data += nblocks << 6;
+                size -= nblocks << 6;
+        }
+
+        /* keep the remainder */
+        if (size > 0)
+        {
+                memcpy(mp->data, data, size);
+                mp->offset = (uint32_t) size;
+        }
         return 0;
 }
 
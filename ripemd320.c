@@ -50,7 +50,10 @@ const hashFunction ripemd320 = {
 	40,
 	(hashFunctionReset) ripemd320Reset,
 	(hashFunctionUpdate) ripemd320Update,
-	(hashFunctionDigest) ripemd320Digest
+	(hashFunctionDigest) ripemd320Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) ripemd320Copy,
+	(hashFunctionCheck) ripemd320Check
 };
 /*@=sizeoftype@*/
 
@@ -71,6 +74,20 @@ int ripemd320Reset(register ripemd320Param* mp)
         return 0;
 }
 
+int ripemd320Copy(register ripemd320Param* dst, const ripemd320Param* src)
+{
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int ripemd320Check(const ripemd320Param* mp)
+{
+	return (mp->offset < 64U) ? 0 : -1;
+}
+
 #define LSR1(a, b, c, d, e, x, s) \
 	a = ROTL32((b^c^d) + a + x, s) + e;\
 	c = ROTL32(c, 10);
@@ -104,25 +121,37 @@ int ripemd320Reset(register ripemd320Param* mp)
 	c = ROTL32(c, 10);
 
 #ifndef ASM_RIPEMD320PROCESS
-void ripemd320Process(ripemd320Param* mp)
+/* processes one block; it may be mp->data itself */
+static void ripemd320Block(ripemd320Param* mp, const byte* block)
 {
 	register uint32_t la, lb, lc, ld, le;
 	register uint32_t ra, rb, rc, rd, re;
 	register uint32_t temp;
-	register uint32_t* x;
+	register const uint32_t* x;
         #ifdef WORDS_BIGENDIAN
+        register uint32_t* load = mp->data;
         register byte t;
-        #endif
 
-        x = mp->data;
-        #ifdef WORDS_BIGENDIAN
         t = 16;
         while (t--)
         {
-                temp = swapu32(*x);
-                *(x++) = temp;
+                uint32_t word;
+                memcpy(&word, block, 4);
+                *(load++) = swapu32(word);
+                block += 4;
         }
         x = mp->data;
+        #else
+        /* the words are already in the right order; only copy when they are
+         * not suitably aligned
+         */
+        if (((size_t) block) & (sizeof(uint32_t)-1))
+        {
+                memcpy(mp->data, block, 64);
+                x = mp->data;
+        }
+        else
+                x = (const uint32_t*) block;
         #endif
 
         la = mp->h[0]; lb = mp->h[1]; lc = mp->h[2]; ld = mp->h[3]; le = mp->h[4];
@@ -334,6 +363,30 @@ void ripemd320Process(ripemd320Param* mp)
 	mp->h[8] += rd;
 	mp->h[9] += re;
 }
+
+void ripemd320ProcessBlocks(ripemd320Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                ripemd320Block(mp, blocks);
+                blocks += 64;
+        }
+}
+
+void ripemd320Process(ripemd320Param* mp)
+{
+        ripemd320Block(mp, (const byte*) mp->data);
+}
+#else
+void ripemd320ProcessBlocks(ripemd320Param* mp, const byte* blocks, size_t nblocks)
+{
+        while (nblocks--)
+        {
+                memcpy(mp->data, blocks, 64);
+                ripemd320Process(mp);
+                blocks += 64;
+        }
+}
 #endif
 
 int ripemd320Update(ripemd320Param* mp, const byte* data, size_t size)
@@ -354,12 +407,11 @@ int ripemd320Update(ripemd320Param* mp, const byte* data, size_t size)
         # error
         #endif
 
-        while (size > 0)
+        /* complete a partial block first */
+        if (mp->offset > 0)
         {
                 proclength = ((mp->offset + size) > 64U) ? (64U - mp->offset) : size;
-/*@-mayaliasunique@*/
                 memcpy(((byte *) mp->data) + mp->offset, data, proclength);
-/*@=mayaliasunique@*/
                 size -= proclength;
                 data += proclength;
                 mp->offset += proclength;
@@ -370,6 +422,23 @@ int ripemd320Update(ripemd320Param* mp, const byte* data, size_t size)
                         mp->offset = 0;
                 }
         }
+
+        /* whole blocks are processed straight from the caller's buffer */
+        if (size >= 64U)
+        {
+                register size_t nblocks = size >> 6;
+
+                ripemd320ProcessBlocks(mp, data, nblocks);
+                data += nblocks << 6;
+                size -= nblocks << 6;
+        }
+
+        /* keep the remainder */
+        if (size > 0)
+        {
+                memcpy(mp->data, data, size);
+                mp->offset = (uint32_t) size;
+        }
         return 0;
 }
 
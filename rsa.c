@@ -31,77 +31,100 @@
 #endif
 
 #include "beecrypt/rsa.h"
+#include "beecrypt/mpmont.h"
+#include "beecrypt/mpwksp.h"
 
-int rsapub(const mpbarrett* n, const mpnumber* e,
-           const mpnumber* m, mpnumber* c)
-{
-	register size_t size = n->size;
-	register mpw* temp;
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
+static unsigned int _rsa_batch_threads = 0;
+static unsigned int _rsa_batch_lanes = RSA_BATCH_LANES;
+
+int rsapub_w(const mpbarrett* n, const mpnumber* e,
+             const mpnumber* m, mpnumber* c, mpw* wksp)
+{
 	if (mpgex(m->size, m->data, n->size, n->modl))
 		return -1;
 
-	temp = (mpw*) malloc((4*size+2)*sizeof(mpw));
+	mpnsize(c, n->size);
+	if (c->data == (mpw*) 0)
+		return -1;
+
+	mpbpowmod_w(n, m->size, m->data, e->size, e->data, c->data, wksp);
+
+	return 0;
+}
+
+int rsapub(const mpbarrett* n, const mpnumber* e,
+           const mpnumber* m, mpnumber* c)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget(4*n->size+2);
 
 	if (temp)
 	{
-		mpnsize(c, size);
-		mpbpowmod_w(n, m->size, m->data, e->size, e->data, c->data, temp);
+		rc = rsapub_w(n, e, m, c, temp);
 
-		free(temp);
-
-		return 0;
+		mpwkspput(temp);
 	}
-	return -1;
+	return rc;
 }
 
-int rsapri(const mpbarrett* n, const mpnumber* d,
-           const mpnumber* c, mpnumber* m)
+int rsapri_w(const mpbarrett* n, const mpnumber* d,
+             const mpnumber* c, mpnumber* m, mpw* wksp)
 {
-	register size_t size = n->size;
-	register mpw* temp;
-
 	if (mpgex(c->size, c->data, n->size, n->modl))
 		return -1;
 
-	temp = (mpw*) malloc((4*size+2)*sizeof(mpw));
+	mpnsize(m, n->size);
+	if (m->data == (mpw*) 0)
+		return -1;
+
+	mpenginepowmod_w(n, (const mpmont*) 0, c->size, c->data, d->size, d->data, m->data, wksp);
+
+	return 0;
+}
+
+int rsapri(const mpbarrett* n, const mpnumber* d,
+           const mpnumber* c, mpnumber* m)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget(4*n->size+2);
 
 	if (temp)
 	{
-		mpnsize(m, size);
-		mpbpowmod_w(n, c->size, c->data, d->size, d->data, m->data, temp);
-
-		free(temp);
+		rc = rsapri_w(n, d, c, m, temp);
 
-		return 0;
+		mpwkspput(temp);
 	}
-	return -1;
+	return rc;
 }
 
-int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
-              const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
-              const mpnumber* c, mpnumber* m)
+/*
+ * rsapricrt_m
+ *  does the CRT private key operation, with optional prepared Montgomery
+ *  contexts for p and q
+ */
+static int rsapricrt_m(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+                       const mpmont* pm, const mpmont* qm,
+                       const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+                       const mpnumber* c, mpnumber* m, mpw* wksp)
 {
 	register size_t nsize = n->size;
 	register size_t psize = p->size;
 	register size_t qsize = q->size;
 
-	register mpw* ptemp;
-	register mpw* qtemp;
+	register mpw* ptemp = wksp;
+	register mpw* qtemp = wksp+6*psize+2;
 
 	if (mpgex(c->size, c->data, n->size, n->modl))
 		return -1;
 
-	ptemp = (mpw*) malloc((6*psize+2)*sizeof(mpw));
-	if (ptemp == (mpw*) 0)
-		return -1;
-
-	qtemp = (mpw*) malloc((6*qsize+2)*sizeof(mpw));
-	if (qtemp == (mpw*) 0)
-	{
-		free(ptemp);
+	/* make sure the message gets the proper size */
+	mpnsize(m, nsize);
+	if (m->data == (mpw*) 0)
 		return -1;
-	}
 
 	#pragma omp parallel sections
 	{
@@ -114,7 +137,7 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
 		mpbmod_w(p, ptemp, ptemp+psize, ptemp+2*psize);
 
 		/* compute j1 = c^dp mod p, store @ ptemp */
-		mpbpowmod_w(p, psize, ptemp+psize, dp->size, dp->data, ptemp, ptemp+2*psize);
+		mpenginepowmod_w(p, pm, psize, ptemp+psize, dp->size, dp->data, ptemp, ptemp+2*psize);
 		}
 
 		#pragma omp section
@@ -126,7 +149,7 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
 		mpbmod_w(q, qtemp, qtemp+qsize, qtemp+2*qsize);
 
 		/* compute j2 = c^dq mod q, store @ qtemp */
-		mpbpowmod_w(q, qsize, qtemp+qsize, dq->size, dq->data, qtemp, qtemp+2*qsize);
+		mpenginepowmod_w(q, qm, qsize, qtemp+qsize, dq->size, dq->data, qtemp, qtemp+2*qsize);
 		}
 	}
 
@@ -136,42 +159,226 @@ int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
 	/* compute h = c*(j1-j2) mod p, store @ ptemp */
 	mpbmulmod_w(p, psize, ptemp, psize, qi->data, ptemp, ptemp+2*psize);
 
-	/* make sure the message gets the proper size */
-	mpnsize(m, nsize);
-
 	/* compute m = h*q + j2 */
 	mpmul(m->data, psize, ptemp, qsize, q->modl);
 	mpaddx(nsize, m->data, qsize, qtemp);
 
-	free(ptemp);
-	free(qtemp);
+	return 0;
+}
+
+int rsapricrt_w(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+                const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+                const mpnumber* c, mpnumber* m, mpw* wksp)
+{
+	return rsapricrt_m(n, p, q, (const mpmont*) 0, (const mpmont*) 0, dp, dq, qi, c, m, wksp);
+}
+
+int rsapricrt(const mpbarrett* n, const mpbarrett* p, const mpbarrett* q,
+              const mpnumber* dp, const mpnumber* dq, const mpnumber* qi,
+              const mpnumber* c, mpnumber* m)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget(6*(p->size+q->size)+4);
+
+	if (temp)
+	{
+		rc = rsapricrt_w(n, p, q, dp, dq, qi, c, m, temp);
+
+		mpwkspput(temp);
+	}
+	return rc;
+}
+
+int rsapricrtkp(const rsakp* kp, const mpnumber* c, mpnumber* m)
+{
+	register int rc = -1;
+	register mpw* temp = mpwkspget(6*(kp->p.size+kp->q.size)+4);
+
+	if (temp)
+	{
+		rc = rsapricrt_m(&kp->n, &kp->p, &kp->q, &kp->pm, &kp->qm, &kp->dp, &kp->dq, &kp->qi, c, m, temp);
+
+		mpwkspput(temp);
+	}
+	return rc;
+}
+
+int rsaBatchSetup(unsigned int threads, unsigned int lanes)
+{
+	if (lanes > RSA_BATCH_MAXLANES)
+		return -1;
+
+	_rsa_batch_threads = threads;
+	_rsa_batch_lanes = lanes ? lanes : RSA_BATCH_LANES;
 
 	return 0;
 }
 
-int rsavrfy(const mpbarrett* n, const mpnumber* e,
-            const mpnumber* m, const mpnumber* c)
+/*
+ * rsapricrt_lanes
+ *  does the private key operation for the lanes ciphertexts starting at c
+ *  needs workspace of ((12*lanes+6)*size+2) words, where size is the larger
+ *  of psize and qsize
+ */
+static void rsapricrt_lanes(const rsakp* kp, const mpmont* pm, const mpmont* qm, size_t lanes, const mpnumber* c, mpnumber* m, mpw* wksp)
 {
+	register size_t nsize = kp->n.size;
+	register size_t psize = kp->p.size;
+	register size_t qsize = kp->q.size;
+	register size_t size = (psize > qsize) ? psize : qsize;
+	register size_t i;
+
+	register mpw* xp = wksp;
+	register mpw* xq = xp+lanes*psize;
+	register mpw* jp = xq+lanes*qsize;
+	register mpw* jq = jp+lanes*psize;
+	register mpw* temp = jq+lanes*qsize;
+	register mpw* rest = temp+2*size;
+
+	/* reduce every c modulo p and q */
+	for (i = 0; i < lanes; i++)
+	{
+		mpsetx(psize*2, temp, c[i].size, c[i].data);
+		mpbmod_w(&kp->p, temp, xp+i*psize, rest);
+
+		mpsetx(qsize*2, temp, c[i].size, c[i].data);
+		mpbmod_w(&kp->q, temp, xq+i*qsize, rest);
+	}
+
+	/* compute all j1 = c^dp mod p, and all j2 = c^dq mod q */
+	mpmontpowmodn_w(pm, lanes, xp, kp->dp.size, kp->dp.data, jp, rest);
+	mpmontpowmodn_w(qm, lanes, xq, kp->dq.size, kp->dq.data, jq, rest);
+
+	for (i = 0; i < lanes; i++)
+	{
+		register mpw* j1 = jp+i*psize;
+		register mpw* j2 = jq+i*qsize;
+
+		/* compute h = qi*(j1-j2) mod p */
+		mpbsubmod_w(&kp->p, psize, j1, qsize, j2, j1, rest);
+		mpbmulmod_w(&kp->p, psize, j1, kp->qi.size, kp->qi.data, j1, rest);
+
+		/* compute m = h*q + j2 */
+		mpmul(m[i].data, psize, j1, qsize, kp->q.modl);
+		mpaddx(nsize, m[i].data, qsize, j2);
+	}
+}
+
+int rsapricrt_batch(const rsakp* kp, size_t count, const mpnumber* c, mpnumber* m)
+{
+	register size_t nsize = kp->n.size;
+	register size_t size = (kp->p.size > kp->q.size) ? kp->p.size : kp->q.size;
+	register size_t lanes = _rsa_batch_lanes;
+	register size_t groups;
+	register size_t words;
+	unsigned int threads = 1;
+	long g;
 	int rc = 0;
-	register size_t size = n->size;
 
-	register mpw* temp;
+	mpmont pm, qm;
+	const mpmont* pmp = &kp->pm;
+	const mpmont* qmp = &kp->qm;
+
+	for (g = 0; g < (long) count; g++)
+		if (mpgex(c[g].size, c[g].data, nsize, kp->n.modl))
+			return -1;
+
+	for (g = 0; g < (long) count; g++)
+	{
+		mpnsize(m+g, nsize);
+		if (m[g].data == (mpw*) 0)
+			return -1;
+	}
+
+	if (count == 0)
+		return 0;
+
+	/* use the contexts kept on the key; only set up temporary ones, once
+	 * for the whole batch, when they are missing
+	 */
+	mpmontzero(&pm);
+	mpmontzero(&qm);
+
+	if (!mpmontmatch(pmp, &kp->p))
+	{
+		if (mpmontset(&pm, kp->p.size, kp->p.modl))
+			return -1;
+		pmp = &pm;
+	}
+
+	if (!mpmontmatch(qmp, &kp->q))
+	{
+		if (mpmontset(&qm, kp->q.size, kp->q.modl))
+		{
+			mpmontfree(&pm);
+			return -1;
+		}
+		qmp = &qm;
+	}
+
+	if (lanes > count)
+		lanes = count;
+
+	groups = (count + lanes - 1) / lanes;
+	words = (12*lanes+6)*size+2;
+
+	#ifdef _OPENMP
+	threads = _rsa_batch_threads ? _rsa_batch_threads : (unsigned int) omp_get_max_threads();
+	if (threads > groups)
+		threads = (unsigned int) groups;
+	#endif
+
+	#pragma omp parallel for num_threads(threads) if (threads > 1) schedule(dynamic, 1) reduction(|:rc)
+	for (g = 0; g < (long) groups; g++)
+	{
+		/* every thread draws from its own arena */
+		mpw* wksp = mpwkspget(words);
+		size_t first = g*lanes;
+		size_t n = (first+lanes > count) ? count-first : lanes;
+
+		if (wksp)
+		{
+			rsapricrt_lanes(kp, pmp, qmp, n, c+first, m+first, wksp);
+
+			mpwkspput(wksp);
+		}
+		else
+			rc |= -1;
+	}
+
+	mpmontfree(&qm);
+	mpmontfree(&pm);
+
+	return rc;
+}
+
+int rsavrfy_w(const mpbarrett* n, const mpnumber* e,
+              const mpnumber* m, const mpnumber* c, mpw* wksp)
+{
+	register size_t size = n->size;
 
 	if (mpgex(m->size, m->data, n->size, n->modl))
-		return rc;
+		return 0;
 
 	if (mpgex(c->size, c->data, n->size, n->modl))
-		return rc;
+		return 0;
+
+	mpbpowmod_w(n, m->size, m->data, e->size, e->data, wksp, wksp+size);
+
+	return mpeqx(size, wksp, c->size, c->data);
+}
+
+int rsavrfy(const mpbarrett* n, const mpnumber* e,
+            const mpnumber* m, const mpnumber* c)
+{
+	register int rc = 0;
+	register mpw* temp = mpwkspget(5*n->size+2);
 
-	temp = (mpw*) malloc((5*size+2)*sizeof(mpw));
 	if (temp)
 	{
-		mpbpowmod_w(n, m->size, m->data, e->size, e->data, temp, temp+size);
+		rc = rsavrfy_w(n, e, m, c, temp);
 
-		rc = mpeqx(size, temp, c->size, c->data);
-
-		free(temp);
+		mpwkspput(temp);
 	}
-
 	return rc;
 }
@@ -132,7 +132,7 @@ int rsakpMake(rsakp* kp, randomGeneratorContext* rgc, size_t bits)
 		mpnfree(&phi);
 		free(temp);
 
-		return 0;
+		return rsakpPrecompute(kp);
 	}
 	return -1;
 }
@@ -149,6 +149,8 @@ int rsakpInit(rsakp* kp)
 	mpnzero(&kp->dp);
 	mpnzero(&kp->dq);
 	mpnzero(&kp->qi);
+	mpmontzero(&kp->pm);
+	mpmontzero(&kp->qm);
 	*/
 
 	return 0;
@@ -171,6 +173,8 @@ int rsakpFree(rsakp* kp)
 	mpnfree(&kp->dq);
 	mpnwipe(&kp->qi);
 	mpnfree(&kp->qi);
+	mpmontfree(&kp->pm);
+	mpmontfree(&kp->qm);
 
 	return 0;
 }
@@ -183,10 +187,21 @@ int rsakpCopy(rsakp* dst, const rsakp* src)
 	mpbcopy(&dst->p, &src->p);
 	mpbcopy(&dst->q, &src->q);
 	mpncopy(&dst->dp, &src->dp);
-	mpncopy(&dst->dp, &src->dp);
+	mpncopy(&dst->dq, &src->dq);
 	mpncopy(&dst->qi, &src->qi);
 
-	return 0;
+	if (mpmontcopy(&dst->pm, &src->pm))
+		return -1;
+
+	return mpmontcopy(&dst->qm, &src->qm);
+}
+
+int rsakpPrecompute(rsakp* kp)
+{
+	if (mpmontset(&kp->pm, kp->p.size, kp->p.modl))
+		return -1;
+
+	return mpmontset(&kp->qm, kp->q.size, kp->q.modl);
 }
 
 /*!\}
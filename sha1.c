@@ -32,6 +32,18 @@
 #include "beecrypt/sha1.h"
 #include "beecrypt/endianness.h"
 
+#if !defined(ASM_SHA1PROCESS) && (ENABLE_SHANI || ENABLE_SSSE3)
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# define SHA1_DISPATCH 1
+#endif
+
+#if ENABLE_AVX2 || ENABLE_AVX512
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# define SHA1_LANES 1
+#endif
+
 /*!\addtogroup HASH_sha1_m
  * \{
  */
@@ -47,7 +59,10 @@ const hashFunction sha1 = {
 	20,
 	(hashFunctionReset) sha1Reset,
 	(hashFunctionUpdate) sha1Update,
-	(hashFunctionDigest) sha1Digest
+	(hashFunctionDigest) sha1Digest,
+	(hashFunctionBatch) sha1MultiDigest,
+	(hashFunctionCopy) sha1Copy,
+	(hashFunctionCheck) sha1Check
 };
 
 int sha1Reset(register sha1Param* p)
@@ -65,6 +80,21 @@ int sha1Reset(register sha1Param* p)
 	return 0;
 }
 
+int sha1Copy(register sha1Param* dst, const sha1Param* src)
+{
+	/* the rest of data is scratch space for the message schedule */
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int sha1Check(const sha1Param* sp)
+{
+	return (sp->offset < 64U) ? 0 : -1;
+}
+
 #define SUBROUND1(a, b, c, d, e, w, k) \
 	e = ROTL32(a, 5) + ((b&(c^d))^d) + e + w + k;	\
 	b = ROTR32(b, 2)
@@ -79,30 +109,11 @@ int sha1Reset(register sha1Param* p)
 	b = ROTR32(b, 2)
 
 #ifndef ASM_SHA1PROCESS
-void sha1Process(sha1Param* sp)
+/* the 80 rounds, on the expanded message in sp->data */
+static void sha1Rounds(sha1Param* sp)
 {
 	register uint32_t a, b, c, d, e;
 	register uint32_t *w;
-	register byte t;
-
-	#if WORDS_BIGENDIAN
-	w = sp->data + 16;
-	#else
-	w = sp->data;
-	t = 16;
-	while (t--)
-	{
-		register uint32_t temp = swapu32(*w);
-		*(w++) = temp;
-	}
-	#endif
-
-	t = 64;
-	while (t--)
-	{
-		register uint32_t temp = w[-3] ^ w[-8] ^ w[-14] ^ w[-16];
-		*(w++) = ROTL32(temp, 1);
-	}
 
 	w = sp->data;
 
@@ -198,6 +209,226 @@ void sha1Process(sha1Param* sp)
 	sp->h[3] += d;
 	sp->h[4] += e;
 }
+
+/* loads a block into sp->data as big-endian words, and expands it; the
+ * block may be sp->data itself
+ */
+static void sha1Expand(sha1Param* sp, const byte* block)
+{
+	register uint32_t *w;
+	register byte t;
+
+	w = sp->data;
+	#if WORDS_BIGENDIAN
+	if (block != (const byte*) w)
+		memcpy(w, block, 64);
+	w += 16;
+	#else
+	t = 16;
+	while (t--)
+	{
+		uint32_t load;
+		memcpy(&load, block, 4);
+		*(w++) = swapu32(load);
+		block += 4;
+	}
+	#endif
+
+	t = 64;
+	while (t--)
+	{
+		register uint32_t temp = w[-3] ^ w[-8] ^ w[-14] ^ w[-16];
+		*(w++) = ROTL32(temp, 1);
+	}
+}
+
+#if SHA1_DISPATCH
+static void sha1BlocksC(sha1Param* sp, const byte* blocks, size_t nblocks)
+#else
+void sha1ProcessBlocks(sha1Param* sp, const byte* blocks, size_t nblocks)
+#endif
+{
+	while (nblocks--)
+	{
+		sha1Expand(sp, blocks);
+		sha1Rounds(sp);
+		blocks += 64;
+	}
+}
+
+#if ENABLE_SSSE3 && SHA1_DISPATCH
+# define SSSE3_TARGET __attribute__((target("ssse3")))
+
+# define ROTL1_EPI32(x) _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31))
+
+/* computes w[i..i+3] into g0, which holds w[i-16..i-13]; g1, g2 and g3 hold
+ * the next three groups of four words. The last word depends on the first
+ * one, so it is computed without, and patched afterwards.
+ */
+# define SHA1_SSSE3_SCHEDULE(g0, g1, g2, g3, i) \
+	t = _mm_xor_si128(_mm_srli_si128(g3, 4), g2); \
+	t = _mm_xor_si128(t, _mm_alignr_epi8(g1, g0, 8)); \
+	t = _mm_xor_si128(t, g0); \
+	t = ROTL1_EPI32(t); \
+	u = _mm_slli_si128(t, 12); \
+	g0 = _mm_xor_si128(t, ROTL1_EPI32(u)); \
+	_mm_storeu_si128((__m128i*) (w+i), g0)
+
+/* expands the message with 128-bit vector instructions, four words at a
+ * time; the byte shuffles need SSSE3
+ */
+static SSSE3_TARGET void sha1BlocksSSSE3(sha1Param* sp, const byte* blocks, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	register uint32_t* w = sp->data;
+	__m128i g0, g1, g2, g3, t, u;
+	int i;
+
+	while (nblocks--)
+	{
+		g0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+ 0)), swap);
+		g1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+16)), swap);
+		g2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+32)), swap);
+		g3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+48)), swap);
+
+		_mm_storeu_si128((__m128i*) (w+ 0), g0);
+		_mm_storeu_si128((__m128i*) (w+ 4), g1);
+		_mm_storeu_si128((__m128i*) (w+ 8), g2);
+		_mm_storeu_si128((__m128i*) (w+12), g3);
+
+		for (i = 16; i < 80; i += 16)
+		{
+			SHA1_SSSE3_SCHEDULE(g0, g1, g2, g3, i   );
+			SHA1_SSSE3_SCHEDULE(g1, g2, g3, g0, i+ 4);
+			SHA1_SSSE3_SCHEDULE(g2, g3, g0, g1, i+ 8);
+			SHA1_SSSE3_SCHEDULE(g3, g0, g1, g2, i+12);
+		}
+
+		sha1Rounds(sp);
+		blocks += 64;
+	}
+}
+#endif
+
+#if ENABLE_SHANI && SHA1_DISPATCH
+# define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+/* computes the message words for the next four rounds into m0, which holds
+ * those of sixteen rounds earlier; m1, m2 and m3 hold the ones in between
+ */
+# define SHA1_SHANI_SCHEDULE(m0, m1, m2, m3) \
+	m0 = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(m0, m1), m2), m3)
+
+/* four rounds; e0 holds the state from before the previous four rounds,
+ * from which the instructions derive e
+ */
+# define SHA1_SHANI_ROUNDS(m, f) \
+	e1 = abcd; \
+	abcd = _mm_sha1rnds4_epu32(abcd, _mm_sha1nexte_epu32(e0, m), f); \
+	e0 = e1
+
+static SHANI_TARGET void sha1BlocksSHANI(sha1Param* sp, const byte* blocks, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i abcd, abcdsave, e0, e1, esave, m0, m1, m2, m3;
+
+	/* the instructions want a in the highest lane, and e by itself */
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) sp->h), 0x1b);
+	e0 = _mm_set_epi32((int) sp->h[4], 0, 0, 0);
+
+	while (nblocks--)
+	{
+		abcdsave = abcd;
+		esave = e0;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+ 0)), swap);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+16)), swap);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+32)), swap);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+48)), swap);
+
+		/* rounds 0-3 add e directly */
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e0, m0), 0);
+		e0 = e1;
+
+		SHA1_SHANI_ROUNDS(m1, 0);
+		SHA1_SHANI_ROUNDS(m2, 0);
+		SHA1_SHANI_ROUNDS(m3, 0);
+		SHA1_SHANI_SCHEDULE(m0, m1, m2, m3); SHA1_SHANI_ROUNDS(m0, 0);
+
+		SHA1_SHANI_SCHEDULE(m1, m2, m3, m0); SHA1_SHANI_ROUNDS(m1, 1);
+		SHA1_SHANI_SCHEDULE(m2, m3, m0, m1); SHA1_SHANI_ROUNDS(m2, 1);
+		SHA1_SHANI_SCHEDULE(m3, m0, m1, m2); SHA1_SHANI_ROUNDS(m3, 1);
+		SHA1_SHANI_SCHEDULE(m0, m1, m2, m3); SHA1_SHANI_ROUNDS(m0, 1);
+		SHA1_SHANI_SCHEDULE(m1, m2, m3, m0); SHA1_SHANI_ROUNDS(m1, 1);
+
+		SHA1_SHANI_SCHEDULE(m2, m3, m0, m1); SHA1_SHANI_ROUNDS(m2, 2);
+		SHA1_SHANI_SCHEDULE(m3, m0, m1, m2); SHA1_SHANI_ROUNDS(m3, 2);
+		SHA1_SHANI_SCHEDULE(m0, m1, m2, m3); SHA1_SHANI_ROUNDS(m0, 2);
+		SHA1_SHANI_SCHEDULE(m1, m2, m3, m0); SHA1_SHANI_ROUNDS(m1, 2);
+		SHA1_SHANI_SCHEDULE(m2, m3, m0, m1); SHA1_SHANI_ROUNDS(m2, 2);
+
+		SHA1_SHANI_SCHEDULE(m3, m0, m1, m2); SHA1_SHANI_ROUNDS(m3, 3);
+		SHA1_SHANI_SCHEDULE(m0, m1, m2, m3); SHA1_SHANI_ROUNDS(m0, 3);
+		SHA1_SHANI_SCHEDULE(m1, m2, m3, m0); SHA1_SHANI_ROUNDS(m1, 3);
+		SHA1_SHANI_SCHEDULE(m2, m3, m0, m1); SHA1_SHANI_ROUNDS(m2, 3);
+		SHA1_SHANI_SCHEDULE(m3, m0, m1, m2); SHA1_SHANI_ROUNDS(m3, 3);
+
+		e0 = _mm_sha1nexte_epu32(e0, esave);
+		abcd = _mm_add_epi32(abcd, abcdsave);
+
+		blocks += 64;
+	}
+
+	_mm_storeu_si128((__m128i*) sp->h, _mm_shuffle_epi32(abcd, 0x1b));
+	sp->h[4] = (uint32_t) _mm_extract_epi32(e0, 3);
+}
+#endif
+
+#if SHA1_DISPATCH
+typedef void (*sha1BlocksFunction)(sha1Param*, const byte*, size_t);
+
+/* the implementation used by sha1ProcessBlocks; chosen on the first call */
+static sha1BlocksFunction _sha1blocks = (sha1BlocksFunction) 0;
+
+static sha1BlocksFunction sha1Select(void)
+{
+	register uint32_t features = cpuFeatures();
+
+	#if ENABLE_SHANI
+	if ((features & (CPU_FEATURE_SHA | CPU_FEATURE_SSE41)) == (CPU_FEATURE_SHA | CPU_FEATURE_SSE41))
+		return sha1BlocksSHANI;
+	#endif
+	#if ENABLE_SSSE3
+	if (features & CPU_FEATURE_SSSE3)
+		return sha1BlocksSSSE3;
+	#endif
+	return sha1BlocksC;
+}
+
+void sha1ProcessBlocks(sha1Param* sp, const byte* blocks, size_t nblocks)
+{
+	if (_sha1blocks == (sha1BlocksFunction) 0)
+		_sha1blocks = sha1Select();
+
+	_sha1blocks(sp, blocks, nblocks);
+}
+#endif
+
+void sha1Process(sha1Param* sp)
+{
+	sha1ProcessBlocks(sp, (const byte*) sp->data, 1);
+}
+#else
+void sha1ProcessBlocks(sha1Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(sp->data, blocks, 64);
+		sha1Process(sp);
+		blocks += 64;
+	}
+}
 #endif
 
 int sha1Update(sha1Param* sp, const byte* data, size_t size)
@@ -218,7 +449,8 @@ int sha1Update(sha1Param* sp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (sp->offset > 0)
 	{
 		proclength = ((sp->offset + size) > 64U) ? (64U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
@@ -232,6 +464,23 @@ int sha1Update(sha1Param* sp, const byte* data, size_t size)
 			sp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 64U)
+	{
+		register size_t nblocks = size >> 6;
+
+		sha1ProcessBlocks(sp, data, nblocks);
+		data += nblocks << 6;
+		size -= nblocks << 6;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(sp->data, data, size);
+		sp->offset = (uint32_t) size;
+	}
 	return 0;
 }
 
@@ -320,5 +569,307 @@ int sha1Digest(sha1Param* sp, byte* data)
 	return 0;
 }
 
+#if SHA1_LANES
+# define SHA1_MAXLANES	16
+
+/* the message words are gathered from each lane's block; idle lanes point
+ * to a block whose result is ignored
+ */
+typedef void (*sha1LanesFunction)(uint32_t*, const byte**);
+
+# if ENABLE_AVX2
+#  define AVX2_TARGET __attribute__((target("avx2")))
+
+#  define SHA1_AVX2_ROTL(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32-(n)))
+#  define SHA1_AVX2_F1(b, c, d) _mm256_xor_si256(_mm256_and_si256(b, _mm256_xor_si256(c, d)), d)
+#  define SHA1_AVX2_F2(b, c, d) _mm256_xor_si256(_mm256_xor_si256(b, c), d)
+#  define SHA1_AVX2_F3(b, c, d) _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(b, c), d), _mm256_and_si256(b, c))
+
+#  define SHA1_AVX2_ROUND(a, b, c, d, e, f, i) \
+	if ((i) >= 16) \
+	{ \
+		t = _mm256_xor_si256(_mm256_xor_si256(w[((i)-3)&15], w[((i)-8)&15]), _mm256_xor_si256(w[((i)-14)&15], w[(i)&15])); \
+		w[(i)&15] = SHA1_AVX2_ROTL(t, 1); \
+	} \
+	e = _mm256_add_epi32(_mm256_add_epi32(SHA1_AVX2_ROTL(a, 5), f(b, c, d)), _mm256_add_epi32(_mm256_add_epi32(e, w[(i)&15]), kv)); \
+	b = SHA1_AVX2_ROTL(b, 30)
+
+#  define SHA1_AVX2_ROUNDS(f, n) \
+	for (kv = _mm256_set1_epi32((int) k[((n)-1)/20]); i < (n); i += 5) \
+	{ \
+		SHA1_AVX2_ROUND(a, b, c, d, e, f, i  ); \
+		SHA1_AVX2_ROUND(e, a, b, c, d, f, i+1); \
+		SHA1_AVX2_ROUND(d, e, a, b, c, f, i+2); \
+		SHA1_AVX2_ROUND(c, d, e, a, b, f, i+3); \
+		SHA1_AVX2_ROUND(b, c, d, e, a, f, i+4); \
+	}
+
+/* eight lanes */
+static AVX2_TARGET void sha1LanesAVX2(uint32_t* st, const byte** ptr)
+{
+	const __m256i swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	const __m256i four = _mm256_set1_epi64x(4);
+	__m256i a, b, c, d, e, t, kv, lo, hi;
+	__m256i w[16];
+	int i;
+
+	lo = _mm256_set_epi64x((long long) (size_t) ptr[3], (long long) (size_t) ptr[2], (long long) (size_t) ptr[1], (long long) (size_t) ptr[0]);
+	hi = _mm256_set_epi64x((long long) (size_t) ptr[7], (long long) (size_t) ptr[6], (long long) (size_t) ptr[5], (long long) (size_t) ptr[4]);
+
+	for (i = 0; i < 16; i++)
+	{
+		w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_i64gather_epi32((const int*) 0, lo, 1)), _mm256_i64gather_epi32((const int*) 0, hi, 1), 1), swap);
+		lo = _mm256_add_epi64(lo, four);
+		hi = _mm256_add_epi64(hi, four);
+	}
+
+	a = _mm256_loadu_si256((const __m256i*) (st+ 0));
+	b = _mm256_loadu_si256((const __m256i*) (st+ 8));
+	c = _mm256_loadu_si256((const __m256i*) (st+16));
+	d = _mm256_loadu_si256((const __m256i*) (st+24));
+	e = _mm256_loadu_si256((const __m256i*) (st+32));
+
+	i = 0;
+	SHA1_AVX2_ROUNDS(SHA1_AVX2_F1, 20);
+	SHA1_AVX2_ROUNDS(SHA1_AVX2_F2, 40);
+	SHA1_AVX2_ROUNDS(SHA1_AVX2_F3, 60);
+	SHA1_AVX2_ROUNDS(SHA1_AVX2_F2, 80);
+
+	_mm256_storeu_si256((__m256i*) (st+ 0), _mm256_add_epi32(a, _mm256_loadu_si256((const __m256i*) (st+ 0))));
+	_mm256_storeu_si256((__m256i*) (st+ 8), _mm256_add_epi32(b, _mm256_loadu_si256((const __m256i*) (st+ 8))));
+	_mm256_storeu_si256((__m256i*) (st+16), _mm256_add_epi32(c, _mm256_loadu_si256((const __m256i*) (st+16))));
+	_mm256_storeu_si256((__m256i*) (st+24), _mm256_add_epi32(d, _mm256_loadu_si256((const __m256i*) (st+24))));
+	_mm256_storeu_si256((__m256i*) (st+32), _mm256_add_epi32(e, _mm256_loadu_si256((const __m256i*) (st+32))));
+}
+# endif
+
+# if ENABLE_AVX512
+#  define AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+
+/* the ternary logic immediates 0xca, 0x96 and 0xe8 are CH, PARITY and MAJ */
+#  define SHA1_AVX512_ROUND(a, b, c, d, e, f, i) \
+	if ((i) >= 16) \
+		w[(i)&15] = _mm512_rol_epi32(_mm512_xor_si512(_mm512_ternarylogic_epi32(w[((i)-3)&15], w[((i)-8)&15], w[((i)-14)&15], 0x96), w[(i)&15]), 1); \
+	e = _mm512_add_epi32(_mm512_add_epi32(_mm512_rol_epi32(a, 5), _mm512_ternarylogic_epi32(b, c, d, f)), _mm512_add_epi32(_mm512_add_epi32(e, w[(i)&15]), kv)); \
+	b = _mm512_rol_epi32(b, 30)
+
+#  define SHA1_AVX512_ROUNDS(f, n) \
+	for (kv = _mm512_set1_epi32((int) k[((n)-1)/20]); i < (n); i += 5) \
+	{ \
+		SHA1_AVX512_ROUND(a, b, c, d, e, f, i  ); \
+		SHA1_AVX512_ROUND(e, a, b, c, d, f, i+1); \
+		SHA1_AVX512_ROUND(d, e, a, b, c, f, i+2); \
+		SHA1_AVX512_ROUND(c, d, e, a, b, f, i+3); \
+		SHA1_AVX512_ROUND(b, c, d, e, a, f, i+4); \
+	}
+
+/* sixteen lanes */
+static AVX512_TARGET void sha1LanesAVX512(uint32_t* st, const byte** ptr)
+{
+	const __m512i swap = _mm512_set_epi32(
+			0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203, 0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203,
+			0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203, 0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203);
+	const __m512i four = _mm512_set1_epi64(4);
+	__m512i a, b, c, d, e, kv, lo, hi;
+	__m512i w[16];
+	int i;
+
+	lo = _mm512_set_epi64((long long) (size_t) ptr[ 7], (long long) (size_t) ptr[ 6], (long long) (size_t) ptr[ 5], (long long) (size_t) ptr[ 4],
+	                      (long long) (size_t) ptr[ 3], (long long) (size_t) ptr[ 2], (long long) (size_t) ptr[ 1], (long long) (size_t) ptr[ 0]);
+	hi = _mm512_set_epi64((long long) (size_t) ptr[15], (long long) (size_t) ptr[14], (long long) (size_t) ptr[13], (long long) (size_t) ptr[12],
+	                      (long long) (size_t) ptr[11], (long long) (size_t) ptr[10], (long long) (size_t) ptr[ 9], (long long) (size_t) ptr[ 8]);
+
+	for (i = 0; i < 16; i++)
+	{
+		w[i] = _mm512_shuffle_epi8(_mm512_inserti64x4(_mm512_castsi256_si512(_mm512_i64gather_epi32(lo, (const void*) 0, 1)), _mm512_i64gather_epi32(hi, (const void*) 0, 1), 1), swap);
+		lo = _mm512_add_epi64(lo, four);
+		hi = _mm512_add_epi64(hi, four);
+	}
+
+	a = _mm512_loadu_si512((const void*) (st+ 0));
+	b = _mm512_loadu_si512((const void*) (st+16));
+	c = _mm512_loadu_si512((const void*) (st+32));
+	d = _mm512_loadu_si512((const void*) (st+48));
+	e = _mm512_loadu_si512((const void*) (st+64));
+
+	i = 0;
+	SHA1_AVX512_ROUNDS(0xca, 20);
+	SHA1_AVX512_ROUNDS(0x96, 40);
+	SHA1_AVX512_ROUNDS(0xe8, 60);
+	SHA1_AVX512_ROUNDS(0x96, 80);
+
+	_mm512_storeu_si512((void*) (st+ 0), _mm512_add_epi32(a, _mm512_loadu_si512((const void*) (st+ 0))));
+	_mm512_storeu_si512((void*) (st+16), _mm512_add_epi32(b, _mm512_loadu_si512((const void*) (st+16))));
+	_mm512_storeu_si512((void*) (st+32), _mm512_add_epi32(c, _mm512_loadu_si512((const void*) (st+32))));
+	_mm512_storeu_si512((void*) (st+48), _mm512_add_epi32(d, _mm512_loadu_si512((const void*) (st+48))));
+	_mm512_storeu_si512((void*) (st+64), _mm512_add_epi32(e, _mm512_loadu_si512((const void*) (st+64))));
+}
+# endif
+
+typedef struct
+{
+	const byte*	next;		/* the next block */
+	size_t		blocks;		/* blocks left before the tail, or in it */
+	size_t		msg;		/* the message's index, or count if idle */
+	int			tail;
+	byte		pad[128];	/* the padded tail of the message */
+} sha1Lane;
+
+static void sha1LaneTail(sha1Lane* lane, const byte* msg, size_t len)
+{
+	register size_t rem = len & 63;
+	register uint64_t bits = ((uint64_t) len) << 3;
+	register byte* end;
+
+	memcpy(lane->pad, msg + (len - rem), rem);
+	lane->pad[rem] = 0x80;
+	lane->blocks = (rem < 56) ? 1 : 2;
+
+	end = lane->pad + (lane->blocks << 6) - 8;
+	memset(lane->pad + rem + 1, 0, end - (lane->pad + rem + 1));
+
+	end[0] = (byte)(bits >> 56);
+	end[1] = (byte)(bits >> 48);
+	end[2] = (byte)(bits >> 40);
+	end[3] = (byte)(bits >> 32);
+	end[4] = (byte)(bits >> 24);
+	end[5] = (byte)(bits >> 16);
+	end[6] = (byte)(bits >>  8);
+	end[7] = (byte)(bits      );
+
+	lane->next = lane->pad;
+	lane->tail = 1;
+}
+
+/* hands each free lane the next message, until all of them are done */
+static void sha1Lanes(sha1LanesFunction process, int lanes, size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+{
+	uint32_t st[5*SHA1_MAXLANES];
+	const byte* ptr[SHA1_MAXLANES];
+	sha1Lane lane[SHA1_MAXLANES];
+	size_t next = 0, busy = 0;
+	int i, l;
+
+	for (l = 0; l < lanes; l++)
+		lane[l].msg = count;
+
+	while (1)
+	{
+		for (l = 0; l < lanes; l++)
+		{
+			if (lane[l].msg == count && next < count)
+			{
+				for (i = 0; i < 5; i++)
+					st[i*lanes+l] = hinit[i];
+
+				lane[l].msg = next;
+				lane[l].blocks = lens[next] >> 6;
+				lane[l].next = msgs[next];
+				lane[l].tail = 0;
+
+				if (lane[l].blocks == 0)
+					sha1LaneTail(lane+l, msgs[next], lens[next]);
+
+				next++;
+				busy++;
+			}
+
+			ptr[l] = (lane[l].msg < count) ? lane[l].next : lane[l].pad;
+		}
+
+		if (busy == 0)
+			break;
+
+		process(st, ptr);
+
+		for (l = 0; l < lanes; l++)
+		{
+			register sha1Lane* ln = lane+l;
+
+			if (ln->msg == count)
+				continue;
+
+			ln->next += 64;
+			if (--ln->blocks)
+				continue;
+
+			if (!ln->tail)
+				sha1LaneTail(ln, msgs[ln->msg], lens[ln->msg]);
+			else
+			{
+				register byte* data = digests[ln->msg];
+
+				for (i = 0; i < 5; i++)
+				{
+					register uint32_t temp = st[i*lanes+l];
+
+					data[0] = (byte)(temp >> 24);
+					data[1] = (byte)(temp >> 16);
+					data[2] = (byte)(temp >>  8);
+					data[3] = (byte)(temp      );
+					data += 4;
+				}
+
+				ln->msg = count;
+				busy--;
+			}
+		}
+	}
+
+	memset(lane, 0, sizeof(lane));
+	memset(st, 0, sizeof(st));
+}
+#endif
+
+int sha1MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+{
+	sha1Param param;
+	size_t i;
+
+	if (count == 0)
+		return 0;
+
+	if (msgs == (const byte* const*) 0 || lens == (const size_t*) 0 || digests == (byte* const*) 0)
+		return -1;
+
+	#if SHA1_LANES
+	if (count > 1)
+	{
+		register uint32_t features = cpuFeatures();
+
+		# if ENABLE_AVX512
+		if ((features & (CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW)) == (CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW))
+		{
+			sha1Lanes(sha1LanesAVX512, 16, count, msgs, lens, digests);
+			return 0;
+		}
+		# endif
+		# if ENABLE_AVX2
+		/* eight lanes don't beat the SHA instructions on a single message */
+		# if ENABLE_SHANI
+		if ((features & CPU_FEATURE_AVX2) && (features & (CPU_FEATURE_SHA | CPU_FEATURE_SSE41)) != (CPU_FEATURE_SHA | CPU_FEATURE_SSE41))
+		# else
+		if (features & CPU_FEATURE_AVX2)
+		# endif
+		{
+			sha1Lanes(sha1LanesAVX2, 8, count, msgs, lens, digests);
+			return 0;
+		}
+		# endif
+	}
+	#endif
+
+	/* one message at a time */
+	sha1Reset(&param);
+
+	for (i = 0; i < count; i++)
+	{
+		sha1Update(&param, msgs[i], lens[i]);
+		sha1Digest(&param, digests[i]);
+	}
+
+	return 0;
+}
+
 /*!\}
  */
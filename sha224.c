@@ -30,7 +30,7 @@
 #endif
 
 #include "beecrypt/sha224.h"
-#include "beecrypt/sha2k32.h"
+#include "beecrypt/sha256.h"
 #include "beecrypt/endianness.h"
 
 /*!\addtogroup HASH_sha224_m
@@ -48,7 +48,10 @@ const hashFunction sha224 = {
 	24,
 	(hashFunctionReset) sha224Reset,
 	(hashFunctionUpdate) sha224Update,
-	(hashFunctionDigest) sha224Digest
+	(hashFunctionDigest) sha224Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) sha224Copy,
+	(hashFunctionCheck) sha224Check
 };
 
 int sha224Reset(register sha224Param* sp)
@@ -66,128 +69,43 @@ int sha224Reset(register sha224Param* sp)
 	return 0;
 }
 
-#define R(x,s)  ((x) >> (s))
-#define S(x,s) ROTR32(x, s)
-
-#define CH(x,y,z) ((x&(y^z))^z)
-#define MAJ(x,y,z) (((x|y)&z)|(x&y))
-#define SIG0(x)	(S(x,2) ^ S(x,13) ^ S(x,22))
-#define SIG1(x)	(S(x,6) ^ S(x,11) ^ S(x,25))
-#define sig0(x) (S(x,7) ^ S(x,18) ^ R(x,3))
-#define sig1(x) (S(x,17) ^ S(x,19) ^ R(x,10))
+int sha224Copy(register sha224Param* dst, const sha224Param* src)
+{
+	/* the rest of data is scratch space for the message schedule */
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
 
-#define ROUND(a,b,c,d,e,f,g,h,w,k)	\
-	temp = h + SIG1(e) + CH(e,f,g) + k + w;	\
-	h = temp + SIG0(a) + MAJ(a,b,c);	\
-	d += temp
+int sha224Check(const sha224Param* sp)
+{
+	return (sp->offset < 64U) ? 0 : -1;
+}
 
 #ifndef ASM_SHA224PROCESS
+/* SHA-224 uses the SHA-256 compression function; the parameter blocks only
+ * differ in name, so this also gets its processor-specific variants
+ */
 void sha224Process(register sha224Param* sp)
 {
-	register uint32_t a, b, c, d, e, f, g, h, temp;
-	register       uint32_t *w;
-	register const uint32_t *k;
-	register byte t;
-	
-	#if WORDS_BIGENDIAN
-	w = sp->data + 16;
-	#else
-	w = sp->data;
-	t = 16;
-	while (t--)
-	{
-		temp = swapu32(*w);
-		*(w++) = temp;
-	}
-	#endif
+	sha256Process((sha256Param*) sp);
+}
 
-	t = 48;
-	while (t--)
+void sha224ProcessBlocks(register sha224Param* sp, const byte* blocks, size_t nblocks)
+{
+	sha256ProcessBlocks((sha256Param*) sp, blocks, nblocks);
+}
+#else
+void sha224ProcessBlocks(register sha224Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
 	{
-		temp = sig1(w[-2]) + w[-7] + sig0(w[-15]) + w[-16];
-		*(w++) = temp;
+		memcpy(sp->data, blocks, 64);
+		sha224Process(sp);
+		blocks += 64;
 	}
-
-	w = sp->data;
-
-	a = sp->h[0]; b = sp->h[1]; c = sp->h[2]; d = sp->h[3];
-	e = sp->h[4]; f = sp->h[5]; g = sp->h[6]; h = sp->h[7];
-
-	k = SHA2_32BIT_K;
-
-	ROUND(a,b,c,d,e,f,g,h,w[ 0],k[ 0]);
-	ROUND(h,a,b,c,d,e,f,g,w[ 1],k[ 1]);
-	ROUND(g,h,a,b,c,d,e,f,w[ 2],k[ 2]);
-	ROUND(f,g,h,a,b,c,d,e,w[ 3],k[ 3]);
-	ROUND(e,f,g,h,a,b,c,d,w[ 4],k[ 4]);
-	ROUND(d,e,f,g,h,a,b,c,w[ 5],k[ 5]);
-	ROUND(c,d,e,f,g,h,a,b,w[ 6],k[ 6]);
-	ROUND(b,c,d,e,f,g,h,a,w[ 7],k[ 7]);
-	ROUND(a,b,c,d,e,f,g,h,w[ 8],k[ 8]);
-	ROUND(h,a,b,c,d,e,f,g,w[ 9],k[ 9]);
-	ROUND(g,h,a,b,c,d,e,f,w[10],k[10]);
-	ROUND(f,g,h,a,b,c,d,e,w[11],k[11]);
-	ROUND(e,f,g,h,a,b,c,d,w[12],k[12]);
-	ROUND(d,e,f,g,h,a,b,c,w[13],k[13]);
-	ROUND(c,d,e,f,g,h,a,b,w[14],k[14]);
-	ROUND(b,c,d,e,f,g,h,a,w[15],k[15]);
-	ROUND(a,b,c,d,e,f,g,h,w[16],k[16]);
-	ROUND(h,a,b,c,d,e,f,g,w[17],k[17]);
-	ROUND(g,h,a,b,c,d,e,f,w[18],k[18]);
-	ROUND(f,g,h,a,b,c,d,e,w[19],k[19]);
-	ROUND(e,f,g,h,a,b,c,d,w[20],k[20]);
-	ROUND(d,e,f,g,h,a,b,c,w[21],k[21]);
-	ROUND(c,d,e,f,g,h,a,b,w[22],k[22]);
-	ROUND(b,c,d,e,f,g,h,a,w[23],k[23]);
-	ROUND(a,b,c,d,e,f,g,h,w[24],k[24]);
-	ROUND(h,a,b,c,d,e,f,g,w[25],k[25]);
-	ROUND(g,h,a,b,c,d,e,f,w[26],k[26]);
-	ROUND(f,g,h,a,b,c,d,e,w[27],k[27]);
-	ROUND(e,f,g,h,a,b,c,d,w[28],k[28]);
-	ROUND(d,e,f,g,h,a,b,c,w[29],k[29]);
-	ROUND(c,d,e,f,g,h,a,b,w[30],k[30]);
-	ROUND(b,c,d,e,f,g,h,a,w[31],k[31]);
-	ROUND(a,b,c,d,e,f,g,h,w[32],k[32]);
-	ROUND(h,a,b,c,d,e,f,g,w[33],k[33]);
-	ROUND(g,h,a,b,c,d,e,f,w[34],k[34]);
-	ROUND(f,g,h,a,b,c,d,e,w[35],k[35]);
-	ROUND(e,f,g,h,a,b,c,d,w[36],k[36]);
-	ROUND(d,e,f,g,h,a,b,c,w[37],k[37]);
-	ROUND(c,d,e,f,g,h,a,b,w[38],k[38]);
-	ROUND(b,c,d,e,f,g,h,a,w[39],k[39]);
-	ROUND(a,b,c,d,e,f,g,h,w[40],k[40]);
-	ROUND(h,a,b,c,d,e,f,g,w[41],k[41]);
-	ROUND(g,h,a,b,c,d,e,f,w[42],k[42]);
-	ROUND(f,g,h,a,b,c,d,e,w[43],k[43]);
-	ROUND(e,f,g,h,a,b,c,d,w[44],k[44]);
-	ROUND(d,e,f,g,h,a,b,c,w[45],k[45]);
-	ROUND(c,d,e,f,g,h,a,b,w[46],k[46]);
-	ROUND(b,c,d,e,f,g,h,a,w[47],k[47]);
-	ROUND(a,b,c,d,e,f,g,h,w[48],k[48]);
-	ROUND(h,a,b,c,d,e,f,g,w[49],k[49]);
-	ROUND(g,h,a,b,c,d,e,f,w[50],k[50]);
-	ROUND(f,g,h,a,b,c,d,e,w[51],k[51]);
-	ROUND(e,f,g,h,a,b,c,d,w[52],k[52]);
-	ROUND(d,e,f,g,h,a,b,c,w[53],k[53]);
-	ROUND(c,d,e,f,g,h,a,b,w[54],k[54]);
-	ROUND(b,c,d,e,f,g,h,a,w[55],k[55]);
-	ROUND(a,b,c,d,e,f,g,h,w[56],k[56]);
-	ROUND(h,a,b,c,d,e,f,g,w[57],k[57]);
-	ROUND(g,h,a,b,c,d,e,f,w[58],k[58]);
-	ROUND(f,g,h,a,b,c,d,e,w[59],k[59]);
-	ROUND(e,f,g,h,a,b,c,d,w[60],k[60]);
-	ROUND(d,e,f,g,h,a,b,c,w[61],k[61]);
-	ROUND(c,d,e,f,g,h,a,b,w[62],k[62]);
-	ROUND(b,c,d,e,f,g,h,a,w[63],k[63]);
-
-	sp->h[0] += a;
-	sp->h[1] += b;
-	sp->h[2] += c;
-	sp->h[3] += d;
-	sp->h[4] += e;
-	sp->h[5] += f;
-	sp->h[6] += g;
-	sp->h[7] += h;
 }
 #endif
 
@@ -209,7 +127,8 @@ int sha224Update(register sha224Param* sp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (sp->offset > 0)
 	{
 		proclength = ((sp->offset + size) > 64U) ? (64U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
@@ -223,6 +142,23 @@ int sha224Update(register sha224Param* sp, const byte* data, size_t size)
 			sp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 64U)
+	{
+		register size_t nblocks = size >> 6;
+
+		sha224ProcessBlocks(sp, data, nblocks);
+		data += nblocks << 6;
+		size -= nblocks << 6;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(sp->data, data, size);
+		sp->offset = (uint32_t) size;
+	}
 	return 0;
 }
 
@@ -33,6 +33,18 @@
 #include "beecrypt/sha2k32.h"
 #include "beecrypt/endianness.h"
 
+#if !defined(ASM_SHA256PROCESS) && ENABLE_SHANI
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# define SHA256_DISPATCH 1
+#endif
+
+#if ENABLE_AVX2 || ENABLE_AVX512
+# include <immintrin.h>
+# include "beecrypt/cpu.h"
+# define SHA256_LANES 1
+#endif
+
 /*!\addtogroup HASH_sha256_m
  * \{
  */
@@ -48,7 +60,10 @@ const hashFunction sha256 = {
 	32,
 	(hashFunctionReset) sha256Reset,
 	(hashFunctionUpdate) sha256Update,
-	(hashFunctionDigest) sha256Digest
+	(hashFunctionDigest) sha256Digest,
+	(hashFunctionBatch) sha256MultiDigest,
+	(hashFunctionCopy) sha256Copy,
+	(hashFunctionCheck) sha256Check
 };
 
 int sha256Reset(register sha256Param* sp)
@@ -66,6 +81,21 @@ int sha256Reset(register sha256Param* sp)
 	return 0;
 }
 
+int sha256Copy(register sha256Param* dst, const sha256Param* src)
+{
+	/* the rest of data is scratch space for the message schedule */
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 64);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int sha256Check(const sha256Param* sp)
+{
+	return (sp->offset < 64U) ? 0 : -1;
+}
+
 #define R(x,s)  ((x) >> (s))
 #define S(x,s) ROTR32(x, s)
 
@@ -82,22 +112,27 @@ int sha256Reset(register sha256Param* sp)
 	d += temp
 
 #ifndef ASM_SHA256PROCESS
-void sha256Process(register sha256Param* sp)
+/* processes one block; it may be sp->data itself */
+static void sha256Block(register sha256Param* sp, const byte* block)
 {
 	register uint32_t a, b, c, d, e, f, g, h, temp;
 	register       uint32_t *w;
 	register const uint32_t *k;
 	register byte t;
 	
+	w = sp->data;
 	#if WORDS_BIGENDIAN
-	w = sp->data + 16;
+	if (block != (const byte*) w)
+		memcpy(w, block, 64);
+	w += 16;
 	#else
-	w = sp->data;
 	t = 16;
 	while (t--)
 	{
-		temp = swapu32(*w);
-		*(w++) = temp;
+		uint32_t load;
+		memcpy(&load, block, 4);
+		*(w++) = swapu32(load);
+		block += 4;
 	}
 	#endif
 
@@ -189,6 +224,127 @@ void sha256Process(register sha256Param* sp)
 	sp->h[6] += g;
 	sp->h[7] += h;
 }
+
+#if SHA256_DISPATCH
+static void sha256BlocksC(register sha256Param* sp, const byte* blocks, size_t nblocks)
+#else
+void sha256ProcessBlocks(register sha256Param* sp, const byte* blocks, size_t nblocks)
+#endif
+{
+	while (nblocks--)
+	{
+		sha256Block(sp, blocks);
+		blocks += 64;
+	}
+}
+
+#if SHA256_DISPATCH
+# define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+/* computes the message words for the next four rounds into m0, which holds
+ * those of sixteen rounds earlier; m1, m2 and m3 hold the ones in between
+ */
+# define SHA256_SHANI_SCHEDULE(m0, m1, m2, m3) \
+	m0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), _mm_alignr_epi8(m3, m2, 4)), m3)
+
+/* four rounds, two per instruction */
+# define SHA256_SHANI_ROUNDS(m, i) \
+	t = _mm_add_epi32(m, _mm_loadu_si128((const __m128i*) (SHA2_32BIT_K+4*(i)))); \
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t); \
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e))
+
+static SHANI_TARGET void sha256BlocksSHANI(register sha256Param* sp, const byte* blocks, size_t nblocks)
+{
+	const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	__m128i abef, cdgh, abefsave, cdghsave, m0, m1, m2, m3, t;
+
+	/* the instructions want the state as (a, b, e, f) and (c, d, g, h) */
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (sp->h+0)), 0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (sp->h+4)), 0x1b);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	while (nblocks--)
+	{
+		abefsave = abef;
+		cdghsave = cdgh;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+ 0)), swap);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+16)), swap);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+32)), swap);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks+48)), swap);
+
+		SHA256_SHANI_ROUNDS(m0,  0);
+		SHA256_SHANI_ROUNDS(m1,  1);
+		SHA256_SHANI_ROUNDS(m2,  2);
+		SHA256_SHANI_ROUNDS(m3,  3);
+		SHA256_SHANI_SCHEDULE(m0, m1, m2, m3); SHA256_SHANI_ROUNDS(m0,  4);
+		SHA256_SHANI_SCHEDULE(m1, m2, m3, m0); SHA256_SHANI_ROUNDS(m1,  5);
+		SHA256_SHANI_SCHEDULE(m2, m3, m0, m1); SHA256_SHANI_ROUNDS(m2,  6);
+		SHA256_SHANI_SCHEDULE(m3, m0, m1, m2); SHA256_SHANI_ROUNDS(m3,  7);
+		SHA256_SHANI_SCHEDULE(m0, m1, m2, m3); SHA256_SHANI_ROUNDS(m0,  8);
+		SHA256_SHANI_SCHEDULE(m1, m2, m3, m0); SHA256_SHANI_ROUNDS(m1,  9);
+		SHA256_SHANI_SCHEDULE(m2, m3, m0, m1); SHA256_SHANI_ROUNDS(m2, 10);
+		SHA256_SHANI_SCHEDULE(m3, m0, m1, m2); SHA256_SHANI_ROUNDS(m3, 11);
+		SHA256_SHANI_SCHEDULE(m0, m1, m2, m3); SHA256_SHANI_ROUNDS(m0, 12);
+		SHA256_SHANI_SCHEDULE(m1, m2, m3, m0); SHA256_SHANI_ROUNDS(m1, 13);
+		SHA256_SHANI_SCHEDULE(m2, m3, m0, m1); SHA256_SHANI_ROUNDS(m2, 14);
+		SHA256_SHANI_SCHEDULE(m3, m0, m1, m2); SHA256_SHANI_ROUNDS(m3, 15);
+
+		abef = _mm_add_epi32(abef, abefsave);
+		cdgh = _mm_add_epi32(cdgh, cdghsave);
+
+		blocks += 64;
+	}
+
+	/* back to (a, b, c, d) and (e, f, g, h) */
+	t = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i*) (sp->h+0), _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i*) (sp->h+4), _mm_alignr_epi8(cdgh, t, 8));
+}
+#endif
+
+#if SHA256_DISPATCH
+typedef void (*sha256BlocksFunction)(sha256Param*, const byte*, size_t);
+
+/* the implementation used by sha256ProcessBlocks; chosen on the first call */
+static sha256BlocksFunction _sha256blocks = (sha256BlocksFunction) 0;
+
+static sha256BlocksFunction sha256Select(void)
+{
+	register uint32_t features = cpuFeatures();
+
+	#if ENABLE_SHANI
+	if ((features & (CPU_FEATURE_SHA | CPU_FEATURE_SSE41)) == (CPU_FEATURE_SHA | CPU_FEATURE_SSE41))
+		return sha256BlocksSHANI;
+	#endif
+	return sha256BlocksC;
+}
+
+void sha256ProcessBlocks(register sha256Param* sp, const byte* blocks, size_t nblocks)
+{
+	if (_sha256blocks == (sha256BlocksFunction) 0)
+		_sha256blocks = sha256Select();
+
+	_sha256blocks(sp, blocks, nblocks);
+}
+#endif
+
+void sha256Process(register sha256Param* sp)
+{
+	sha256ProcessBlocks(sp, (const byte*) sp->data, 1);
+}
+#else
+void sha256ProcessBlocks(register sha256Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(sp->data, blocks, 64);
+		sha256Process(sp);
+		blocks += 64;
+	}
+}
 #endif
 
 int sha256Update(register sha256Param* sp, const byte* data, size_t size)
@@ -209,7 +365,8 @@ int sha256Update(register sha256Param* sp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (sp->offset > 0)
 	{
 		proclength = ((sp->offset + size) > 64U) ? (64U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
@@ -223,6 +380,23 @@ int sha256Update(register sha256Param* sp, const byte* data, size_t size)
 			sp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 64U)
+	{
+		register size_t nblocks = size >> 6;
+
+		sha256ProcessBlocks(sp, data, nblocks);
+		data += nblocks << 6;
+		size -= nblocks << 6;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(sp->data, data, size);
+		sp->offset = (uint32_t) size;
+	}
 	return 0;
 }
 
@@ -313,5 +487,319 @@ int sha256Digest(register sha256Param* sp, byte* data)
 	return 0;
 }
 
+#if SHA256_LANES
+# define SHA256_MAXLANES	16
+
+/* the message words are gathered from each lane's block; idle lanes point
+ * to a block whose result is ignored
+ */
+typedef void (*sha256LanesFunction)(uint32_t*, const byte**);
+
+# if ENABLE_AVX2
+#  define AVX2_TARGET __attribute__((target("avx2")))
+
+#  define SHA256_AVX2_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32-(n)))
+#  define SHA256_AVX2_SIG0(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 2), SHA256_AVX2_ROR(x, 13)), SHA256_AVX2_ROR(x, 22))
+#  define SHA256_AVX2_SIG1(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 6), SHA256_AVX2_ROR(x, 11)), SHA256_AVX2_ROR(x, 25))
+#  define SHA256_AVX2_sig0(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 7), SHA256_AVX2_ROR(x, 18)), _mm256_srli_epi32(x, 3))
+#  define SHA256_AVX2_sig1(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 17), SHA256_AVX2_ROR(x, 19)), _mm256_srli_epi32(x, 10))
+
+#  define SHA256_AVX2_ROUND(a, b, c, d, e, f, g, h, i) \
+	if ((i) >= 16) \
+		w[(i)&15] = _mm256_add_epi32(_mm256_add_epi32(SHA256_AVX2_sig1(w[((i)-2)&15]), w[((i)-7)&15]), _mm256_add_epi32(SHA256_AVX2_sig0(w[((i)-15)&15]), w[(i)&15])); \
+	t1 = _mm256_add_epi32(_mm256_add_epi32(h, SHA256_AVX2_SIG1(e)), _mm256_add_epi32(_mm256_xor_si256(_mm256_and_si256(_mm256_xor_si256(f, g), e), g), _mm256_add_epi32(_mm256_set1_epi32((int) SHA2_32BIT_K[i]), w[(i)&15]))); \
+	t2 = _mm256_add_epi32(SHA256_AVX2_SIG0(a), _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c), _mm256_and_si256(a, b))); \
+	d = _mm256_add_epi32(d, t1); \
+	h = _mm256_add_epi32(t1, t2)
+
+/* eight lanes */
+static AVX2_TARGET void sha256LanesAVX2(uint32_t* st, const byte** ptr)
+{
+	const __m256i swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	const __m256i four = _mm256_set1_epi64x(4);
+	__m256i a, b, c, d, e, f, g, h, t1, t2, lo, hi;
+	__m256i w[16];
+	int i;
+
+	lo = _mm256_set_epi64x((long long) (size_t) ptr[3], (long long) (size_t) ptr[2], (long long) (size_t) ptr[1], (long long) (size_t) ptr[0]);
+	hi = _mm256_set_epi64x((long long) (size_t) ptr[7], (long long) (size_t) ptr[6], (long long) (size_t) ptr[5], (long long) (size_t) ptr[4]);
+
+	for (i = 0; i < 16; i++)
+	{
+		w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_i64gather_epi32((const int*) 0, lo, 1)), _mm256_i64gather_epi32((const int*) 0, hi, 1), 1), swap);
+		lo = _mm256_add_epi64(lo, four);
+		hi = _mm256_add_epi64(hi, four);
+	}
+
+	a = _mm256_loadu_si256((const __m256i*) (st+ 0));
+	b = _mm256_loadu_si256((const __m256i*) (st+ 8));
+	c = _mm256_loadu_si256((const __m256i*) (st+16));
+	d = _mm256_loadu_si256((const __m256i*) (st+24));
+	e = _mm256_loadu_si256((const __m256i*) (st+32));
+	f = _mm256_loadu_si256((const __m256i*) (st+40));
+	g = _mm256_loadu_si256((const __m256i*) (st+48));
+	h = _mm256_loadu_si256((const __m256i*) (st+56));
+
+	for (i = 0; i < 64; i += 8)
+	{
+		SHA256_AVX2_ROUND(a, b, c, d, e, f, g, h, i  );
+		SHA256_AVX2_ROUND(h, a, b, c, d, e, f, g, i+1);
+		SHA256_AVX2_ROUND(g, h, a, b, c, d, e, f, i+2);
+		SHA256_AVX2_ROUND(f, g, h, a, b, c, d, e, i+3);
+		SHA256_AVX2_ROUND(e, f, g, h, a, b, c, d, i+4);
+		SHA256_AVX2_ROUND(d, e, f, g, h, a, b, c, i+5);
+		SHA256_AVX2_ROUND(c, d, e, f, g, h, a, b, i+6);
+		SHA256_AVX2_ROUND(b, c, d, e, f, g, h, a, i+7);
+	}
+
+	_mm256_storeu_si256((__m256i*) (st+ 0), _mm256_add_epi32(a, _mm256_loadu_si256((const __m256i*) (st+ 0))));
+	_mm256_storeu_si256((__m256i*) (st+ 8), _mm256_add_epi32(b, _mm256_loadu_si256((const __m256i*) (st+ 8))));
+	_mm256_storeu_si256((__m256i*) (st+16), _mm256_add_epi32(c, _mm256_loadu_si256((const __m256i*) (st+16))));
+	_mm256_storeu_si256((__m256i*) (st+24), _mm256_add_epi32(d, _mm256_loadu_si256((const __m256i*) (st+24))));
+	_mm256_storeu_si256((__m256i*) (st+32), _mm256_add_epi32(e, _mm256_loadu_si256((const __m256i*) (st+32))));
+	_mm256_storeu_si256((__m256i*) (st+40), _mm256_add_epi32(f, _mm256_loadu_si256((const __m256i*) (st+40))));
+	_mm256_storeu_si256((__m256i*) (st+48), _mm256_add_epi32(g, _mm256_loadu_si256((const __m256i*) (st+48))));
+	_mm256_storeu_si256((__m256i*) (st+56), _mm256_add_epi32(h, _mm256_loadu_si256((const __m256i*) (st+56))));
+}
+# endif
+
+# if ENABLE_AVX512
+#  define AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+
+#  define SHA256_AVX512_XOR3(x, y, z) _mm512_ternarylogic_epi32(x, y, z, 0x96)
+#  define SHA256_AVX512_SIG0(x) SHA256_AVX512_XOR3(_mm512_ror_epi32(x, 2), _mm512_ror_epi32(x, 13), _mm512_ror_epi32(x, 22))
+#  define SHA256_AVX512_SIG1(x) SHA256_AVX512_XOR3(_mm512_ror_epi32(x, 6), _mm512_ror_epi32(x, 11), _mm512_ror_epi32(x, 25))
+#  define SHA256_AVX512_sig0(x) SHA256_AVX512_XOR3(_mm512_ror_epi32(x, 7), _mm512_ror_epi32(x, 18), _mm512_srli_epi32(x, 3))
+#  define SHA256_AVX512_sig1(x) SHA256_AVX512_XOR3(_mm512_ror_epi32(x, 17), _mm512_ror_epi32(x, 19), _mm512_srli_epi32(x, 10))
+
+/* the ternary logic immediates 0xca and 0xe8 are CH and MAJ */
+#  define SHA256_AVX512_ROUND(a, b, c, d, e, f, g, h, i) \
+	if ((i) >= 16) \
+		w[(i)&15] = _mm512_add_epi32(_mm512_add_epi32(SHA256_AVX512_sig1(w[((i)-2)&15]), w[((i)-7)&15]), _mm512_add_epi32(SHA256_AVX512_sig0(w[((i)-15)&15]), w[(i)&15])); \
+	t1 = _mm512_add_epi32(_mm512_add_epi32(h, SHA256_AVX512_SIG1(e)), _mm512_add_epi32(_mm512_ternarylogic_epi32(e, f, g, 0xca), _mm512_add_epi32(_mm512_set1_epi32((int) SHA2_32BIT_K[i]), w[(i)&15]))); \
+	t2 = _mm512_add_epi32(SHA256_AVX512_SIG0(a), _mm512_ternarylogic_epi32(a, b, c, 0xe8)); \
+	d = _mm512_add_epi32(d, t1); \
+	h = _mm512_add_epi32(t1, t2)
+
+/* sixteen lanes */
+static AVX512_TARGET void sha256LanesAVX512(uint32_t* st, const byte** ptr)
+{
+	const __m512i swap = _mm512_set_epi32(
+			0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203, 0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203,
+			0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203, 0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203);
+	const __m512i four = _mm512_set1_epi64(4);
+	__m512i a, b, c, d, e, f, g, h, t1, t2, lo, hi;
+	__m512i w[16];
+	int i;
+
+	lo = _mm512_set_epi64((long long) (size_t) ptr[ 7], (long long) (size_t) ptr[ 6], (long long) (size_t) ptr[ 5], (long long) (size_t) ptr[ 4],
+	                      (long long) (size_t) ptr[ 3], (long long) (size_t) ptr[ 2], (long long) (size_t) ptr[ 1], (long long) (size_t) ptr[ 0]);
+	hi = _mm512_set_epi64((long long) (size_t) ptr[15], (long long) (size_t) ptr[14], (long long) (size_t) ptr[13], (long long) (size_t) ptr[12],
+	                      (long long) (size_t) ptr[11], (long long) (size_t) ptr[10], (long long) (size_t) ptr[ 9], (long long) (size_t) ptr[ 8]);
+
+	for (i = 0; i < 16; i++)
+	{
+		w[i] = _mm512_shuffle_epi8(_mm512_inserti64x4(_mm512_castsi256_si512(_mm512_i64gather_epi32(lo, (const void*) 0, 1)), _mm512_i64gather_epi32(hi, (const void*) 0, 1), 1), swap);
+		lo = _mm512_add_epi64(lo, four);
+		hi = _mm512_add_epi64(hi, four);
+	}
+
+	a = _mm512_loadu_si512((const void*) (st+  0));
+	b = _mm512_loadu_si512((const void*) (st+ 16));
+	c = _mm512_loadu_si512((const void*) (st+ 32));
+	d = _mm512_loadu_si512((const void*) (st+ 48));
+	e = _mm512_loadu_si512((const void*) (st+ 64));
+	f = _mm512_loadu_si512((const void*) (st+ 80));
+	g = _mm512_loadu_si512((const void*) (st+ 96));
+	h = _mm512_loadu_si512((const void*) (st+112));
+
+	for (i = 0; i < 64; i += 8)
+	{
+		SHA256_AVX512_ROUND(a, b, c, d, e, f, g, h, i  );
+		SHA256_AVX512_ROUND(h, a, b, c, d, e, f, g, i+1);
+		SHA256_AVX512_ROUND(g, h, a, b, c, d, e, f, i+2);
+		SHA256_AVX512_ROUND(f, g, h, a, b, c, d, e, i+3);
+		SHA256_AVX512_ROUND(e, f, g, h, a, b, c, d, i+4);
+		SHA256_AVX512_ROUND(d, e, f, g, h, a, b, c, i+5);
+		SHA256_AVX512_ROUND(c, d, e, f, g, h, a, b, i+6);
+		SHA256_AVX512_ROUND(b, c, d, e, f, g, h, a, i+7);
+	}
+
+	_mm512_storeu_si512((void*) (st+  0), _mm512_add_epi32(a, _mm512_loadu_si512((const void*) (st+  0))));
+	_mm512_storeu_si512((void*) (st+ 16), _mm512_add_epi32(b, _mm512_loadu_si512((const void*) (st+ 16))));
+	_mm512_storeu_si512((void*) (st+ 32), _mm512_add_epi32(c, _mm512_loadu_si512((const void*) (st+ 32))));
+	_mm512_storeu_si512((void*) (st+ 48), _mm512_add_epi32(d, _mm512_loadu_si512((const void*) (st+ 48))));
+	_mm512_storeu_si512((void*) (st+ 64), _mm512_add_epi32(e, _mm512_loadu_si512((const void*) (st+ 64))));
+	_mm512_storeu_si512((void*) (st+ 80), _mm512_add_epi32(f, _mm512_loadu_si512((const void*) (st+ 80))));
+	_mm512_storeu_si512((void*) (st+ 96), _mm512_add_epi32(g, _mm512_loadu_si512((const void*) (st+ 96))));
+	_mm512_storeu_si512((void*) (st+112), _mm512_add_epi32(h, _mm512_loadu_si512((const void*) (st+112))));
+}
+# endif
+
+typedef struct
+{
+	const byte*	next;		/* the next block */
+	size_t		blocks;		/* blocks left before the tail, or in it */
+	size_t		msg;		/* the message's index, or count if idle */
+	int			tail;
+	byte		pad[128];	/* the padded tail of the message */
+} sha256Lane;
+
+static void sha256LaneTail(sha256Lane* lane, const byte* msg, size_t len)
+{
+	register size_t rem = len & 63;
+	register uint64_t bits = ((uint64_t) len) << 3;
+	register byte* end;
+
+	memcpy(lane->pad, msg + (len - rem), rem);
+	lane->pad[rem] = 0x80;
+	lane->blocks = (rem < 56) ? 1 : 2;
+
+	end = lane->pad + (lane->blocks << 6) - 8;
+	memset(lane->pad + rem + 1, 0, end - (lane->pad + rem + 1));
+
+	end[0] = (byte)(bits >> 56);
+	end[1] = (byte)(bits >> 48);
+	end[2] = (byte)(bits >> 40);
+	end[3] = (byte)(bits >> 32);
+	end[4] = (byte)(bits >> 24);
+	end[5] = (byte)(bits >> 16);
+	end[6] = (byte)(bits >>  8);
+	end[7] = (byte)(bits      );
+
+	lane->next = lane->pad;
+	lane->tail = 1;
+}
+
+/* hands each free lane the next message, until all of them are done */
+static void sha256Lanes(sha256LanesFunction process, int lanes, size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+{
+	uint32_t st[8*SHA256_MAXLANES];
+	const byte* ptr[SHA256_MAXLANES];
+	sha256Lane lane[SHA256_MAXLANES];
+	size_t next = 0, busy = 0;
+	int i, l;
+
+	for (l = 0; l < lanes; l++)
+		lane[l].msg = count;
+
+	while (1)
+	{
+		for (l = 0; l < lanes; l++)
+		{
+			if (lane[l].msg == count && next < count)
+			{
+				for (i = 0; i < 8; i++)
+					st[i*lanes+l] = hinit[i];
+
+				lane[l].msg = next;
+				lane[l].blocks = lens[next] >> 6;
+				lane[l].next = msgs[next];
+				lane[l].tail = 0;
+
+				if (lane[l].blocks == 0)
+					sha256LaneTail(lane+l, msgs[next], lens[next]);
+
+				next++;
+				busy++;
+			}
+
+			ptr[l] = (lane[l].msg < count) ? lane[l].next : lane[l].pad;
+		}
+
+		if (busy == 0)
+			break;
+
+		process(st, ptr);
+
+		for (l = 0; l < lanes; l++)
+		{
+			register sha256Lane* ln = lane+l;
+
+			if (ln->msg == count)
+				continue;
+
+			ln->next += 64;
+			if (--ln->blocks)
+				continue;
+
+			if (!ln->tail)
+				sha256LaneTail(ln, msgs[ln->msg], lens[ln->msg]);
+			else
+			{
+				register byte* data = digests[ln->msg];
+
+				for (i = 0; i < 8; i++)
+				{
+					register uint32_t temp = st[i*lanes+l];
+
+					data[0] = (byte)(temp >> 24);
+					data[1] = (byte)(temp >> 16);
+					data[2] = (byte)(temp >>  8);
+					data[3] = (byte)(temp      );
+					data += 4;
+				}
+
+				ln->msg = count;
+				busy--;
+			}
+		}
+	}
+
+	memset(lane, 0, sizeof(lane));
+	memset(st, 0, sizeof(st));
+}
+#endif
+
+int sha256MultiDigest(size_t count, const byte* const* msgs, const size_t* lens, byte* const* digests)
+{
+	sha256Param param;
+	size_t i;
+
+	if (count == 0)
+		return 0;
+
+	if (msgs == (const byte* const*) 0 || lens == (const size_t*) 0 || digests == (byte* const*) 0)
+		return -1;
+
+	#if SHA256_LANES
+	if (count > 1)
+	{
+		register uint32_t features = cpuFeatures();
+
+		# if ENABLE_AVX512
+		if ((features & (CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW)) == (CPU_FEATURE_AVX512F | CPU_FEATURE_AVX512BW))
+		{
+			sha256Lanes(sha256LanesAVX512, 16, count, msgs, lens, digests);
+			return 0;
+		}
+		# endif
+		# if ENABLE_AVX2
+		/* eight lanes don't beat the SHA instructions on a single message */
+		# if ENABLE_SHANI
+		if ((features & CPU_FEATURE_AVX2) && (features & (CPU_FEATURE_SHA | CPU_FEATURE_SSE41)) != (CPU_FEATURE_SHA | CPU_FEATURE_SSE41))
+		# else
+		if (features & CPU_FEATURE_AVX2)
+		# endif
+		{
+			sha256Lanes(sha256LanesAVX2, 8, count, msgs, lens, digests);
+			return 0;
+		}
+		# endif
+	}
+	#endif
+
+	/* one message at a time */
+	sha256Reset(&param);
+
+	for (i = 0; i < count; i++)
+	{
+		sha256Update(&param, msgs[i], lens[i]);
+		sha256Digest(&param, digests[i]);
+	}
+
+	return 0;
+}
+
 /*!\}
  */
@@ -73,7 +73,10 @@ const hashFunction sha384 = {
 	48,
 	(hashFunctionReset) sha384Reset,
 	(hashFunctionUpdate) sha384Update,
-	(hashFunctionDigest) sha384Digest
+	(hashFunctionDigest) sha384Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) sha384Copy,
+	(hashFunctionCheck) sha384Check
 };
 
 int sha384Reset(register sha384Param* sp)
@@ -91,6 +94,21 @@ int sha384Reset(register sha384Param* sp)
 	return 0;
 }
 
+int sha384Copy(register sha384Param* dst, const sha384Param* src)
+{
+	/* the rest of data is scratch space for the message schedule */
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 128);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int sha384Check(const sha384Param* sp)
+{
+	return (sp->offset < 128U) ? 0 : -1;
+}
+
 #ifdef OPTIMIZE_SSE2
 
 # define R(x,s) _mm_srli_si64(x,s)
@@ -126,7 +144,8 @@ int sha384Reset(register sha384Param* sp)
 #endif
 
 #ifndef ASM_SHA384PROCESS
-void sha384Process(register sha384Param* sp)
+/* processes one block; it may be sp->data itself */
+static void sha384Block(register sha384Param* sp, const byte* block)
 {
 	#ifdef OPTIMIZE_SSE2 
 	
@@ -143,6 +162,9 @@ void sha384Process(register sha384Param* sp)
 	register const __m64 *k;
 	register byte t;
 
+	if (block != (const byte*) sp->data)
+		memcpy(sp->data, block, 128);
+
 	w = (__m64*) sp->data;
 	t = 16;
 	while (t--)
@@ -176,15 +198,19 @@ void sha384Process(register sha384Param* sp)
 	register const uint64_t *k;
 	register byte t;
 
+	w = sp->data;
 	# if WORDS_BIGENDIAN
-	w = sp->data + 16;
+	if (block != (const byte*) w)
+		memcpy(w, block, 128);
+	w += 16;
 	# else
-	w = sp->data;
 	t = 16;
 	while (t--)
 	{
-		temp = swapu64(*w);
-		*(w++) = temp;
+		uint64_t load;
+		memcpy(&load, block, 8);
+		*(w++) = swapu64(load);
+		block += 8;
 	}
 	# endif
 
@@ -306,6 +332,30 @@ void sha384Process(register sha384Param* sp)
 	sp->h[7] += h;
 	#endif
 }
+
+void sha384ProcessBlocks(register sha384Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		sha384Block(sp, blocks);
+		blocks += 128;
+	}
+}
+
+void sha384Process(register sha384Param* sp)
+{
+	sha384Block(sp, (const byte*) sp->data);
+}
+#else
+void sha384ProcessBlocks(register sha384Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(sp->data, blocks, 128);
+		sha384Process(sp);
+		blocks += 128;
+	}
+}
 #endif
 
 int sha384Update(register sha384Param* sp, const byte* data, size_t size)
@@ -326,7 +376,8 @@ int sha384Update(register sha384Param* sp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (sp->offset > 0)
 	{
 		proclength = ((sp->offset + size) > 128U) ? (128U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
@@ -340,6 +391,23 @@ int sha384Update(register sha384Param* sp, const byte* data, size_t size)
 			sp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 128U)
+	{
+		register size_t nblocks = size >> 7;
+
+		sha384ProcessBlocks(sp, data, nblocks);
+		data += nblocks << 7;
+		size -= nblocks << 7;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(sp->data, data, size);
+		sp->offset = size;
+	}
 	return 0;
 }
 
@@ -73,7 +73,10 @@ const hashFunction sha512 = {
 	64,
 	(hashFunctionReset) sha512Reset,
 	(hashFunctionUpdate) sha512Update,
-	(hashFunctionDigest) sha512Digest
+	(hashFunctionDigest) sha512Digest,
+	(hashFunctionBatch) 0,
+	(hashFunctionCopy) sha512Copy,
+	(hashFunctionCheck) sha512Check
 };
 
 int sha512Reset(register sha512Param* sp)
@@ -92,6 +95,21 @@ int sha512Reset(register sha512Param* sp)
 	return 0;
 }
 
+int sha512Copy(register sha512Param* dst, const sha512Param* src)
+{
+	/* the rest of data is scratch space for the message schedule */
+	memcpy(dst->h, src->h, sizeof(dst->h));
+	memcpy(dst->data, src->data, 128);
+	memcpy(dst->length, src->length, sizeof(dst->length));
+	dst->offset = src->offset;
+	return 0;
+}
+
+int sha512Check(const sha512Param* sp)
+{
+	return (sp->offset < 128U) ? 0 : -1;
+}
+
 #ifdef OPTIMIZE_SSE2
 
 # define R(x,s) _mm_srli_si64(x,s)
@@ -127,7 +145,8 @@ int sha512Reset(register sha512Param* sp)
 #endif
 
 #ifndef ASM_SHA512PROCESS
-void sha512Process(register sha512Param* sp)
+/* processes one block; it may be sp->data itself */
+static void sha512Block(register sha512Param* sp, const byte* block)
 {
 	#ifdef OPTIMIZE_SSE2
 	# if defined(_MSC_VER) || defined(__INTEL_COMPILER)
@@ -143,6 +162,9 @@ void sha512Process(register sha512Param* sp)
 	register const __m64 *k;
 	register byte t;
 
+	if (block != (const byte*) sp->data)
+		memcpy(sp->data, block, 128);
+
 	w = (__m64*) sp->data;
 	t = 16;
 	while (t--)
@@ -176,15 +198,19 @@ void sha512Process(register sha512Param* sp)
 	register const uint64_t *k;
 	register byte t;
 
+	w = sp->data;
 	# if WORDS_BIGENDIAN
-	w = sp->data + 16;
+	if (block != (const byte*) w)
+		memcpy(w, block, 128);
+	w += 16;
 	# else
-	w = sp->data;
 	t = 16;
 	while (t--)
 	{
-		temp = swapu64(*w);
-		*(w++) = temp;
+		uint64_t load;
+		memcpy(&load, block, 8);
+		*(w++) = swapu64(load);
+		block += 8;
 	}
 	# endif
 
@@ -306,6 +332,30 @@ void sha512Process(register sha512Param* sp)
 	sp->h[7] += h;
 	#endif
 }
+
+void sha512ProcessBlocks(register sha512Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		sha512Block(sp, blocks);
+		blocks += 128;
+	}
+}
+
+void sha512Process(register sha512Param* sp)
+{
+	sha512Block(sp, (const byte*) sp->data);
+}
+#else
+void sha512ProcessBlocks(register sha512Param* sp, const byte* blocks, size_t nblocks)
+{
+	while (nblocks--)
+	{
+		memcpy(sp->data, blocks, 128);
+		sha512Process(sp);
+		blocks += 128;
+	}
+}
 #endif
 
 int sha512Update(register sha512Param* sp, const byte* data, size_t size)
@@ -326,7 +376,8 @@ int sha512Update(register sha512Param* sp, const byte* data, size_t size)
 	# error
 	#endif
 
-	while (size > 0)
+	/* complete a partial block first */
+	if (sp->offset > 0)
 	{
 		proclength = ((sp->offset + size) > 128U) ? (128U - sp->offset) : size;
 		memcpy(((byte *) sp->data) + sp->offset, data, proclength);
@@ -340,6 +391,23 @@ int sha512Update(register sha512Param* sp, const byte* data, size_t size)
 			sp->offset = 0;
 		}
 	}
+
+	/* whole blocks are processed straight from the caller's buffer */
+	if (size >= 128U)
+	{
+		register size_t nblocks = size >> 7;
+
+		sha512ProcessBlocks(sp, data, nblocks);
+		data += nblocks << 7;
+		size -= nblocks << 7;
+	}
+
+	/* keep the remainder */
+	if (size > 0)
+	{
+		memcpy(sp->data, data, size);
+		sp->offset = size;
+	}
 	return 0;
 }
 
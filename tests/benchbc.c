@@ -23,9 +23,11 @@
  */
 
 #include "beecrypt/beecrypt.h"
+#include "beecrypt/cpu.h"
 #include "beecrypt/timestamp.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #define SECONDS	10
 
@@ -260,5 +262,8 @@ int main(int argc, char* argv[])
 			usage();
 	}
 
+	if (strcmp(bc->name, "AES") == 0)
+		printf("AES-NI %s\n", (cpuFeatures() & CPU_FEATURE_AESNI) ? "available" : "not available");
+
 	return benchmark(bc, keybits, size);
 }
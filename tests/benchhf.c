@@ -23,9 +23,11 @@
  */
 
 #include "beecrypt/beecrypt.h"
+#include "beecrypt/cpu.h"
 #include "beecrypt/timestamp.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #define SECONDS	10
 
@@ -116,5 +118,14 @@ int main(int argc, char* argv[])
 			usage();
 	}
 
+	if (strcmp(hf->name, "SHA-1") == 0 || strcmp(hf->name, "SHA-224") == 0 || strcmp(hf->name, "SHA-256") == 0)
+	{
+		uint32_t features = cpuFeatures();
+
+		printf("SHA extensions %s, AVX2 %s\n",
+			(features & CPU_FEATURE_SHA) ? "available" : "not available",
+			(features & CPU_FEATURE_AVX2) ? "available" : "not available");
+	}
+
 	return benchmark(hf, size);
 }
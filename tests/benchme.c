@@ -24,6 +24,7 @@
 
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/dldp.h"
+#include "beecrypt/mpmont.h"
 #include "beecrypt/timestamp.h"
 
 #include <stdio.h>
@@ -37,9 +38,11 @@ static const char* hg = "9b01e78dcaca5ae69656bb01c9a1f3b159f7cf8f77781146f916836
 int main()
 {
 	dldp_p params;
+	mpmont pmont;
 	mpnumber gq;
 	jlong start, now;
 	int iterations = 0;
+	int engine;
 
 	dldp_pInit(&params);
 
@@ -48,42 +51,60 @@ int main()
 	mpnsethex(&params.g, hg);
 	mpnzero(&gq);
 
-	/* get starting time */
-	iterations = 0;
-	start = timestamp();
-	do
-	{
-		mpbnpowmod(&params.p, &params.g, (mpnumber*) &params.q, &gq);
-		now = timestamp();
-		iterations++;
-	} while (now < (start + (SECONDS * ONE_SECOND)));
-
-	printf("(%d bits ^ %d bits) mod (%d bits): %d times in %d seconds\n",
-		(int) mpbits(params.g.size, params.g.data),
-		(int) mpbits(params.q.size, params.q.modl),
-		(int) mpbits(params.p.size, params.p.modl),
-		iterations,
-		SECONDS);
-
-	/* get starting time */
-	iterations = 0;
-	start = timestamp();
-	do
+	mpmontzero(&pmont);
+	mpmontset(&pmont, params.p.size, params.p.modl);
+
+	for (engine = MP_ENGINE_BARRETT; engine <= MP_ENGINE_MONTGOMERY; engine++)
 	{
-		mpbnpowmod(&params.p, &params.g, (mpnumber*) &params.g, &gq);
-		now = timestamp();
-		iterations++;
-	} while (now < (start + (SECONDS * ONE_SECOND)));
-
-	printf("(%d bits ^ %d bits) mod (%d bits): %d times in %d seconds\n",
-		(int) mpbits(params.g.size, params.g.data),
-		(int) mpbits(params.g.size, params.g.data),
-		(int) mpbits(params.p.size, params.p.modl),
-		iterations,
-		SECONDS);
+		const char* name = (engine == MP_ENGINE_BARRETT) ? "Barrett" : "Montgomery";
+
+		/* get starting time */
+		iterations = 0;
+		start = timestamp();
+		do
+		{
+			if (engine == MP_ENGINE_BARRETT)
+				mpbnpowmod(&params.p, &params.g, (mpnumber*) &params.q, &gq);
+			else
+				mpmontnpowmod(&pmont, &params.g, (mpnumber*) &params.q, &gq);
+			now = timestamp();
+			iterations++;
+		} while (now < (start + (SECONDS * ONE_SECOND)));
+
+		printf("%s: (%d bits ^ %d bits) mod (%d bits): %d times in %d seconds\n",
+			name,
+			(int) mpbits(params.g.size, params.g.data),
+			(int) mpbits(params.q.size, params.q.modl),
+			(int) mpbits(params.p.size, params.p.modl),
+			iterations,
+			SECONDS);
+
+		/* get starting time */
+		iterations = 0;
+		start = timestamp();
+		do
+		{
+			if (engine == MP_ENGINE_BARRETT)
+				mpbnpowmod(&params.p, &params.g, (mpnumber*) &params.g, &gq);
+			else
+				mpmontnpowmod(&pmont, &params.g, (mpnumber*) &params.g, &gq);
+			now = timestamp();
+			iterations++;
+		} while (now < (start + (SECONDS * ONE_SECOND)));
+
+		printf("%s: (%d bits ^ %d bits) mod (%d bits): %d times in %d seconds\n",
+			name,
+			(int) mpbits(params.g.size, params.g.data),
+			(int) mpbits(params.g.size, params.g.data),
+			(int) mpbits(params.p.size, params.p.modl),
+			iterations,
+			SECONDS);
+	}
 
 	mpnfree(&gq);
 
+	mpmontfree(&pmont);
+
 	dldp_pFree(&params);
 
 	return 0;
@@ -29,6 +29,7 @@
 #include <stdio.h>
 
 #define SECONDS	10
+#define MAXBATCH	64
 
 const char* hm = "0001FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF03021300906052B0E03021A05000414993E364706816ABA3E25717850C26C9CD0D89D";
 
@@ -37,8 +38,9 @@ int main()
 	randomGeneratorContext rngc;
 	rsakp pair;
 	mpnumber m, c;
+	mpnumber cb[MAXBATCH], mb[MAXBATCH];
 	jlong start, now;
-	int iterations = 0;
+	int i, batch, iterations = 0;
 
 	randomGeneratorContextInit(&rngc, randomGeneratorDefault());
 
@@ -95,6 +97,38 @@ int main()
 		iterations,
 		SECONDS);
 
+	/* batch crt operation, over a range of batch sizes */
+	for (i = 0; i < MAXBATCH; i++)
+	{
+		mpnzero(cb+i);
+		mpnzero(mb+i);
+		mpnset(cb+i, c.size, c.data);
+	}
+
+	for (batch = 1; batch <= MAXBATCH; batch <<= 1)
+	{
+		iterations = 0;
+		start = timestamp();
+		do
+		{
+			rsapricrt_batch(&pair, batch, cb, mb);
+			now = timestamp();
+			iterations += batch;
+		} while (now < (start + (SECONDS * ONE_SECOND)));
+
+		printf("%d bits crt batch %2d:  %d times in %d seconds\n",
+			(int) mpbits(pair.n.size, pair.n.modl),
+			batch,
+			iterations,
+			SECONDS);
+	}
+
+	for (i = 0; i < MAXBATCH; i++)
+	{
+		mpnfree(mb+i);
+		mpnfree(cb+i);
+	}
+
 	rsakpFree(&pair);
 
 	mpnfree(&c);
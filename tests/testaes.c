@@ -26,6 +26,7 @@
 #include <stdio.h>
 
 #include "beecrypt/aes.h"
+#include "beecrypt/blockmode.h"
 
 extern int fromhex(byte*, const char*);
 extern void hexdump(const byte*, size_t);
@@ -67,6 +68,46 @@ struct vector table[NVECTORS] = {
 	  DECRYPT }
 };
 
+/* multi-block vectors from NIST SP 800-38A, appendix F */
+struct mode_vector
+{
+	char*			key;
+	char*			iv;
+	char*			input;
+	char*			expect;
+	int				(*mode)(blockCipherContext*, uint32_t*, const uint32_t*, int);
+	cipherOperation	op;
+};
+
+#define NMODEVECTORS 4
+
+struct mode_vector mode_table[NMODEVECTORS] = {
+	{ "2b7e151628aed2a6abf7158809cf4f3c",
+	  (char*) 0,
+	  "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+	  "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4",
+	  blockCipherContextECB,
+	  ENCRYPT },
+	{ "2b7e151628aed2a6abf7158809cf4f3c",
+	  (char*) 0,
+	  "3ad77bb40d7a3660a89ecaf32466ef97f5d3d58503b9699de785895a96fdbaaf43b1cd7f598ece23881b00e3ed0306887b0c785e27e8ad3f8223207104725dd4",
+	  "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+	  blockCipherContextECB,
+	  DECRYPT },
+	{ "2b7e151628aed2a6abf7158809cf4f3c",
+	  "000102030405060708090a0b0c0d0e0f",
+	  "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+	  "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b273bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7",
+	  blockCipherContextCBC,
+	  ENCRYPT },
+	{ "2b7e151628aed2a6abf7158809cf4f3c",
+	  "000102030405060708090a0b0c0d0e0f",
+	  "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b273bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7",
+	  "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710",
+	  blockCipherContextCBC,
+	  DECRYPT }
+};
+
 int main()
 {
 	int i, failures = 0;
@@ -107,5 +148,144 @@ int main()
 
 	}
 
+	for (i = 0; i < NMODEVECTORS; i++)
+	{
+		blockCipherContext bcc;
+		uint32_t msrc[16], mdst[16], mchk[16];
+		int nblocks;
+
+		if (blockCipherContextInit(&bcc, &aes))
+			return -1;
+
+		keybits = fromhex(key, mode_table[i].key) << 3;
+
+		if (blockCipherContextSetup(&bcc, key, keybits, mode_table[i].op))
+			return -1;
+
+		if (mode_table[i].iv)
+		{
+			byte iv[16];
+
+			fromhex(iv, mode_table[i].iv);
+
+			if (blockCipherContextSetIV(&bcc, iv))
+				return -1;
+		}
+
+		nblocks = fromhex((byte*) msrc, mode_table[i].input) >> 4;
+		fromhex((byte*) mchk, mode_table[i].expect);
+
+		if (mode_table[i].mode(&bcc, mdst, msrc, nblocks))
+			return -1;
+
+		if (memcmp(mdst, mchk, nblocks << 4))
+		{
+			printf("failed mode vector %d\n", i+1);
+			failures++;
+		}
+
+		blockCipherContextFree(&bcc);
+	}
+
+	/* CTR mode must produce the same keystream whether blocks are processed
+	 * one at a time or in a single multi-block call
+	 */
+	{
+		blockCipherContext one, all;
+		uint32_t msrc[36], mdst[36], mchk[36];
+
+		memset(msrc, 0xa5, sizeof(msrc));
+
+		if (blockCipherContextInit(&one, &aes) || blockCipherContextInit(&all, &aes))
+			return -1;
+
+		keybits = fromhex(key, table[4].key) << 3;
+
+		if (blockCipherContextSetup(&one, key, keybits, ENCRYPT) || blockCipherContextSetup(&all, key, keybits, ENCRYPT))
+			return -1;
+
+		if (blockCipherContextSetCTR(&one, (const byte*) 0, 0x1234) || blockCipherContextSetCTR(&all, (const byte*) 0, 0x1234))
+			return -1;
+
+		for (i = 0; i < 9; i++)
+			if (blockCipherContextCTR(&one, mchk + (i << 2), msrc + (i << 2), 1))
+				return -1;
+
+		if (blockCipherContextCTR(&all, mdst, msrc, 9))
+			return -1;
+
+		if (memcmp(mdst, mchk, sizeof(mdst)))
+		{
+			printf("failed CTR multi-block consistency\n");
+			failures++;
+		}
+
+		/* likewise CBC decryption of several blocks in one call, which
+		 * optimized implementations process in parallel
+		 */
+		if (blockCipherContextSetup(&all, key, keybits, DECRYPT))
+			return -1;
+
+		if (blockCipherContextSetIV(&one, (const byte*) 0) || blockCipherContextSetIV(&all, (const byte*) 0))
+			return -1;
+
+		for (i = 0; i < 9; i++)
+			if (blockCipherContextCBC(&one, mchk + (i << 2), msrc + (i << 2), 1))
+				return -1;
+
+		if (blockCipherContextCBC(&all, mdst, mchk, 9))
+			return -1;
+
+		if (memcmp(mdst, msrc, sizeof(mdst)))
+		{
+			printf("failed CBC multi-block consistency\n");
+			failures++;
+		}
+
+		blockCipherContextFree(&one);
+		blockCipherContextFree(&all);
+	}
+
+	/* CTR mode split over several threads must match the serial result,
+	 * and leave the counter at the same value
+	 */
+	{
+		blockCipherContext one, all;
+		uint32_t msrc[404], mdst[404], mchk[404];
+
+		memset(msrc, 0x5a, sizeof(msrc));
+
+		if (blockCipherContextInit(&one, &aes) || blockCipherContextInit(&all, &aes))
+			return -1;
+
+		keybits = fromhex(key, table[2].key) << 3;
+
+		if (blockCipherContextSetup(&one, key, keybits, ENCRYPT) || blockCipherContextSetup(&all, key, keybits, ENCRYPT))
+			return -1;
+
+		if (blockCipherContextSetCTR(&one, (const byte*) 0, (size_t) -7) || blockCipherContextSetCTR(&all, (const byte*) 0, (size_t) -7))
+			return -1;
+
+		/* force small chunks on several threads */
+		blockModeParallelSetup(4, 256);
+
+		if (blockCipherContextCTR(&one, mchk, msrc, 101))
+			return -1;
+
+		if (blockCipherContextCTRParallel(&all, mdst, msrc, 100) || blockCipherContextCTR(&all, mdst + 400, msrc + 400, 1))
+			return -1;
+
+		blockModeParallelSetup(0, 0);
+
+		if (memcmp(mdst, mchk, sizeof(mdst)))
+		{
+			printf("failed CTR parallel consistency\n");
+			failures++;
+		}
+
+		blockCipherContextFree(&one);
+		blockCipherContextFree(&all);
+	}
+
 	return failures;
 }
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testbase64.c
+ * \brief Unit test program for base64 encoding and decoding; the lengths
+ *        run through both the vectorized and the byte-wise code.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/base64.h"
+
+struct vector
+{
+	const char*	data;
+	const char*	expect;
+};
+
+#define NVECTORS 7
+
+/* from RFC 4648 */
+struct vector table[NVECTORS] =
+{
+	{ "",       ""         },
+	{ "f",      "Zg=="     },
+	{ "fo",     "Zm8="     },
+	{ "foo",    "Zm9v"     },
+	{ "foob",   "Zm9vYg==" },
+	{ "fooba",  "Zm9vYmE=" },
+	{ "foobar", "Zm9vYmFy" }
+};
+
+#define MAXSIZE 1000
+
+static const char* to_b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* the obvious encoder, one bit at a time, with 76 characters per line */
+static size_t reference(const byte* data, size_t size, char* s)
+{
+	size_t i, chars = 0, len = 0;
+
+	for (i = 0; i < (size * 8 + 5) / 6; i++)
+	{
+		int j, bits = 0;
+
+		for (j = 0; j < 6; j++)
+		{
+			size_t bit = i * 6 + j;
+
+			bits <<= 1;
+			if (bit < size * 8)
+				bits |= (data[bit >> 3] >> (7 - (bit & 7))) & 1;
+		}
+
+		s[len++] = to_b64[bits];
+		if (++chars % 76 == 0)
+			s[len++] = '\n';
+	}
+
+	while (chars % 4)
+	{
+		s[len++] = '=';
+		if (++chars % 76 == 0)
+			s[len++] = '\n';
+	}
+
+	return len;
+}
+
+static int checkvectors()
+{
+	int i, failures = 0;
+	char s[16];
+	byte data[16];
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		size_t slen = sizeof(s), dlen = sizeof(data);
+
+		if (b64encodeto(table[i].data, strlen(table[i].data), s, &slen, 0, (const char*) 0) || (slen != strlen(table[i].expect)) || memcmp(s, table[i].expect, slen))
+		{
+			printf("failed encoding test vector %d\n", i+1);
+			failures++;
+		}
+
+		if (b64decodeto(table[i].expect, strlen(table[i].expect), data, &dlen) || (dlen != strlen(table[i].data)) || memcmp(data, table[i].data, dlen))
+		{
+			printf("failed decoding test vector %d\n", i+1);
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+static int checksizes()
+{
+	static byte data[MAXSIZE], back[2 * MAXSIZE];
+	static char expect[2 * MAXSIZE], s[2 * MAXSIZE];
+	int failures = 0;
+	size_t i, size;
+
+	for (i = 0; i < MAXSIZE; i++)
+		data[i] = (byte) (i * 167 + (i >> 3));
+
+	for (size = 0; size < MAXSIZE; size += (size < 100) ? 1 : 37)
+	{
+		size_t elen = reference(data, size, expect), slen = sizeof(s), dlen = sizeof(back);
+
+		if (b64encodesize(size, 76, "\n") != elen)
+		{
+			printf("wrong encoded size for %u bytes\n", (unsigned) size);
+			failures++;
+		}
+
+		if (b64encodeto(data, size, s, &slen, 76, "\n") || (slen != elen) || memcmp(s, expect, elen))
+		{
+			printf("failed encoding %u bytes\n", (unsigned) size);
+			failures++;
+		}
+
+		/* a buffer of exactly the right size must do, and one less must not */
+		dlen = size;
+		if (b64decodeto(expect, elen, back, &dlen) || (dlen != size) || memcmp(back, data, size))
+		{
+			printf("failed decoding %u bytes\n", (unsigned) size);
+			failures++;
+		}
+
+		dlen = size - 1;
+		if ((size > 0) && (b64decodeto(expect, elen, back, &dlen) == 0))
+		{
+			printf("overran the buffer decoding %u bytes\n", (unsigned) size);
+			failures++;
+		}
+
+		/* an invalid character, anywhere, must be noticed */
+		if (elen > 0)
+		{
+			size_t pos = (size * 31) % elen;
+			char save = expect[pos];
+
+			expect[pos] = '*';
+			dlen = sizeof(back);
+			if (b64decodeto(expect, elen, back, &dlen) == 0)
+			{
+				printf("accepted an invalid character at %u of %u\n", (unsigned) pos, (unsigned) elen);
+				failures++;
+			}
+			expect[pos] = save;
+		}
+	}
+
+	return failures;
+}
+
+/* feeding the input in uneven pieces must not change the result */
+static int checkstreaming()
+{
+	static byte data[MAXSIZE], back[2 * MAXSIZE];
+	static char expect[2 * MAXSIZE], s[2 * MAXSIZE];
+	b64encodeContext ectxt;
+	b64decodeContext dctxt;
+	size_t i, elen, slen = 0, dlen = 0, piece, len;
+	int failures = 0;
+
+	for (i = 0; i < MAXSIZE; i++)
+		data[i] = (byte) (i * 89 + 7);
+
+	elen = reference(data, MAXSIZE, expect);
+
+	b64encodeInit(&ectxt, 76, "\n");
+	for (i = 0, piece = 1; i < MAXSIZE; i += piece, piece = piece * 3 % 67 + 1)
+	{
+		if (piece > MAXSIZE - i)
+			piece = MAXSIZE - i;
+
+		len = sizeof(s) - slen;
+		if (b64encodeUpdate(&ectxt, data + i, piece, s + slen, &len))
+			return 1;
+		slen += len;
+	}
+	len = sizeof(s) - slen;
+	if (b64encodeFinal(&ectxt, s + slen, &len))
+		return 1;
+	slen += len;
+
+	if ((slen != elen) || memcmp(s, expect, elen))
+	{
+		printf("failed streaming encoding\n");
+		failures++;
+	}
+
+	b64decodeInit(&dctxt);
+	for (i = 0, piece = 1; i < elen; i += piece, piece = piece * 5 % 71 + 1)
+	{
+		if (piece > elen - i)
+			piece = elen - i;
+
+		len = sizeof(back) - dlen;
+		if (b64decodeUpdate(&dctxt, expect + i, piece, back + dlen, &len))
+			return 1;
+		dlen += len;
+	}
+	len = sizeof(back) - dlen;
+	if (b64decodeFinal(&dctxt, back + dlen, &len))
+		return 1;
+	dlen += len;
+
+	if ((dlen != MAXSIZE) || memcmp(back, data, MAXSIZE))
+	{
+		printf("failed streaming decoding\n");
+		failures++;
+	}
+
+	return failures;
+}
+
+static int checkmalformed()
+{
+	static const char* bad[] = { "Z", "Zg=", "Zg=a", "Zm9v=", "Zm9vY===", "Zm 9v\n*" };
+	static const char* good[] = { "Zg", "Zm8", " Zm\r\n9v\tYg =\n= " };
+	static const size_t goodlen[] = { 1, 2, 4 };
+	int i, failures = 0;
+	byte data[16];
+	size_t dlen;
+
+	for (i = 0; i < (int) (sizeof(bad) / sizeof(bad[0])); i++)
+	{
+		dlen = sizeof(data);
+		if (b64decodeto(bad[i], strlen(bad[i]), data, &dlen) == 0)
+		{
+			printf("accepted malformed input \"%s\"\n", bad[i]);
+			failures++;
+		}
+	}
+
+	for (i = 0; i < (int) (sizeof(good) / sizeof(good[0])); i++)
+	{
+		dlen = sizeof(data);
+		if (b64decodeto(good[i], strlen(good[i]), data, &dlen) || (dlen != goodlen[i]) || memcmp(data, "foob", dlen))
+		{
+			printf("rejected input \"%s\"\n", good[i]);
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+static int checklegacy()
+{
+	/* b64dec keeps decoding the way it always did */
+	static const char* input[] = { "QUJ", "QUJDRA", "QQ=", "QUI=", "Zm9v\nYmFy", "QQ==A" };
+	static const int expect[] = { 0, 3, 1, 2, 6, -1 };
+	int i, failures = 0;
+	void* data;
+	size_t dlen;
+
+	for (i = 0; i < (int) (sizeof(input) / sizeof(input[0])); i++)
+	{
+		memchunk* chunk = b64dec(input[i]);
+
+		if ((chunk ? (int) chunk->size : -1) != expect[i])
+		{
+			printf("failed b64dec \"%s\"\n", input[i]);
+			failures++;
+		}
+		if (chunk)
+			memchunkFree(chunk);
+	}
+
+	/* b64decode wants whole groups, and '=' only as padding */
+	if (b64decode("QUJ", &data, &dlen) != 2)
+	{
+		printf("failed b64decode of a partial group\n");
+		failures++;
+	}
+	if (b64decode("QQ=A", &data, &dlen) != 3)
+	{
+		printf("failed b64decode of misplaced padding\n");
+		failures++;
+	}
+	if (b64decode("QUI=", &data, &dlen) || (dlen != 2) || memcmp(data, "AB", 2))
+	{
+		printf("failed b64decode\n");
+		failures++;
+	}
+	else
+		free(data);
+
+	return failures;
+}
+
+int main()
+{
+	int failures = 0;
+	char* s;
+
+	failures += checkvectors();
+	failures += checksizes();
+	failures += checkstreaming();
+	failures += checkmalformed();
+	failures += checklegacy();
+
+	/* the allocating encoder terminates the last line */
+	s = b64encode("foobar!", 0);
+	if ((s == (char*) 0) || strcmp(s, "Zm9vYmFyIQ==\n"))
+	{
+		printf("failed b64encode\n");
+		failures++;
+	}
+	free(s);
+
+	return failures;
+}
@@ -54,6 +54,149 @@ int main()
 			failures++;
 		}
 
+		/* powers of g from the precomputed table must match, also for
+		 * exponents larger than the table covers
+		 */
+		if (dldp_pPrecompute(&params) == 0)
+		{
+			mpnumber x, y;
+			int i;
+
+			mpnzero(&x);
+			mpnzero(&y);
+
+			for (i = 0; i < 8; i++)
+			{
+				if (i < 6)
+					mpbnrnd(&params.q, &rngc, &x);
+				else
+					mpbnrnd(&params.p, &rngc, &x);
+
+				dldp_pPublic(&params, &x, &y);
+				mpbnpowmod(&params.p, &params.g, &x, &gq);
+
+				if (mpnex(y.size, y.data, gq.size, gq.data))
+				{
+					printf("failed test vector 2\n");
+					failures++;
+					break;
+				}
+			}
+
+			mpnfree(&y);
+			mpnfree(&x);
+
+			/* the table may not be used for a different modulus of the same size */
+			{
+				mpbarrett b;
+
+				mpbzero(&b);
+				mpbcopy(&b, &params.p);
+				mpsubw(b.size, b.modl, 2);
+
+				if (mpbfbmatch(&params.gfb, &b, params.g.size, params.g.data) || !mpbfbmatch(&params.gfb, &params.p, params.g.size, params.g.data))
+				{
+					printf("failed test vector 2\n");
+					failures++;
+				}
+
+				mpbfree(&b);
+			}
+		}
+		else
+		{
+			printf("failed test vector 2\n");
+			failures++;
+		}
+
+		/* simultaneous exponentiation must match the product of separate
+		 * exponentiations
+		 */
+		{
+			mpnumber x[3], e[3], t[3], v;
+			int i, j;
+
+			mpnzero(&v);
+			for (j = 0; j < 3; j++)
+			{
+				mpnzero(&x[j]);
+				mpnzero(&e[j]);
+				mpnzero(&t[j]);
+			}
+
+			for (i = 0; i < 4; i++)
+			{
+				for (j = 0; j < 3; j++)
+				{
+					mpbnrnd(&params.p, &rngc, &x[j]);
+					/* vary the lengths of the exponents */
+					mpbnrnd((i+j) & 1 ? &params.q : &params.p, &rngc, &e[j]);
+					mpbnpowmod(&params.p, &x[j], &e[j], &t[j]);
+				}
+
+				mpbnmulmod(&params.p, &t[0], &t[1], &gq);
+				mpbsm2powmod(&params.p, &x[0], &e[0], &x[1], &e[1], &v);
+
+				if (mpnex(v.size, v.data, gq.size, gq.data))
+				{
+					printf("failed test vector 3\n");
+					failures++;
+					break;
+				}
+
+				mpbnmulmod(&params.p, &gq, &t[2], &t[0]);
+				mpbsm3powmod(&params.p, &x[0], &e[0], &x[1], &e[1], &x[2], &e[2], &v);
+
+				if (mpnex(v.size, v.data, t[0].size, t[0].data))
+				{
+					printf("failed test vector 4\n");
+					failures++;
+					break;
+				}
+			}
+
+			mpnfree(&v);
+			for (j = 0; j < 3; j++)
+			{
+				mpnfree(&x[j]);
+				mpnfree(&e[j]);
+				mpnfree(&t[j]);
+			}
+		}
+
+		/* parameters found by racing workers must be just as valid */
+		{
+			dldp_p race;
+
+			dldp_pInit(&race);
+
+			if (dldp_pgonMakeSafeParallel(&race, &rngc, 512, 4) || (mpbbits(&race.p) != 512) || (dldp_pgonValidate(&race, &rngc) != 1))
+			{
+				printf("failed test vector 5\n");
+				failures++;
+			}
+
+			dldp_pFree(&race);
+			dldp_pInit(&race);
+
+			if (dldp_pgoqMakeParallel(&race, &rngc, 1024, 160, 1, 4) || (dldp_pgoqValidate(&race, &rngc, 1) != 1))
+			{
+				printf("failed test vector 6\n");
+				failures++;
+			}
+			else
+			{
+				mpbnpowmod(&race.p, &race.g, (mpnumber*) &race.q, &gq);
+				if (!mpisone(gq.size, gq.data))
+				{
+					printf("failed test vector 6\n");
+					failures++;
+				}
+			}
+
+			dldp_pFree(&race);
+		}
+
 		mpnfree(&gq);
 
 		dldp_pFree(&params);
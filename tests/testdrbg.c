@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testdrbg.c
+ * \brief Unit test program for the CTR_DRBG and HMAC_DRBG generators; the
+ *        first vector of each comes from the NIST CAVP test files, the
+ *        others exercise personalization, reseeding, additional input and
+ *        the limits of a request.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/ctrdrbg.h"
+#include "beecrypt/hmacdrbg.h"
+
+extern int fromhex(byte*, const char*);
+
+struct vector
+{
+	const char*	entropy;
+	const char*	nonce;
+	size_t		size;
+	const char*	expect;
+};
+
+/* instantiate, generate twice, and check the second result */
+static struct vector ctrnist =
+{
+	"36401940fa8b1fba91a1661f211d78a0b9389a74e5bccfece8d766af1a6d3b14",
+	"496f25b0f1301b4f501be30380a137eb",
+	64,
+	"5862eb38bd558dd978a696e6df164782ddd887e7e9a6c9f3f1fbafb78941b535a64912dfd224c6dc7454e5250b3d97165e16260c2faf1cc7735cb75fb4f07e1d"
+};
+
+static struct vector hmacnist =
+{
+	"ca851911349384bffe89de1cbdc46e6831e44d34a4fb935ee285dd14b71a7488",
+	"659ba96c601dc69fc902940805ec0ca8",
+	128,
+	"e528e9abf2dece54d47c7e75e5fe302149f817ea9fb4bee6f4199697d04d5b89d54fbb978a15b5c443c9ec21036d2460b6f73ebad0dc2aba6e624abf07745bc107694bb7547bb0995f70de25d6b29e2d3011bb19d27676c07162c8b5ccde0668961df86803482cb37ed6d5c0bb8d50cf1f50d476aa0458bdaba806f48be9dcb8"
+};
+
+/* instantiate with personalization, reseed with additional input, generate
+ * with additional input, and check a second generate, into an unaligned
+ * buffer
+ */
+static const char* ctrmixed = "4e6e19e8523cd75b3a3e79714031c488f4cff995e5a80399eb316643f1a0887b65e9a0ed38ac40f38a9afc8a0bc21d3e88d63c027515b65bdcf5664d8737cbbb1081c3c23108cc4cdaff5c69fca1b10881f021ab23a4468c241d481b9a8907175901274e";
+static const char* hmacmixed = "07bc9daf0bb21958efd21cd88df82ee41b421dca41ae37cd5950ccec3ad1674ccbc3403e8324e5beab3c20b560f64a12f9f51535fc57c9da7600620afa358054c7097f80f2358d356e18793dc94b79752697546db1827b42203c1d5620831dcddfcd4932";
+
+/* the last sixteen bytes of the largest request */
+static const char* ctrlarge = "c2fb839ee5434947c2786b5c204b3ef9";
+static const char* hmaclarge = "7eceb3e1f4cac004117787fc8dda51ca";
+
+static byte entropy[32], entropy2[32], nonce[16];
+static const byte pers[] = "beecrypt";
+static const byte add[] = "additional input";
+
+static byte output[65536 + 1];
+static byte expect[128];
+
+static void setup(void)
+{
+	int i;
+
+	for (i = 0; i < 32; i++)
+	{
+		entropy[i] = (byte) (0x20 + i);
+		entropy2[i] = (byte) (0x80 + i);
+	}
+	for (i = 0; i < 16; i++)
+		nonce[i] = (byte) (0x40 + i);
+}
+
+static int testctrdrbg(void)
+{
+	int failures = 0;
+	byte e[32], n[16];
+	randomGeneratorContext rngc;
+	ctrdrbgParam* dp;
+
+	/* the context allocates the parameters, since their layout depends on
+	 * the library's threading configuration
+	 */
+	if (randomGeneratorContextInit(&rngc, &ctrdrbg))
+		return -1;
+
+	dp = (ctrdrbgParam*) rngc.param;
+
+	fromhex(e, ctrnist.entropy);
+	fromhex(n, ctrnist.nonce);
+	fromhex(expect, ctrnist.expect);
+
+	if (ctrdrbgInstantiate(dp, e, 32, n, 16, (const byte*) 0, 0))
+		return -1;
+	if (ctrdrbgGenerate(dp, output, ctrnist.size, (const byte*) 0, 0))
+		return -1;
+	if (ctrdrbgGenerate(dp, output, ctrnist.size, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output, expect, ctrnist.size))
+	{
+		printf("failed CTR_DRBG test vector\n");
+		failures++;
+	}
+
+	fromhex(expect, ctrmixed);
+
+	if (ctrdrbgInstantiate(dp, entropy, 32, nonce, 16, pers, 8))
+		return -1;
+	if (ctrdrbgReseed(dp, entropy2, 32, add, 16))
+		return -1;
+	if (ctrdrbgGenerate(dp, output, 100, add, 16))
+		return -1;
+	if (ctrdrbgGenerate(dp, output+1, 100, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output+1, expect, 100))
+	{
+		printf("failed CTR_DRBG reseed test\n");
+		failures++;
+	}
+
+	fromhex(expect, ctrlarge);
+
+	if (ctrdrbgInstantiate(dp, entropy, 32, nonce, 16, (const byte*) 0, 0))
+		return -1;
+	if (ctrdrbgGenerate(dp, output, CTRDRBG_MAX_REQUEST, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output+CTRDRBG_MAX_REQUEST-16, expect, 16))
+	{
+		printf("failed CTR_DRBG large request\n");
+		failures++;
+	}
+	if (ctrdrbgGenerate(dp, output, CTRDRBG_MAX_REQUEST+1, (const byte*) 0, 0) == 0)
+	{
+		printf("failed CTR_DRBG oversized request\n");
+		failures++;
+	}
+
+	randomGeneratorContextFree(&rngc);
+
+	return failures;
+}
+
+static int testhmacdrbg(void)
+{
+	int failures = 0;
+	byte e[32], n[16];
+	randomGeneratorContext rngc;
+	hmacdrbgParam* dp;
+
+	/* the context allocates the parameters, since their layout depends on
+	 * the library's threading configuration
+	 */
+	if (randomGeneratorContextInit(&rngc, &hmacdrbg))
+		return -1;
+
+	dp = (hmacdrbgParam*) rngc.param;
+
+	fromhex(e, hmacnist.entropy);
+	fromhex(n, hmacnist.nonce);
+	fromhex(expect, hmacnist.expect);
+
+	if (hmacdrbgInstantiate(dp, e, 32, n, 16, (const byte*) 0, 0))
+		return -1;
+	if (hmacdrbgGenerate(dp, output, hmacnist.size, (const byte*) 0, 0))
+		return -1;
+	if (hmacdrbgGenerate(dp, output, hmacnist.size, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output, expect, hmacnist.size))
+	{
+		printf("failed HMAC_DRBG test vector\n");
+		failures++;
+	}
+
+	fromhex(expect, hmacmixed);
+
+	if (hmacdrbgInstantiate(dp, entropy, 32, nonce, 16, pers, 8))
+		return -1;
+	if (hmacdrbgReseed(dp, entropy2, 32, add, 16))
+		return -1;
+	if (hmacdrbgGenerate(dp, output, 100, add, 16))
+		return -1;
+	if (hmacdrbgGenerate(dp, output+1, 100, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output+1, expect, 100))
+	{
+		printf("failed HMAC_DRBG reseed test\n");
+		failures++;
+	}
+
+	fromhex(expect, hmaclarge);
+
+	if (hmacdrbgInstantiate(dp, entropy, 32, nonce, 16, (const byte*) 0, 0))
+		return -1;
+	if (hmacdrbgGenerate(dp, output, HMACDRBG_MAX_REQUEST, (const byte*) 0, 0))
+		return -1;
+	if (memcmp(output+HMACDRBG_MAX_REQUEST-16, expect, 16))
+	{
+		printf("failed HMAC_DRBG large request\n");
+		failures++;
+	}
+	if (hmacdrbgGenerate(dp, output, HMACDRBG_MAX_REQUEST+1, (const byte*) 0, 0) == 0)
+	{
+		printf("failed HMAC_DRBG oversized request\n");
+		failures++;
+	}
+
+	randomGeneratorContextFree(&rngc);
+
+	return failures;
+}
+
+int main()
+{
+	int i, failures = 0;
+	const char* names[2] = { "CTR_DRBG AES-256", "HMAC_DRBG SHA-256" };
+
+	setup();
+
+	failures += testctrdrbg();
+	failures += testhmacdrbg();
+
+	/* through the generic interface, a request beyond the limit of a
+	 * single generate call is split up
+	 */
+	for (i = 0; i < 2; i++)
+	{
+		randomGeneratorContext rngc;
+
+		if (randomGeneratorContextInit(&rngc, randomGeneratorFind(names[i])))
+			return -1;
+
+		if (randomGeneratorContextSeed(&rngc, add, 16))
+			return -1;
+
+		memset(output, 0, sizeof(output));
+		if (randomGeneratorContextNext(&rngc, output, sizeof(output)))
+		{
+			printf("failed %s context\n", names[i]);
+			failures++;
+		}
+
+		randomGeneratorContextFree(&rngc);
+	}
+
+	return failures;
+}
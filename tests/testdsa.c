@@ -28,6 +28,7 @@
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/dlkp.h"
 #include "beecrypt/dsa.h"
+#include "beecrypt/mpmont.h"
 
 struct vector
 {
@@ -65,6 +66,10 @@ int main()
 
 	dlkp_p keypair;
 	mpnumber hm, r, s, k, e_r, e_s;
+	randomGeneratorContext rngc;
+
+	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()))
+		return -1;
 
 	for (i = 0; i < NVECTORS; i++)
 	{
@@ -91,6 +96,55 @@ int main()
 		if (!dsavrfy(&keypair.param.p, &keypair.param.q, &keypair.param.g, &hm, &keypair.y, &e_r, &e_s))
 			failures++;
 
+		/* second test, sign with a precomputed table of powers of g and a
+		 * fresh key, then verify
+		 */
+		if (dldp_pPrecompute(&keypair.param) == 0)
+		{
+			dldp_pPair(&keypair.param, &rngc, &keypair.x, &keypair.y);
+
+			if (dsasignfb(&keypair.param.p, &keypair.param.q, &keypair.param.gfb, &rngc, &hm, &keypair.x, &r, &s))
+				failures++;
+			else if (!dsavrfy(&keypair.param.p, &keypair.param.q, &keypair.param.g, &hm, &keypair.y, &r, &s))
+				failures++;
+		}
+		else
+			failures++;
+
+		/* third test, sign through the Montgomery engine, then verify */
+		mpengineSetup(MP_ENGINE_MONTGOMERY);
+
+		if (dsasign(&keypair.param.p, &keypair.param.q, &keypair.param.g, &rngc, &hm, &keypair.x, &r, &s))
+			failures++;
+		else if (!dsavrfy(&keypair.param.p, &keypair.param.q, &keypair.param.g, &hm, &keypair.y, &r, &s))
+			failures++;
+
+		mpengineSetup(MP_ENGINE_BARRETT);
+
+		/* fourth test, sign again into the same r and s with our own
+		 * workspace; this may not reallocate them
+		 */
+		{
+			size_t psize = keypair.param.p.size, qsize = keypair.param.q.size;
+			mpw* wksp = (mpw*) malloc(((6*psize+2)+(9*qsize+6)) * sizeof(mpw));
+			mpw* rdata = r.data;
+			mpw* sdata = s.data;
+
+			if (wksp == (mpw*) 0)
+				failures++;
+			else
+			{
+				if (dsasign_w(&keypair.param.p, &keypair.param.q, &keypair.param.g, &rngc, &hm, &keypair.x, &r, &s, wksp))
+					failures++;
+				else if (r.data != rdata || s.data != sdata)
+					failures++;
+				else if (!dsavrfy_w(&keypair.param.p, &keypair.param.q, &keypair.param.g, &hm, &keypair.y, &r, &s, wksp))
+					failures++;
+
+				free(wksp);
+			}
+		}
+
 		mpnfree(&s);
 		mpnfree(&r);
 
@@ -102,5 +156,7 @@ int main()
 		dlkp_pFree(&keypair);
 	}
 
+	randomGeneratorContextFree(&rngc);
+
 	return failures;
 }
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testentropy.c
+ * \brief Unit test program for the entropy sources; it checks that
+ *        requests of every size are filled, and never twice the same.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+
+#define MAXSIZE 300
+
+static int check(const entropySource* es)
+{
+	byte prev[MAXSIZE], next[MAXSIZE];
+	int failures = 0;
+	size_t size;
+
+	/* these sizes run through the pool's refills, and past its size */
+	for (size = 8; size <= MAXSIZE; size += 7)
+	{
+		memset(prev, 0, size);
+		memset(next, 0, size);
+
+		if (es->next(prev, size) || es->next(next, size))
+		{
+			printf("entropy source %s failed for %u bytes\n", es->name, (unsigned) size);
+			return 1;
+		}
+
+		if (memcmp(prev, next, size) == 0)
+		{
+			printf("entropy source %s repeated itself for %u bytes\n", es->name, (unsigned) size);
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+int main()
+{
+	const entropySource* es = entropySourceFind("getrandom");
+	byte data[16];
+	int failures = 0;
+
+	/* not every system has this source */
+	if (es)
+		failures += check(es);
+
+	if (entropyGatherNext(data, sizeof(data)))
+	{
+		printf("entropyGatherNext failed\n");
+		failures++;
+	}
+
+	return failures;
+}
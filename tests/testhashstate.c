@@ -0,0 +1,178 @@
+/*
+ * testhashstate.c
+ *
+ * Unit test program for saving and restoring the state of a hash computation
+ * in progress, for every registered hash function.
+ *
+ * Copyright (c) 2026 Bob Deblier <bob.deblier@telenet.be>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "beecrypt/md4.h"
+#include "beecrypt/md5.h"
+#include "beecrypt/ripemd128.h"
+#include "beecrypt/ripemd160.h"
+#include "beecrypt/ripemd256.h"
+#include "beecrypt/ripemd320.h"
+#include "beecrypt/sha1.h"
+#include "beecrypt/sha224.h"
+#include "beecrypt/sha256.h"
+#include "beecrypt/sha384.h"
+#include "beecrypt/sha512.h"
+
+/* where each hash function keeps the number of buffered bytes */
+struct layout
+{
+	const hashFunction*	algo;
+	size_t				offset;
+	size_t				size;
+};
+
+struct layout table[11] = {
+	{ &md4,       offsetof(md4Param,       offset), sizeof(uint32_t) },
+	{ &md5,       offsetof(md5Param,       offset), sizeof(uint32_t) },
+	{ &ripemd128, offsetof(ripemd128Param, offset), sizeof(uint32_t) },
+	{ &ripemd160, offsetof(ripemd160Param, offset), sizeof(uint32_t) },
+	{ &ripemd256, offsetof(ripemd256Param, offset), sizeof(uint32_t) },
+	{ &ripemd320, offsetof(ripemd320Param, offset), sizeof(uint32_t) },
+	{ &sha1,      offsetof(sha1Param,      offset), sizeof(uint32_t) },
+	{ &sha224,    offsetof(sha224Param,    offset), sizeof(uint32_t) },
+	{ &sha256,    offsetof(sha256Param,    offset), sizeof(uint32_t) },
+	{ &sha384,    offsetof(sha384Param,    offset), sizeof(uint64_t) },
+	{ &sha512,    offsetof(sha512Param,    offset), sizeof(uint64_t) }
+};
+
+/* overwrites the buffered byte count inside a serialized state */
+static void tamper(byte* state, size_t statesize, const struct layout* l, uint64_t value)
+{
+	byte* param = state + statesize - l->algo->paramsize;
+
+	if (l->size == sizeof(uint32_t))
+	{
+		uint32_t v = (uint32_t) value;
+		memcpy(param + l->offset, &v, sizeof(v));
+	}
+	else
+		memcpy(param + l->offset, &value, sizeof(value));
+}
+
+int main()
+{
+	int i, j, failures = 0;
+
+	byte message[300];
+	byte expect[64], digest[64];
+	byte* state;
+
+	for (i = 0; i < sizeof(message); i++)
+		message[i] = (byte) (i * 37 + 11);
+
+	for (i = 0; i < hashFunctionCount(); i++)
+	{
+		const hashFunction* hf = hashFunctionGet(i);
+		const struct layout* l = (const struct layout*) 0;
+		hashFunctionContext ctxt, restored;
+		size_t statesize;
+
+		for (j = 0; j < 11; j++)
+			if (table[j].algo == hf)
+				l = table+j;
+
+		if (l == (const struct layout*) 0)
+		{
+			printf("no layout for %s\n", hf->name);
+			failures++;
+			continue;
+		}
+
+		if (hashFunctionContextInit(&ctxt, hf))
+			return -1;
+		if (hashFunctionContextUpdate(&ctxt, message, sizeof(message)))
+			return -1;
+		if (hashFunctionContextDigest(&ctxt, expect))
+			return -1;
+
+		/* save the state halfway through a block */
+		if (hashFunctionContextUpdate(&ctxt, message, 100))
+			return -1;
+
+		statesize = hashFunctionContextStateSize(&ctxt);
+		state = (byte*) malloc(statesize);
+		if (state == (byte*) 0)
+			return -1;
+		if (hashFunctionContextSerialize(&ctxt, state, statesize))
+			return -1;
+
+		if (hashFunctionContextInit(&restored, hf))
+			return -1;
+		if (hashFunctionContextDeserialize(&restored, state, statesize))
+		{
+			printf("failed to restore %s\n", hf->name);
+			failures++;
+		}
+		else
+		{
+			if (hashFunctionContextUpdate(&restored, message+100, sizeof(message)-100))
+				return -1;
+			if (hashFunctionContextDigest(&restored, digest))
+				return -1;
+			if (memcmp(digest, expect, hf->digestsize))
+			{
+				printf("failed restored state of %s\n", hf->name);
+				failures++;
+			}
+		}
+
+		/* a tampered state is rejected, and leaves the context alone */
+		if (hashFunctionContextUpdate(&restored, message, 100))
+			return -1;
+
+		tamper(state, statesize, l, hf->blocksize);
+		if (hashFunctionContextDeserialize(&restored, state, statesize) != -1)
+		{
+			printf("failed to reject an offset of one block in %s\n", hf->name);
+			failures++;
+		}
+
+		tamper(state, statesize, l, (uint64_t) -1);
+		if (hashFunctionContextDeserialize(&restored, state, statesize) != -1)
+		{
+			printf("failed to reject a huge offset in %s\n", hf->name);
+			failures++;
+		}
+
+		if (hashFunctionContextUpdate(&restored, message+100, sizeof(message)-100))
+			return -1;
+		if (hashFunctionContextDigest(&restored, digest))
+			return -1;
+		if (memcmp(digest, expect, hf->digestsize))
+		{
+			printf("failed state after rejecting %s\n", hf->name);
+			failures++;
+		}
+
+		free(state);
+
+		hashFunctionContextFree(&restored);
+		hashFunctionContextFree(&ctxt);
+	}
+
+	return failures;
+}
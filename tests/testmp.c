@@ -2,6 +2,7 @@
 
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/mp.h"
+#include "beecrypt/mpnumber.h"
 
 #define INIT	0xdeadbeefU;
 
@@ -10,6 +11,10 @@ static const mpw F[4] = { MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK};
 static const mpw P[8] = { MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK-1U, 0U, 0U, 0U, 1U };
 static const mpw SM[5] = { MP_ALLMASK-1U, MP_ALLMASK, MP_ALLMASK, MP_ALLMASK, 1U };
 
+#define KSIZE	100
+
+static mpw kx[KSIZE], ky[KSIZE], kr[2*KSIZE], ks[2*KSIZE], kw[6*KSIZE];
+
 int main()
 {
 	int i, carry;
@@ -119,5 +124,65 @@ int main()
 		return 1;
 	}
 
+	/* Karatsuba: (B^n-1)^2 = B^2n - 2*B^n + 1 */
+	mpkaratsubaSetup(MP_KARATSUBA_MIN_THRESHOLD, MP_KARATSUBA_MIN_THRESHOLD);
+
+	mpfill(KSIZE, kx, MP_ALLMASK);
+	mpfill(KSIZE, ks, MP_ALLMASK);
+	mpzero(KSIZE, ks+KSIZE);
+	ks[KSIZE-1] = MP_ALLMASK-1U;
+	ks[2*KSIZE-1] = 1U;
+
+	mpmul_w(kr, KSIZE, kx, KSIZE, kx, kw);
+	if (!mpeq(2*KSIZE, kr, ks))
+	{
+		printf("mpmul_w failed\n");
+		return 1;
+	}
+
+	mpsqr_w(kr, KSIZE, kx, kw);
+	if (!mpeq(2*KSIZE, kr, ks))
+	{
+		printf("mpsqr_w failed\n");
+		return 1;
+	}
+
+	/* unbalanced Karatsuba against the schoolbook method */
+	for (i = 0; i < KSIZE; i++)
+	{
+		kx[i] = (mpw) 0x9e3779b97f4a7c15ULL * (i+1);
+		ky[i] = (mpw) 0xc2b2ae3d27d4eb4fULL * (i+7);
+	}
+
+	mpmul_w(kr, KSIZE, kx, 37, ky, kw);
+
+	mpkaratsubaSetup((size_t) -1, (size_t) -1);
+
+	mpmul(ks, KSIZE, kx, 37, ky);
+	if (!mpeq(KSIZE+37, kr, ks))
+	{
+		printf("unbalanced mpmul_w failed\n");
+		return 1;
+	}
+
+	mpkaratsubaSetup(MP_KARATSUBA_MUL_THRESHOLD, MP_KARATSUBA_SQR_THRESHOLD);
+
+	/* shrinking a number keeps its least significant words */
+	{
+		mpnumber n;
+
+		mpnzero(&n);
+		mpnset(&n, 8, P);
+		mpnsize(&n, 6);
+
+		if (n.size != 6 || !mpeq(6, n.data, P+2))
+		{
+			printf("mpnsize failed\n");
+			return 1;
+		}
+
+		mpnfree(&n);
+	}
+
 	return 0;
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testpkcs12.c
+ * \brief Unit test program for PKCS#12 key derivation; the vectors pin
+ *        down the output which existing keystores depend on.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/pkcs12.h"
+
+extern int fromhex(byte*, const char*);
+
+struct vector
+{
+	const char*	hash;
+	byte		id;
+	size_t		iterations;
+	const char*	expect;
+};
+
+#define NVECTORS 8
+
+struct vector table[NVECTORS] =
+{
+	{ "MD5",        PKCS12_ID_CIPHER,    1, "0fb8580e899ee6e33d8f26c991100bd20fb8580e899ee6e33d8f26c991100bd20fb8580e899ee6e3" },
+	{ "MD5",        PKCS12_ID_MAC,    1000, "968f1915fd362e917566a7f6ea980ce2968f1915fd362e917566a7f6ea980ce2968f1915fd362e91" },
+	{ "SHA-1",      PKCS12_ID_IV,     1000, "22f481911d97973b0cd629fec54103ac76efd7d422f481911d97973b0cd629fec54103ac76efd7d4" },
+	{ "SHA-256",    PKCS12_ID_CIPHER, 1000, "c564f55ea2d69dfbab86603acb190795a116d65868d81d40c3454e6a5f485424c564f55ea2d69dfb" },
+	{ "SHA-384",    PKCS12_ID_MAC,    1000, "c427a213b6d5302ae146271b55759903805e5b4f8a916c154c6be15e18871f91239562259b81734a" },
+	{ "SHA-512",    PKCS12_ID_IV,     1000, "33acc641abe567679cd93ef11edab5409c8d427c3cb379476c4b6b7f56d80ac28184b15b072c260b" },
+	{ "RIPEMD-160", PKCS12_ID_CIPHER,    1, "8d4c249927e3c5e6ed3d8af30124b5b49aa7f26a8d4c249927e3c5e6ed3d8af30124b5b49aa7f26a" },
+	{ "RIPEMD-160", PKCS12_ID_MAC,    1000, "b6718eac0b2e4d53fff15c0d639c14fd9cf1a717b6718eac0b2e4d53fff15c0d639c14fd9cf1a717" }
+};
+
+static const byte password[] = { 0, 's', 0, 'm', 0, 'e', 0, 'g', 0, 0 };
+static const byte salt[] = { 0x0a, 0x58, 0xcf, 0x64, 0x53, 0x0d, 0x82, 0x3f };
+
+int main()
+{
+	int i, j, failures = 0;
+	byte expect[40], key[40];
+
+	for (i = 0; i < NVECTORS; i++)
+	{
+		const hashFunction* h = hashFunctionFind(table[i].hash);
+
+		if (h == (const hashFunction*) 0)
+			return -1;
+
+		fromhex(expect, table[i].expect);
+
+		if (pkcs12_derive_key(h, table[i].id, password, sizeof(password), salt, sizeof(salt), table[i].iterations, key, sizeof(key)))
+			return -1;
+
+		if (memcmp(key, expect, sizeof(key)))
+		{
+			printf("failed test vector %d\n", i+1);
+			failures++;
+		}
+	}
+
+	/* deriving several keys at once must give the same result as one at a time */
+	for (i = 0; i < NVECTORS; i++)
+	{
+		const hashFunction* h = hashFunctionFind(table[i].hash);
+		const byte ids[3] = { PKCS12_ID_CIPHER, PKCS12_ID_MAC, PKCS12_ID_IV };
+		byte keys[3][40];
+		byte* const ndata[3] = { keys[0], keys[1], keys[2] };
+		const size_t nsize[3] = { 32, 40, 16 };
+
+		if (pkcs12_derive_keys(h, password, sizeof(password), salt, sizeof(salt), table[i].iterations, 3, ids, ndata, nsize))
+			return -1;
+
+		for (j = 0; j < 3; j++)
+		{
+			if (pkcs12_derive_key(h, ids[j], password, sizeof(password), salt, sizeof(salt), table[i].iterations, key, nsize[j]))
+				return -1;
+
+			if (memcmp(key, keys[j], nsize[j]))
+			{
+				printf("failed batch derivation %d of test vector %d\n", j+1, i+1);
+				failures++;
+			}
+		}
+	}
+
+	return failures;
+}
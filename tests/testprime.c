@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testprime.c
+ * \brief Unit test program for probable prime generation; checks the
+ *        properties of the generated primes, and that the outcome does
+ *        not depend on the number of threads.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/mpprime.h"
+
+/* a reproducible stream of bits, so that runs can be compared */
+static int testrngNext(randomGeneratorParam* param, byte* data, size_t size)
+{
+	uint64_t* state = (uint64_t*) param;
+
+	while (size--)
+	{
+		*state ^= *state << 13;
+		*state ^= *state >> 7;
+		*state ^= *state << 17;
+		*(data++) = (byte)(*state >> 24);
+	}
+	return 0;
+}
+
+static const randomGenerator testrng = { "test", sizeof(uint64_t), 0, 0, (randomGeneratorNext) testrngNext, 0 };
+
+static int isprime(const mpbarrett* p, randomGeneratorContext* rc)
+{
+	register size_t size = p->size;
+	register mpw* temp = (mpw*) malloc((8*size+2) * sizeof(mpw));
+	int rv;
+
+	if (temp == (mpw*) 0)
+		return 0;
+
+	rv = mppmilrab_w(p, rc, 32, temp);
+
+	free(temp);
+
+	return rv;
+}
+
+int main()
+{
+	int failures = 0;
+	size_t bits[4] = { 24, 160, 512, 1024 };
+	randomGeneratorContext rc;
+	randomGeneratorContext tc;
+	uint64_t state;
+	mpbarrett p, q;
+	mpnumber min, max, f;
+	mpw* temp;
+	int i;
+
+	if (randomGeneratorContextInit(&rc, randomGeneratorDefault()))
+		return -1;
+
+	tc.rng = &testrng;
+	tc.param = (randomGeneratorParam*) &state;
+
+	temp = (mpw*) malloc((8*MP_BITS_TO_WORDS(1024 + MP_WBITS - 1)+2) * sizeof(mpw));
+	if (temp == (mpw*) 0)
+		return -1;
+
+	mpbzero(&p);
+	mpbzero(&q);
+	mpnzero(&min);
+	mpnzero(&max);
+	mpnzero(&f);
+
+	for (i = 0; i < 4; i++)
+	{
+		/* the same stream must give the same prime, however many threads search */
+		mpprimeParallelSetup(1);
+		state = 0x0123456789abcdefULL + i;
+		if (mpprnd_w(&p, &tc, bits[i], mpptrials(bits[i]), (const mpnumber*) 0, temp))
+			return -1;
+
+		mpprimeParallelSetup(4);
+		state = 0x0123456789abcdefULL + i;
+		if (mpprnd_w(&q, &tc, bits[i], mpptrials(bits[i]), (const mpnumber*) 0, temp))
+			return -1;
+
+		if (mpbits(p.size, p.modl) != bits[i] || !isprime(&p, &rc))
+		{
+			printf("failed prime of %u bits\n", (unsigned) bits[i]);
+			failures++;
+		}
+
+		if (p.size != q.size || mpne(p.size, p.modl, q.modl))
+		{
+			printf("failed threaded prime of %u bits\n", (unsigned) bits[i]);
+			failures++;
+		}
+	}
+
+	mpprimeParallelSetup(0);
+
+	/* a prime in a range, with p-1 coprime to f */
+	mpnsethex(&min, "c0000000000000000000000000000000000000000000000000000000000000000000000000000000");
+	mpnsethex(&max, "dfffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+	mpnsetw(&f, 65537);
+
+	for (i = 0; i < 4; i++)
+	{
+		mpw x[MP_BITS_TO_WORDS(320)], y[MP_BITS_TO_WORDS(320)], g[MP_BITS_TO_WORDS(320)];
+
+		if (mpprndr_w(&p, &rc, 320, mpptrials(320), &min, &max, &f, temp))
+			return -1;
+
+		mpcopy(p.size, x, p.modl);
+		mpsubw(p.size, x, 1);
+		mpsetx(p.size, y, f.size, f.data);
+		mpgcd_w(p.size, x, y, g, temp);
+
+		if (mpltx(p.size, p.modl, min.size, min.data) || mpgtx(p.size, p.modl, max.size, max.data) || !mpisone(p.size, g) || !isprime(&p, &rc))
+		{
+			printf("failed ranged prime %d\n", i+1);
+			failures++;
+		}
+	}
+
+	/* a safe prime, p = 2q+1 */
+	mpprndsafe_w(&p, &rc, 256, mpptrials(256), temp);
+
+	mpcopy(p.size, temp, p.modl);
+	mpdivtwo(p.size, temp);
+	mpbset(&q, p.size, temp);
+
+	if (mpbits(p.size, p.modl) != 256 || !isprime(&p, &rc) || !isprime(&q, &rc))
+	{
+		printf("failed safe prime\n");
+		failures++;
+	}
+
+	mpbfree(&p);
+	mpbfree(&q);
+	mpnfree(&min);
+	mpnfree(&max);
+	mpnfree(&f);
+
+	free(temp);
+
+	randomGeneratorContextFree(&rc);
+
+	return failures;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 Bob Deblier
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*!\file testprng.c
+ * \brief Unit test program for the per-thread random generators; it checks
+ *        that threads, and a parent and its forked child, get different
+ *        output, and that requests are filled completely.
+ * \author Bob Deblier <bob.deblier@telenet.be>
+ * \ingroup UNIT_m
+ */
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "beecrypt/beecrypt.h"
+#include "beecrypt/fips186.h"
+#include "beecrypt/mtprng.h"
+
+#if defined(_REENTRANT) && HAVE_PTHREAD_H
+# include <pthread.h>
+# define TEST_THREADS	1
+#endif
+
+#if ENABLE_THREAD_LOCAL_STORAGE && defined(_REENTRANT) && HAVE_PTHREAD_H && HAVE_UNISTD_H && HAVE_SYS_WAIT_H
+# include <unistd.h>
+# include <sys/wait.h>
+# define TEST_FORK	1
+#endif
+
+#define SIZE 64
+
+static int generate(const randomGenerator* rng, byte* data, size_t size)
+{
+	randomGeneratorContext rngc;
+	int rc;
+
+	if (randomGeneratorContextInit(&rngc, rng))
+		return -1;
+
+	rc = randomGeneratorContextNext(&rngc, data, size);
+
+	randomGeneratorContextFree(&rngc);
+
+	return rc;
+}
+
+/* every byte of the request has to be written */
+static int checkfull(const randomGenerator* rng)
+{
+	byte data[1001];
+	int failures = 0;
+	size_t i;
+
+	memset(data, 0, sizeof(data));
+
+	if (generate(rng, data, sizeof(data)))
+	{
+		printf("%s failed\n", rng->name);
+		return 1;
+	}
+
+	for (i = 0; i + 8 <= sizeof(data); i += 8)
+	{
+		static const byte zero[8];
+
+		if (memcmp(data + i, zero, 8) == 0)
+		{
+			printf("%s left bytes %u to %u unwritten\n", rng->name, (unsigned) i, (unsigned) i+7);
+			failures++;
+			break;
+		}
+	}
+
+	return failures;
+}
+
+#if TEST_THREADS
+struct job
+{
+	const randomGenerator* rng;
+	byte data[SIZE];
+	int rc;
+};
+
+static void* run(void* arg)
+{
+	struct job* j = (struct job*) arg;
+
+	j->rc = generate(j->rng, j->data, SIZE);
+
+	return (void*) 0;
+}
+
+static int checkthreads(const randomGenerator* rng)
+{
+	struct job a, b;
+	pthread_t ta, tb;
+
+	a.rng = b.rng = rng;
+
+	if (pthread_create(&ta, (pthread_attr_t*) 0, run, &a))
+		return 1;
+	if (pthread_create(&tb, (pthread_attr_t*) 0, run, &b))
+		return 1;
+
+	pthread_join(ta, (void**) 0);
+	pthread_join(tb, (void**) 0);
+
+	if (a.rc || b.rc)
+	{
+		printf("%s failed in a thread\n", rng->name);
+		return 1;
+	}
+
+	if (memcmp(a.data, b.data, SIZE) == 0)
+	{
+		printf("%s gave two threads the same output\n", rng->name);
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
+#if TEST_FORK
+static int checkfork(const randomGenerator* rng)
+{
+	byte parent[SIZE], child[SIZE];
+	int fd[2], status;
+	pid_t pid;
+
+	/* the thread's state exists before the fork */
+	if (generate(rng, parent, SIZE))
+		return 1;
+
+	if (pipe(fd))
+		return 1;
+
+	if ((pid = fork()) < 0)
+		return 1;
+
+	if (pid == 0)
+	{
+		close(fd[0]);
+		if (generate(rng, child, SIZE) || write(fd[1], child, SIZE) != SIZE)
+			_exit(1);
+		_exit(0);
+	}
+
+	close(fd[1]);
+
+	if (generate(rng, parent, SIZE))
+		return 1;
+
+	if (read(fd[0], child, SIZE) != SIZE)
+	{
+		printf("%s failed in a forked child\n", rng->name);
+		close(fd[0]);
+		waitpid(pid, &status, 0);
+		return 1;
+	}
+
+	close(fd[0]);
+	waitpid(pid, &status, 0);
+
+	if (memcmp(parent, child, SIZE) == 0)
+	{
+		printf("%s gave a forked child the parent's output\n", rng->name);
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
+int main()
+{
+	const randomGenerator* rngs[] = { &fips186ptprng, &mtprngpt };
+	int i, failures = 0;
+
+	for (i = 0; i < 2; i++)
+	{
+		failures += checkfull(rngs[i]);
+		#if TEST_THREADS
+		failures += checkthreads(rngs[i]);
+		#endif
+		#if TEST_FORK
+		failures += checkfork(rngs[i]);
+		#endif
+	}
+
+	return failures;
+}
@@ -27,6 +27,7 @@
 
 #include "beecrypt/beecrypt.h"
 #include "beecrypt/rsa.h"
+#include "beecrypt/mpmont.h"
 
 static const char* rsa_n  = "91e0fc15be36c499f2e2e36d77619c646cacf0cf6657fa136fea748b8e153f1d0cc4d38104da5273655c771282c77fd63061f360d8031406f5c9899f5ca590a19ba07d0bb3cf28c21d6d5fbf27149d2f817353c875f171a4eca9fd427feb4fc9e5f073cd68208423936ed0c3e71ada976fbec43b435dcaa3cfa7fafd973d2eaf";
 static const char* rsa_d = "54d7a9456c0fa66073270a66cc1bf53d63076236fdab0542f0c0477032fea06a60d6c8bc2cfa5d21c83df2f2cd250270ac4b0ba5b37c76d565760598ade58d2bcaefb61845002c5557911603cb13db23abd21a4b1981e49d74d4f37fe0d1ee83b98bca722e11aac9d268c014bbf18b276343d7a63ae8275fa21a43be76c241a1";
@@ -39,12 +40,14 @@ static const char* rsa_qi = "352b5d9d650e5e8ba1bf075e1b6ea6413cdcd419d16ae446a97
 
 static const char* rsa_m  = "0001ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff003021300906052b0e03021a05000414da39a3ee5e6b4b0d3255bfef95601890afd80709";
 
+#define BATCH	7
+
 int main()
 {
 	int failures = 0;
 
 	rsakp keypair;
-	mpnumber m, sig, sigcrt;
+	mpnumber m, sig, sigcrt, sigmont;
 	randomGeneratorContext rngc;
 
 	if (randomGeneratorContextInit(&rngc, randomGeneratorDefault()) == 0)
@@ -64,6 +67,7 @@ int main()
 		mpnzero(&m);
 		mpnzero(&sig);
 		mpnzero(&sigcrt);
+		mpnzero(&sigmont);
 
 		mpnsethex(&m, rsa_m);
 
@@ -86,6 +90,80 @@ int main()
 			failures++;
 		}
 
+		/* the Montgomery engine must produce the same signatures */
+		mpengineSetup(MP_ENGINE_MONTGOMERY);
+
+		if (rsapri(&keypair.n, &keypair.d, &m, &sigmont) || mpnex(sig.size, sig.data, sigmont.size, sigmont.data))
+		{
+			printf("rsapri with Montgomery engine failed\n");
+			failures++;
+		}
+
+		if (rsapricrt(&keypair.n, &keypair.p, &keypair.q, &keypair.dp, &keypair.dq, &keypair.qi, &m, &sigmont) || mpnex(sig.size, sig.data, sigmont.size, sigmont.data))
+		{
+			printf("rsapricrt with Montgomery engine failed\n");
+			failures++;
+		}
+
+		/* with the contexts prepared on the keypair */
+		if (rsakpPrecompute(&keypair) || rsapricrtkp(&keypair, &m, &sigmont) || mpnex(sig.size, sig.data, sigmont.size, sigmont.data))
+		{
+			printf("rsapricrtkp with Montgomery engine failed\n");
+			failures++;
+		}
+
+		mpengineSetup(MP_ENGINE_BARRETT);
+
+		/* the batch function must recover a set of encrypted messages,
+		 * with the default settings and with small groups over two threads
+		 */
+		{
+			mpnumber msg[BATCH], enc[BATCH], dec[BATCH];
+			int i, j;
+
+			for (i = 0; i < BATCH; i++)
+			{
+				mpnzero(msg+i);
+				mpnzero(enc+i);
+				mpnzero(dec+i);
+
+				mpnsethex(msg+i, rsa_m);
+				mpaddw(msg[i].size, msg[i].data, (mpw) i);
+
+				rsapub(&keypair.n, &keypair.e, msg+i, enc+i);
+			}
+
+			for (j = 0; j < 2; j++)
+			{
+				if (j)
+					rsaBatchSetup(2, 3);
+
+				if (rsapricrt_batch(&keypair, BATCH, enc, dec))
+				{
+					printf("rsapricrt_batch failed\n");
+					failures++;
+				}
+				else for (i = 0; i < BATCH; i++)
+				{
+					if (mpnex(msg[i].size, msg[i].data, dec[i].size, dec[i].data))
+					{
+						printf("rsapricrt_batch mismatch at %d\n", i);
+						failures++;
+					}
+				}
+			}
+
+			rsaBatchSetup(0, 0);
+
+			for (i = 0; i < BATCH; i++)
+			{
+				mpnfree(dec+i);
+				mpnfree(enc+i);
+				mpnfree(msg+i);
+			}
+		}
+
+		mpnfree(&sigmont);
 		mpnfree(&sigcrt);
 		mpnfree(&sig);
 		mpnfree(&m);
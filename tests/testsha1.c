@@ -18,8 +18,8 @@
  */
 
 /*!\file testsha1.c
- * \brief Unit test program for the SHA-1 algorithm ; it tests all but one of
- *        the vectors specified by FIPS PUB 180-1.
+ * \brief Unit test program for the SHA-1 algorithm ; it tests the vectors
+ *        specified by FIPS PUB 180-1.
  * \author Bob Deblier <bob.deblier@telenet.be>
  * \ingroup UNIT_m
  */
@@ -64,5 +64,97 @@ int main()
 			failures++;
 		}
 	}
+
+	/* the million times 'a' vector, from an unaligned buffer, first in one
+	 * piece, then in pieces which don't line up with the block boundaries
+	 */
+	{
+		static const int pieces[5] = { 1, 63, 64, 65, 1000 };
+		byte* buf = (byte*) malloc(1000001);
+
+		if (buf == (byte*) 0)
+			return -1;
+
+		memset(buf+1, 'a', 1000000);
+
+		for (i = 0; i < 2; i++)
+		{
+			if (sha1Reset(&param))
+				return -1;
+
+			if (i == 0)
+			{
+				if (sha1Update(&param, buf+1, 1000000))
+					return -1;
+			}
+			else
+			{
+				int j = 0, done = 0;
+
+				while (done < 1000000)
+				{
+					int size = pieces[j++ % 5];
+
+					if (size > 1000000 - done)
+						size = 1000000 - done;
+					if (sha1Update(&param, buf+1+done, size))
+						return -1;
+					done += size;
+				}
+			}
+
+			if (sha1Digest(&param, digest))
+				return -1;
+
+			if (memcmp(digest, "\x34\xaa\x97\x3c\xd4\xc4\xda\xa4\xf6\x1e\xeb\x2b\xdb\xad\x27\x31\x65\x34\x01\x6f", 20))
+			{
+				printf("failed test vector 3, pass %d\n", i+1);
+				failures++;
+			}
+		}
+
+		free(buf);
+	}
+
+	/* messages of many lengths at once must hash as they do one by one */
+	{
+		const byte* msgs[37];
+		size_t lens[37];
+		byte* digests[37];
+		byte* buf = (byte*) malloc(37 * 300 + 37 * 20);
+		byte expect[20];
+
+		if (buf == (byte*) 0)
+			return -1;
+
+		for (i = 0; i < 37 * 300; i++)
+			buf[i] = (byte) (i * 131 + 7);
+
+		for (i = 0; i < 37; i++)
+		{
+			msgs[i] = buf + i * 300 + (i & 3);
+			lens[i] = (size_t) (i * 8 + (i & 1));
+			digests[i] = buf + 37 * 300 + i * 20;
+		}
+
+		if (hashFunctionMultiDigest(&sha1, 37, msgs, lens, digests))
+			return -1;
+
+		for (i = 0; i < 37; i++)
+		{
+			if (sha1Update(&param, msgs[i], lens[i]))
+				return -1;
+			if (sha1Digest(&param, expect))
+				return -1;
+
+			if (memcmp(digests[i], expect, 20))
+			{
+				printf("failed multiple digest %d\n", i+1);
+				failures++;
+			}
+		}
+
+		free(buf);
+	}
 	return failures;
 }
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 
+#include "beecrypt/sha224.h"
 #include "beecrypt/sha256.h"
 
 struct vector
@@ -61,5 +62,170 @@ int main()
 			failures++;
 		}
 	}
+
+	/* the million times 'a' vector, from an unaligned buffer, first in one
+	 * piece, then in pieces which don't line up with the block boundaries
+	 */
+	{
+		static const int pieces[5] = { 1, 63, 64, 65, 1000 };
+		byte* buf = (byte*) malloc(1000001);
+
+		if (buf == (byte*) 0)
+			return -1;
+
+		memset(buf+1, 'a', 1000000);
+
+		for (i = 0; i < 2; i++)
+		{
+			if (sha256Reset(&param))
+				return -1;
+
+			if (i == 0)
+			{
+				if (sha256Update(&param, buf+1, 1000000))
+					return -1;
+			}
+			else
+			{
+				int j = 0, done = 0;
+
+				while (done < 1000000)
+				{
+					int size = pieces[j++ % 5];
+
+					if (size > 1000000 - done)
+						size = 1000000 - done;
+					if (sha256Update(&param, buf+1+done, size))
+						return -1;
+					done += size;
+				}
+			}
+
+			if (sha256Digest(&param, digest))
+				return -1;
+
+			if (memcmp(digest, "\xcd\xc7\x6e\x5c\x99\x14\xfb\x92\x81\xa1\xc7\xe2\x84\xd7\x3e\x67\xf1\x80\x9a\x48\xa4\x97\x20\x0e\x04\x6d\x39\xcc\xc7\x11\x2c\xd0", 32))
+			{
+				printf("failed test vector 3, pass %d\n", i+1);
+				failures++;
+			}
+		}
+
+		free(buf);
+	}
+
+	/* messages of many lengths at once must hash as they do one by one */
+	{
+		const byte* msgs[37];
+		size_t lens[37];
+		byte* digests[37];
+		byte* buf = (byte*) malloc(37 * 300 + 37 * 32);
+		byte expect[32];
+
+		if (buf == (byte*) 0)
+			return -1;
+
+		for (i = 0; i < 37 * 300; i++)
+			buf[i] = (byte) (i * 131 + 7);
+
+		for (i = 0; i < 37; i++)
+		{
+			msgs[i] = buf + i * 300 + (i & 3);
+			lens[i] = (size_t) (i * 8 + (i & 1));
+			digests[i] = buf + 37 * 300 + i * 32;
+		}
+
+		if (hashFunctionMultiDigest(&sha256, 37, msgs, lens, digests))
+			return -1;
+
+		for (i = 0; i < 37; i++)
+		{
+			if (sha256Update(&param, msgs[i], lens[i]))
+				return -1;
+			if (sha256Digest(&param, expect))
+				return -1;
+
+			if (memcmp(digests[i], expect, 32))
+			{
+				printf("failed multiple digest %d\n", i+1);
+				failures++;
+			}
+		}
+
+		free(buf);
+	}
+
+	/* hash the common prefix "abc" once, then fork it; also take the state
+	 * through its serialized form
+	 */
+	{
+		hashFunctionContext prefix, fork, restored;
+		byte* state;
+		size_t statesize;
+
+		if (hashFunctionContextInit(&prefix, &sha256))
+			return -1;
+		if (hashFunctionContextUpdate(&prefix, table[1].input, 3))
+			return -1;
+		if (hashFunctionContextClone(&fork, &prefix))
+			return -1;
+
+		statesize = hashFunctionContextStateSize(&prefix);
+		state = (byte*) malloc(statesize);
+		if (state == (byte*) 0)
+			return -1;
+		if (hashFunctionContextSerialize(&prefix, state, statesize))
+			return -1;
+
+		/* finishing one of them may not disturb the other */
+		if (hashFunctionContextDigest(&prefix, digest))
+			return -1;
+		if (memcmp(digest, table[0].expect, 32))
+		{
+			printf("failed cloned state, prefix\n");
+			failures++;
+		}
+
+		if (hashFunctionContextUpdate(&fork, table[1].input+3, 53))
+			return -1;
+		if (hashFunctionContextDigest(&fork, digest))
+			return -1;
+		if (memcmp(digest, table[1].expect, 32))
+		{
+			printf("failed cloned state, fork\n");
+			failures++;
+		}
+
+		if (hashFunctionContextInit(&restored, &sha256))
+			return -1;
+		if (hashFunctionContextDeserialize(&restored, state, statesize))
+			return -1;
+		if (hashFunctionContextUpdate(&restored, table[1].input+3, 53))
+			return -1;
+		if (hashFunctionContextDigest(&restored, digest))
+			return -1;
+		if (memcmp(digest, table[1].expect, 32))
+		{
+			printf("failed serialized state\n");
+			failures++;
+		}
+
+		/* the state of another hash function doesn't fit */
+		if (hashFunctionContextFree(&restored))
+			return -1;
+		if (hashFunctionContextInit(&restored, &sha224))
+			return -1;
+		if (hashFunctionContextDeserialize(&restored, state, statesize) == 0)
+		{
+			printf("failed to reject a foreign state\n");
+			failures++;
+		}
+
+		free(state);
+
+		hashFunctionContextFree(&restored);
+		hashFunctionContextFree(&fork);
+		hashFunctionContextFree(&prefix);
+	}
 	return failures;
 }